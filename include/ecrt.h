@@ -46,6 +46,23 @@
  * - Added ecrt_slave_config_state_timeout() to set the application-layer
  *   state change timeout and EC_HAVE_STATE_TIMEOUT to check for its
  *   existence.
+ * - Added the process data flight recorder methods ecrt_domain_recorder()
+ *   and ecrt_domain_recorder_freeze(), the EC_RECORDER_TRIGGER_* flags and
+ *   the EC_HAVE_RECORDER definition to check for its existence.
+ * - Added bulk access functions for arrays of little-endian values, i. e.
+ *   ecrt_read_u16_array(), ecrt_write_s32_array() etc., and
+ *   ecrt_slave_config_reg_pdo() to register a complete PDO at once. Use
+ *   EC_HAVE_ARRAY_ACCESS to check for their existence.
+ * - Added ecrt_master_set_domain_merging() to send the datagrams of domains
+ *   with adjacent logical addresses as one physical datagram, and the
+ *   EC_HAVE_DOMAIN_MERGING definition to check for its existence.
+ * - Added ecrt_master_sdo_upload_complete() and
+ *   ecrt_sdo_request_complete_access() to upload SDOs via CompleteAccess,
+ *   and the EC_HAVE_COMPLETE_UPLOAD definition to check for their
+ *   existence.
+ * - Added ecrt_master_foe_write() to store a file on several slaves in
+ *   parallel via FoE, the datatype ec_foe_target_t and the
+ *   EC_HAVE_FOE_WRITE definition to check for their existence.
  *
  * Changes since version 1.5.2:
  *
@@ -242,6 +259,30 @@
  */
 #define EC_HAVE_STATE_TIMEOUT
 
+/** Defined, if the methods ecrt_domain_recorder() and
+ * ecrt_domain_recorder_freeze() are available.
+ */
+#define EC_HAVE_RECORDER
+
+/** Defined, if the method ecrt_slave_config_reg_pdo() and the bulk access
+ * functions ecrt_read_*_array() and ecrt_write_*_array() are available.
+ */
+#define EC_HAVE_ARRAY_ACCESS
+
+/** Defined, if the method ecrt_master_set_domain_merging() is available.
+ */
+#define EC_HAVE_DOMAIN_MERGING
+
+/** Defined, if the methods ecrt_master_sdo_upload_complete() and
+ * ecrt_sdo_request_complete_access() are available.
+ */
+#define EC_HAVE_COMPLETE_UPLOAD
+
+/** Defined, if the method ecrt_master_foe_write() and the datatype
+ * ec_foe_target_t are available.
+ */
+#define EC_HAVE_FOE_WRITE
+
 /****************************************************************************/
 
 /** Symbol visibility control macro.
@@ -474,6 +515,24 @@ typedef struct {
 
 /****************************************************************************/
 
+/** Target slave of an FoE write.
+ *
+ * This is used as an input/output parameter of ecrt_master_foe_write().
+ *
+ * \see ecrt_master_foe_write().
+ */
+typedef struct {
+    uint16_t slave_position; /**< Slave position (input). */
+    int error; /**< Zero on success, otherwise a negative error code. */
+    uint32_t result; /**< FoE result code of the master, if the transfer
+                       failed. */
+    uint32_t error_code; /**< Error code from an FoE Error Request of the
+                           slave. */
+    size_t data_size; /**< Number of bytes acknowledged by the slave. */
+} ec_foe_target_t;
+
+/****************************************************************************/
+
 /** Domain working counter interpretation.
  *
  * This is used in ec_domain_state_t.
@@ -499,6 +558,22 @@ typedef struct {
 
 /****************************************************************************/
 
+/** Flight recorder trigger: Freeze, if the working counter drops.
+ *
+ * Fires, if the working counter of a domain falls below the expected value
+ * after it was complete before.
+ */
+#define EC_RECORDER_TRIGGER_WC 0x01
+
+/** Flight recorder trigger: Freeze on explicit request.
+ *
+ * This is reported, if the recorder was frozen via
+ * ecrt_domain_recorder_freeze() or the command-line tool.
+ */
+#define EC_RECORDER_TRIGGER_MANUAL 0x80
+
+/****************************************************************************/
+
 /** Direction type for PDO assignment functions.
  */
 typedef enum {
@@ -995,6 +1070,60 @@ EC_PUBLIC_API int ecrt_master_sdo_upload(
         uint32_t *abort_code /**< Abort code of the SDO upload. */
         );
 
+/** Executes an SDO upload request to read data from a slave via complete
+ * access.
+ *
+ * All subindices of the SDO, starting with subindex 0, are read in one
+ * transfer. The data of subindex 0 are padded to 16 bit.
+ *
+ * This request is processed by the master state machine. This method blocks,
+ * until the request has been processed and may not be called in realtime
+ * context.
+ *
+ * \apiusage{master_any,blocking}
+ *
+ * \retval  0 Success.
+ * \retval <0 Error code.
+ */
+EC_PUBLIC_API int ecrt_master_sdo_upload_complete(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint16_t slave_position, /**< Slave position. */
+        uint16_t index, /**< Index of the SDO. */
+        uint8_t *target, /**< Target buffer for the upload. */
+        size_t target_size, /**< Size of the target buffer. */
+        size_t *result_size, /**< Uploaded data size. */
+        uint32_t *abort_code /**< Abort code of the SDO upload. */
+        );
+
+/** Stores a file on one or more slaves via FoE.
+ *
+ * One FoE write request is queued for each target slave. The slave state
+ * machines process them in parallel, so that the mailbox packets of all
+ * slaves are exchanged in the same frames. The data are held only once.
+ *
+ * The \a error, \a result, \a error_code and \a data_size fields of the
+ * targets are set individually. A missing slave or a failed transfer does not
+ * affect the other targets. Each slave may be listed only once, otherwise
+ * nothing is transferred and -EINVAL is returned.
+ *
+ * This method blocks, until all requests have been processed and may not be
+ * called in realtime context.
+ *
+ * \apiusage{master_any,blocking}
+ *
+ * \retval  0 Success on all targets.
+ * \retval -EIO The transfer failed on at least one target.
+ * \retval <0 Error code.
+ */
+EC_PUBLIC_API int ecrt_master_foe_write(
+        ec_master_t *master, /**< EtherCAT master. */
+        ec_foe_target_t *targets, /**< Target slaves. */
+        size_t target_count, /**< Number of target slaves. */
+        const char *file_name, /**< File name on the slaves. */
+        const uint8_t *data, /**< File data. */
+        size_t data_size /**< Size of the file data. */
+        );
+
 /** Executes an SoE write request.
  *
  * Starts writing an IDN and blocks until the request was processed, or an
@@ -1098,6 +1227,35 @@ EC_PUBLIC_API int ecrt_master_set_send_interval(
         size_t send_interval /**< Send interval in us */
         );
 
+/** Enables or disables merging of domain datagrams.
+ *
+ * If enabled, ecrt_master_send() combines the datagrams of domains, that
+ * were queued in the same cycle and whose logical address ranges are
+ * adjacent, into a single physical datagram. This saves the datagram header
+ * and working counter overhead for applications that use many small domains
+ * only for grouping purposes.
+ *
+ * Datagrams are only merged, if they do not address a common slave, because
+ * a slave increments the working counter of a datagram only once.
+ *
+ * The working counters of the individual domains are derived from the
+ * working counter of the merged datagram. If the merged datagram does not
+ * return the expected value, each affected domain reports an incomplete
+ * working counter and merging is suspended for some cycles, so that the
+ * exact per-domain working counters become visible again.
+ *
+ * Merging is disabled by default and is reset by ecrt_master_deactivate().
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \retval 0 on success.
+ * \retval <0 Error code.
+ */
+EC_PUBLIC_API int ecrt_master_set_domain_merging(
+        ec_master_t *master, /**< EtherCAT master. */
+        int enable /**< Non-zero to enable merging. */
+        );
+
 /** Sends all datagrams in the queue.
  *
  * This method takes all datagrams, that have been queued for transmission,
@@ -1591,6 +1749,29 @@ EC_PUBLIC_API int ecrt_slave_config_reg_pdo_entry_pos(
                                  is desired */
         );
 
+/** Registers a complete PDO for process data exchange in a domain.
+ *
+ * Similar to ecrt_slave_config_reg_pdo_entry(), but registers all entries of
+ * the PDO with the given index at once. This is useful for PDOs containing
+ * arrays of values, that shall be accessed with the ecrt_read_*_array() and
+ * ecrt_write_*_array() functions. The PDO has to start at a byte boundary.
+ *
+ * This method has to be called in non-realtime context before
+ * ecrt_master_activate().
+ *
+ * \apiusage{master_idle,blocking}
+ *
+ * \retval >=0 Success: Offset of the PDO's process data.
+ * \retval  <0 Error code.
+ */
+EC_PUBLIC_API int ecrt_slave_config_reg_pdo(
+        ec_slave_config_t *sc, /**< Slave configuration. */
+        uint16_t pdo_index, /**< Index of the PDO to register. */
+        ec_domain_t *domain, /**< Domain. */
+        unsigned int *size /**< Optional address to store the size of the
+                             PDO's process data in byte. */
+        );
+
 /** Configure distributed clocks.
  *
  * Sets the AssignActivate word and the cycle and shift times for the sync
@@ -2264,6 +2445,50 @@ EC_PUBLIC_API int ecrt_domain_state(
                                    information. */
         );
 
+/** Enables the process data flight recorder of a domain.
+ *
+ * The recorder keeps the last \a depth process data images of the domain
+ * together with the working counters and the application time in a ring
+ * buffer. A record is appended on every call of ecrt_domain_process(). The
+ * memory is allocated on master activation, so recording does not allocate
+ * memory in realtime context.
+ *
+ * If one of the \a triggers fires (see EC_RECORDER_TRIGGER_WC), or if
+ * ecrt_domain_recorder_freeze() is called, the recorder takes \a
+ * post_trigger further records and then freezes, until it is re-armed. The
+ * ring can be read with the 'ethercat record' command.
+ *
+ * This method has to be called in non-realtime context before
+ * ecrt_master_activate(). Afterwards, -EBUSY is returned.
+ *
+ * \apiusage{master_idle,blocking}
+ *
+ * \return 0 on success, otherwise negative error code.
+ */
+EC_PUBLIC_API int ecrt_domain_recorder(
+        ec_domain_t *domain, /**< Domain. */
+        unsigned int depth, /**< Number of records. Zero disables the
+                              recorder. */
+        unsigned int post_trigger, /**< Number of records to take after a
+                                     trigger. Must be less than \a depth. */
+        unsigned int triggers /**< Bitwise OR of EC_RECORDER_TRIGGER_*
+                                flags. */
+        );
+
+/** Freezes the flight recorder of a domain.
+ *
+ * Triggers the recorder as with EC_RECORDER_TRIGGER_MANUAL. Use this, if the
+ * application detects a fault condition itself. The trigger is applied by
+ * the next call of ecrt_domain_process().
+ *
+ * \apiusage{master_op,rt_safe}
+ *
+ * \return 0 on success, otherwise negative error code.
+ */
+EC_PUBLIC_API int ecrt_domain_recorder_freeze(
+        ec_domain_t *domain /**< Domain. */
+        );
+
 /*****************************************************************************
  * SDO request methods.
  ****************************************************************************/
@@ -2309,6 +2534,24 @@ EC_PUBLIC_API int ecrt_sdo_request_timeout(
                            timeout. */
         );
 
+/** Select the CompleteAccess method for an SDO request.
+ *
+ * If enabled, ecrt_sdo_request_read() and ecrt_sdo_request_write() transfer
+ * all subindices of the SDO at once, starting with subindex 0, which is
+ * padded to 16 bit. The subindex of the request is ignored in this case.
+ *
+ * \attention This method may not be called while ecrt_sdo_request_state()
+ * returns EC_REQUEST_BUSY.
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \return 0 on success, otherwise negative error code.
+ */
+EC_PUBLIC_API int ecrt_sdo_request_complete_access(
+        ec_sdo_request_t *req, /**< SDO request. */
+        int complete_access /**< Non-zero to use CompleteAccess. */
+        );
+
 /** Access to the SDO request's data.
  *
  * This function returns a pointer to the request's internal SDO data memory.
@@ -3028,6 +3271,93 @@ EC_PUBLIC_API double ecrt_read_lreal(const void *data);
 
 #endif // ifndef __KERNEL__
 
+/*****************************************************************************
+ * Bulk read functions (userspace only)
+ ****************************************************************************/
+
+#ifndef __KERNEL__
+
+/** Read an array of 16-bit unsigned values from EtherCAT data.
+ *
+ * On little-endian hosts, this is a plain memory copy, otherwise the byte
+ * order of all values is swapped in a single loop.
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param values Destination array.
+ * \param data EtherCAT data pointer.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_read_u16_array(uint16_t *values, const void *data,
+        size_t count);
+
+/** Read an array of 16-bit signed values from EtherCAT data.
+ *
+ * \see ecrt_read_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param values Destination array.
+ * \param data EtherCAT data pointer.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_read_s16_array(int16_t *values, const void *data,
+        size_t count);
+
+/** Read an array of 32-bit unsigned values from EtherCAT data.
+ *
+ * \see ecrt_read_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param values Destination array.
+ * \param data EtherCAT data pointer.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_read_u32_array(uint32_t *values, const void *data,
+        size_t count);
+
+/** Read an array of 32-bit signed values from EtherCAT data.
+ *
+ * \see ecrt_read_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param values Destination array.
+ * \param data EtherCAT data pointer.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_read_s32_array(int32_t *values, const void *data,
+        size_t count);
+
+/** Read an array of 64-bit unsigned values from EtherCAT data.
+ *
+ * \see ecrt_read_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param values Destination array.
+ * \param data EtherCAT data pointer.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_read_u64_array(uint64_t *values, const void *data,
+        size_t count);
+
+/** Read an array of 64-bit signed values from EtherCAT data.
+ *
+ * \see ecrt_read_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param values Destination array.
+ * \param data EtherCAT data pointer.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_read_s64_array(int64_t *values, const void *data,
+        size_t count);
+
+#endif // ifndef __KERNEL__
+
 /*****************************************************************************
  * Write macros
  ****************************************************************************/
@@ -3140,6 +3470,93 @@ EC_PUBLIC_API void ecrt_write_lreal(void *data, double value);
 
 #endif // ifndef __KERNEL__
 
+/*****************************************************************************
+ * Bulk write functions (userspace only)
+ ****************************************************************************/
+
+#ifndef __KERNEL__
+
+/** Write an array of 16-bit unsigned values to EtherCAT data.
+ *
+ * On little-endian hosts, this is a plain memory copy, otherwise the byte
+ * order of all values is swapped in a single loop.
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param data EtherCAT data pointer.
+ * \param values Source array.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_write_u16_array(void *data, const uint16_t *values,
+        size_t count);
+
+/** Write an array of 16-bit signed values to EtherCAT data.
+ *
+ * \see ecrt_write_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param data EtherCAT data pointer.
+ * \param values Source array.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_write_s16_array(void *data, const int16_t *values,
+        size_t count);
+
+/** Write an array of 32-bit unsigned values to EtherCAT data.
+ *
+ * \see ecrt_write_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param data EtherCAT data pointer.
+ * \param values Source array.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_write_u32_array(void *data, const uint32_t *values,
+        size_t count);
+
+/** Write an array of 32-bit signed values to EtherCAT data.
+ *
+ * \see ecrt_write_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param data EtherCAT data pointer.
+ * \param values Source array.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_write_s32_array(void *data, const int32_t *values,
+        size_t count);
+
+/** Write an array of 64-bit unsigned values to EtherCAT data.
+ *
+ * \see ecrt_write_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param data EtherCAT data pointer.
+ * \param values Source array.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_write_u64_array(void *data, const uint64_t *values,
+        size_t count);
+
+/** Write an array of 64-bit signed values to EtherCAT data.
+ *
+ * \see ecrt_write_u16_array()
+ *
+ * \apiusage{master_any,rt_safe}
+ *
+ * \param data EtherCAT data pointer.
+ * \param values Source array.
+ * \param count Number of values.
+ */
+EC_PUBLIC_API void ecrt_write_s64_array(void *data, const int64_t *values,
+        size_t count);
+
+#endif // ifndef __KERNEL__
+
 /****************************************************************************/
 
 #ifdef __cplusplus
@@ -0,0 +1,151 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT master userspace library.
+ *
+ *  The IgH EtherCAT master userspace library is free software; you can
+ *  redistribute it and/or modify it under the terms of the GNU Lesser General
+ *  Public License as published by the Free Software Foundation; version 2.1
+ *  of the License.
+ *
+ *  The IgH EtherCAT master userspace library is distributed in the hope that
+ *  it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with the IgH EtherCAT master userspace library. If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************************/
+
+/** \file
+ * Bulk access to arrays of process data values.
+ *
+ * This file is also compiled into the fake userspace library.
+ */
+
+/****************************************************************************/
+
+#include <endian.h>
+#include <string.h>
+
+#include "include/ecrt.h"
+
+/****************************************************************************/
+
+/** Copies an array of values from or to little-endian byte order.
+ *
+ * On little-endian hosts, this is a plain memcpy(). Otherwise, the bytes of
+ * each value are reversed. The byte-wise loop works with unaligned process
+ * data and is turned into vector permutations by the compiler, because \a
+ * width is a constant after inlining.
+ */
+static inline void ec_copy_le(
+        void *dst, /**< Destination. */
+        const void *src, /**< Source. */
+        size_t count, /**< Number of values. */
+        const size_t width /**< Size of a value in byte. */
+        )
+{
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    memcpy(dst, src, count * width);
+#else
+    const uint8_t *s = (const uint8_t *) src;
+    uint8_t *d = (uint8_t *) dst;
+    size_t i, j;
+
+    for (i = 0; i < count; i++, s += width, d += width) {
+        for (j = 0; j < width; j++) {
+            d[j] = s[width - 1 - j];
+        }
+    }
+#endif
+}
+
+/****************************************************************************/
+
+void ecrt_read_u16_array(uint16_t *values, const void *data, size_t count)
+{
+    ec_copy_le(values, data, count, sizeof(uint16_t));
+}
+
+/****************************************************************************/
+
+void ecrt_read_s16_array(int16_t *values, const void *data, size_t count)
+{
+    ec_copy_le(values, data, count, sizeof(int16_t));
+}
+
+/****************************************************************************/
+
+void ecrt_read_u32_array(uint32_t *values, const void *data, size_t count)
+{
+    ec_copy_le(values, data, count, sizeof(uint32_t));
+}
+
+/****************************************************************************/
+
+void ecrt_read_s32_array(int32_t *values, const void *data, size_t count)
+{
+    ec_copy_le(values, data, count, sizeof(int32_t));
+}
+
+/****************************************************************************/
+
+void ecrt_read_u64_array(uint64_t *values, const void *data, size_t count)
+{
+    ec_copy_le(values, data, count, sizeof(uint64_t));
+}
+
+/****************************************************************************/
+
+void ecrt_read_s64_array(int64_t *values, const void *data, size_t count)
+{
+    ec_copy_le(values, data, count, sizeof(int64_t));
+}
+
+/****************************************************************************/
+
+void ecrt_write_u16_array(void *data, const uint16_t *values, size_t count)
+{
+    ec_copy_le(data, values, count, sizeof(uint16_t));
+}
+
+/****************************************************************************/
+
+void ecrt_write_s16_array(void *data, const int16_t *values, size_t count)
+{
+    ec_copy_le(data, values, count, sizeof(int16_t));
+}
+
+/****************************************************************************/
+
+void ecrt_write_u32_array(void *data, const uint32_t *values, size_t count)
+{
+    ec_copy_le(data, values, count, sizeof(uint32_t));
+}
+
+/****************************************************************************/
+
+void ecrt_write_s32_array(void *data, const int32_t *values, size_t count)
+{
+    ec_copy_le(data, values, count, sizeof(int32_t));
+}
+
+/****************************************************************************/
+
+void ecrt_write_u64_array(void *data, const uint64_t *values, size_t count)
+{
+    ec_copy_le(data, values, count, sizeof(uint64_t));
+}
+
+/****************************************************************************/
+
+void ecrt_write_s64_array(void *data, const int64_t *values, size_t count)
+{
+    ec_copy_le(data, values, count, sizeof(int64_t));
+}
+
+/****************************************************************************/
@@ -161,3 +161,4 @@ void ecrt_write_lreal(void *data, double value)
 }
 
 /****************************************************************************/
+
@@ -132,3 +132,39 @@ int ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state)
 }
 
 /****************************************************************************/
+
+int ecrt_domain_recorder(ec_domain_t *domain, unsigned int depth,
+        unsigned int post_trigger, unsigned int triggers)
+{
+    ec_ioctl_recorder_t io = {};
+    int ret;
+
+    io.domain_index = domain->index;
+    io.depth = depth;
+    io.post_trigger = post_trigger;
+    io.triggers = triggers;
+
+    ret = ioctl(domain->master->fd, EC_IOCTL_DOMAIN_RECORDER, &io);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to configure flight recorder: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+int ecrt_domain_recorder_freeze(ec_domain_t *domain)
+{
+    int ret;
+
+    ret = ioctl(domain->master->fd, EC_IOCTL_RECORDER_FREEZE, domain->index);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        return -EC_IOCTL_ERRNO(ret);
+    }
+    return 0;
+}
+
+/****************************************************************************/
@@ -480,6 +480,7 @@ int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
     upload.slave_position = slave_position;
     upload.sdo_index = index;
     upload.sdo_entry_subindex = subindex;
+    upload.complete_access = 0;
     upload.target_size = target_size;
     upload.target = target;
 
@@ -499,6 +500,66 @@ int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
 
 /****************************************************************************/
 
+int ecrt_master_sdo_upload_complete(ec_master_t *master,
+        uint16_t slave_position, uint16_t index, uint8_t *target,
+        size_t target_size, size_t *result_size, uint32_t *abort_code)
+{
+    ec_ioctl_slave_sdo_upload_t upload;
+    int ret;
+
+    upload.slave_position = slave_position;
+    upload.sdo_index = index;
+    upload.sdo_entry_subindex = 0;
+    upload.complete_access = 1;
+    upload.target_size = target_size;
+    upload.target = target;
+
+    ret = ioctl(master->fd, EC_IOCTL_SLAVE_SDO_UPLOAD, &upload);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        if (EC_IOCTL_ERRNO(ret) == EIO && abort_code) {
+            *abort_code = upload.abort_code;
+        }
+        fprintf(stderr, "Failed to execute SDO upload: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    *result_size = upload.data_size;
+    return 0;
+}
+
+/****************************************************************************/
+
+int ecrt_master_foe_write(ec_master_t *master, ec_foe_target_t *targets,
+        size_t target_count, const char *file_name, const uint8_t *data,
+        size_t data_size)
+{
+    ec_ioctl_slave_foe_multi_t io;
+    int ret;
+
+    if (strlen(file_name) >= sizeof(io.file_name)) {
+        fprintf(stderr, "FoE file name too long.\n");
+        return -EINVAL;
+    }
+
+    strcpy(io.file_name, file_name);
+    io.buffer_size = data_size;
+    io.buffer = data;
+    io.target_count = target_count;
+    io.targets = targets;
+
+    ret = ioctl(master->fd, EC_IOCTL_SLAVE_FOE_WRITE_MULTI, &io);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to write via FoE: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
 int ecrt_master_write_idn(ec_master_t *master, uint16_t slave_position,
         uint8_t drive_no, uint16_t idn, const uint8_t *data, size_t data_size,
         uint16_t *error_code)
@@ -642,6 +703,20 @@ int ecrt_master_set_send_interval(ec_master_t *master,
 
 /****************************************************************************/
 
+int ecrt_master_set_domain_merging(ec_master_t *master, int enable)
+{
+    int ret;
+
+    ret = ioctl(master->fd, EC_IOCTL_DOMAIN_MERGING, enable ? 1 : 0);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
 int ecrt_master_send(ec_master_t *master)
 {
     int ret;
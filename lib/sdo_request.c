@@ -86,6 +86,26 @@ int ecrt_sdo_request_timeout(ec_sdo_request_t *req, uint32_t timeout)
 
 /****************************************************************************/
 
+int ecrt_sdo_request_complete_access(ec_sdo_request_t *req,
+        int complete_access)
+{
+    ec_ioctl_sdo_request_t data;
+    int ret;
+
+    data.config_index = req->config->index;
+    data.request_index = req->index;
+    data.complete_access = complete_access ? 1 : 0;
+
+    ret = ioctl(req->config->master->fd, EC_IOCTL_SDO_REQUEST_COMPLETE,
+            &data);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        return -EC_IOCTL_ERRNO(ret);
+    }
+    return 0;
+}
+
+/****************************************************************************/
+
 uint8_t *ecrt_sdo_request_data(const ec_sdo_request_t *req)
 {
     return req->data;
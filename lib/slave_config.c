@@ -369,6 +369,36 @@ int ecrt_slave_config_reg_pdo_entry_pos(
 
 /****************************************************************************/
 
+int ecrt_slave_config_reg_pdo(
+        ec_slave_config_t *sc,
+        uint16_t pdo_index,
+        ec_domain_t *domain,
+        unsigned int *size
+        )
+{
+    ec_ioctl_reg_pdo_t io;
+    int ret;
+
+    io.config_index = sc->index;
+    io.pdo_index = pdo_index;
+    io.domain_index = domain->index;
+
+    ret = ioctl(sc->master->fd, EC_IOCTL_SC_REG_PDO, &io);
+    if (EC_IOCTL_IS_ERROR(ret)) {
+        fprintf(stderr, "Failed to register PDO: %s\n",
+                strerror(EC_IOCTL_ERRNO(ret)));
+        return -EC_IOCTL_ERRNO(ret);
+    }
+
+    if (size) {
+        *size = io.size;
+    }
+
+    return ret;
+}
+
+/****************************************************************************/
+
 int ecrt_slave_config_dc(ec_slave_config_t *sc, uint16_t assign_activate,
         uint32_t sync0_cycle_time, int32_t sync0_shift_time,
         uint32_t sync1_cycle_time, int32_t sync1_shift_time)
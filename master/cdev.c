@@ -151,6 +151,8 @@ int eccdev_open(struct inode *inode, struct file *filp)
     priv->ctx.requested = 0;
     priv->ctx.process_data = NULL;
     priv->ctx.process_data_size = 0;
+    priv->ctx.foe_stream = NULL;
+    sema_init(&priv->ctx.foe_stream_sem, 1);
 
     filp->private_data = priv;
 
@@ -169,6 +171,8 @@ int eccdev_release(struct inode *inode, struct file *filp)
     ec_cdev_priv_t *priv = (ec_cdev_priv_t *) filp->private_data;
     ec_master_t *master = priv->cdev->master;
 
+    ec_ioctl_foe_stream_clear(master, &priv->ctx);
+
     if (priv->ctx.requested) {
         ecrt_release_master(master);
     }
@@ -260,11 +264,38 @@ static FAULT_RETURN_TYPE eccdev_vma_fault(
     ec_cdev_priv_t *priv = (ec_cdev_priv_t *) vma->vm_private_data;
     struct page *page;
 
-    if (offset >= priv->ctx.process_data_size) {
+    if (offset >= EC_RECORDER_MMAP_OFFSET(0)) {
+        /* flight recorder memory of a domain. The domain list and the
+         * recorder memory are protected by master_sem. */
+        ec_master_t *master = priv->cdev->master;
+        const ec_domain_t *domain;
+
+        if (down_interruptible(&master->master_sem)) {
+            return VM_FAULT_NOPAGE; // retry after the signal
+        }
+        domain = ec_master_find_domain_const(master,
+                (offset >> EC_RECORDER_MMAP_SHIFT) - 1);
+        offset &= EC_RECORDER_MMAP_OFFSET(0) - 1;
+        if (!domain || offset >= domain->recorder.mem_size) {
+            up(&master->master_sem);
+            return VM_FAULT_SIGBUS;
+        }
+        page = vmalloc_to_page(domain->recorder.memory + offset);
+        if (page) {
+            get_page(page);
+        }
+        up(&master->master_sem);
+        if (!page) {
+            return VM_FAULT_SIGBUS;
+        }
+        vmf->page = page;
+        return 0;
+    } else if (offset < priv->ctx.process_data_size) {
+        page = vmalloc_to_page(priv->ctx.process_data + offset);
+    } else {
         return VM_FAULT_SIGBUS;
     }
 
-    page = vmalloc_to_page(priv->ctx.process_data + offset);
     if (!page) {
         return VM_FAULT_SIGBUS;
     }
@@ -41,7 +41,9 @@
         return ret; \
     datagram->index = 0; \
     datagram->working_counter = 0; \
-    datagram->state = EC_DATAGRAM_INIT;
+    datagram->state = EC_DATAGRAM_INIT; \
+    datagram->mbox_status_bit = -1; \
+    datagram->mbox_parked = 0;
 
 #define EC_FUNC_FOOTER \
     datagram->data_size = data_size; \
@@ -101,6 +103,12 @@ void ec_datagram_init(ec_datagram_t *datagram /**< EtherCAT datagram. */)
     datagram->skip_count = 0;
     datagram->stats_output_jiffies = 0;
     memset(datagram->name, 0x00, EC_DATAGRAM_NAME_SIZE);
+    datagram->expected_working_counter = 0x0000;
+    datagram->merge_next = NULL;
+    datagram->merge_size = 0;
+    datagram->merge_base = 0xFFFFFFFF;
+    datagram->mbox_status_bit = -1;
+    datagram->mbox_parked = 0;
 }
 
 /****************************************************************************/
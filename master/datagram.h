@@ -76,7 +76,7 @@ typedef enum {
 
 /** EtherCAT datagram.
  */
-typedef struct {
+typedef struct ec_datagram {
     struct list_head queue; /**< Master datagram queue item,
         protected by user-supplied mutex. */
     struct list_head ext_queue; /**< External datagram queue item, protected by ext_queue_sem. */
@@ -104,6 +104,21 @@ typedef struct {
     unsigned int skip_count; /**< Number of requeues when not yet received. */
     unsigned long stats_output_jiffies; /**< Last statistics output. */
     char name[EC_DATAGRAM_NAME_SIZE]; /**< Description of the datagram. */
+    uint16_t expected_working_counter; /**< Expected working counter of a
+                                         domain datagram, else zero. */
+    struct ec_datagram *merge_next; /**< Next datagram sent within the same
+                                      physical datagram, or NULL. */
+    size_t merge_size; /**< Size of the physical datagram this datagram
+                         heads. */
+    uint32_t merge_base; /**< Lowest logical address of a physical
+                           datagram, that this datagram may be appended to.
+                           */
+    int mbox_status_bit; /**< Bit of the addressed slave in the master's
+                           mailbox status image, if this is a mailbox check
+                           datagram, that can be answered from it, else -1. */
+    unsigned int mbox_parked; /**< The mailbox check datagram stays in the
+                                queue, until it is answered by the mailbox
+                                status datagram. */
 } ec_datagram_t;
 
 /****************************************************************************/
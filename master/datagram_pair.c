@@ -122,6 +122,8 @@ int ec_datagram_pair_init(
 
     for (dev_idx = EC_DEVICE_MAIN;
             dev_idx < ec_master_num_devices(domain->master); dev_idx++) {
+        pair->datagrams[dev_idx].expected_working_counter =
+            pair->expected_working_counter;
         ec_datagram_zero(&pair->datagrams[dev_idx]);
     }
 
@@ -78,6 +78,11 @@ void ec_domain_init(
     domain->working_counter_changes = 0;
     domain->redundancy_active = 0;
     domain->notify_jiffies = 0;
+    domain->diag_request = 0;
+    domain->diag_state = EC_WC_DIAG_IDLE;
+    domain->diag_working_counter = 0x0000;
+    domain->diag_count = 0;
+    ec_recorder_init(&domain->recorder, domain);
 }
 
 /****************************************************************************/
@@ -95,6 +100,7 @@ void ec_domain_clear(ec_domain_t *domain /**< EtherCAT domain */)
         kfree(datagram_pair);
     }
 
+    ec_recorder_clear(&domain->recorder);
     ec_domain_clear_data(domain);
 }
 
@@ -307,6 +313,10 @@ int ec_domain_finish(
         datagram_count++;
     }
 
+    ret = ec_recorder_alloc(&domain->recorder);
+    if (ret < 0)
+        return ret;
+
     EC_MASTER_INFO(domain->master, "Domain%u: Logical address 0x%08x,"
             " %zu byte, expected working counter %u.\n", domain->index,
             domain->logical_base_address, domain->data_size,
@@ -456,7 +466,7 @@ uint8_t *ecrt_domain_data(const ec_domain_t *domain)
 
 int ecrt_domain_process(ec_domain_t *domain)
 {
-    uint16_t wc_sum[EC_MAX_NUM_DEVICES] = {}, wc_total;
+    uint16_t wc_sum[EC_MAX_NUM_DEVICES] = {}, wc_total, wc_last;
     ec_datagram_pair_t *pair;
 #if EC_MAX_NUM_DEVICES > 1
     uint16_t datagram_pair_wc, redundant_wc;
@@ -592,8 +602,10 @@ int ecrt_domain_process(ec_domain_t *domain)
     wc_change = 0;
 #endif
     wc_total = 0;
+    wc_last = 0;
     for (dev_idx = EC_DEVICE_MAIN;
             dev_idx < ec_master_num_devices(domain->master); dev_idx++) {
+        wc_last += domain->working_counter[dev_idx];
         if (wc_sum[dev_idx] != domain->working_counter[dev_idx]) {
 #ifdef EC_RT_SYSLOG
             wc_change = 1;
@@ -603,6 +615,13 @@ int ecrt_domain_process(ec_domain_t *domain)
         wc_total += wc_sum[dev_idx];
     }
 
+    if (unlikely(wc_total < wc_last) && !domain->diag_request
+            && domain->diag_state != EC_WC_DIAG_BUSY) {
+        // let the master state machine find the missing slaves
+        domain->diag_working_counter = wc_total;
+        domain->diag_request = 1;
+    }
+
 #ifdef EC_RT_SYSLOG
     if (wc_change) {
         domain->working_counter_changes++;
@@ -640,6 +659,10 @@ int ecrt_domain_process(ec_domain_t *domain)
         domain->working_counter_changes = 0;
     }
 #endif
+
+    if (domain->recorder.header) {
+        ec_recorder_record(&domain->recorder, wc_total);
+    }
     return 0;
 }
 
@@ -704,6 +727,31 @@ int ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state)
 
 /****************************************************************************/
 
+int ecrt_domain_recorder(ec_domain_t *domain, unsigned int depth,
+        unsigned int post_trigger, unsigned int triggers)
+{
+    int ret;
+
+    EC_MASTER_DBG(domain->master, 1, "ecrt_domain_recorder(domain = 0x%p,"
+            " depth = %u, post_trigger = %u, triggers = 0x%x)\n",
+            domain, depth, post_trigger, triggers);
+
+    down(&domain->master->master_sem);
+    ret = ec_recorder_config(&domain->recorder, depth, post_trigger,
+            triggers);
+    up(&domain->master->master_sem);
+    return ret;
+}
+
+/****************************************************************************/
+
+int ecrt_domain_recorder_freeze(ec_domain_t *domain)
+{
+    return ec_recorder_freeze(&domain->recorder);
+}
+
+/****************************************************************************/
+
 /** \cond */
 
 EXPORT_SYMBOL(ecrt_domain_reg_pdo_entry_list);
@@ -713,6 +761,8 @@ EXPORT_SYMBOL(ecrt_domain_data);
 EXPORT_SYMBOL(ecrt_domain_process);
 EXPORT_SYMBOL(ecrt_domain_queue);
 EXPORT_SYMBOL(ecrt_domain_state);
+EXPORT_SYMBOL(ecrt_domain_recorder);
+EXPORT_SYMBOL(ecrt_domain_recorder_freeze);
 
 /** \endcond */
 
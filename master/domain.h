@@ -35,6 +35,7 @@
 #include "datagram.h"
 #include "master.h"
 #include "fmmu_config.h"
+#include "recorder.h"
 
 /****************************************************************************/
 
@@ -64,6 +65,15 @@ struct ec_domain
                                              since last notification. */
     unsigned int redundancy_active; /**< Non-zero, if redundancy is in use. */
     unsigned long notify_jiffies; /**< Time of last notification. */
+
+    unsigned int diag_request; /**< The working counter dropped, a
+                                 diagnosis is requested. */
+    ec_wc_diag_state_t diag_state; /**< Working counter diagnosis state. */
+    uint16_t diag_working_counter; /**< Working counter, that triggered the
+                                     last diagnosis. */
+    unsigned int diag_count; /**< Number of diagnoses done. */
+
+    ec_recorder_t recorder; /**< Process data flight recorder. */
 };
 
 /****************************************************************************/
@@ -31,6 +31,7 @@
 #include <linux/etherdevice.h>
 #include <linux/lockdep.h>
 #include <linux/skbuff.h>
+#include <linux/if_vlan.h>
 
 #include "globals.h"
 #include "master.h"
@@ -68,11 +69,24 @@
  */
 #define EC_EOE_TRIES 100
 
+/** Number of preallocated socket buffers for receiving.
+ */
+#define EC_EOE_RX_POOL_SIZE 16
+
+/** Number of completed frames, after which the network stack is notified
+ * even if the slave has more frames pending.
+ */
+#define EC_EOE_RX_BATCH 16
+
 /****************************************************************************/
 
 // prototypes for private methods
 void ec_eoe_flush(ec_eoe_t *);
 int ec_eoe_send(ec_eoe_t *);
+void ec_eoe_drop_tx_frame(ec_eoe_t *);
+void ec_eoe_fill_rx_pool(ec_eoe_t *);
+struct sk_buff *ec_eoe_rx_skb(ec_eoe_t *, size_t);
+void ec_eoe_clear_rx_frames(ec_eoe_t *);
 
 /****************************************************************************/
 
@@ -87,6 +101,7 @@ void ec_eoe_state_tx_sent(ec_eoe_t *);
 int ec_eoedev_open(struct net_device *);
 int ec_eoedev_stop(struct net_device *);
 int ec_eoedev_tx(struct sk_buff *, struct net_device *);
+int ec_eoedev_poll(struct napi_struct *, int);
 struct net_device_stats *ec_eoedev_stats(struct net_device *);
 
 /****************************************************************************/
@@ -120,12 +135,16 @@ int ec_eoe_init(
 
     eoe->slave = slave;
 
-    ec_datagram_init(&eoe->datagram);
-    eoe->queue_datagram = 0;
-    eoe->state = ec_eoe_state_rx_start;
+    ec_datagram_init(&eoe->rx_datagram);
+    eoe->rx_queue_datagram = 0;
+    eoe->rx_state = ec_eoe_state_rx_start;
+    ec_datagram_init(&eoe->tx_datagram);
+    eoe->tx_queue_datagram = 0;
+    eoe->tx_state = ec_eoe_state_tx_start;
     eoe->opened = 0;
-    eoe->rx_skb = NULL;
-    eoe->rx_expected_fragment = 0;
+    memset(eoe->rx_frames, 0, sizeof(eoe->rx_frames));
+    skb_queue_head_init(&eoe->rx_pool);
+    skb_queue_head_init(&eoe->rx_done);
     INIT_LIST_HEAD(&eoe->tx_queue);
     eoe->tx_frame = NULL;
     eoe->tx_queue_active = 0;
@@ -153,7 +172,8 @@ int ec_eoe_init(
                 "eoe%us%u", slave->master->index, slave->ring_position);
     }
 
-    snprintf(eoe->datagram.name, EC_DATAGRAM_NAME_SIZE, name);
+    snprintf(eoe->rx_datagram.name, EC_DATAGRAM_NAME_SIZE, name);
+    snprintf(eoe->tx_datagram.name, EC_DATAGRAM_NAME_SIZE, name);
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 17, 0)
     eoe->dev = alloc_netdev(sizeof(ec_eoe_t *), name, NET_NAME_UNKNOWN,
@@ -170,6 +190,11 @@ int ec_eoe_init(
 
     // initialize net_device
     eoe->dev->netdev_ops = &ec_eoedev_ops;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 1, 0)
+    netif_napi_add(eoe->dev, &eoe->napi, ec_eoedev_poll);
+#else
+    netif_napi_add(eoe->dev, &eoe->napi, ec_eoedev_poll, NAPI_POLL_WEIGHT);
+#endif
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 15, 0) || (SUSE_VERSION == 15 && SUSE_PATCHLEVEL >= 5)
     eth_hw_addr_set(eoe->dev, mac_addr);
@@ -232,12 +257,14 @@ void ec_eoe_clear(ec_eoe_t *eoe /**< EoE handler */)
         kfree(eoe->tx_frame);
     }
 
-    if (eoe->rx_skb)
-        dev_kfree_skb(eoe->rx_skb);
+    ec_eoe_clear_rx_frames(eoe);
+    skb_queue_purge(&eoe->rx_done);
+    skb_queue_purge(&eoe->rx_pool);
 
-    free_netdev(eoe->dev);
+    free_netdev(eoe->dev); // also removes the NAPI context
 
-    ec_datagram_clear(&eoe->datagram);
+    ec_datagram_clear(&eoe->rx_datagram);
+    ec_datagram_clear(&eoe->tx_datagram);
 }
 
 /****************************************************************************/
@@ -317,7 +344,7 @@ int ec_eoe_send(ec_eoe_t *eoe /**< EoE handler */)
     printk(KERN_CONT "\n");
 #endif
 
-    data = ec_slave_mbox_prepare_send(eoe->slave, &eoe->datagram,
+    data = ec_slave_mbox_prepare_send(eoe->slave, &eoe->tx_datagram,
             EC_MBOX_TYPE_EOE, current_size + 4);
     if (IS_ERR(data))
         return PTR_ERR(data);
@@ -329,7 +356,7 @@ int ec_eoe_send(ec_eoe_t *eoe /**< EoE handler */)
                             (eoe->tx_frame_number & 0x0F) << 12));
 
     memcpy(data + 4, eoe->tx_frame->skb->data + eoe->tx_offset, current_size);
-    eoe->queue_datagram = 1;
+    eoe->tx_queue_datagram = 1;
 
     eoe->tx_offset += current_size;
     eoe->tx_fragment_number++;
@@ -338,19 +365,112 @@ int ec_eoe_send(ec_eoe_t *eoe /**< EoE handler */)
 
 /****************************************************************************/
 
-/** Runs the EoE state machine.
+/** Drops the current frame after a transmit error.
+ */
+void ec_eoe_drop_tx_frame(ec_eoe_t *eoe /**< EoE handler */)
+{
+    dev_kfree_skb(eoe->tx_frame->skb);
+    kfree(eoe->tx_frame);
+    eoe->tx_frame = NULL;
+    eoe->tx_state = ec_eoe_state_tx_start;
+}
+
+/****************************************************************************/
+
+/** Refills the pool of receive socket buffers.
+ *
+ * The buffers are allocated outside of the receive path, so that a frame
+ * can be reassembled without an allocation in most cases.
+ */
+void ec_eoe_fill_rx_pool(ec_eoe_t *eoe /**< EoE handler */)
+{
+    struct sk_buff *skb;
+    size_t size = ((eoe->dev->mtu + VLAN_ETH_HLEN) / 32 + 1) * 32;
+
+    while (skb_queue_len(&eoe->rx_pool) < EC_EOE_RX_POOL_SIZE) {
+        if (!(skb = __netdev_alloc_skb(eoe->dev, size, GFP_KERNEL))) {
+            break;
+        }
+        skb_queue_tail(&eoe->rx_pool, skb);
+    }
+}
+
+/****************************************************************************/
+
+/** Gets a socket buffer for receiving a frame.
+ *
+ * Takes a buffer from the pool, if it is large enough. Otherwise a new
+ * buffer is allocated.
+ *
+ * \return Socket buffer, or NULL if out of memory.
+ */
+struct sk_buff *ec_eoe_rx_skb(
+        ec_eoe_t *eoe, /**< EoE handler */
+        size_t size /**< size of the frame */
+        )
+{
+    struct sk_buff *skb = skb_dequeue(&eoe->rx_pool);
+
+    if (skb) {
+        if (skb_tailroom(skb) >= size) {
+            return skb;
+        }
+        skb_queue_head(&eoe->rx_pool, skb);
+    }
+
+    return dev_alloc_skb(size);
+}
+
+/****************************************************************************/
+
+/** Frees all frames in reassembly.
+ */
+void ec_eoe_clear_rx_frames(ec_eoe_t *eoe /**< EoE handler */)
+{
+    unsigned int i;
+
+    for (i = 0; i < EC_EOE_RX_FRAMES; i++) {
+        if (eoe->rx_frames[i].skb) {
+            dev_kfree_skb(eoe->rx_frames[i].skb);
+            eoe->rx_frames[i].skb = NULL;
+        }
+    }
+}
+
+/****************************************************************************/
+
+/** Runs the EoE state machines.
+ *
+ * The receive and the transmit state machine are executed independently,
+ * each one as soon as its last datagram was received.
  */
 void ec_eoe_run(ec_eoe_t *eoe /**< EoE handler */)
 {
     if (!eoe->opened)
         return;
 
-    // if the datagram was not sent, or is not yet received, skip this cycle
-    if (eoe->queue_datagram || eoe->datagram.state == EC_DATAGRAM_SENT)
-        return;
+    // if a datagram was not sent, or is not yet received, skip its state
+    // machine in this cycle
+    if (!eoe->rx_queue_datagram
+            && eoe->rx_datagram.state != EC_DATAGRAM_SENT) {
+        eoe->rx_state(eoe);
+    }
+
+    if (!eoe->tx_queue_datagram
+            && eoe->tx_datagram.state != EC_DATAGRAM_SENT) {
+        eoe->tx_state(eoe);
+    }
+
+    // hand over the completed frames to the network stack in batches, as
+    // long as the slave has more frames pending
+    if (!skb_queue_empty(&eoe->rx_done) && (eoe->rx_idle
+                || skb_queue_len(&eoe->rx_done) >= EC_EOE_RX_BATCH)) {
+        local_bh_disable();
+        napi_schedule(&eoe->napi);
+        local_bh_enable();
+    }
 
-    // call state function
-    eoe->state(eoe);
+    ec_eoe_fill_rx_pool(eoe);
 
     // update statistics
     if (jiffies - eoe->rate_jiffies > HZ) {
@@ -361,42 +481,47 @@ void ec_eoe_run(ec_eoe_t *eoe /**< EoE handler */)
         eoe->rate_jiffies = jiffies;
     }
 
-    ec_datagram_output_stats(&eoe->datagram);
+    ec_datagram_output_stats(&eoe->rx_datagram);
+    ec_datagram_output_stats(&eoe->tx_datagram);
 }
 
 /****************************************************************************/
 
-/** Queues the datagram, if necessary.
+/** Queues the datagrams, if necessary.
  */
 void ec_eoe_queue(ec_eoe_t *eoe /**< EoE handler */)
 {
-    if (eoe->queue_datagram) {
-        ec_master_queue_datagram_ext(eoe->slave->master, &eoe->datagram);
-        eoe->queue_datagram = 0;
+    if (eoe->rx_queue_datagram) {
+        ec_master_queue_datagram_ext(eoe->slave->master, &eoe->rx_datagram);
+        eoe->rx_queue_datagram = 0;
+    }
+
+    if (eoe->tx_queue_datagram) {
+        ec_master_queue_datagram_ext(eoe->slave->master, &eoe->tx_datagram);
+        eoe->tx_queue_datagram = 0;
     }
 }
 
 /****************************************************************************/
 
-/** Returns the state of the device.
+/** Returns, if a datagram is ready for queuing.
  *
- * \return 1 if the device is "up", 0 if it is "down"
+ * \return Non-zero, if ec_eoe_queue() has something to queue.
  */
-int ec_eoe_is_open(const ec_eoe_t *eoe /**< EoE handler */)
+int ec_eoe_has_datagram(const ec_eoe_t *eoe /**< EoE handler */)
 {
-    return eoe->opened;
+    return eoe->rx_queue_datagram || eoe->tx_queue_datagram;
 }
 
 /****************************************************************************/
 
-/** Returns the idle state.
+/** Returns the state of the device.
  *
- * \retval 1 The device is idle.
- * \retval 0 The device is busy.
+ * \return 1 if the device is "up", 0 if it is "down"
  */
-int ec_eoe_is_idle(const ec_eoe_t *eoe /**< EoE handler */)
+int ec_eoe_is_open(const ec_eoe_t *eoe /**< EoE handler */)
 {
-    return eoe->rx_idle && eoe->tx_idle;
+    return eoe->opened;
 }
 
 /*****************************************************************************
@@ -415,13 +540,13 @@ void ec_eoe_state_rx_start(ec_eoe_t *eoe /**< EoE handler */)
     if (eoe->slave->error_flag ||
             !eoe->slave->master->devices[EC_DEVICE_MAIN].link_state) {
         eoe->rx_idle = 1;
-        eoe->tx_idle = 1;
+        eoe->rx_state = ec_eoe_state_rx_start;
         return;
     }
 
-    ec_slave_mbox_prepare_check(eoe->slave, &eoe->datagram);
-    eoe->queue_datagram = 1;
-    eoe->state = ec_eoe_state_rx_check;
+    ec_slave_mbox_prepare_check(eoe->slave, &eoe->rx_datagram);
+    eoe->rx_queue_datagram = 1;
+    eoe->rx_state = ec_eoe_state_rx_check;
 }
 
 /****************************************************************************/
@@ -433,26 +558,27 @@ void ec_eoe_state_rx_start(ec_eoe_t *eoe /**< EoE handler */)
  */
 void ec_eoe_state_rx_check(ec_eoe_t *eoe /**< EoE handler */)
 {
-    if (eoe->datagram.state != EC_DATAGRAM_RECEIVED) {
+    if (eoe->rx_datagram.state != EC_DATAGRAM_RECEIVED) {
         eoe->stats.rx_errors++;
 #if EOE_DEBUG_LEVEL >= 1
         EC_SLAVE_WARN(eoe->slave, "Failed to receive mbox"
                 " check datagram for %s.\n", eoe->dev->name);
 #endif
-        eoe->state = ec_eoe_state_tx_start;
+        eoe->rx_state = ec_eoe_state_rx_start;
         return;
     }
 
-    if (!ec_slave_mbox_check(&eoe->datagram)) {
+    if (!ec_slave_mbox_check(&eoe->rx_datagram)) {
         eoe->rx_idle = 1;
-        eoe->state = ec_eoe_state_tx_start;
+        // check again with the next cycle
+        ec_eoe_state_rx_start(eoe);
         return;
     }
 
     eoe->rx_idle = 0;
-    ec_slave_mbox_prepare_fetch(eoe->slave, &eoe->datagram);
-    eoe->queue_datagram = 1;
-    eoe->state = ec_eoe_state_rx_fetch;
+    ec_slave_mbox_prepare_fetch(eoe->slave, &eoe->rx_datagram);
+    eoe->rx_queue_datagram = 1;
+    eoe->rx_state = ec_eoe_state_rx_fetch;
 }
 
 /****************************************************************************/
@@ -466,26 +592,24 @@ void ec_eoe_state_rx_fetch(ec_eoe_t *eoe /**< EoE handler */)
 {
     size_t rec_size, data_size;
     uint8_t *data, frame_type, last_fragment, time_appended, mbox_prot;
-    uint8_t fragment_offset, fragment_number;
-#if EOE_DEBUG_LEVEL >= 2
-    uint8_t frame_number;
-#endif
+    uint8_t fragment_offset, fragment_number, frame_number;
+    ec_eoe_rx_frame_t *frame;
     off_t offset;
 #if EOE_DEBUG_LEVEL >= 3
     unsigned int i;
 #endif
 
-    if (eoe->datagram.state != EC_DATAGRAM_RECEIVED) {
+    if (eoe->rx_datagram.state != EC_DATAGRAM_RECEIVED) {
         eoe->stats.rx_errors++;
 #if EOE_DEBUG_LEVEL >= 1
         EC_SLAVE_WARN(eoe->slave, "Failed to receive mbox"
                 " fetch datagram for %s.\n", eoe->dev->name);
 #endif
-        eoe->state = ec_eoe_state_tx_start;
+        eoe->rx_state = ec_eoe_state_rx_start;
         return;
     }
 
-    data = ec_slave_mbox_fetch(eoe->slave, &eoe->datagram,
+    data = ec_slave_mbox_fetch(eoe->slave, &eoe->rx_datagram,
             &mbox_prot, &rec_size);
     if (IS_ERR(data)) {
         eoe->stats.rx_errors++;
@@ -493,7 +617,7 @@ void ec_eoe_state_rx_fetch(ec_eoe_t *eoe /**< EoE handler */)
         EC_SLAVE_WARN(eoe->slave, "Invalid mailbox response for %s.\n",
                 eoe->dev->name);
 #endif
-        eoe->state = ec_eoe_state_tx_start;
+        eoe->rx_state = ec_eoe_state_rx_start;
         return;
     }
 
@@ -503,7 +627,7 @@ void ec_eoe_state_rx_fetch(ec_eoe_t *eoe /**< EoE handler */)
         EC_SLAVE_WARN(eoe->slave, "Other mailbox protocol response for %s.\n",
                 eoe->dev->name);
 #endif
-        eoe->state = ec_eoe_state_tx_start;
+        eoe->rx_state = ec_eoe_state_rx_start;
         return;
     }
 
@@ -515,7 +639,7 @@ void ec_eoe_state_rx_fetch(ec_eoe_t *eoe /**< EoE handler */)
                 " Dropping.\n", eoe->dev->name);
 #endif
         eoe->stats.rx_dropped++;
-        eoe->state = ec_eoe_state_tx_start;
+        eoe->rx_state = ec_eoe_state_rx_start;
         return;
     }
 
@@ -525,9 +649,7 @@ void ec_eoe_state_rx_fetch(ec_eoe_t *eoe /**< EoE handler */)
     time_appended = (EC_READ_U16(data) >> 9) & 0x0001;
     fragment_number = EC_READ_U16(data + 2) & 0x003F;
     fragment_offset = (EC_READ_U16(data + 2) >> 6) & 0x003F;
-#if EOE_DEBUG_LEVEL >= 2
     frame_number = (EC_READ_U16(data + 2) >> 12) & 0x000F;
-#endif
 
 #if EOE_DEBUG_LEVEL >= 2
     EC_SLAVE_DBG(eoe->slave, 0, "EoE %s RX fragment %u%s, offset %u,"
@@ -550,92 +672,91 @@ void ec_eoe_state_rx_fetch(ec_eoe_t *eoe /**< EoE handler */)
 #endif
 
     data_size = time_appended ? rec_size - 8 : rec_size - 4;
+    frame = &eoe->rx_frames[frame_number % EC_EOE_RX_FRAMES];
 
     if (!fragment_number) {
-        if (eoe->rx_skb) {
+        if (frame->skb) {
             EC_SLAVE_WARN(eoe->slave, "EoE RX freeing old socket buffer.\n");
-            dev_kfree_skb(eoe->rx_skb);
+            dev_kfree_skb(frame->skb);
         }
 
         // new socket buffer
-        if (!(eoe->rx_skb = dev_alloc_skb(fragment_offset * 32))) {
+        if (!(frame->skb = ec_eoe_rx_skb(eoe, fragment_offset * 32))) {
             if (printk_ratelimit())
                 EC_SLAVE_WARN(eoe->slave, "EoE RX low on mem,"
                         " frame dropped.\n");
             eoe->stats.rx_dropped++;
-            eoe->state = ec_eoe_state_tx_start;
+            eoe->rx_state = ec_eoe_state_rx_start;
             return;
         }
 
-        eoe->rx_skb_offset = 0;
-        eoe->rx_skb_size = fragment_offset * 32;
-        eoe->rx_expected_fragment = 0;
+        frame->offset = 0;
+        frame->size = fragment_offset * 32;
+        frame->frame_number = frame_number;
+        frame->expected_fragment = 0;
     }
     else {
-        if (!eoe->rx_skb) {
+        if (!frame->skb || frame->frame_number != frame_number) {
             eoe->stats.rx_dropped++;
-            eoe->state = ec_eoe_state_tx_start;
+            eoe->rx_state = ec_eoe_state_rx_start;
             return;
         }
 
         offset = fragment_offset * 32;
-        if (offset != eoe->rx_skb_offset ||
-            offset + data_size > eoe->rx_skb_size ||
-            fragment_number != eoe->rx_expected_fragment) {
-            dev_kfree_skb(eoe->rx_skb);
-            eoe->rx_skb = NULL;
+        if (offset != frame->offset ||
+            offset + data_size > frame->size ||
+            fragment_number != frame->expected_fragment) {
+            dev_kfree_skb(frame->skb);
+            frame->skb = NULL;
             eoe->stats.rx_errors++;
 #if EOE_DEBUG_LEVEL >= 1
             EC_SLAVE_WARN(eoe->slave, "Fragmenting error at %s.\n",
                     eoe->dev->name);
 #endif
-            eoe->state = ec_eoe_state_tx_start;
+            eoe->rx_state = ec_eoe_state_rx_start;
             return;
         }
     }
 
     // copy fragment into socket buffer
-    memcpy(skb_put(eoe->rx_skb, data_size), data + 4, data_size);
-    eoe->rx_skb_offset += data_size;
+    memcpy(skb_put(frame->skb, data_size), data + 4, data_size);
+    frame->offset += data_size;
 
     if (last_fragment) {
         // update statistics
         eoe->stats.rx_packets++;
-        eoe->stats.rx_bytes += eoe->rx_skb->len;
-        eoe->rx_counter += eoe->rx_skb->len;
+        eoe->stats.rx_bytes += frame->skb->len;
+        eoe->rx_counter += frame->skb->len;
 
 #if EOE_DEBUG_LEVEL >= 2
         EC_SLAVE_DBG(eoe->slave, 0, "EoE %s RX frame completed"
-                " with %u octets.\n", eoe->dev->name, eoe->rx_skb->len);
+                " with %u octets.\n", eoe->dev->name, frame->skb->len);
 #endif
 
-        // pass socket buffer to network stack
-        eoe->rx_skb->dev = eoe->dev;
-        eoe->rx_skb->protocol = eth_type_trans(eoe->rx_skb, eoe->dev);
-        eoe->rx_skb->ip_summed = CHECKSUM_UNNECESSARY;
-        if (netif_rx(eoe->rx_skb)) {
-            EC_SLAVE_WARN(eoe->slave, "EoE RX netif_rx failed.\n");
-        }
-        eoe->rx_skb = NULL;
-
-        eoe->state = ec_eoe_state_tx_start;
+        // queue socket buffer for the network stack
+        frame->skb->dev = eoe->dev;
+        frame->skb->protocol = eth_type_trans(frame->skb, eoe->dev);
+        frame->skb->ip_summed = CHECKSUM_UNNECESSARY;
+        skb_queue_tail(&eoe->rx_done, frame->skb);
+        frame->skb = NULL;
     }
     else {
-        eoe->rx_expected_fragment++;
+        frame->expected_fragment++;
 #if EOE_DEBUG_LEVEL >= 2
         EC_SLAVE_DBG(eoe->slave, 0, "EoE %s RX expecting fragment %u\n",
-               eoe->dev->name, eoe->rx_expected_fragment);
+               eoe->dev->name, frame->expected_fragment);
 #endif
-        eoe->state = ec_eoe_state_rx_start;
     }
+
+    // check for the next fragment or frame with the next cycle
+    ec_eoe_state_rx_start(eoe);
 }
 
 /****************************************************************************/
 
 /** State: TX START.
  *
- * Starts a new transmit sequence. If no data is available, a new receive
- * sequence is started instead.
+ * Starts a new transmit sequence, if a frame is queued.
  *
  * \todo Use both devices.
  */
@@ -647,7 +768,6 @@ void ec_eoe_state_tx_start(ec_eoe_t *eoe /**< EoE handler */)
 
     if (eoe->slave->error_flag ||
             !eoe->slave->master->devices[EC_DEVICE_MAIN].link_state) {
-        eoe->rx_idle = 1;
         eoe->tx_idle = 1;
         return;
     }
@@ -658,8 +778,6 @@ void ec_eoe_state_tx_start(ec_eoe_t *eoe /**< EoE handler */)
         netif_tx_unlock_bh(eoe->dev);
         eoe->tx_idle = 1;
         // no data available.
-        // start a new receive immediately.
-        ec_eoe_state_rx_start(eoe);
         return;
     }
 
@@ -686,11 +804,8 @@ void ec_eoe_state_tx_start(ec_eoe_t *eoe /**< EoE handler */)
     eoe->tx_offset = 0;
 
     if (ec_eoe_send(eoe)) {
-        dev_kfree_skb(eoe->tx_frame->skb);
-        kfree(eoe->tx_frame);
-        eoe->tx_frame = NULL;
+        ec_eoe_drop_tx_frame(eoe);
         eoe->stats.tx_errors++;
-        eoe->state = ec_eoe_state_rx_start;
 #if EOE_DEBUG_LEVEL >= 1
         EC_SLAVE_WARN(eoe->slave, "Send error at %s.\n", eoe->dev->name);
 #endif
@@ -704,7 +819,7 @@ void ec_eoe_state_tx_start(ec_eoe_t *eoe /**< EoE handler */)
 #endif
 
     eoe->tries = EC_EOE_TRIES;
-    eoe->state = ec_eoe_state_tx_sent;
+    eoe->tx_state = ec_eoe_state_tx_sent;
 }
 
 /****************************************************************************/
@@ -716,10 +831,10 @@ void ec_eoe_state_tx_start(ec_eoe_t *eoe /**< EoE handler */)
  */
 void ec_eoe_state_tx_sent(ec_eoe_t *eoe /**< EoE handler */)
 {
-    if (eoe->datagram.state != EC_DATAGRAM_RECEIVED) {
+    if (eoe->tx_datagram.state != EC_DATAGRAM_RECEIVED) {
         if (eoe->tries) {
             eoe->tries--; // try again
-            eoe->queue_datagram = 1;
+            eoe->tx_queue_datagram = 1;
         } else {
             eoe->stats.tx_errors++;
 #if EOE_DEBUG_LEVEL >= 1
@@ -727,15 +842,15 @@ void ec_eoe_state_tx_sent(ec_eoe_t *eoe /**< EoE handler */)
                     " datagram for %s after %u tries.\n",
                     eoe->dev->name, EC_EOE_TRIES);
 #endif
-            eoe->state = ec_eoe_state_rx_start;
+            ec_eoe_drop_tx_frame(eoe);
         }
         return;
     }
 
-    if (eoe->datagram.working_counter != 1) {
+    if (eoe->tx_datagram.working_counter != 1) {
         if (eoe->tries) {
             eoe->tries--; // try again
-            eoe->queue_datagram = 1;
+            eoe->tx_queue_datagram = 1;
         } else {
             eoe->stats.tx_errors++;
 #if EOE_DEBUG_LEVEL >= 1
@@ -743,7 +858,7 @@ void ec_eoe_state_tx_sent(ec_eoe_t *eoe /**< EoE handler */)
                     " for %s after %u tries.\n",
                     eoe->dev->name, EC_EOE_TRIES);
 #endif
-            eoe->state = ec_eoe_state_rx_start;
+            ec_eoe_drop_tx_frame(eoe);
         }
         return;
     }
@@ -756,18 +871,17 @@ void ec_eoe_state_tx_sent(ec_eoe_t *eoe /**< EoE handler */)
         dev_kfree_skb(eoe->tx_frame->skb);
         kfree(eoe->tx_frame);
         eoe->tx_frame = NULL;
-        eoe->state = ec_eoe_state_rx_start;
+        // continue with the next queued frame in the same cycle
+        eoe->tx_state = ec_eoe_state_tx_start;
+        ec_eoe_state_tx_start(eoe);
     }
     else { // send next fragment
         if (ec_eoe_send(eoe)) {
-            dev_kfree_skb(eoe->tx_frame->skb);
-            kfree(eoe->tx_frame);
-            eoe->tx_frame = NULL;
             eoe->stats.tx_errors++;
 #if EOE_DEBUG_LEVEL >= 1
             EC_SLAVE_WARN(eoe->slave, "Send error at %s.\n", eoe->dev->name);
 #endif
-            eoe->state = ec_eoe_state_rx_start;
+            ec_eoe_drop_tx_frame(eoe);
         }
     }
 }
@@ -784,6 +898,8 @@ int ec_eoedev_open(struct net_device *dev /**< EoE net_device */)
 {
     ec_eoe_t *eoe = *((ec_eoe_t **) netdev_priv(dev));
     ec_eoe_flush(eoe);
+    skb_queue_purge(&eoe->rx_done);
+    napi_enable(&eoe->napi);
     eoe->opened = 1;
     eoe->rx_idle = 0;
     eoe->tx_idle = 0;
@@ -811,6 +927,8 @@ int ec_eoedev_stop(struct net_device *dev /**< EoE net_device */)
     eoe->tx_queue_active = 0;
     eoe->opened = 0;
     ec_eoe_flush(eoe);
+    napi_disable(&eoe->napi);
+    skb_queue_purge(&eoe->rx_done);
 #if EOE_DEBUG_LEVEL >= 2
     EC_SLAVE_DBG(eoe->slave, 0, "%s stopped.\n", dev->name);
 #endif
@@ -860,6 +978,9 @@ int ec_eoedev_tx(struct sk_buff *skb, /**< transmit socket buffer */
         eoe->tx_queue_active = 0;
     }
 
+    // do not wait for the next cycle to start sending
+    ec_master_eoe_wakeup(eoe->slave->master);
+
 #if EOE_DEBUG_LEVEL >= 2
     EC_SLAVE_DBG(eoe->slave, 0, "EoE %s TX queued frame"
             " with %u octets (%u frames queued).\n",
@@ -886,3 +1007,37 @@ struct net_device_stats *ec_eoedev_stats(
 }
 
 /****************************************************************************/
+
+/** Passes received frames to the network stack.
+ *
+ * NAPI poll function. The frames are reassembled by the EoE state machine
+ * and handed over via GRO, so that the stack can coalesce them.
+ *
+ * \return Number of frames processed.
+ */
+int ec_eoedev_poll(
+        struct napi_struct *napi, /**< NAPI context */
+        int budget /**< maximum number of frames to process */
+        )
+{
+    ec_eoe_t *eoe = container_of(napi, ec_eoe_t, napi);
+    struct sk_buff *skb;
+    int done = 0;
+
+    while (done < budget && (skb = skb_dequeue(&eoe->rx_done))) {
+        napi_gro_receive(napi, skb);
+        done++;
+    }
+
+    if (done < budget) {
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 19, 0)
+        napi_complete_done(napi, done);
+#else
+        napi_complete(napi);
+#endif
+    }
+
+    return done;
+}
+
+/****************************************************************************/
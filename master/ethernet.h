@@ -63,34 +63,62 @@ ec_eoe_frame_t;
 
 /****************************************************************************/
 
+/** Number of frames, that can be reassembled concurrently.
+ *
+ * The frames are assigned by their frame number.
+ */
+#define EC_EOE_RX_FRAMES 4
+
+/** Frame in reassembly.
+ */
+typedef struct {
+    struct sk_buff *skb; /**< socket buffer, NULL if unused */
+    off_t offset; /**< current write pointer in the socket buffer */
+    size_t size; /**< announced size of the frame */
+    uint8_t frame_number; /**< EoE frame number */
+    uint8_t expected_fragment; /**< next expected fragment number */
+} ec_eoe_rx_frame_t;
+
+/****************************************************************************/
+
 typedef struct ec_eoe ec_eoe_t; /**< \see ec_eoe */
 
 /**
    Ethernet over EtherCAT (EoE) handler.
    The master creates one of these objects for each slave that supports the
-   EoE protocol.
+   EoE protocol. Receiving and transmitting are independent state machines
+   with a datagram each, so that a fragment can be sent while the mailbox
+   is checked for received data.
 */
 
 struct ec_eoe
 {
     struct list_head list; /**< list item */
     ec_slave_t *slave; /**< pointer to the corresponding slave */
-    ec_datagram_t datagram; /**< datagram */
-    unsigned int queue_datagram; /**< the datagram is ready for queuing */
-    void (*state)(ec_eoe_t *); /**< state function for the state machine */
     struct net_device *dev; /**< net_device for virtual ethernet device */
     struct net_device_stats stats; /**< device statistics */
     unsigned int opened; /**< net_device is opened */
     unsigned long rate_jiffies; /**< time of last rate output */
 
-    struct sk_buff *rx_skb; /**< current rx socket buffer */
-    off_t rx_skb_offset; /**< current write pointer in the socket buffer */
-    size_t rx_skb_size; /**< size of the allocated socket buffer memory */
-    uint8_t rx_expected_fragment; /**< next expected fragment number */
+    ec_datagram_t rx_datagram; /**< datagram for receiving */
+    unsigned int rx_queue_datagram; /**< the rx datagram is ready for
+                                      queuing */
+    void (*rx_state)(ec_eoe_t *); /**< state function for receiving */
+    ec_eoe_rx_frame_t rx_frames[EC_EOE_RX_FRAMES]; /**< frames in
+                                                     reassembly */
+    struct sk_buff_head rx_pool; /**< preallocated socket buffers */
+    struct sk_buff_head rx_done; /**< received frames for the network
+                                   stack */
+    struct napi_struct napi; /**< NAPI context for passing received frames
+                               to the network stack */
     uint32_t rx_counter; /**< octets received during last second */
     uint32_t rx_rate; /**< receive rate (bps) */
     unsigned int rx_idle; /**< Idle flag. */
 
+    ec_datagram_t tx_datagram; /**< datagram for transmitting */
+    unsigned int tx_queue_datagram; /**< the tx datagram is ready for
+                                      queuing */
+    void (*tx_state)(ec_eoe_t *); /**< state function for transmitting */
     struct list_head tx_queue; /**< queue for frames to send */
     unsigned int tx_queue_size; /**< Transmit queue size. */
     unsigned int tx_queue_active; /**< kernel netif queue started */
@@ -112,8 +140,8 @@ int ec_eoe_init(ec_eoe_t *, ec_slave_t *);
 void ec_eoe_clear(ec_eoe_t *);
 void ec_eoe_run(ec_eoe_t *);
 void ec_eoe_queue(ec_eoe_t *);
+int ec_eoe_has_datagram(const ec_eoe_t *);
 int ec_eoe_is_open(const ec_eoe_t *);
-int ec_eoe_is_idle(const ec_eoe_t *);
 
 /****************************************************************************/
 
@@ -55,6 +55,9 @@ void ec_fmmu_config_init(
     fmmu->logical_start_address = domain->data_size;
     fmmu->data_size = ec_pdo_list_total_size(
             &sc->sync_configs[sync_index].pdos);
+    fmmu->diag_flags = 0;
+    fmmu->diag_al_state = 0;
+    fmmu->diag_al_status_code = 0;
 
     ec_domain_add_fmmu_config(domain, fmmu);
 }
@@ -43,6 +43,11 @@ typedef struct {
     ec_direction_t dir; /**< FMMU direction. */
     uint32_t logical_start_address; /**< Logical start address. */
     unsigned int data_size; /**< Covered PDO size. */
+    uint8_t diag_flags; /**< Working counter diagnosis findings
+                          (EC_WC_DIAG_*). */
+    uint8_t diag_al_state; /**< AL state read by the diagnosis. */
+    uint16_t diag_al_status_code; /**< AL status code read by the
+                                    diagnosis. */
 } ec_fmmu_config_t;
 
 /****************************************************************************/
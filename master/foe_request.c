@@ -64,6 +64,13 @@ void ec_foe_request_init(
     req->state = EC_INT_REQUEST_INIT;
     req->result = FOE_BUSY;
     req->error_code = 0x00000000;
+    req->progress = 0;
+    req->stream = 0;
+    req->stream_head = 0;
+    req->stream_tail = 0;
+    req->stream_eof = 0;
+    req->stream_abort = 0;
+    req->stream_orphaned = 0;
 }
 
 /****************************************************************************/
@@ -166,6 +173,100 @@ int ec_foe_request_timed_out(
 
 /****************************************************************************/
 
+/** Prepares a streamed transfer.
+ *
+ * The data memory is used as a ring buffer of \a size bytes (the window),
+ * through which the data are passed while the transfer is running.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_foe_request_stream(
+        ec_foe_request_t *req, /**< FoE request. */
+        size_t size /**< Window size. */
+        )
+{
+    int ret;
+
+    ret = ec_foe_request_alloc(req, size);
+    if (ret) {
+        return ret;
+    }
+
+    req->stream = 1;
+    req->stream_head = 0;
+    req->stream_tail = 0;
+    req->stream_eof = 0;
+    req->stream_abort = 0;
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Returns the number of bytes in the ring buffer.
+ *
+ * \return Number of bytes available.
+ */
+size_t ec_foe_request_stream_avail(
+        const ec_foe_request_t *req /**< FoE request. */
+        )
+{
+    return req->stream_head - req->stream_tail;
+}
+
+/****************************************************************************/
+
+/** Returns the free space in the ring buffer.
+ *
+ * \return Number of bytes, that can be put into the ring buffer.
+ */
+size_t ec_foe_request_stream_space(
+        const ec_foe_request_t *req /**< FoE request. */
+        )
+{
+    return req->buffer_size - (req->stream_head - req->stream_tail);
+}
+
+/****************************************************************************/
+
+/** Copies data out of the ring buffer without taking them.
+ */
+void ec_foe_request_stream_peek(
+        const ec_foe_request_t *req, /**< FoE request. */
+        uint8_t *target, /**< Target memory. */
+        size_t offset, /**< Stream offset of the data (between
+                         \a stream_tail and \a stream_head). */
+        size_t size /**< Number of bytes to copy. */
+        )
+{
+    size_t pos = offset % req->buffer_size;
+    size_t first = min(size, req->buffer_size - pos);
+
+    memcpy(target, req->buffer + pos, first);
+    memcpy(target + first, req->buffer, size - first);
+}
+
+/****************************************************************************/
+
+/** Puts data into the ring buffer.
+ *
+ * The caller has to make sure, that there is enough space.
+ */
+void ec_foe_request_stream_put(
+        ec_foe_request_t *req, /**< FoE request. */
+        const uint8_t *source, /**< Source data. */
+        size_t size /**< Number of bytes to put. */
+        )
+{
+    size_t pos = req->stream_head % req->buffer_size;
+    size_t first = min(size, req->buffer_size - pos);
+
+    memcpy(req->buffer + pos, source, first);
+    memcpy(req->buffer, source + first, size - first);
+    req->stream_head += size;
+}
+
+/****************************************************************************/
+
 /** Prepares a read request (slave to master).
  */
 void ec_foe_request_read(
@@ -175,6 +276,7 @@ void ec_foe_request_read(
     req->dir = EC_DIR_INPUT;
     req->state = EC_INT_REQUEST_QUEUED;
     req->result = FOE_BUSY;
+    req->progress = 0;
     req->jiffies_start = jiffies;
 }
 
@@ -189,6 +291,7 @@ void ec_foe_request_write(
     req->dir = EC_DIR_OUTPUT;
     req->state = EC_INT_REQUEST_QUEUED;
     req->result = FOE_BUSY;
+    req->progress = 0;
     req->jiffies_start = jiffies;
 }
 
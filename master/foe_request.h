@@ -59,6 +59,20 @@ typedef struct {
     uint8_t *file_name; /**< Pointer to the filename. */
     uint32_t result; /**< FoE request abort code. Zero on success. */
     uint32_t error_code; /**< Error code from an FoE Error Request. */
+    size_t progress; /**< Number of bytes acknowledged by the slave
+                       (writing) or received (reading). */
+
+    unsigned int stream; /**< The data are streamed through \a buffer,
+                           which is used as a ring buffer. */
+    size_t stream_head; /**< Number of bytes put into the ring buffer. */
+    size_t stream_tail; /**< Number of bytes taken from the ring buffer. */
+    unsigned int stream_eof; /**< No more data will be put into the ring
+                               buffer (writing only). */
+    unsigned int stream_abort; /**< Abort the transfer at the next packet
+                                 boundary. */
+    unsigned int stream_orphaned; /**< The owner of the request has gone.
+                                    The request was allocated with kmalloc()
+                                    and is freed by the slave FSM. */
 } ec_foe_request_t;
 
 /****************************************************************************/
@@ -70,6 +84,13 @@ int ec_foe_request_alloc(ec_foe_request_t *, size_t);
 int ec_foe_request_copy_data(ec_foe_request_t *, const uint8_t *, size_t);
 int ec_foe_request_timed_out(const ec_foe_request_t *);
 
+int ec_foe_request_stream(ec_foe_request_t *, size_t);
+size_t ec_foe_request_stream_avail(const ec_foe_request_t *);
+size_t ec_foe_request_stream_space(const ec_foe_request_t *);
+void ec_foe_request_stream_peek(const ec_foe_request_t *, uint8_t *,
+        size_t, size_t);
+void ec_foe_request_stream_put(ec_foe_request_t *, const uint8_t *, size_t);
+
 void ec_foe_request_write(ec_foe_request_t *);
 void ec_foe_request_read(ec_foe_request_t *);
 
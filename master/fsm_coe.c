@@ -217,6 +217,7 @@ void ec_fsm_coe_transfer(
     fsm->request = request;
 
     if (request->dir == EC_DIR_OUTPUT) {
+        ec_slave_sdo_download(slave, request->index);
         fsm->state = ec_fsm_coe_down_start;
     }
     else {
@@ -588,7 +589,7 @@ void ec_fsm_coe_dict_response(
         return;
     }
 
-    first_segment = list_empty(&slave->sdo_dictionary) ? true : false;
+    first_segment = list_empty(&slave->sdo_dict->sdos) ? true : false;
     index_list_offset = first_segment ? 8 : 6;
 
     if (rec_size < index_list_offset || rec_size % 2) {
@@ -613,8 +614,8 @@ void ec_fsm_coe_dict_response(
             return;
         }
 
-        ec_sdo_init(sdo, slave, sdo_index);
-        list_add_tail(&sdo->list, &slave->sdo_dictionary);
+        ec_sdo_init(sdo, sdo_index);
+        list_add_tail(&sdo->list, &slave->sdo_dict->sdos);
     }
 
     fragments_left = EC_READ_U16(data + 4);
@@ -632,14 +633,14 @@ void ec_fsm_coe_dict_response(
         return;
     }
 
-    if (list_empty(&slave->sdo_dictionary)) {
+    if (list_empty(&slave->sdo_dict->sdos)) {
         // no SDOs in dictionary. finished.
         fsm->state = ec_fsm_coe_end; // success
         return;
     }
 
     // fetch SDO descriptions
-    fsm->sdo = list_entry(slave->sdo_dictionary.next, ec_sdo_t, list);
+    fsm->sdo = list_entry(slave->sdo_dict->sdos.next, ec_sdo_t, list);
 
     fsm->retries = EC_FSM_RETRIES;
     if (ec_fsm_coe_dict_prepare_desc(fsm, datagram)) {
@@ -1174,7 +1175,7 @@ void ec_fsm_coe_dict_entry_response(
     }
 
     // another SDO description to fetch?
-    if (fsm->sdo->list.next != &slave->sdo_dictionary) {
+    if (fsm->sdo->list.next != &slave->sdo_dict->sdos) {
 
         fsm->sdo = list_entry(fsm->sdo->list.next, ec_sdo_t, list);
         fsm->retries = EC_FSM_RETRIES;
@@ -1861,9 +1862,11 @@ int ec_fsm_coe_prepare_up(
     }
 
     EC_WRITE_U16(data, 0x2 << 12); // SDO request
-    EC_WRITE_U8 (data + 2, 0x2 << 5); // initiate upload request
+    EC_WRITE_U8 (data + 2, 0x2 << 5 // initiate upload request
+            | ((request->complete_access ? 1 : 0) << 4));
     EC_WRITE_U16(data + 3, request->index);
-    EC_WRITE_U8 (data + 5, request->subindex);
+    EC_WRITE_U8 (data + 5,
+            request->complete_access ? 0x00 : request->subindex);
     memset(data + 6, 0x00, 4);
 
     if (master->debug_level) {
@@ -1889,8 +1892,16 @@ void ec_fsm_coe_up_start(
     ec_slave_t *slave = fsm->slave;
     ec_sdo_request_t *request = fsm->request;
 
-    EC_SLAVE_DBG(slave, 1, "Uploading SDO 0x%04X:%02X.\n",
-            request->index, request->subindex);
+    if (slave->master->debug_level) {
+        char subidxstr[10];
+        if (request->complete_access) {
+            subidxstr[0] = 0x00;
+        } else {
+            sprintf(subidxstr, ":%02X", request->subindex);
+        }
+        EC_SLAVE_DBG(slave, 1, "Uploading SDO 0x%04X%s.\n",
+                request->index, subidxstr);
+    }
 
     if (!(slave->sii.mailbox_protocols & EC_MBOX_COE)) {
         EC_SLAVE_ERR(slave, "Slave does not support CoE!\n");
@@ -2079,7 +2090,7 @@ void ec_fsm_coe_up_response(
     ec_slave_t *slave = fsm->slave;
     ec_master_t *master = slave->master;
     uint16_t rec_index;
-    uint8_t *data, mbox_prot, rec_subindex;
+    uint8_t *data, mbox_prot, rec_subindex, subindex;
     size_t rec_size, data_size;
     ec_sdo_request_t *request = fsm->request;
     unsigned int expedited, size_specified;
@@ -2144,10 +2155,19 @@ void ec_fsm_coe_up_response(
         return;
     }
 
+    // complete access always starts with subindex 0
+    subindex = request->complete_access ? 0x00 : request->subindex;
+
     if (EC_READ_U16(data) >> 12 == 0x2 && // SDO request
             EC_READ_U8(data + 2) >> 5 == 0x4) { // abort SDO transfer request
-        EC_SLAVE_ERR(slave, "SDO upload 0x%04X:%02X aborted.\n",
-               request->index, request->subindex);
+        char subidxstr[10];
+        if (request->complete_access) {
+            subidxstr[0] = 0x00;
+        } else {
+            sprintf(subidxstr, ":%02X", request->subindex);
+        }
+        EC_SLAVE_ERR(slave, "SDO upload 0x%04X%s aborted.\n",
+               request->index, subidxstr);
         if (rec_size >= 10) {
             request->abort_code = EC_READ_U32(data + 6);
             ec_canopen_abort_msg(slave, request->abort_code);
@@ -2163,7 +2183,7 @@ void ec_fsm_coe_up_response(
             EC_READ_U8(data + 2) >> 5 != 0x2) { // upload response
         EC_SLAVE_ERR(slave, "Received unknown response while"
                 " uploading SDO 0x%04X:%02X.\n",
-                request->index, request->subindex);
+                request->index, subindex);
         ec_print_data(data, rec_size);
         request->errno = EIO;
         fsm->state = ec_fsm_coe_error;
@@ -2173,10 +2193,10 @@ void ec_fsm_coe_up_response(
     rec_index = EC_READ_U16(data + 3);
     rec_subindex = EC_READ_U8(data + 5);
 
-    if (rec_index != request->index || rec_subindex != request->subindex) {
+    if (rec_index != request->index || rec_subindex != subindex) {
         EC_SLAVE_ERR(slave, "Received upload response for wrong SDO"
                 " (0x%04X:%02X, requested: 0x%04X:%02X).\n",
-                rec_index, rec_subindex, request->index, request->subindex);
+                rec_index, rec_subindex, request->index, subindex);
         ec_print_data(data, rec_size);
 
         // check for CoE response again
@@ -60,12 +60,20 @@ enum {
     EC_FOE_OPCODE_BUSY = 6  /**< Busy. */
 };
 
+/** FoE error code sent to the slave, if a streamed transfer is aborted
+ * ("not defined").
+ */
+#define EC_FOE_ERROR_ABORT 0x00008000
+
 /****************************************************************************/
 
 int ec_foe_prepare_data_send(ec_fsm_foe_t *, ec_datagram_t *);
 int ec_foe_prepare_wrq_send(ec_fsm_foe_t *, ec_datagram_t *);
 int ec_foe_prepare_rrq_send(ec_fsm_foe_t *, ec_datagram_t *);
 int ec_foe_prepare_send_ack(ec_fsm_foe_t *, ec_datagram_t *);
+int ec_foe_prepare_send_error(ec_fsm_foe_t *, ec_datagram_t *);
+int ec_fsm_foe_starved(const ec_fsm_foe_t *);
+void ec_fsm_foe_abort(ec_fsm_foe_t *, ec_datagram_t *);
 
 void ec_foe_set_tx_error(ec_fsm_foe_t *, uint32_t);
 void ec_foe_set_rx_error(ec_fsm_foe_t *, uint32_t);
@@ -80,10 +88,13 @@ void ec_fsm_foe_state_ack_check(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_ack_read(ec_fsm_foe_t *, ec_datagram_t *);
 
 void ec_fsm_foe_state_data_sent(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_data_paused(ec_fsm_foe_t *, ec_datagram_t *);
 
 void ec_fsm_foe_state_data_check(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_data_read(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_state_sent_ack(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_ack_paused(ec_fsm_foe_t *, ec_datagram_t *);
+void ec_fsm_foe_state_error_sent(ec_fsm_foe_t *, ec_datagram_t *);
 
 void ec_fsm_foe_write_start(ec_fsm_foe_t *, ec_datagram_t *);
 void ec_fsm_foe_read_start(ec_fsm_foe_t *, ec_datagram_t *);
@@ -98,6 +109,7 @@ void ec_fsm_foe_init(
 {
     fsm->state = NULL;
     fsm->datagram = NULL;
+    fsm->pause_request = 0;
 }
 
 /****************************************************************************/
@@ -131,8 +143,8 @@ int ec_fsm_foe_exec(
 
     fsm->state(fsm, datagram);
 
-    datagram_used =
-        fsm->state != ec_fsm_foe_end && fsm->state != ec_fsm_foe_error;
+    datagram_used = fsm->state != ec_fsm_foe_end
+        && fsm->state != ec_fsm_foe_error && !ec_fsm_foe_paused(fsm);
 
     if (datagram_used) {
         fsm->datagram = datagram;
@@ -155,6 +167,57 @@ int ec_fsm_foe_success(const ec_fsm_foe_t *fsm /**< Finite state machine */)
 
 /****************************************************************************/
 
+/** Returns, if the transfer is paused between two packets.
+ *
+ * A paused transfer continues with the next call of ec_fsm_foe_exec(). A
+ * streamed transfer stays paused, until the application has provided more
+ * data (writing) or made room in the window (reading).
+ *
+ * \return non-zero if paused.
+ */
+int ec_fsm_foe_paused(const ec_fsm_foe_t *fsm /**< Finite state machine */)
+{
+    return fsm->state == ec_fsm_foe_state_data_paused
+        || fsm->state == ec_fsm_foe_state_ack_paused;
+}
+
+/****************************************************************************/
+
+/** Returns, if a streamed transfer has to wait for the application.
+ *
+ * This is the case, if the window does not contain a full packet of data
+ * (writing), or has no space for a full packet (reading). An aborted stream
+ * is always starved.
+ *
+ * \return non-zero if starved.
+ */
+int ec_fsm_foe_starved(const ec_fsm_foe_t *fsm /**< Finite state machine */)
+{
+    const ec_foe_request_t *request = fsm->request;
+    const ec_slave_t *slave = fsm->slave;
+
+    if (!request->stream) {
+        return 0;
+    }
+
+    if (request->stream_abort) {
+        return 1;
+    }
+
+    if (request->dir == EC_DIR_OUTPUT) {
+        return !request->stream_eof
+            && request->stream_head - fsm->tx_buffer_offset
+            < slave->configured_tx_mailbox_size
+            - EC_MBOX_HEADER_SIZE - EC_FOE_HEADER_SIZE;
+    } else {
+        return ec_foe_request_stream_space(request)
+            < slave->configured_rx_mailbox_size
+            - EC_MBOX_HEADER_SIZE - EC_FOE_HEADER_SIZE;
+    }
+}
+
+/****************************************************************************/
+
 /** Prepares an FoE transfer.
  */
 void ec_fsm_foe_transfer(
@@ -165,6 +228,7 @@ void ec_fsm_foe_transfer(
 {
     fsm->slave = slave;
     fsm->request = request;
+    fsm->pause_request = 0;
 
     if (request->dir == EC_DIR_OUTPUT) {
         fsm->tx_buffer = fsm->request->buffer;
@@ -229,7 +293,11 @@ int ec_foe_prepare_data_send(
     size_t remaining_size, current_size;
     uint8_t *data;
 
-    remaining_size = fsm->tx_buffer_size - fsm->tx_buffer_offset;
+    if (fsm->request->stream) {
+        remaining_size = fsm->request->stream_head - fsm->tx_buffer_offset;
+    } else {
+        remaining_size = fsm->tx_buffer_size - fsm->tx_buffer_offset;
+    }
 
     if (remaining_size < fsm->slave->configured_tx_mailbox_size
             - EC_MBOX_HEADER_SIZE - EC_FOE_HEADER_SIZE) {
@@ -249,8 +317,13 @@ int ec_foe_prepare_data_send(
     EC_WRITE_U16(data, EC_FOE_OPCODE_DATA);    // OpCode = DataBlock req.
     EC_WRITE_U32(data + 2, fsm->tx_packet_no); // PacketNo, Password
 
-    memcpy(data + EC_FOE_HEADER_SIZE,
-            fsm->tx_buffer + fsm->tx_buffer_offset, current_size);
+    if (fsm->request->stream) {
+        ec_foe_request_stream_peek(fsm->request, data + EC_FOE_HEADER_SIZE,
+                fsm->tx_buffer_offset, current_size);
+    } else {
+        memcpy(data + EC_FOE_HEADER_SIZE,
+                fsm->tx_buffer + fsm->tx_buffer_offset, current_size);
+    }
     fsm->tx_current_size = current_size;
 
     return 0;
@@ -438,12 +511,27 @@ void ec_fsm_foe_state_ack_read(
     if (opCode == EC_FOE_OPCODE_ACK) {
         fsm->tx_packet_no++;
         fsm->tx_buffer_offset += fsm->tx_current_size;
+        fsm->request->progress = fsm->tx_buffer_offset;
+
+        if (fsm->request->stream) {
+            // release the acknowledged data
+            fsm->request->stream_tail = fsm->tx_buffer_offset;
+            wake_up_all(&slave->master->request_queue);
+        }
 
         if (fsm->tx_last_packet) {
+            if (fsm->request->stream) {
+                fsm->request->data_size = fsm->tx_buffer_offset;
+            }
             fsm->state = ec_fsm_foe_end;
             return;
         }
 
+        if (fsm->pause_request || ec_fsm_foe_starved(fsm)) {
+            fsm->state = ec_fsm_foe_state_data_paused;
+            return;
+        }
+
         if (ec_foe_prepare_data_send(fsm, datagram)) {
             ec_foe_set_tx_error(fsm, FOE_PROT_ERROR);
             return;
@@ -535,6 +623,35 @@ void ec_fsm_foe_state_data_sent(
 
 /****************************************************************************/
 
+/** State: DATA PAUSED.
+ *
+ * Sends the next data packet after a pause.
+ */
+void ec_fsm_foe_state_data_paused(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (ec_fsm_foe_starved(fsm)) {
+        if (fsm->request->stream_abort) {
+            ec_fsm_foe_abort(fsm, datagram);
+        }
+        return; // stay paused
+    }
+
+    if (ec_foe_prepare_data_send(fsm, datagram)) {
+        ec_foe_set_tx_error(fsm, FOE_PROT_ERROR);
+        return;
+    }
+    fsm->state = ec_fsm_foe_state_data_sent;
+}
+
+/****************************************************************************/
+
 /** Prepare a read request (RRQ) with filename
  *
  * \return Zero on success, otherwise a negative error code.
@@ -800,17 +917,29 @@ void ec_fsm_foe_state_data_read(
 
     rec_size -= EC_FOE_HEADER_SIZE;
 
-    if (fsm->rx_buffer_size >= fsm->rx_buffer_offset + rec_size) {
+    if (fsm->request->stream) {
+        if (rec_size > ec_foe_request_stream_space(fsm->request)) {
+            EC_SLAVE_ERR(slave, "FoE data do not fit into the window!\n");
+            ec_foe_set_rx_error(fsm, FOE_PROT_ERROR);
+            return;
+        }
+        ec_foe_request_stream_put(fsm->request,
+                data + EC_FOE_HEADER_SIZE, rec_size);
+        fsm->rx_buffer_offset += rec_size;
+        wake_up_all(&slave->master->request_queue);
+    } else if (fsm->rx_buffer_size >= fsm->rx_buffer_offset + rec_size) {
         memcpy(fsm->rx_buffer + fsm->rx_buffer_offset,
                 data + EC_FOE_HEADER_SIZE, rec_size);
         fsm->rx_buffer_offset += rec_size;
     }
 
+    fsm->request->progress = fsm->rx_buffer_offset;
+
     fsm->rx_last_packet =
         (rec_size + EC_MBOX_HEADER_SIZE + EC_FOE_HEADER_SIZE
          != slave->configured_rx_mailbox_size);
 
-    if (fsm->rx_last_packet ||
+    if (fsm->request->stream || fsm->rx_last_packet ||
             (slave->configured_rx_mailbox_size - EC_MBOX_HEADER_SIZE
              - EC_FOE_HEADER_SIZE + fsm->rx_buffer_offset)
             <= fsm->rx_buffer_size) {
@@ -819,6 +948,13 @@ void ec_fsm_foe_state_data_read(
 #ifdef DEBUG_FOE
         EC_SLAVE_DBG(fsm->slave, 0, "last_packet=true\n");
 #endif
+        if (!fsm->rx_last_packet
+                && (fsm->pause_request || ec_fsm_foe_starved(fsm))) {
+            // the slave waits for the acknowledge
+            fsm->state = ec_fsm_foe_state_ack_paused;
+            return;
+        }
+
         if (ec_foe_prepare_send_ack(fsm, datagram)) {
             ec_foe_set_rx_error(fsm, FOE_RX_DATA_ACK_ERROR);
             return;
@@ -888,6 +1024,102 @@ void ec_fsm_foe_state_sent_ack(
 
 /****************************************************************************/
 
+/** State: ACK PAUSED.
+ *
+ * Acknowledges the last data packet after a pause.
+ */
+void ec_fsm_foe_state_ack_paused(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (ec_fsm_foe_starved(fsm)) {
+        if (fsm->request->stream_abort) {
+            ec_fsm_foe_abort(fsm, datagram);
+        }
+        return; // stay paused
+    }
+
+    if (ec_foe_prepare_send_ack(fsm, datagram)) {
+        ec_foe_set_rx_error(fsm, FOE_RX_DATA_ACK_ERROR);
+        return;
+    }
+    fsm->state = ec_fsm_foe_state_sent_ack;
+}
+
+/****************************************************************************/
+
+/** Prepare to send an error request, that aborts the transfer.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_foe_prepare_send_error(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    uint8_t *data;
+
+    data = ec_slave_mbox_prepare_send(fsm->slave, datagram,
+            EC_MBOX_TYPE_FOE, EC_FOE_HEADER_SIZE);
+    if (IS_ERR(data)) {
+        return -1;
+    }
+
+    EC_WRITE_U16(data, EC_FOE_OPCODE_ERR);
+    EC_WRITE_U32(data + 2, EC_FOE_ERROR_ABORT);
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Aborts a paused stream by sending an error request to the slave.
+ */
+void ec_fsm_foe_abort(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    EC_SLAVE_WARN(fsm->slave, "Aborting FoE transfer.\n");
+
+    if (ec_foe_prepare_send_error(fsm, datagram)) {
+        ec_foe_set_tx_error(fsm, FOE_ABORTED_ERROR);
+        return;
+    }
+
+    fsm->state = ec_fsm_foe_state_error_sent;
+}
+
+/****************************************************************************/
+
+/** State: ERROR SENT.
+ *
+ * The error request was sent to abort the transfer.
+ */
+void ec_fsm_foe_state_error_sent(
+        ec_fsm_foe_t *fsm, /**< FoE statemachine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+#ifdef DEBUG_FOE
+    EC_SLAVE_DBG(fsm->slave, 0, "%s()\n", __func__);
+#endif
+
+    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED
+            || fsm->datagram->working_counter != 1) {
+        EC_SLAVE_WARN(fsm->slave, "Failed to send FoE abort request.\n");
+    }
+
+    ec_foe_set_tx_error(fsm, FOE_ABORTED_ERROR);
+}
+
+/****************************************************************************/
+
 /** Set an error code and go to the send error state.
  */
 void ec_foe_set_tx_error(
@@ -53,6 +53,9 @@ struct ec_fsm_foe {
     uint8_t subindex; /**< Current subindex. */
     ec_foe_request_t *request; /**< FoE request. */
     uint8_t toggle; /**< Toggle bit for segment commands. */
+    unsigned int pause_request; /**< Pause the transfer at the next packet
+                                  boundary, so that the mailbox can be used
+                                  for another request. */
 
     uint8_t *tx_buffer; /**< Buffer with data to transmit. */
     uint32_t tx_buffer_size; /**< Size of data to transmit. */
@@ -79,6 +82,7 @@ void ec_fsm_foe_clear(ec_fsm_foe_t *);
 
 int ec_fsm_foe_exec(ec_fsm_foe_t *, ec_datagram_t *);
 int ec_fsm_foe_success(const ec_fsm_foe_t *);
+int ec_fsm_foe_paused(const ec_fsm_foe_t *);
 
 void ec_fsm_foe_transfer(ec_fsm_foe_t *, ec_slave_t *, ec_foe_request_t *);
 
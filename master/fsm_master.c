@@ -46,13 +46,37 @@
 
 // prototypes for private methods
 void ec_fsm_master_restart(ec_fsm_master_t *);
+ec_datagram_t *ec_fsm_master_batch_datagram(ec_fsm_master_t *,
+        unsigned int);
+int ec_fsm_master_batch_busy(const ec_fsm_master_t *);
+int ec_fsm_master_batch_retry(ec_fsm_master_t *);
+void ec_fsm_master_action_process_state(ec_fsm_master_t *);
+void ec_fsm_master_clear_slot(ec_fsm_master_slot_t *);
+void ec_fsm_master_scan_start(ec_fsm_master_t *,
+        ec_fsm_master_slot_t *);
+ec_fsm_master_slot_t *ec_fsm_master_config_slot(ec_fsm_master_t *);
+int ec_fsm_master_group_op_possible(const ec_fsm_master_t *, int);
+void ec_fsm_master_config_start(ec_fsm_master_t *, ec_fsm_master_slot_t *,
+        int);
+void ec_fsm_master_config_finish(ec_fsm_master_t *, ec_fsm_master_slot_t *);
+int ec_fsm_master_exec_config_slots(ec_fsm_master_t *);
+int ec_fsm_master_configuring(const ec_fsm_master_t *,
+        const ec_slave_t *);
+int ec_fsm_master_hotplug_possible(const ec_fsm_master_t *);
+void ec_fsm_master_hotplug_fallback(ec_fsm_master_t *);
+void ec_fsm_master_hotplug_scan(ec_fsm_master_t *);
+int ec_fsm_master_hotplug_dl_status(ec_fsm_master_t *, ec_slave_t *,
+        uint16_t);
 int ec_fsm_master_action_process_sii(ec_fsm_master_t *);
 int ec_fsm_master_action_process_int_request(ec_fsm_master_t *);
+int ec_fsm_master_action_wc_diag(ec_fsm_master_t *);
+ec_fmmu_config_t *ec_fsm_master_wc_diag_fmmu(ec_fsm_master_t *);
+int ec_fsm_master_wc_diag_next(ec_fsm_master_t *);
 void ec_fsm_master_action_idle(ec_fsm_master_t *);
 void ec_fsm_master_action_next_slave_state(ec_fsm_master_t *);
 void ec_fsm_master_action_configure(ec_fsm_master_t *);
-u64 ec_fsm_master_dc_offset32(ec_fsm_master_t *, u64, u64, unsigned long);
-u64 ec_fsm_master_dc_offset64(ec_fsm_master_t *, u64, u64, unsigned long);
+u64 ec_fsm_master_dc_offset32(ec_slave_t *, u64, u64, unsigned long);
+u64 ec_fsm_master_dc_offset64(ec_slave_t *, u64, u64, unsigned long);
 
 /****************************************************************************/
 
@@ -61,9 +85,16 @@ void ec_fsm_master_state_broadcast(ec_fsm_master_t *);
 void ec_fsm_master_state_read_state(ec_fsm_master_t *);
 void ec_fsm_master_state_acknowledge(ec_fsm_master_t *);
 void ec_fsm_master_state_configure_slave(ec_fsm_master_t *);
+void ec_fsm_master_state_configure_wait(ec_fsm_master_t *);
+void ec_fsm_master_state_group_op_request(ec_fsm_master_t *);
+void ec_fsm_master_state_group_op_check(ec_fsm_master_t *);
+void ec_fsm_master_state_group_op_fallback(ec_fsm_master_t *);
 void ec_fsm_master_state_clear_addresses(ec_fsm_master_t *);
 void ec_fsm_master_state_dc_measure_delays(ec_fsm_master_t *);
 void ec_fsm_master_state_scan_slave(ec_fsm_master_t *);
+void ec_fsm_master_state_hotplug_check(ec_fsm_master_t *);
+void ec_fsm_master_state_hotplug_measure(ec_fsm_master_t *);
+void ec_fsm_master_state_hotplug_refresh(ec_fsm_master_t *);
 void ec_fsm_master_state_dc_read_offset(ec_fsm_master_t *);
 void ec_fsm_master_state_dc_write_offset(ec_fsm_master_t *);
 void ec_fsm_master_state_assign_sii(ec_fsm_master_t *);
@@ -71,34 +102,57 @@ void ec_fsm_master_state_write_sii(ec_fsm_master_t *);
 void ec_fsm_master_state_sdo_dictionary(ec_fsm_master_t *);
 void ec_fsm_master_state_sdo_request(ec_fsm_master_t *);
 void ec_fsm_master_state_soe_request(ec_fsm_master_t *);
+void ec_fsm_master_state_wc_diag(ec_fsm_master_t *);
 
 void ec_fsm_master_enter_clear_addresses(ec_fsm_master_t *);
+void ec_fsm_master_enter_hotplug(ec_fsm_master_t *);
+void ec_fsm_master_enter_hotplug_check(ec_fsm_master_t *);
+void ec_fsm_master_enter_hotplug_refresh(ec_fsm_master_t *);
+void ec_fsm_master_enter_read_states(ec_fsm_master_t *);
 void ec_fsm_master_enter_write_system_times(ec_fsm_master_t *);
+void ec_fsm_master_enter_group_op(ec_fsm_master_t *);
+void ec_fsm_master_enter_group_op_fallback(ec_fsm_master_t *);
 
 /****************************************************************************/
 
 /** Constructor.
+ *
+ * \return Zero on success, otherwise a negative error code.
  */
-void ec_fsm_master_init(
+int ec_fsm_master_init(
         ec_fsm_master_t *fsm, /**< Master state machine. */
         ec_master_t *master, /**< EtherCAT master. */
         ec_datagram_t *datagram /**< Datagram object to use. */
         )
 {
+    ec_fsm_master_slot_t *slot;
+    unsigned int i;
+    int ret;
+
     fsm->master = master;
     fsm->datagram = datagram;
+    fsm->op_deferred = 0;
 
     // inits the member variables state, idle, dev_idx, link_state,
-    // slaves_responding, slave_states and rescan_required
+    // slaves_responding, slave_states, rescan_required and hotplug
     ec_fsm_master_reset(fsm);
 
     fsm->retries = 0;
+    fsm->datagram_pending = 0;
     fsm->scan_jiffies = 0;
     fsm->slave = NULL;
     fsm->sii_request = NULL;
     fsm->sii_index = 0;
     fsm->sdo_request = NULL;
     fsm->soe_request = NULL;
+    fsm->diag_domain_index = 0;
+    fsm->diag_fmmu_pos = 0;
+    fsm->diag_step = 0;
+    fsm->group_jiffies = 0;
+    fsm->group_timeout_ms = 0;
+    fsm->batch_count = 0;
+    fsm->batch_index = 0;
+    fsm->batch_pending = 0;
 
     // init sub-state-machines
     ec_fsm_coe_init(&fsm->fsm_coe);
@@ -108,12 +162,91 @@ void ec_fsm_master_init(
     ec_fsm_eoe_init(&fsm->fsm_eoe);
 #endif
     ec_fsm_change_init(&fsm->fsm_change, fsm->datagram);
-    ec_fsm_slave_config_init(&fsm->fsm_slave_config, fsm->datagram,
-            &fsm->fsm_change, &fsm->fsm_coe, &fsm->fsm_soe, &fsm->fsm_pdo,
-            &fsm->fsm_eoe);
-    ec_fsm_slave_scan_init(&fsm->fsm_slave_scan, fsm->datagram,
-            &fsm->fsm_slave_config, &fsm->fsm_pdo);
     ec_fsm_sii_init(&fsm->fsm_sii, fsm->datagram);
+
+    for (i = 0; i < EC_FSM_MASTER_BATCH_SIZE - 1; i++) {
+        ec_datagram_init(&fsm->batch_datagrams[i]);
+        snprintf(fsm->batch_datagrams[i].name, EC_DATAGRAM_NAME_SIZE,
+                "master-batch-%u", i);
+        ret = ec_datagram_prealloc(&fsm->batch_datagrams[i],
+                EC_MAX_DATA_SIZE);
+        if (ret < 0) {
+            EC_MASTER_ERR(master, "Failed to allocate batch datagram.\n");
+            i++; // clear this one, too
+            goto out_clear_batch;
+        }
+    }
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        slot = &fsm->slots[i];
+        slot->slave = NULL;
+        slot->pending = 0;
+        slot->configuring = 0;
+
+        ec_datagram_init(&slot->datagram);
+        snprintf(slot->datagram.name, EC_DATAGRAM_NAME_SIZE,
+                "master-slot-%u", i);
+        ret = ec_datagram_prealloc(&slot->datagram, EC_MAX_DATA_SIZE);
+        if (ret < 0) {
+            EC_MASTER_ERR(master, "Failed to allocate scan datagram.\n");
+            ec_datagram_clear(&slot->datagram);
+            goto out_clear_slots;
+        }
+
+        ec_fsm_coe_init(&slot->fsm_coe);
+        ec_fsm_soe_init(&slot->fsm_soe);
+        ec_fsm_pdo_init(&slot->fsm_pdo, &slot->fsm_coe);
+#ifdef EC_EOE
+        ec_fsm_eoe_init(&slot->fsm_eoe);
+#endif
+        ec_fsm_change_init(&slot->fsm_change, &slot->datagram);
+        ec_fsm_slave_config_init(&slot->fsm_slave_config, &slot->datagram,
+                &slot->fsm_change, &slot->fsm_coe, &slot->fsm_soe,
+                &slot->fsm_pdo, &slot->fsm_eoe);
+        ec_fsm_slave_scan_init(&slot->fsm_slave_scan, &slot->datagram,
+                &slot->fsm_slave_config, &slot->fsm_pdo);
+    }
+
+    return 0;
+
+out_clear_slots:
+    while (i--) {
+        ec_fsm_master_clear_slot(&fsm->slots[i]);
+    }
+    i = EC_FSM_MASTER_BATCH_SIZE - 1;
+out_clear_batch:
+    while (i--) {
+        ec_datagram_clear(&fsm->batch_datagrams[i]);
+    }
+    ec_fsm_coe_clear(&fsm->fsm_coe);
+    ec_fsm_soe_clear(&fsm->fsm_soe);
+    ec_fsm_pdo_clear(&fsm->fsm_pdo);
+#ifdef EC_EOE
+    ec_fsm_eoe_clear(&fsm->fsm_eoe);
+#endif
+    ec_fsm_change_clear(&fsm->fsm_change);
+    ec_fsm_sii_clear(&fsm->fsm_sii);
+    return ret;
+}
+
+/****************************************************************************/
+
+/** Clears a scanning slot.
+ */
+void ec_fsm_master_clear_slot(
+        ec_fsm_master_slot_t *slot /**< Scanning slot. */
+        )
+{
+    ec_fsm_coe_clear(&slot->fsm_coe);
+    ec_fsm_soe_clear(&slot->fsm_soe);
+    ec_fsm_pdo_clear(&slot->fsm_pdo);
+#ifdef EC_EOE
+    ec_fsm_eoe_clear(&slot->fsm_eoe);
+#endif
+    ec_fsm_change_clear(&slot->fsm_change);
+    ec_fsm_slave_config_clear(&slot->fsm_slave_config);
+    ec_fsm_slave_scan_clear(&slot->fsm_slave_scan);
+    ec_datagram_clear(&slot->datagram);
 }
 
 /****************************************************************************/
@@ -124,6 +257,8 @@ void ec_fsm_master_clear(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
+    unsigned int i;
+
     // clear sub-state machines
     ec_fsm_coe_clear(&fsm->fsm_coe);
     ec_fsm_soe_clear(&fsm->fsm_soe);
@@ -132,9 +267,15 @@ void ec_fsm_master_clear(
     ec_fsm_eoe_clear(&fsm->fsm_eoe);
 #endif
     ec_fsm_change_clear(&fsm->fsm_change);
-    ec_fsm_slave_config_clear(&fsm->fsm_slave_config);
-    ec_fsm_slave_scan_clear(&fsm->fsm_slave_scan);
     ec_fsm_sii_clear(&fsm->fsm_sii);
+
+    for (i = 0; i < EC_FSM_MASTER_BATCH_SIZE - 1; i++) {
+        ec_datagram_clear(&fsm->batch_datagrams[i]);
+    }
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        ec_fsm_master_clear_slot(&fsm->slots[i]);
+    }
 }
 
 /****************************************************************************/
@@ -146,6 +287,7 @@ void ec_fsm_master_reset(
         )
 {
     ec_device_index_t dev_idx;
+    unsigned int i;
 
     fsm->state = ec_fsm_master_state_start;
     fsm->idle = 0;
@@ -159,6 +301,39 @@ void ec_fsm_master_reset(
     }
 
     fsm->rescan_required = 0;
+    fsm->hotplug = 0;
+    fsm->hotplug_dev_idx = EC_DEVICE_MAIN;
+    fsm->hotplug_count = 0;
+    fsm->hotplug_step = 0;
+    fsm->hotplug_slave = NULL;
+    fsm->hotplug_port = 0;
+    fsm->datagram_pending = 0;
+    fsm->batch_count = 0;
+    fsm->batch_index = 0;
+    fsm->batch_pending = 0;
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        fsm->slots[i].slave = NULL;
+        fsm->slots[i].pending = 0;
+        fsm->slots[i].configuring = 0;
+    }
+
+    // abandon running slave configurations and grouped transitions
+    if (fsm->op_deferred) {
+        ec_slave_t *slave;
+
+        for (slave = fsm->master->slaves;
+                slave < fsm->master->slaves + fsm->master->slave_count;
+                slave++) {
+            slave->op_deferred = 0;
+        }
+        fsm->op_deferred = 0;
+    }
+
+    down(&fsm->master->config_sem);
+    fsm->master->config_busy = 0;
+    up(&fsm->master->config_sem);
+    wake_up_interruptible(&fsm->master->config_queue);
 }
 
 /****************************************************************************/
@@ -168,20 +343,76 @@ void ec_fsm_master_reset(
  * If the state machine's datagram is not sent or received yet, the execution
  * of the state machine is delayed to the next cycle.
  *
- * \return true, if the state machine was executed
+ * \return true, if the state machine was executed and datagrams have to be
+ *         queued with ec_fsm_master_queue_datagrams().
  */
 int ec_fsm_master_exec(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
+    unsigned int i;
+    int exec;
+
+    // slave configurations run independently of the master datagram
+    exec = ec_fsm_master_exec_config_slots(fsm);
+
     if (fsm->datagram->state == EC_DATAGRAM_SENT
-        || fsm->datagram->state == EC_DATAGRAM_QUEUED) {
-        // datagram was not sent or received yet.
-        return 0;
+        || fsm->datagram->state == EC_DATAGRAM_QUEUED
+        || ec_fsm_master_batch_busy(fsm)) {
+        // datagrams were not sent or received yet.
+        return exec;
     }
 
     fsm->state(fsm);
-    return 1;
+
+    if (fsm->state != ec_fsm_master_state_scan_slave
+            && fsm->state != ec_fsm_master_state_configure_slave
+            && fsm->state != ec_fsm_master_state_configure_wait
+            && fsm->state != ec_fsm_master_state_group_op_fallback) {
+        fsm->datagram_pending = 1;
+        return 1;
+    }
+
+    // while waiting for the slots, only the slot datagrams are used
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        if (fsm->slots[i].pending) {
+            return 1;
+        }
+    }
+    return exec;
+}
+
+/****************************************************************************/
+
+/** Queues the datagrams produced by the last execution.
+ *
+ * This has to be called after ec_fsm_master_exec() returned true, either
+ * directly by the master thread or by the realtime context on injection.
+ */
+void ec_fsm_master_queue_datagrams(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_fsm_master_slot_t *slot;
+    unsigned int i;
+
+    if (fsm->datagram_pending) {
+        ec_master_queue_datagram(fsm->master, fsm->datagram);
+        for (i = 0; i < fsm->batch_pending; i++) {
+            ec_master_queue_datagram(fsm->master,
+                    &fsm->batch_datagrams[i]);
+        }
+        fsm->datagram_pending = 0;
+        fsm->batch_pending = 0;
+    }
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        slot = &fsm->slots[i];
+        if (slot->pending) {
+            ec_master_queue_datagram(fsm->master, &slot->datagram);
+            slot->pending = 0;
+        }
+    }
 }
 
 /****************************************************************************/
@@ -193,7 +424,72 @@ int ec_fsm_master_idle(
         const ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    return fsm->idle;
+    return fsm->idle && !fsm->master->config_busy;
+}
+
+/****************************************************************************/
+
+/** Returns a datagram of the current batch.
+ *
+ * \return The master datagram for index 0, otherwise a batch datagram.
+ */
+ec_datagram_t *ec_fsm_master_batch_datagram(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        unsigned int index /**< Index in the batch. */
+        )
+{
+    return index ? &fsm->batch_datagrams[index - 1] : fsm->datagram;
+}
+
+/****************************************************************************/
+
+/** Checks, if additional datagrams of the current batch are in transit.
+ *
+ * \return Non-zero, if a batch datagram was not sent or received yet.
+ */
+int ec_fsm_master_batch_busy(
+        const ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    const ec_datagram_t *datagram;
+    unsigned int i;
+
+    for (i = 1; i < fsm->batch_count; i++) {
+        datagram = &fsm->batch_datagrams[i - 1];
+        if (datagram->state == EC_DATAGRAM_SENT
+                || datagram->state == EC_DATAGRAM_QUEUED) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Sends the current batch again, if one of its datagrams timed out.
+ *
+ * \return Non-zero, if the batch is sent again.
+ */
+int ec_fsm_master_batch_retry(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < fsm->batch_count; i++) {
+        if (ec_fsm_master_batch_datagram(fsm, i)->state
+                == EC_DATAGRAM_TIMED_OUT) {
+            break;
+        }
+    }
+
+    if (i == fsm->batch_count || !fsm->retries--) {
+        return 0;
+    }
+
+    fsm->batch_pending = fsm->batch_count - 1;
+    return 1;
 }
 
 /****************************************************************************/
@@ -205,6 +501,14 @@ void ec_fsm_master_restart(
         )
 {
     fsm->dev_idx = EC_DEVICE_MAIN;
+
+    if (fsm->master->config_busy || fsm->op_deferred) {
+        // let running slave configurations finish first
+        fsm->idle = 0;
+        fsm->state = ec_fsm_master_state_configure_wait;
+        return;
+    }
+
     fsm->state = ec_fsm_master_state_start;
     fsm->state(fsm); // execute immediately
 }
@@ -290,6 +594,12 @@ void ec_fsm_master_state_broadcast(
 
     // bus topology change?
     if (datagram->working_counter != fsm->slaves_responding[fsm->dev_idx]) {
+        // slaves added to a known bus may be scanned incrementally
+        fsm->hotplug = !fsm->rescan_required
+            && fsm->slaves_responding[fsm->dev_idx]
+            && datagram->working_counter
+            > fsm->slaves_responding[fsm->dev_idx];
+        fsm->hotplug_dev_idx = fsm->dev_idx;
         fsm->rescan_required = 1;
         fsm->slaves_responding[fsm->dev_idx] = datagram->working_counter;
         EC_MASTER_INFO(master, "%u slave(s) responding on %s device.\n",
@@ -344,6 +654,9 @@ void ec_fsm_master_state_broadcast(
     }
 
     if (fsm->rescan_required) {
+        unsigned int hotplug = fsm->hotplug;
+
+        fsm->hotplug = 0;
         down(&master->scan_sem);
         if (!master->allow_scan) {
             up(&master->scan_sem);
@@ -355,11 +668,18 @@ void ec_fsm_master_state_broadcast(
             master->scan_index = 0;
             up(&master->scan_sem);
 
-            // clear all slaves and scan the bus
             fsm->rescan_required = 0;
             fsm->idle = 0;
             fsm->scan_jiffies = jiffies;
 
+            if (hotplug && ec_fsm_master_hotplug_possible(fsm)) {
+                ec_fsm_master_enter_hotplug(fsm);
+                return;
+            }
+
+            // clear all slaves and scan the bus
+            fsm->hotplug_count = 0;
+
 #ifdef EC_EOE
             ec_master_eoe_stop(master);
             ec_master_clear_eoe_handlers(master);
@@ -379,7 +699,8 @@ void ec_fsm_master_state_broadcast(
                 return;
             }
 
-            size = sizeof(ec_slave_t) * count;
+            // reserve memory for slaves, that are hot-connected later
+            size = sizeof(ec_slave_t) * (count + master->hotplug_slaves);
             if (!(master->slaves =
                         (ec_slave_t *) kmalloc(size, GFP_KERNEL))) {
                 EC_MASTER_ERR(master, "Failed to allocate %u bytes"
@@ -389,6 +710,7 @@ void ec_fsm_master_state_broadcast(
                 ec_fsm_master_restart(fsm);
                 return;
             }
+            master->slave_capacity = count + master->hotplug_slaves;
 
             // init slaves
             dev_idx = EC_DEVICE_MAIN;
@@ -413,6 +735,9 @@ void ec_fsm_master_state_broadcast(
             master->slave_count = count;
             master->fsm_slave = master->slaves;
 
+            // adopt a warm-start snapshot, if it matches
+            ec_snapshot_start(&master->snapshot);
+
             /* start with first device with slaves responding; at least one
              * has responding slaves, otherwise count would be zero. */
             fsm->dev_idx = EC_DEVICE_MAIN;
@@ -437,14 +762,13 @@ void ec_fsm_master_state_broadcast(
             ec_fsm_master_enter_write_system_times(fsm);
 
         } else {
-            // fetch state from first slave
+            // fetch states beginning with the first slave
             fsm->slave = master->slaves;
-            ec_datagram_fprd(fsm->datagram, fsm->slave->station_address,
-                    0x0130, 2);
-            ec_datagram_zero(datagram);
-            fsm->datagram->device_index = fsm->slave->device_index;
-            fsm->retries = EC_FSM_RETRIES;
-            fsm->state = ec_fsm_master_state_read_state;
+            ec_fsm_master_enter_read_states(fsm);
+            if (!fsm->batch_count) {
+                // all slaves are being configured
+                ec_fsm_master_restart(fsm);
+            }
         }
     } else {
         ec_fsm_master_restart(fsm);
@@ -598,6 +922,166 @@ int ec_fsm_master_action_process_int_request(
 
 /****************************************************************************/
 
+/** Master action: Working counter diagnosis.
+ *
+ * Starts diagnosing a domain, whose working counter has dropped. Every slave
+ * configuration of the domain is checked by reading the AL status, the FMMU
+ * and the sync manager registers, one datagram per cycle, so that the
+ * process data exchange is not disturbed.
+ *
+ * \return non-zero, if a diagnosis datagram is pending.
+ */
+int ec_fsm_master_action_wc_diag(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_domain_t *domain;
+    ec_fmmu_config_t *fmmu;
+
+    list_for_each_entry(domain, &master->domains, list) {
+        if (!domain->diag_request) {
+            continue;
+        }
+
+        domain->diag_request = 0;
+        domain->diag_state = EC_WC_DIAG_BUSY;
+        domain->diag_count++;
+
+        list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+            fmmu->diag_flags = 0;
+            fmmu->diag_al_state = 0;
+            fmmu->diag_al_status_code = 0;
+        }
+
+        EC_MASTER_DBG(master, 1, "Domain %u: Diagnosing working counter"
+                " %u/%u.\n", domain->index, domain->diag_working_counter,
+                domain->expected_working_counter);
+
+        fsm->diag_domain_index = domain->index;
+        fsm->diag_fmmu_pos = 0;
+        fsm->diag_step = 0;
+
+        if (ec_fsm_master_wc_diag_next(fsm)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Looks up the FMMU configuration currently being diagnosed.
+ *
+ * The domain is searched every time, because it may have been removed in the
+ * meantime.
+ *
+ * \return FMMU configuration, or NULL.
+ */
+ec_fmmu_config_t *ec_fsm_master_wc_diag_fmmu(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_domain_t *domain;
+    ec_fmmu_config_t *fmmu;
+    unsigned int pos = 0;
+
+    domain = ec_master_find_domain(fsm->master, fsm->diag_domain_index);
+    if (!domain) {
+        return NULL;
+    }
+
+    list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+        if (pos++ == fsm->diag_fmmu_pos) {
+            return fmmu;
+        }
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
+/** Issues the next working counter diagnosis datagram.
+ *
+ * If all FMMU configurations of the domain are checked, the diagnosis is
+ * finished and the results are logged.
+ *
+ * \return non-zero, if a datagram was issued.
+ */
+int ec_fsm_master_wc_diag_next(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_domain_t *domain;
+    ec_fmmu_config_t *fmmu;
+    ec_slave_t *slave;
+    unsigned int fmmu_index, missing = 0;
+
+    while ((fmmu = ec_fsm_master_wc_diag_fmmu(fsm))) {
+        if (!(slave = fmmu->sc->slave)) {
+            fmmu->diag_flags |= EC_WC_DIAG_OFFLINE;
+            fsm->diag_fmmu_pos++;
+            fsm->diag_step = 0;
+            continue;
+        }
+
+        switch (fsm->diag_step) {
+            case 0: // AL status and AL status code
+                ec_datagram_fprd(fsm->datagram,
+                        slave->station_address, 0x0130, 6);
+                break;
+            case 1: // FMMU configuration page
+                fmmu_index = fmmu - fmmu->sc->fmmu_configs;
+                ec_datagram_fprd(fsm->datagram, slave->station_address,
+                        0x0600 + fmmu_index * EC_FMMU_PAGE_SIZE,
+                        EC_FMMU_PAGE_SIZE);
+                break;
+            default: // sync manager configuration page
+                ec_datagram_fprd(fsm->datagram, slave->station_address,
+                        0x0800 + fmmu->sync_index * EC_SYNC_PAGE_SIZE,
+                        EC_SYNC_PAGE_SIZE);
+                break;
+        }
+
+        ec_datagram_zero(fsm->datagram);
+        fsm->datagram->device_index = slave->device_index;
+        fsm->idle = 1;
+        fsm->slave = slave;
+        fsm->retries = EC_FSM_RETRIES;
+        fsm->state = ec_fsm_master_state_wc_diag;
+        return 1;
+    }
+
+    domain = ec_master_find_domain(fsm->master, fsm->diag_domain_index);
+    if (!domain) {
+        return 0;
+    }
+
+    list_for_each_entry(fmmu, &domain->fmmu_configs, list) {
+        if (!fmmu->diag_flags) {
+            continue;
+        }
+
+        missing++;
+        EC_CONFIG_WARN(fmmu->sc, "Not contributing to the working counter"
+                " of domain %u (SM%u, findings 0x%02X, AL state 0x%02X,"
+                " AL status code 0x%04X).\n", domain->index,
+                fmmu->sync_index, fmmu->diag_flags, fmmu->diag_al_state,
+                fmmu->diag_al_status_code);
+    }
+
+    EC_MASTER_INFO(fsm->master, "Domain %u: Working counter diagnosis"
+            " finished, %u of %u FMMU configurations not contributing.\n",
+            domain->index, missing, ec_domain_fmmu_count(domain));
+
+    domain->diag_state = EC_WC_DIAG_DONE;
+    return 0;
+}
+
+/****************************************************************************/
+
 /** Master action: IDLE.
  *
  * Does secondary work.
@@ -608,12 +1092,18 @@ void ec_fsm_master_action_idle(
 {
     ec_master_t *master = fsm->master;
     ec_slave_t *slave;
+    ec_sdo_dict_t *dict;
 
     // Check for pending internal SDO or SoE requests
     if (ec_fsm_master_action_process_int_request(fsm)) {
         return;
     }
 
+    // Check for working counter drops to diagnose
+    if (ec_fsm_master_action_wc_diag(fsm)) {
+        return;
+    }
+
     // enable processing of requests
     for (slave = master->slaves;
             slave < master->slaves + master->slave_count;
@@ -631,13 +1121,34 @@ void ec_fsm_master_action_idle(
                 || slave->sdo_dictionary_fetched
                 || slave->current_state == EC_SLAVE_STATE_INIT
                 || slave->current_state == EC_SLAVE_STATE_UNKNOWN
-                || jiffies - slave->jiffies_preop < EC_WAIT_SDO_DICT * HZ
                 ) continue;
 
-        EC_SLAVE_DBG(slave, 1, "Fetching SDO dictionary.\n");
+        // a cached dictionary does not need the delay for the slave
+        dict = ec_sdo_cache_find(&master->sdo_cache, slave->sii.vendor_id,
+                slave->sii.product_code, slave->sii.revision_number);
+        if (dict) {
+            EC_SLAVE_DBG(slave, 1, "Using cached SDO dictionary.\n");
+            slave->sdo_dictionary_fetched = 1;
+            slave->sdo_dict = ec_sdo_dict_get(dict);
+            ec_slave_attach_pdo_names(slave);
+            continue;
+        }
+
+        if (jiffies - slave->jiffies_preop < EC_WAIT_SDO_DICT * HZ) {
+            continue;
+        }
 
         slave->sdo_dictionary_fetched = 1;
 
+        if (!(slave->sdo_dict = ec_sdo_dict_alloc(slave->sii.vendor_id,
+                        slave->sii.product_code,
+                        slave->sii.revision_number))) {
+            EC_SLAVE_ERR(slave, "Failed to allocate SDO dictionary!\n");
+            continue;
+        }
+
+        EC_SLAVE_DBG(slave, 1, "Fetching SDO dictionary.\n");
+
         // start fetching SDO dictionary
         fsm->idle = 0;
         fsm->slave = slave;
@@ -666,21 +1177,34 @@ void ec_fsm_master_action_next_slave_state(
 {
     ec_master_t *master = fsm->master;
 
-    // is there another slave to query?
-    fsm->slave++;
-    if (fsm->slave < master->slaves + master->slave_count) {
-        // fetch state from next slave
-        fsm->idle = 1;
-        ec_datagram_fprd(fsm->datagram,
-                fsm->slave->station_address, 0x0130, 2);
-        ec_datagram_zero(fsm->datagram);
-        fsm->datagram->device_index = fsm->slave->device_index;
-        fsm->retries = EC_FSM_RETRIES;
-        fsm->state = ec_fsm_master_state_read_state;
+    // is there another slave in the batch, whose state was fetched?
+    if (++fsm->batch_index < fsm->batch_count) {
+        fsm->slave = fsm->batch_slaves[fsm->batch_index];
+        ec_fsm_master_action_process_state(fsm);
         return;
     }
 
+    // is there another slave to query? (an empty batch has no successor)
+    if (fsm->batch_count) {
+        fsm->slave = fsm->batch_slaves[fsm->batch_count - 1] + 1;
+    } else {
+        fsm->slave = master->slaves + master->slave_count;
+    }
+    if (fsm->slave < master->slaves + master->slave_count) {
+        ec_fsm_master_enter_read_states(fsm);
+        if (fsm->batch_count) {
+            return;
+        }
+    }
+
     // all slaves processed
+    if (master->config_busy || fsm->op_deferred) {
+        // wait for the slave configurations to finish
+        fsm->idle = 0;
+        fsm->state = ec_fsm_master_state_configure_wait;
+        return;
+    }
+
     ec_fsm_master_action_idle(fsm);
 }
 
@@ -695,7 +1219,7 @@ void ec_fsm_master_action_configure(
     ec_master_t *master = fsm->master;
     ec_slave_t *slave = fsm->slave;
 
-    if (master->config_changed) {
+    if (master->config_changed && !master->config_busy) {
         master->config_changed = 0;
 
         // abort iterating through slaves,
@@ -711,29 +1235,19 @@ void ec_fsm_master_action_configure(
 
     // Does the slave have to be configured?
     if ((slave->current_state != slave->requested_state
-                || slave->force_config) && !slave->error_flag) {
+                || slave->force_config) && !slave->error_flag
+            && !slave->op_deferred) {
+        ec_fsm_master_slot_t *slot = ec_fsm_master_config_slot(fsm);
 
-        // Start slave configuration
-        down(&master->config_sem);
-        master->config_busy = 1;
-        up(&master->config_sem);
-
-        if (master->debug_level) {
-            char old_state[EC_STATE_STRING_SIZE],
-                 new_state[EC_STATE_STRING_SIZE];
-            ec_state_string(slave->current_state, old_state, 0);
-            ec_state_string(slave->requested_state, new_state, 0);
-            EC_SLAVE_DBG(slave, 1, "Changing state from %s to %s%s.\n",
-                    old_state, new_state,
-                    slave->force_config ? " (forced)" : "");
+        if (!slot) {
+            // wait for a free slot
+            fsm->idle = 0;
+            fsm->state = ec_fsm_master_state_configure_slave;
+            return;
         }
 
-        fsm->idle = 0;
-        fsm->state = ec_fsm_master_state_configure_slave;
-        ec_fsm_slave_config_start(&fsm->fsm_slave_config, slave);
-        fsm->state(fsm); // execute immediately
-        fsm->datagram->device_index = fsm->slave->device_index;
-        return;
+        // configure the slave in parallel and check the next one
+        ec_fsm_master_config_start(fsm, slot, 0);
     }
 
     // process next slave
@@ -742,43 +1256,186 @@ void ec_fsm_master_action_configure(
 
 /****************************************************************************/
 
-/** Master state: READ STATE.
+/** Master state: WC DIAG.
  *
- * Fetches the AL state of a slave.
+ * Evaluates a register block read by the working counter diagnosis.
  */
-void ec_fsm_master_state_read_state(
+void ec_fsm_master_state_wc_diag(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    ec_slave_t *slave = fsm->slave;
     ec_datagram_t *datagram = fsm->datagram;
+    ec_fmmu_config_t *fmmu;
+    const uint8_t *data = datagram->data;
+    uint8_t al_status;
 
     if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
         return;
     }
 
-    if (datagram->state != EC_DATAGRAM_RECEIVED) {
-        EC_SLAVE_ERR(slave, "Failed to receive AL state datagram: ");
-        ec_datagram_print_state(datagram);
+    if (!(fmmu = ec_fsm_master_wc_diag_fmmu(fsm))) {
+        // domain was removed in the meantime
         ec_fsm_master_restart(fsm);
         return;
     }
 
-    // did the slave not respond to its station address?
-    if (datagram->working_counter != 1) {
-        if (!slave->error_flag) {
-            slave->error_flag = 1;
-            EC_SLAVE_DBG(slave, 1, "Slave did not respond to state query.\n");
+    if (datagram->state != EC_DATAGRAM_RECEIVED
+            || datagram->working_counter != 1) {
+        fmmu->diag_flags |= EC_WC_DIAG_NO_RESPONSE;
+        fsm->diag_step = 2; // skip remaining blocks
+    } else {
+        switch (fsm->diag_step) {
+            case 0:
+                al_status = EC_READ_U8(data);
+                fmmu->diag_al_state = al_status & EC_SLAVE_STATE_MASK;
+                if (al_status & EC_SLAVE_STATE_ACK_ERR) {
+                    fmmu->diag_flags |= EC_WC_DIAG_AL_ERROR;
+                    fmmu->diag_al_status_code = EC_READ_U16(data + 4);
+                }
+                if (fmmu->diag_al_state != EC_SLAVE_STATE_OP &&
+                        (fmmu->dir == EC_DIR_OUTPUT ||
+                         fmmu->diag_al_state != EC_SLAVE_STATE_SAFEOP)) {
+                    fmmu->diag_flags |= EC_WC_DIAG_AL_STATE;
+                }
+                break;
+            case 1:
+                if (!(EC_READ_U8(data + 12) & 0x01)
+                        || EC_READ_U32(data) != fmmu->logical_start_address
+                        || EC_READ_U16(data + 4) != fmmu->data_size) {
+                    fmmu->diag_flags |= EC_WC_DIAG_FMMU;
+                }
+                break;
+            default:
+                // SM activation and PDI deactivation request
+                if (!(EC_READ_U8(data + 6) & 0x01)
+                        || (EC_READ_U8(data + 7) & 0x01)) {
+                    fmmu->diag_flags |= EC_WC_DIAG_SM;
+                }
+                break;
         }
-        fsm->rescan_required = 1;
-        ec_fsm_master_restart(fsm);
-        return;
     }
 
-    // A single slave responded
-    ec_slave_set_state(slave, EC_READ_U8(datagram->data));
+    if (fsm->diag_step < 2) {
+        fsm->diag_step++;
+    } else {
+        fsm->diag_fmmu_pos++;
+        fsm->diag_step = 0;
+    }
 
-    if (!slave->error_flag) {
+    if (!ec_fsm_master_wc_diag_next(fsm)) {
+        // diagnosis finished, continue with secondary work
+        ec_fsm_master_action_idle(fsm);
+    }
+}
+
+/****************************************************************************/
+
+/** Start fetching the AL states of the next slaves.
+ *
+ * The states of up to EC_FSM_MASTER_BATCH_SIZE slaves, beginning with the
+ * current one, are read in the same cycle. Slaves, that are being configured,
+ * are skipped. If there are no more slaves, the batch is empty.
+ */
+void ec_fsm_master_enter_read_states(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+
+    fsm->batch_count = 0;
+    fsm->batch_index = 0;
+
+    for (slave = fsm->slave; slave < master->slaves + master->slave_count
+            && fsm->batch_count < EC_FSM_MASTER_BATCH_SIZE; slave++) {
+        if (ec_fsm_master_configuring(fsm, slave)) {
+            continue;
+        }
+
+        datagram = ec_fsm_master_batch_datagram(fsm, fsm->batch_count);
+        ec_datagram_fprd(datagram, slave->station_address, 0x0130, 2);
+        ec_datagram_zero(datagram);
+        datagram->device_index = slave->device_index;
+        fsm->batch_slaves[fsm->batch_count++] = slave;
+    }
+
+    if (!fsm->batch_count) {
+        return;
+    }
+
+    fsm->slave = fsm->batch_slaves[0];
+    fsm->batch_pending = fsm->batch_count - 1;
+    fsm->idle = 1;
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_master_state_read_state;
+}
+
+/****************************************************************************/
+
+/** Master state: READ STATE.
+ *
+ * Fetches the AL states of a batch of slaves and processes the first one.
+ */
+void ec_fsm_master_state_read_state(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+    unsigned int i, failed = 0;
+
+    if (ec_fsm_master_batch_retry(fsm)) {
+        return;
+    }
+
+    for (i = 0; i < fsm->batch_count; i++) {
+        datagram = ec_fsm_master_batch_datagram(fsm, i);
+        slave = fsm->batch_slaves[i];
+
+        if (datagram->state != EC_DATAGRAM_RECEIVED) {
+            EC_SLAVE_ERR(slave, "Failed to receive AL state datagram: ");
+            ec_datagram_print_state(datagram);
+            failed = 1;
+            continue;
+        }
+
+        // did the slave not respond to its station address?
+        if (datagram->working_counter != 1) {
+            if (!slave->error_flag) {
+                slave->error_flag = 1;
+                EC_SLAVE_DBG(slave, 1,
+                        "Slave did not respond to state query.\n");
+            }
+            fsm->rescan_required = 1;
+            failed = 1;
+            continue;
+        }
+
+        // A single slave responded
+        ec_slave_set_state(slave, EC_READ_U8(datagram->data));
+    }
+
+    if (failed) {
+        ec_fsm_master_restart(fsm);
+        return;
+    }
+
+    fsm->slave = fsm->batch_slaves[0];
+    ec_fsm_master_action_process_state(fsm);
+}
+
+/****************************************************************************/
+
+/** Master action: Process the fetched AL state of the current slave.
+ */
+void ec_fsm_master_action_process_state(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+
+    if (!slave->error_flag) {
         // Check, if new slave state has to be acknowledged
         if (slave->current_state & EC_SLAVE_STATE_ACK_ERR) {
             fsm->idle = 0;
@@ -788,103 +1445,1036 @@ void ec_fsm_master_state_read_state(
             return;
         }
 
-        // No acknowlegde necessary; check for configuration
-        ec_fsm_master_action_configure(fsm);
-        return;
+        // No acknowlegde necessary; check for configuration
+        ec_fsm_master_action_configure(fsm);
+        return;
+    }
+
+    // slave has error flag set; process next one
+    ec_fsm_master_action_next_slave_state(fsm);
+}
+
+/****************************************************************************/
+
+/** Master state: ACKNOWLEDGE.
+ */
+void ec_fsm_master_state_acknowledge(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+
+    if (ec_fsm_change_exec(&fsm->fsm_change)) {
+        return;
+    }
+
+    if (!ec_fsm_change_success(&fsm->fsm_change)) {
+        fsm->slave->error_flag = 1;
+        EC_SLAVE_ERR(slave, "Failed to acknowledge state change.\n");
+    }
+
+    ec_fsm_master_action_configure(fsm);
+}
+
+/****************************************************************************/
+
+/** Start clearing slave addresses.
+ */
+void ec_fsm_master_enter_clear_addresses(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    // broadcast clear all station addresses
+    ec_datagram_bwr(fsm->datagram, 0x0010, 2);
+    EC_WRITE_U16(fsm->datagram->data, 0x0000);
+    fsm->datagram->device_index = fsm->dev_idx;
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_master_state_clear_addresses;
+}
+
+/****************************************************************************/
+
+/** Master state: CLEAR ADDRESSES.
+ */
+void ec_fsm_master_state_clear_addresses(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram = fsm->datagram;
+
+    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        return;
+    }
+
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
+        EC_MASTER_ERR(master, "Failed to receive address"
+                " clearing datagram on %s link: ",
+                ec_device_names[fsm->dev_idx != 0]);
+        ec_datagram_print_state(datagram);
+        master->scan_busy = 0;
+        master->scan_index = master->slave_count;
+        wake_up_interruptible(&master->scan_queue);
+        ec_fsm_master_restart(fsm);
+        return;
+    }
+
+    if (datagram->working_counter != fsm->slaves_responding[fsm->dev_idx]) {
+        EC_MASTER_WARN(master, "Failed to clear station addresses on %s link:"
+                " Cleared %u of %u",
+                ec_device_names[fsm->dev_idx != 0], datagram->working_counter,
+                fsm->slaves_responding[fsm->dev_idx]);
+    }
+
+    EC_MASTER_DBG(master, 1, "Sending broadcast-write"
+            " to measure transmission delays on %s link.\n",
+            ec_device_names[fsm->dev_idx != 0]);
+
+    ec_datagram_bwr(datagram, 0x0900, 1);
+    ec_datagram_zero(datagram);
+    fsm->datagram->device_index = fsm->dev_idx;
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_master_state_dc_measure_delays;
+}
+
+/****************************************************************************/
+
+/** Master state: DC MEASURE DELAYS.
+ */
+void ec_fsm_master_state_dc_measure_delays(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram = fsm->datagram;
+    unsigned int i;
+
+    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        return;
+    }
+
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
+        EC_MASTER_ERR(master, "Failed to receive delay measuring datagram"
+                " on %s link: ", ec_device_names[fsm->dev_idx != 0]);
+        ec_datagram_print_state(datagram);
+        master->scan_busy = 0;
+        master->scan_index = master->slave_count;
+        wake_up_interruptible(&master->scan_queue);
+        ec_fsm_master_restart(fsm);
+        return;
+    }
+
+    EC_MASTER_DBG(master, 1, "%u slaves responded to delay measuring"
+            " on %s link.\n",
+            datagram->working_counter, ec_device_names[fsm->dev_idx != 0]);
+
+    do {
+        fsm->dev_idx++;
+    } while (fsm->dev_idx < ec_master_num_devices(master) &&
+            !fsm->slaves_responding[fsm->dev_idx]);
+    if (fsm->dev_idx < ec_master_num_devices(master)) {
+        ec_fsm_master_enter_clear_addresses(fsm);
+        return;
+    }
+
+    EC_MASTER_INFO(master, "Scanning bus.\n");
+
+    // begin scanning of slaves, fill all slots
+    fsm->slave = master->slaves;
+    master->scan_index = 0;
+    fsm->state = ec_fsm_master_state_scan_slave;
+    for (i = 0; i < EC_FSM_MASTER_SLOTS
+            && fsm->slave < master->slaves + master->slave_count; i++) {
+        ec_fsm_master_scan_start(fsm, &fsm->slots[i]);
+    }
+}
+
+/****************************************************************************/
+
+/** Starts scanning the next slave in a free slot.
+ */
+void ec_fsm_master_scan_start(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_slot_t *slot /**< Free scanning slot. */
+        )
+{
+    slot->slave = fsm->slave++;
+
+    EC_MASTER_DBG(fsm->master, 1, "Scanning slave %u on %s link.\n",
+            slot->slave->ring_position,
+            ec_device_names[slot->slave->device_index != 0]);
+
+    ec_fsm_slave_scan_start(&slot->fsm_slave_scan, slot->slave);
+    ec_fsm_slave_scan_exec(&slot->fsm_slave_scan); // execute immediately
+    slot->datagram.device_index = slot->slave->device_index;
+    slot->pending = 1;
+}
+
+/****************************************************************************/
+
+/** Master state: SCAN SLAVE.
+ *
+ * Executes the sub-statemachines of all scanning slots. Every slot, that
+ * becomes free, is used to scan the next slave. The slot datagrams are sent
+ * together, while the master datagram is not used in this state.
+ */
+void ec_fsm_master_state_scan_slave(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_fsm_master_slot_t *slot;
+    unsigned int i, busy = 0;
+#ifdef EC_EOE
+    ec_slave_t *slave;
+#endif
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        slot = &fsm->slots[i];
+        if (!slot->slave) {
+            continue;
+        }
+
+        if (slot->datagram.state == EC_DATAGRAM_SENT
+                || slot->datagram.state == EC_DATAGRAM_QUEUED) {
+            // datagram was not sent or received yet.
+            busy++;
+            continue;
+        }
+
+        if (ec_fsm_slave_scan_exec(&slot->fsm_slave_scan)) {
+            slot->pending = 1;
+            busy++;
+            continue;
+        }
+
+#ifdef EC_EOE
+        slave = slot->slave;
+        if (slave->sii.mailbox_protocols & EC_MBOX_EOE) {
+            // create EoE handler for this slave
+            ec_eoe_t *eoe;
+            if (!(eoe = kmalloc(sizeof(ec_eoe_t), GFP_KERNEL))) {
+                EC_SLAVE_ERR(slave, "Failed to allocate EoE handler"
+                        " memory!\n");
+            } else if (ec_eoe_init(eoe, slave)) {
+                EC_SLAVE_ERR(slave, "Failed to init EoE handler!\n");
+                kfree(eoe);
+            } else {
+                list_add_tail(&eoe->list, &master->eoe_handlers);
+            }
+        }
+#endif
+
+        slot->slave = NULL;
+        master->scan_index++;
+    }
+
+    // another slave to fetch?
+    for (i = 0; i < EC_FSM_MASTER_SLOTS
+            && fsm->slave < master->slaves + master->slave_count; i++) {
+        slot = &fsm->slots[i];
+        if (!slot->slave) {
+            ec_fsm_master_scan_start(fsm, slot);
+            busy++;
+        }
+    }
+
+    if (busy) {
+        return;
+    }
+
+    EC_MASTER_INFO(master, "Bus scanning completed in %lu ms.\n",
+            (jiffies - fsm->scan_jiffies) * 1000 / HZ);
+
+    master->scan_busy = 0;
+    master->scan_index = master->slave_count;
+    wake_up_interruptible(&master->scan_queue);
+
+    if (ec_snapshot_finish(&master->snapshot)) {
+        fsm->rescan_required = 1;
+        ec_fsm_master_restart(fsm);
+        return;
+    }
+
+    ec_master_calc_dc(master);
+
+    // Attach slave configurations
+    ec_master_attach_slave_configs(master);
+
+#ifdef EC_EOE
+    // check if EoE processing has to be started
+    ec_master_eoe_start(master);
+#endif
+
+    if (master->slave_count) {
+        // after a hot-connect, only the new slaves need system times
+        fsm->slave = master->slaves;
+        if (!master->config_changed) {
+            fsm->slave += fsm->hotplug_count;
+        }
+        master->config_changed = 0;
+
+        ec_fsm_master_enter_write_system_times(fsm);
+    } else {
+        ec_fsm_master_restart(fsm);
+    }
+}
+
+/****************************************************************************/
+
+/** Checks, if hot-connected slaves can be scanned incrementally.
+ *
+ * This is possible, if only the number of slaves responding on the last
+ * device with slaves increased, the other devices still see the known
+ * slaves and memory for the new slaves was reserved.
+ *
+ * Only slaves, that follow the known slaves in the processing order, can be
+ * scanned incrementally, because the known slave objects can not move. Slaves
+ * inserted in the middle of the line change the ring positions of known
+ * slaves, which is detected while verifying the station addresses, and cause
+ * a full rescan.
+ *
+ * \return Non-zero, if an incremental scan is possible.
+ */
+int ec_fsm_master_hotplug_possible(
+        const ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    unsigned int counts[EC_MAX_NUM_DEVICES] = {0}, added;
+    const ec_slave_t *slave;
+    ec_device_index_t dev_idx;
+
+    if (!master->slave_count) {
+        return 0;
+    }
+
+    for (slave = master->slaves;
+            slave < master->slaves + master->slave_count; slave++) {
+        counts[slave->device_index]++;
+    }
+
+    for (dev_idx = EC_DEVICE_MAIN;
+            dev_idx < ec_master_num_devices(master); dev_idx++) {
+        if (dev_idx == fsm->hotplug_dev_idx) {
+            continue;
+        }
+        if (counts[dev_idx] != fsm->slaves_responding[dev_idx]
+                || (dev_idx > fsm->hotplug_dev_idx && counts[dev_idx])) {
+            return 0;
+        }
+    }
+
+    dev_idx = fsm->hotplug_dev_idx;
+    if (!counts[dev_idx]
+            || counts[dev_idx] >= fsm->slaves_responding[dev_idx]) {
+        return 0;
+    }
+
+    added = fsm->slaves_responding[dev_idx] - counts[dev_idx];
+    if (master->slave_count + added > master->slave_capacity) {
+        EC_MASTER_DBG(master, 1, "No memory reserved for %u"
+                " hot-connected slaves.\n", added);
+        return 0;
+    }
+
+    return 1;
+}
+
+/****************************************************************************/
+
+/** Aborts an incremental scan and requests a full bus rescan instead.
+ */
+void ec_fsm_master_hotplug_fallback(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+
+    EC_MASTER_INFO(master, "Incremental scan not possible."
+            " Rescanning the bus.\n");
+
+    fsm->hotplug_count = 0;
+    master->scan_busy = 0;
+    master->scan_index = master->slave_count;
+    wake_up_interruptible(&master->scan_queue);
+
+#ifdef EC_EOE
+    ec_master_eoe_start(master);
+#endif
+
+    fsm->rescan_required = 1;
+    ec_fsm_master_restart(fsm);
+}
+
+/****************************************************************************/
+
+/** Starts an incremental scan of hot-connected slaves.
+ *
+ * The known slaves keep their configuration and continue exchanging process
+ * data. At first, their station addresses are verified at their ring
+ * positions, to make sure that the new slaves were connected behind them.
+ */
+void ec_fsm_master_enter_hotplug(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+
+    EC_MASTER_INFO(master, "Slaves hot-connected on %s link.\n",
+            ec_device_names[fsm->hotplug_dev_idx != 0]);
+
+    fsm->hotplug_count = master->slave_count;
+    fsm->hotplug_slave = NULL;
+
+#ifdef EC_EOE
+    // EoE handlers of new slaves are added to the list
+    ec_master_eoe_stop(master);
+#endif
+
+    fsm->slave = master->slaves;
+    ec_fsm_master_enter_hotplug_check(fsm);
+}
+
+/****************************************************************************/
+
+/** Verifies the station addresses of a batch of known slaves.
+ *
+ * If all known slaves are verified, the transmission delays are measured.
+ */
+void ec_fsm_master_enter_hotplug_check(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+
+    fsm->batch_count = 0;
+
+    for (slave = fsm->slave; slave < master->slaves + master->slave_count
+            && fsm->batch_count < EC_FSM_MASTER_BATCH_SIZE; slave++) {
+        if (slave->device_index != fsm->hotplug_dev_idx) {
+            continue;
+        }
+
+        datagram = ec_fsm_master_batch_datagram(fsm, fsm->batch_count);
+        ec_datagram_aprd(datagram, slave->ring_position, 0x0010, 2);
+        ec_datagram_zero(datagram);
+        datagram->device_index = slave->device_index;
+        fsm->batch_slaves[fsm->batch_count++] = slave;
+    }
+    fsm->slave = slave;
+
+    if (fsm->batch_count) {
+        fsm->batch_pending = fsm->batch_count - 1;
+        fsm->retries = EC_FSM_RETRIES;
+        fsm->state = ec_fsm_master_state_hotplug_check;
+        return;
+    }
+
+    EC_MASTER_DBG(master, 1, "Sending broadcast-write"
+            " to measure transmission delays on %s link.\n",
+            ec_device_names[fsm->hotplug_dev_idx != 0]);
+
+    ec_datagram_bwr(fsm->datagram, 0x0900, 1);
+    ec_datagram_zero(fsm->datagram);
+    fsm->datagram->device_index = fsm->hotplug_dev_idx;
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_master_state_hotplug_measure;
+}
+
+/****************************************************************************/
+
+/** Master state: HOTPLUG CHECK.
+ */
+void ec_fsm_master_state_hotplug_check(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+    unsigned int i;
+
+    if (ec_fsm_master_batch_retry(fsm)) {
+        return;
+    }
+
+    for (i = 0; i < fsm->batch_count; i++) {
+        datagram = ec_fsm_master_batch_datagram(fsm, i);
+        slave = fsm->batch_slaves[i];
+
+        if (datagram->state != EC_DATAGRAM_RECEIVED) {
+            EC_SLAVE_ERR(slave, "Failed to receive station address"
+                    " datagram: ");
+            ec_datagram_print_state(datagram);
+            ec_fsm_master_hotplug_fallback(fsm);
+            return;
+        }
+
+        if (datagram->working_counter != 1
+                || EC_READ_U16(datagram->data) != slave->station_address) {
+            EC_SLAVE_DBG(slave, 1, "Slave not found at its ring"
+                    " position.\n");
+            ec_fsm_master_hotplug_fallback(fsm);
+            return;
+        }
+    }
+
+    ec_fsm_master_enter_hotplug_check(fsm);
+}
+
+/****************************************************************************/
+
+/** Master state: HOTPLUG MEASURE.
+ */
+void ec_fsm_master_state_hotplug_measure(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram = fsm->datagram;
+
+    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+        return;
+    }
+
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
+        EC_MASTER_ERR(master, "Failed to receive delay measuring datagram"
+                " on %s link: ",
+                ec_device_names[fsm->hotplug_dev_idx != 0]);
+        ec_datagram_print_state(datagram);
+        ec_fsm_master_hotplug_fallback(fsm);
+        return;
+    }
+
+    EC_MASTER_DBG(master, 1, "%u slaves responded to delay measuring"
+            " on %s link.\n", datagram->working_counter,
+            ec_device_names[fsm->hotplug_dev_idx != 0]);
+
+    fsm->slave = master->slaves;
+    fsm->hotplug_step = 0;
+    ec_fsm_master_enter_hotplug_refresh(fsm);
+}
+
+/****************************************************************************/
+
+/** Reads the port information of a batch of known slaves.
+ *
+ * The new slaves changed the link states of the known slaves and the delay
+ * measurement latched new receive times, so the DL status (step 0) and the
+ * DC receive times (step 1) are read again. Afterwards, the new slaves are
+ * scanned.
+ */
+void ec_fsm_master_enter_hotplug_refresh(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+
+    fsm->batch_count = 0;
+
+    for (slave = fsm->slave; slave < master->slaves + master->slave_count
+            && fsm->batch_count < EC_FSM_MASTER_BATCH_SIZE; slave++) {
+        if (slave->device_index != fsm->hotplug_dev_idx
+                || (fsm->hotplug_step && !slave->base_dc_supported)) {
+            continue;
+        }
+
+        datagram = ec_fsm_master_batch_datagram(fsm, fsm->batch_count);
+        if (fsm->hotplug_step) {
+            ec_datagram_fprd(datagram, slave->station_address, 0x0900, 16);
+        } else {
+            ec_datagram_fprd(datagram, slave->station_address, 0x0110, 2);
+        }
+        ec_datagram_zero(datagram);
+        datagram->device_index = slave->device_index;
+        fsm->batch_slaves[fsm->batch_count++] = slave;
+    }
+    fsm->slave = slave;
+
+    if (fsm->batch_count) {
+        fsm->batch_pending = fsm->batch_count - 1;
+        fsm->retries = EC_FSM_RETRIES;
+        fsm->state = ec_fsm_master_state_hotplug_refresh;
+        return;
+    }
+
+    if (!fsm->hotplug_step) {
+        if (!fsm->hotplug_slave) {
+            EC_MASTER_DBG(master, 1, "No known slave got a new link.\n");
+            ec_fsm_master_hotplug_fallback(fsm);
+            return;
+        }
+
+        EC_SLAVE_INFO(fsm->hotplug_slave, "Slaves connected to port %u.\n",
+                fsm->hotplug_port);
+
+        // continue with the DC receive times
+        fsm->hotplug_step = 1;
+        fsm->slave = master->slaves;
+        ec_fsm_master_enter_hotplug_refresh(fsm);
+        return;
+    }
+
+    ec_fsm_master_hotplug_scan(fsm);
+}
+
+/****************************************************************************/
+
+/** Master state: HOTPLUG REFRESH.
+ */
+void ec_fsm_master_state_hotplug_refresh(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+    unsigned int i, j;
+
+    if (ec_fsm_master_batch_retry(fsm)) {
+        return;
+    }
+
+    for (i = 0; i < fsm->batch_count; i++) {
+        datagram = ec_fsm_master_batch_datagram(fsm, i);
+        slave = fsm->batch_slaves[i];
+
+        if (datagram->state != EC_DATAGRAM_RECEIVED) {
+            EC_SLAVE_ERR(slave, "Failed to receive port information"
+                    " datagram: ");
+            ec_datagram_print_state(datagram);
+            ec_fsm_master_hotplug_fallback(fsm);
+            return;
+        }
+
+        if (datagram->working_counter != 1) {
+            EC_SLAVE_ERR(slave, "Failed to read port information: ");
+            ec_datagram_print_wc_error(datagram);
+            ec_fsm_master_hotplug_fallback(fsm);
+            return;
+        }
+
+        if (fsm->hotplug_step) {
+            for (j = 0; j < EC_MAX_PORTS; j++) {
+                slave->ports[j].receive_time =
+                    EC_READ_U32(datagram->data + 4 * j);
+            }
+        } else if (ec_fsm_master_hotplug_dl_status(fsm, slave,
+                    EC_READ_U16(datagram->data))) {
+            ec_fsm_master_hotplug_fallback(fsm);
+            return;
+        }
+    }
+
+    ec_fsm_master_enter_hotplug_refresh(fsm);
+}
+
+/****************************************************************************/
+
+/** Updates the DL status of a known slave during an incremental scan.
+ *
+ * Locates the port, where the new segment was connected: Exactly one port
+ * of the known slaves must have got a link, and no port may have lost its
+ * link. Otherwise the topology changed elsewhere in the line. The port is
+ * only reported; the new slaves are always appended to the slave array.
+ *
+ * \return Zero, if the change is compatible with an incremental scan.
+ */
+int ec_fsm_master_hotplug_dl_status(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_slave_t *slave, /**< Known slave. */
+        uint16_t dl_status /**< Contents of the DL status register. */
+        )
+{
+    unsigned int i, link_up;
+
+    for (i = 0; i < EC_MAX_PORTS; i++) {
+        link_up = dl_status & (1 << (4 + i)) ? 1 : 0;
+
+        if (link_up == slave->ports[i].link.link_up) {
+            continue;
+        }
+
+        if (!link_up) {
+            EC_SLAVE_DBG(slave, 1, "Port %u lost its link.\n", i);
+            return -1;
+        }
+
+        if (fsm->hotplug_slave) {
+            EC_SLAVE_DBG(slave, 1, "Port %u got a link, too.\n", i);
+            return -1;
+        }
+
+        fsm->hotplug_slave = slave;
+        fsm->hotplug_port = i;
+    }
+
+    ec_slave_set_dl_status(slave, dl_status);
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Initializes the hot-connected slaves and starts scanning them.
+ *
+ * The new slaves are appended to the slave array, so that the known slave
+ * objects (and the configurations attached to them) stay valid.
+ */
+void ec_fsm_master_hotplug_scan(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_slave_t *slave;
+    unsigned int ring_position = 0, count = master->slave_count, i;
+
+    for (slave = master->slaves;
+            slave < master->slaves + master->slave_count; slave++) {
+        if (slave->device_index == fsm->hotplug_dev_idx) {
+            ring_position++;
+        }
+    }
+
+    while (ring_position < fsm->slaves_responding[fsm->hotplug_dev_idx]
+            && count < master->slave_capacity) {
+        slave = master->slaves + count;
+        ec_slave_init(slave, master, fsm->hotplug_dev_idx, ring_position++,
+                count + 1);
+
+        // do not force reconfiguration in operation phase to avoid
+        // unnecesssary process data interruptions
+        if (master->phase != EC_OPERATION) {
+            slave->force_config = 1;
+        }
+
+        count++;
+    }
+
+    /* Readers walk the slave array up to slave_count without locking, so
+     * the new slaves are published only after they are initialized. */
+    smp_wmb();
+    master->slave_count = count;
+
+    EC_MASTER_INFO(master, "Scanning %u hot-connected slave(s).\n",
+            master->slave_count - fsm->hotplug_count);
+
+    // begin scanning of the new slaves, fill all slots
+    fsm->slave = master->slaves + fsm->hotplug_count;
+    master->scan_index = fsm->hotplug_count;
+    fsm->state = ec_fsm_master_state_scan_slave;
+    for (i = 0; i < EC_FSM_MASTER_SLOTS
+            && fsm->slave < master->slaves + master->slave_count; i++) {
+        ec_fsm_master_scan_start(fsm, &fsm->slots[i]);
+    }
+}
+
+/****************************************************************************/
+
+/** Returns a free slot for a slave configuration.
+ *
+ * The number of parallel configurations is limited by the \a config_slots
+ * setting of the master.
+ *
+ * \return Free slot, or NULL if the limit is reached.
+ */
+ec_fsm_master_slot_t *ec_fsm_master_config_slot(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    unsigned int i;
+
+    if (fsm->master->config_busy >= fsm->master->config_slots) {
+        return NULL;
+    }
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        if (!fsm->slots[i].slave) {
+            return &fsm->slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
+/** Checks, if a slave is currently configured in one of the slots.
+ *
+ * \return Non-zero, if the slave is being configured.
+ */
+int ec_fsm_master_configuring(
+        const ec_fsm_master_t *fsm, /**< Master state machine. */
+        const ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        if (fsm->slots[i].configuring && fsm->slots[i].slave == slave) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Checks, if OP can be requested for all slaves at once.
+ *
+ * This is the case, if all slaves are connected to the main device, have
+ * no errors and shall go to OP.
+ *
+ * \return Non-zero, if a grouped transition to OP is possible.
+ */
+int ec_fsm_master_group_op_possible(
+        const ec_fsm_master_t *fsm, /**< Master state machine. */
+        int check_states /**< Additionally require, that every slave is
+                           either in OP or waits for the transition. */
+        )
+{
+    const ec_master_t *master = fsm->master;
+    const ec_slave_t *slave;
+
+    if (master->slave_count < 2) {
+        return 0;
+    }
+
+    for (slave = master->slaves;
+            slave < master->slaves + master->slave_count; slave++) {
+        if (slave->device_index != EC_DEVICE_MAIN
+                || slave->error_flag
+                || slave->requested_state != EC_SLAVE_STATE_OP) {
+            return 0;
+        }
+
+        if (check_states && !slave->op_deferred
+                && slave->current_state != EC_SLAVE_STATE_OP) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/****************************************************************************/
+
+/** Starts configuring the current slave in a free slot.
+ */
+void ec_fsm_master_config_start(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_slot_t *slot, /**< Free slot. */
+        int op_only /**< Only request OP (fallback of a grouped transition).
+                     */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_slave_t *slave = fsm->slave;
+
+    down(&master->config_sem);
+    master->config_busy++;
+    up(&master->config_sem);
+
+    if (master->debug_level) {
+        char old_state[EC_STATE_STRING_SIZE],
+             new_state[EC_STATE_STRING_SIZE];
+        ec_state_string(slave->current_state, old_state, 0);
+        ec_state_string(slave->requested_state, new_state, 0);
+        EC_SLAVE_DBG(slave, 1, "Changing state from %s to %s%s.\n",
+                old_state, new_state,
+                slave->force_config ? " (forced)" : "");
+    }
+
+    slot->slave = slave;
+    slot->configuring = 1;
+    if (op_only) {
+        ec_fsm_slave_config_start_op(&slot->fsm_slave_config, slave);
+    } else {
+        ec_fsm_slave_config_start(&slot->fsm_slave_config, slave);
+        slot->fsm_slave_config.defer_op =
+            ec_fsm_master_group_op_possible(fsm, 0);
+    }
+    if (ec_fsm_slave_config_exec(&slot->fsm_slave_config)) {
+        // execute immediately
+        slot->datagram.device_index = slave->device_index;
+        slot->pending = 1;
+    } else {
+        ec_fsm_master_config_finish(fsm, slot);
+    }
+}
+
+/****************************************************************************/
+
+/** Finishes the slave configuration of a slot and frees it.
+ */
+void ec_fsm_master_config_finish(
+        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_fsm_master_slot_t *slot /**< Slot with finished configuration. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_slave_t *slave = slot->slave;
+
+    slave->force_config = 0;
+
+    if (!ec_fsm_slave_config_success(&slot->fsm_slave_config)) {
+        // TODO: mark slave_config as failed.
+    } else if (slot->fsm_slave_config.defer_op
+            && slave->current_state == EC_SLAVE_STATE_SAFEOP
+            && slave->requested_state == EC_SLAVE_STATE_OP) {
+        // OP is requested later for all slaves at once
+        slave->op_deferred = 1;
+        fsm->op_deferred++;
     }
 
-    // slave has error flag set; process next one
-    ec_fsm_master_action_next_slave_state(fsm);
+    slot->slave = NULL;
+    slot->configuring = 0;
+
+    // configuration finished
+    down(&master->config_sem);
+    master->config_busy--;
+    up(&master->config_sem);
+    wake_up_interruptible(&master->config_queue);
 }
 
 /****************************************************************************/
 
-/** Master state: ACKNOWLEDGE.
+/** Executes the slave configurations of all slots.
+ *
+ * \return Non-zero, if slot datagrams have to be queued.
  */
-void ec_fsm_master_state_acknowledge(
+int ec_fsm_master_exec_config_slots(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    ec_slave_t *slave = fsm->slave;
+    ec_fsm_master_slot_t *slot;
+    unsigned int i;
+    int exec = 0;
 
-    if (ec_fsm_change_exec(&fsm->fsm_change)) {
-        return;
-    }
+    for (i = 0; i < EC_FSM_MASTER_SLOTS; i++) {
+        slot = &fsm->slots[i];
+        if (!slot->configuring) {
+            continue;
+        }
 
-    if (!ec_fsm_change_success(&fsm->fsm_change)) {
-        fsm->slave->error_flag = 1;
-        EC_SLAVE_ERR(slave, "Failed to acknowledge state change.\n");
+        if (slot->datagram.state == EC_DATAGRAM_SENT
+                || slot->datagram.state == EC_DATAGRAM_QUEUED) {
+            // datagram was not sent or received yet.
+            continue;
+        }
+
+        if (ec_fsm_slave_config_exec(&slot->fsm_slave_config)) {
+            slot->datagram.device_index = slot->slave->device_index;
+            slot->pending = 1;
+            exec = 1;
+        } else {
+            ec_fsm_master_config_finish(fsm, slot);
+        }
     }
 
-    ec_fsm_master_action_configure(fsm);
+    return exec;
 }
 
 /****************************************************************************/
 
-/** Start clearing slave addresses.
+/** Master state: CONFIGURE SLAVE.
+ *
+ * Waits for a free slot to configure the current slave.
  */
-void ec_fsm_master_enter_clear_addresses(
+void ec_fsm_master_state_configure_slave(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    // broadcast clear all station addresses
-    ec_datagram_bwr(fsm->datagram, 0x0010, 2);
-    EC_WRITE_U16(fsm->datagram->data, 0x0000);
-    fsm->datagram->device_index = fsm->dev_idx;
-    fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_master_state_clear_addresses;
+    ec_fsm_master_slot_t *slot = ec_fsm_master_config_slot(fsm);
+
+    if (!slot) {
+        return;
+    }
+
+    ec_fsm_master_config_start(fsm, slot, 0);
+    ec_fsm_master_action_next_slave_state(fsm);
 }
 
 /****************************************************************************/
 
-/** Master state: CLEAR ADDRESSES.
+/** Master state: CONFIGURE WAIT.
+ *
+ * Waits for all slave configurations to finish, before doing secondary
+ * work.
  */
-void ec_fsm_master_state_clear_addresses(
+void ec_fsm_master_state_configure_wait(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    ec_master_t *master = fsm->master;
-    ec_datagram_t *datagram = fsm->datagram;
+    if (fsm->master->config_busy) {
+        return;
+    }
 
-    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
+    if (fsm->op_deferred) {
+        ec_fsm_master_enter_group_op(fsm);
         return;
     }
 
-    if (datagram->state != EC_DATAGRAM_RECEIVED) {
-        EC_MASTER_ERR(master, "Failed to receive address"
-                " clearing datagram on %s link: ",
-                ec_device_names[fsm->dev_idx != 0]);
-        ec_datagram_print_state(datagram);
-        master->scan_busy = 0;
-        master->scan_index = master->slave_count;
-        wake_up_interruptible(&master->scan_queue);
-        ec_fsm_master_restart(fsm);
+    fsm->idle = 1;
+    ec_fsm_master_action_idle(fsm);
+}
+
+/****************************************************************************/
+
+/** Start the grouped transition to OP.
+ *
+ * Instead of requesting OP from every slave, the AL control register of all
+ * slaves is written with a single broadcast and the AL states are polled
+ * with a broadcast read.
+ */
+void ec_fsm_master_enter_group_op(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    ec_master_t *master = fsm->master;
+    ec_slave_t *slave;
+    unsigned int timeout_ms;
+
+    if (!ec_fsm_master_group_op_possible(fsm, 1)) {
+        EC_MASTER_DBG(master, 1, "Grouped transition to OP not possible"
+                " any more.\n");
+        ec_fsm_master_enter_group_op_fallback(fsm);
         return;
     }
 
-    if (datagram->working_counter != fsm->slaves_responding[fsm->dev_idx]) {
-        EC_MASTER_WARN(master, "Failed to clear station addresses on %s link:"
-                " Cleared %u of %u",
-                ec_device_names[fsm->dev_idx != 0], datagram->working_counter,
-                fsm->slaves_responding[fsm->dev_idx]);
+    // use the longest SAFEOP -> OP timeout of all slaves
+    fsm->group_timeout_ms = 10000; // SafeopOpTimeout
+    for (slave = master->slaves;
+            slave < master->slaves + master->slave_count; slave++) {
+        if (!slave->config) {
+            continue;
+        }
+        timeout_ms = ec_slave_config_al_timeout(slave->config,
+                EC_SLAVE_STATE_SAFEOP, EC_SLAVE_STATE_OP);
+        if (timeout_ms > fsm->group_timeout_ms) {
+            fsm->group_timeout_ms = timeout_ms;
+        }
     }
 
-    EC_MASTER_DBG(master, 1, "Sending broadcast-write"
-            " to measure transmission delays on %s link.\n",
-            ec_device_names[fsm->dev_idx != 0]);
+    EC_MASTER_DBG(master, 1, "Requesting OP for %u slaves at once.\n",
+            fsm->op_deferred);
 
-    ec_datagram_bwr(datagram, 0x0900, 1);
-    ec_datagram_zero(datagram);
-    fsm->datagram->device_index = fsm->dev_idx;
+    ec_datagram_bwr(fsm->datagram, 0x0120, 2);
+    EC_WRITE_U16(fsm->datagram->data, EC_SLAVE_STATE_OP);
+    fsm->datagram->device_index = EC_DEVICE_MAIN;
     fsm->retries = EC_FSM_RETRIES;
-    fsm->state = ec_fsm_master_state_dc_measure_delays;
+    fsm->idle = 0;
+    fsm->state = ec_fsm_master_state_group_op_request;
 }
 
 /****************************************************************************/
 
-/** Master state: DC MEASURE DELAYS.
+/** Master state: GROUP OP REQUEST.
  */
-void ec_fsm_master_state_dc_measure_delays(
+void ec_fsm_master_state_group_op_request(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
@@ -896,174 +2486,198 @@ void ec_fsm_master_state_dc_measure_delays(
     }
 
     if (datagram->state != EC_DATAGRAM_RECEIVED) {
-        EC_MASTER_ERR(master, "Failed to receive delay measuring datagram"
-                " on %s link: ", ec_device_names[fsm->dev_idx != 0]);
+        EC_MASTER_WARN(master, "Failed to receive grouped OP request"
+                " datagram: ");
         ec_datagram_print_state(datagram);
-        master->scan_busy = 0;
-        master->scan_index = master->slave_count;
-        wake_up_interruptible(&master->scan_queue);
-        ec_fsm_master_restart(fsm);
+        ec_fsm_master_enter_group_op_fallback(fsm);
         return;
     }
 
-    EC_MASTER_DBG(master, 1, "%u slaves responded to delay measuring"
-            " on %s link.\n",
-            datagram->working_counter, ec_device_names[fsm->dev_idx != 0]);
-
-    do {
-        fsm->dev_idx++;
-    } while (fsm->dev_idx < ec_master_num_devices(master) &&
-            !fsm->slaves_responding[fsm->dev_idx]);
-    if (fsm->dev_idx < ec_master_num_devices(master)) {
-        ec_fsm_master_enter_clear_addresses(fsm);
+    if (datagram->working_counter != master->slave_count) {
+        EC_MASTER_WARN(master, "Grouped OP request reached %u of %u"
+                " slaves.\n", datagram->working_counter,
+                master->slave_count);
+        ec_fsm_master_enter_group_op_fallback(fsm);
         return;
     }
 
-    EC_MASTER_INFO(master, "Scanning bus.\n");
+    fsm->group_jiffies = datagram->jiffies_sent;
 
-    // begin scanning of slaves
-    fsm->slave = master->slaves;
-    master->scan_index = 0;
-    EC_MASTER_DBG(master, 1, "Scanning slave %u on %s link.\n",
-            fsm->slave->ring_position,
-            ec_device_names[fsm->slave->device_index != 0]);
-    fsm->state = ec_fsm_master_state_scan_slave;
-    ec_fsm_slave_scan_start(&fsm->fsm_slave_scan, fsm->slave);
-    ec_fsm_slave_scan_exec(&fsm->fsm_slave_scan); // execute immediately
-    fsm->datagram->device_index = fsm->slave->device_index;
+    ec_datagram_brd(datagram, 0x0130, 2);
+    ec_datagram_zero(datagram);
+    datagram->device_index = EC_DEVICE_MAIN;
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_master_state_group_op_check;
 }
 
 /****************************************************************************/
 
-/** Master state: SCAN SLAVE.
+/** Master state: GROUP OP CHECK.
  *
- * Executes the sub-statemachine for the scanning of a slave.
+ * The broadcast read delivers the bitwise OR of all AL states, so all
+ * slaves are in OP, if exactly the OP bit is set.
  */
-void ec_fsm_master_state_scan_slave(
+void ec_fsm_master_state_group_op_check(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
     ec_master_t *master = fsm->master;
-#ifdef EC_EOE
-    ec_slave_t *slave = fsm->slave;
-#endif
+    ec_datagram_t *datagram = fsm->datagram;
+    ec_slave_t *slave;
+    uint8_t states;
 
-    if (ec_fsm_slave_scan_exec(&fsm->fsm_slave_scan)) {
+    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--) {
         return;
     }
 
-#ifdef EC_EOE
-    if (slave->sii.mailbox_protocols & EC_MBOX_EOE) {
-        // create EoE handler for this slave
-        ec_eoe_t *eoe;
-        if (!(eoe = kmalloc(sizeof(ec_eoe_t), GFP_KERNEL))) {
-            EC_SLAVE_ERR(slave, "Failed to allocate EoE handler memory!\n");
-        } else if (ec_eoe_init(eoe, slave)) {
-            EC_SLAVE_ERR(slave, "Failed to init EoE handler!\n");
-            kfree(eoe);
-        } else {
-            list_add_tail(&eoe->list, &master->eoe_handlers);
-        }
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
+        EC_MASTER_WARN(master, "Failed to receive grouped AL state"
+                " datagram: ");
+        ec_datagram_print_state(datagram);
+        ec_fsm_master_enter_group_op_fallback(fsm);
+        return;
     }
-#endif
 
-    // another slave to fetch?
-    fsm->slave++;
-    master->scan_index++;
-    if (fsm->slave < master->slaves + master->slave_count) {
-        EC_MASTER_DBG(master, 1, "Scanning slave %u on %s link.\n",
-                fsm->slave->ring_position,
-                ec_device_names[fsm->slave->device_index != 0]);
-        ec_fsm_slave_scan_start(&fsm->fsm_slave_scan, fsm->slave);
-        ec_fsm_slave_scan_exec(&fsm->fsm_slave_scan); // execute immediately
-        fsm->datagram->device_index = fsm->slave->device_index;
+    if (datagram->working_counter != master->slave_count) {
+        EC_MASTER_WARN(master, "Grouped AL state read reached %u of %u"
+                " slaves.\n", datagram->working_counter,
+                master->slave_count);
+        ec_fsm_master_enter_group_op_fallback(fsm);
         return;
     }
 
-    EC_MASTER_INFO(master, "Bus scanning completed in %lu ms.\n",
-            (jiffies - fsm->scan_jiffies) * 1000 / HZ);
-
-    master->scan_busy = 0;
-    master->scan_index = master->slave_count;
-    wake_up_interruptible(&master->scan_queue);
+    states = EC_READ_U8(datagram->data);
 
-    ec_master_calc_dc(master);
+    if (states == EC_SLAVE_STATE_OP) {
+        EC_MASTER_DBG(master, 1, "%u slaves in OP after %lu ms.\n",
+                fsm->op_deferred,
+                (datagram->jiffies_received - fsm->group_jiffies)
+                * 1000 / HZ);
 
-    // Attach slave configurations
-    ec_master_attach_slave_configs(master);
+        for (slave = master->slaves;
+                slave < master->slaves + master->slave_count; slave++) {
+            if (slave->op_deferred) {
+                ec_slave_set_state(slave, EC_SLAVE_STATE_OP);
+                slave->op_deferred = 0;
+            }
+        }
+        fsm->op_deferred = 0;
 
-#ifdef EC_EOE
-    // check if EoE processing has to be started
-    ec_master_eoe_start(master);
-#endif
+        fsm->idle = 1;
+        ec_fsm_master_action_idle(fsm);
+        return;
+    }
 
-    if (master->slave_count) {
-        master->config_changed = 0;
+    if (states & EC_SLAVE_STATE_ACK_ERR) {
+        EC_MASTER_WARN(master, "Error during grouped transition to OP.\n");
+        ec_fsm_master_enter_group_op_fallback(fsm);
+        return;
+    }
 
-        fsm->slave = master->slaves; // begin with first slave
-        ec_fsm_master_enter_write_system_times(fsm);
-    } else {
-        ec_fsm_master_restart(fsm);
+    if ((datagram->jiffies_received - fsm->group_jiffies) * 1000 / HZ
+            >= fsm->group_timeout_ms) {
+        EC_MASTER_WARN(master, "Timeout after %u ms during grouped"
+                " transition to OP.\n", fsm->group_timeout_ms);
+        ec_fsm_master_enter_group_op_fallback(fsm);
+        return;
     }
+
+    // check again
+    ec_datagram_brd(datagram, 0x0130, 2);
+    ec_datagram_zero(datagram);
+    datagram->device_index = EC_DEVICE_MAIN;
+    fsm->retries = EC_FSM_RETRIES;
 }
 
 /****************************************************************************/
 
-/** Master state: CONFIGURE SLAVE.
+/** Start requesting OP from every waiting slave individually.
+ */
+void ec_fsm_master_enter_group_op_fallback(
+        ec_fsm_master_t *fsm /**< Master state machine. */
+        )
+{
+    EC_MASTER_DBG(fsm->master, 1, "Requesting OP for every slave"
+            " individually.\n");
+
+    fsm->slave = fsm->master->slaves;
+    fsm->idle = 0;
+    fsm->state = ec_fsm_master_state_group_op_fallback;
+    fsm->state(fsm); // execute immediately
+}
+
+/****************************************************************************/
+
+/** Master state: GROUP OP FALLBACK.
  *
- * Starts configuring a slave.
+ * Hands the waiting slaves to the configuration slots, that bring them to OP
+ * with the per-slave state change state machine.
  */
-void ec_fsm_master_state_configure_slave(
+void ec_fsm_master_state_group_op_fallback(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
     ec_master_t *master = fsm->master;
+    ec_fsm_master_slot_t *slot;
 
-    if (ec_fsm_slave_config_exec(&fsm->fsm_slave_config)) {
-        return;
-    }
-
-    fsm->slave->force_config = 0;
+    for (; fsm->slave < master->slaves + master->slave_count;
+            fsm->slave++) {
+        if (!fsm->slave->op_deferred) {
+            continue;
+        }
 
-    // configuration finished
-    master->config_busy = 0;
-    wake_up_interruptible(&master->config_queue);
+        if (!(slot = ec_fsm_master_config_slot(fsm))) {
+            return; // wait for a free slot
+        }
 
-    if (!ec_fsm_slave_config_success(&fsm->fsm_slave_config)) {
-        // TODO: mark slave_config as failed.
+        fsm->slave->op_deferred = 0;
+        fsm->op_deferred--;
+        ec_fsm_master_config_start(fsm, slot, 1);
     }
 
-    fsm->idle = 1;
-    ec_fsm_master_action_next_slave_state(fsm);
+    fsm->state = ec_fsm_master_state_configure_wait;
 }
 
 /****************************************************************************/
 
 /** Start writing DC system times.
+ *
+ * The system times of up to EC_FSM_MASTER_BATCH_SIZE slaves, beginning with
+ * the current one, are read in the same cycle.
  */
 void ec_fsm_master_enter_write_system_times(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
     ec_master_t *master = fsm->master;
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
 
     if (master->dc_ref_time) {
 
-        while (fsm->slave < master->slaves + master->slave_count) {
-            if (!fsm->slave->base_dc_supported
-                    || !fsm->slave->has_dc_system_time) {
-                fsm->slave++;
+        fsm->batch_count = 0;
+
+        while (fsm->slave < master->slaves + master->slave_count
+                && fsm->batch_count < EC_FSM_MASTER_BATCH_SIZE) {
+            slave = fsm->slave++;
+
+            if (!slave->base_dc_supported || !slave->has_dc_system_time) {
                 continue;
             }
 
-            EC_SLAVE_DBG(fsm->slave, 1, "Checking system time offset.\n");
+            EC_SLAVE_DBG(slave, 1, "Checking system time offset.\n");
 
             // read DC system time (0x0910, 64 bit)
             //                         gap (64 bit)
             //     and time offset (0x0920, 64 bit)
-            ec_datagram_fprd(fsm->datagram, fsm->slave->station_address,
-                    0x0910, 24);
-            fsm->datagram->device_index = fsm->slave->device_index;
+            datagram = ec_fsm_master_batch_datagram(fsm, fsm->batch_count);
+            ec_datagram_fprd(datagram, slave->station_address, 0x0910, 24);
+            datagram->device_index = slave->device_index;
+            fsm->batch_slaves[fsm->batch_count++] = slave;
+        }
+
+        if (fsm->batch_count) {
+            fsm->batch_pending = fsm->batch_count - 1;
             fsm->retries = EC_FSM_RETRIES;
             fsm->state = ec_fsm_master_state_dc_read_offset;
             return;
@@ -1090,13 +2704,12 @@ void ec_fsm_master_enter_write_system_times(
  * \return New offset.
  */
 u64 ec_fsm_master_dc_offset32(
-        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_slave_t *slave, /**< EtherCAT slave. */
         u64 system_time, /**< System time register. */
         u64 old_offset, /**< Time offset register. */
         unsigned long jiffies_since_read /**< Jiffies for correction. */
         )
 {
-    ec_slave_t *slave = fsm->slave;
     u32 correction, system_time32, old_offset32, new_offset;
     s32 time_diff;
 
@@ -1132,20 +2745,19 @@ u64 ec_fsm_master_dc_offset32(
  * \return New offset.
  */
 u64 ec_fsm_master_dc_offset64(
-        ec_fsm_master_t *fsm, /**< Master state machine. */
+        ec_slave_t *slave, /**< EtherCAT slave. */
         u64 system_time, /**< System time register. */
         u64 old_offset, /**< Time offset register. */
         unsigned long jiffies_since_read /**< Jiffies for correction. */
         )
 {
-    ec_slave_t *slave = fsm->slave;
     u64 new_offset, correction;
     s64 time_diff;
 
     // correct read system time by elapsed time since read operation
     correction = (u64) (jiffies_since_read * 1000 / HZ) * 1000000;
     system_time += correction;
-    time_diff = fsm->slave->master->app_time - system_time;
+    time_diff = slave->master->app_time - system_time;
 
     EC_SLAVE_DBG(slave, 1, "DC 64 bit system time offset calculation:"
             " system_time=%llu (corrected with %llu),"
@@ -1168,52 +2780,69 @@ u64 ec_fsm_master_dc_offset64(
 /****************************************************************************/
 
 /** Master state: DC READ OFFSET.
+ *
+ * Evaluates the system times of a batch of slaves and writes the new
+ * offsets of all slaves, that responded.
  */
 void ec_fsm_master_state_dc_read_offset(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    ec_datagram_t *datagram = fsm->datagram;
-    ec_slave_t *slave = fsm->slave;
+    ec_datagram_t *datagram, *write_datagram;
+    ec_slave_t *slave;
     u64 system_time, old_offset, new_offset;
     unsigned long jiffies_since_read;
+    unsigned int i, count = 0;
 
-    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--)
+    if (ec_fsm_master_batch_retry(fsm)) {
         return;
+    }
 
-    if (datagram->state != EC_DATAGRAM_RECEIVED) {
-        EC_SLAVE_ERR(slave, "Failed to receive DC times datagram: ");
-        ec_datagram_print_state(datagram);
-        fsm->slave++;
-        ec_fsm_master_enter_write_system_times(fsm);
-        return;
+    for (i = 0; i < fsm->batch_count; i++) {
+        datagram = ec_fsm_master_batch_datagram(fsm, i);
+        slave = fsm->batch_slaves[i];
+
+        if (datagram->state != EC_DATAGRAM_RECEIVED) {
+            EC_SLAVE_ERR(slave, "Failed to receive DC times datagram: ");
+            ec_datagram_print_state(datagram);
+            continue;
+        }
+
+        if (datagram->working_counter != 1) {
+            EC_SLAVE_WARN(slave, "Failed to get DC times: ");
+            ec_datagram_print_wc_error(datagram);
+            continue;
+        }
+
+        system_time = EC_READ_U64(datagram->data);     // 0x0910
+        old_offset = EC_READ_U64(datagram->data + 16); // 0x0920
+        jiffies_since_read = jiffies - datagram->jiffies_sent;
+
+        if (slave->base_dc_range == EC_DC_32) {
+            new_offset = ec_fsm_master_dc_offset32(slave,
+                    system_time, old_offset, jiffies_since_read);
+        } else {
+            new_offset = ec_fsm_master_dc_offset64(slave,
+                    system_time, old_offset, jiffies_since_read);
+        }
+
+        // set DC system time offset and transmission delay; the write
+        // datagram index never exceeds the one of the evaluated datagram
+        write_datagram = ec_fsm_master_batch_datagram(fsm, count);
+        ec_datagram_fpwr(write_datagram, slave->station_address, 0x0920, 12);
+        EC_WRITE_U64(write_datagram->data, new_offset);
+        EC_WRITE_U32(write_datagram->data + 8, slave->transmission_delay);
+        write_datagram->device_index = slave->device_index;
+        fsm->batch_slaves[count++] = slave;
     }
 
-    if (datagram->working_counter != 1) {
-        EC_SLAVE_WARN(slave, "Failed to get DC times: ");
-        ec_datagram_print_wc_error(datagram);
-        fsm->slave++;
+    if (!count) {
         ec_fsm_master_enter_write_system_times(fsm);
         return;
     }
 
-    system_time = EC_READ_U64(datagram->data);     // 0x0910
-    old_offset = EC_READ_U64(datagram->data + 16); // 0x0920
-    jiffies_since_read = jiffies - datagram->jiffies_sent;
-
-    if (slave->base_dc_range == EC_DC_32) {
-        new_offset = ec_fsm_master_dc_offset32(fsm,
-                system_time, old_offset, jiffies_since_read);
-    } else {
-        new_offset = ec_fsm_master_dc_offset64(fsm,
-                system_time, old_offset, jiffies_since_read);
-    }
-
-    // set DC system time offset and transmission delay
-    ec_datagram_fpwr(datagram, slave->station_address, 0x0920, 12);
-    EC_WRITE_U64(datagram->data, new_offset);
-    EC_WRITE_U32(datagram->data + 8, slave->transmission_delay);
-    fsm->datagram->device_index = slave->device_index;
+    fsm->batch_count = count;
+    fsm->batch_pending = count - 1;
     fsm->retries = EC_FSM_RETRIES;
     fsm->state = ec_fsm_master_state_dc_write_offset;
 }
@@ -1226,30 +2855,31 @@ void ec_fsm_master_state_dc_write_offset(
         ec_fsm_master_t *fsm /**< Master state machine. */
         )
 {
-    ec_datagram_t *datagram = fsm->datagram;
-    ec_slave_t *slave = fsm->slave;
-
-    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--)
-        return;
+    ec_datagram_t *datagram;
+    ec_slave_t *slave;
+    unsigned int i;
 
-    if (datagram->state != EC_DATAGRAM_RECEIVED) {
-        EC_SLAVE_ERR(slave,
-                "Failed to receive DC system time offset datagram: ");
-        ec_datagram_print_state(datagram);
-        fsm->slave++;
-        ec_fsm_master_enter_write_system_times(fsm);
+    if (ec_fsm_master_batch_retry(fsm)) {
         return;
     }
 
-    if (datagram->working_counter != 1) {
-        EC_SLAVE_ERR(slave, "Failed to set DC system time offset: ");
-        ec_datagram_print_wc_error(datagram);
-        fsm->slave++;
-        ec_fsm_master_enter_write_system_times(fsm);
-        return;
+    for (i = 0; i < fsm->batch_count; i++) {
+        datagram = ec_fsm_master_batch_datagram(fsm, i);
+        slave = fsm->batch_slaves[i];
+
+        if (datagram->state != EC_DATAGRAM_RECEIVED) {
+            EC_SLAVE_ERR(slave,
+                    "Failed to receive DC system time offset datagram: ");
+            ec_datagram_print_state(datagram);
+            continue;
+        }
+
+        if (datagram->working_counter != 1) {
+            EC_SLAVE_ERR(slave, "Failed to set DC system time offset: ");
+            ec_datagram_print_wc_error(datagram);
+        }
     }
 
-    fsm->slave++;
     ec_fsm_master_enter_write_system_times(fsm);
 }
 
@@ -1326,6 +2956,15 @@ void ec_fsm_master_state_write_sii(
     EC_SLAVE_DBG(slave, 1, "Finished writing %zu words of SII data.\n",
             request->nwords);
 
+#ifdef EC_SII_CACHE
+    if (slave->sii_words
+            && slave->sii_nwords >= EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS) {
+        // cached image is outdated
+        ec_sii_cache_invalidate(&master->sii_cache,
+                slave->sii_words + EC_SII_IDENT_OFFSET);
+    }
+#endif
+
     if (request->offset <= 4 && request->offset + request->nwords > 4) {
         // alias was written
         slave->sii.alias = EC_READ_U16(request->words + 4);
@@ -1360,11 +2999,13 @@ void ec_fsm_master_state_sdo_dictionary(
     }
 
     if (!ec_fsm_coe_success(&fsm->fsm_coe)) {
+        // keep the partial dictionary, but do not share it
         ec_fsm_master_restart(fsm);
         return;
     }
 
     // SDO dictionary fetching finished
+    ec_sdo_cache_store(&master->sdo_cache, slave->sdo_dict);
 
     if (master->debug_level) {
         unsigned int sdo_count, entry_count;
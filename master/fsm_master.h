@@ -53,6 +53,45 @@ typedef struct {
 
 /****************************************************************************/
 
+/** Maximum number of slaves, that are scanned or configured in parallel.
+ */
+#define EC_FSM_MASTER_SLOTS 16
+
+/** Slot for scanning or configuring a slave in parallel to others.
+ *
+ * Every slot has its own datagram and sub state machines, so that the
+ * datagrams of all slots can be sent in the same frame. Scanning and
+ * configuration never overlap, so the slots are shared.
+ */
+typedef struct {
+    ec_slave_t *slave; /**< Slave being scanned or configured, or NULL if
+                         unused. */
+    ec_datagram_t datagram; /**< Datagram used by the slot. */
+    unsigned int pending; /**< The datagram has to be queued. */
+    unsigned int configuring; /**< The slot runs a slave configuration. */
+
+    ec_fsm_coe_t fsm_coe; /**< CoE state machine */
+    ec_fsm_soe_t fsm_soe; /**< SoE state machine */
+    ec_fsm_pdo_t fsm_pdo; /**< PDO configuration state machine. */
+    ec_fsm_eoe_t fsm_eoe; /**< EoE state machine */
+    ec_fsm_change_t fsm_change; /**< State change state machine */
+    ec_fsm_slave_config_t fsm_slave_config; /**< slave state machine */
+    ec_fsm_slave_scan_t fsm_slave_scan; /**< slave state machine */
+} ec_fsm_master_slot_t;
+
+/** Maximum number of datagrams, that the master state machine sends in one
+ * cycle to access several slaves at once.
+ */
+#define EC_FSM_MASTER_BATCH_SIZE 16
+
+/** Default number of slaves, for that memory is reserved on a bus scan, so
+ * that they can be hot-connected at the end of the bus without a full
+ * rescan.
+ */
+#define EC_HOTPLUG_SLAVES 16
+
+/****************************************************************************/
+
 typedef struct ec_fsm_master ec_fsm_master_t; /**< \see ec_fsm_master */
 
 /** Finite state machine of an EtherCAT master.
@@ -61,6 +100,7 @@ struct ec_fsm_master {
     ec_master_t *master; /**< master the FSM runs on */
     ec_datagram_t *datagram; /**< datagram used in the state machine */
     unsigned int retries; /**< retries on datagram timeout. */
+    unsigned int datagram_pending; /**< The datagram has to be queued. */
 
     void (*state)(ec_fsm_master_t *); /**< master state function */
     ec_device_index_t dev_idx; /**< Current device index (for scanning etc.).
@@ -73,6 +113,16 @@ struct ec_fsm_master {
                                                           responding slaves
                                                           for every device. */
     unsigned int rescan_required; /**< A bus rescan is required. */
+    unsigned int hotplug; /**< The last topology change only increased the
+                            number of responding slaves on one device. */
+    ec_device_index_t hotplug_dev_idx; /**< Device with the hot-connected
+                                         slaves. */
+    unsigned int hotplug_count; /**< Number of slaves before the
+                                  hot-connect. */
+    unsigned int hotplug_step; /**< Register block being refreshed. */
+    ec_slave_t *hotplug_slave; /**< Known slave, whose port got a link to
+                                 the hot-connected slaves. */
+    unsigned int hotplug_port; /**< Port of \a hotplug_slave. */
     ec_slave_state_t slave_states[EC_MAX_NUM_DEVICES]; /**< AL states of
                                                          responding slaves for
                                                          every device. */
@@ -81,25 +131,48 @@ struct ec_fsm_master {
     off_t sii_index; /**< index to SII write request data */
     ec_sdo_request_t *sdo_request; /**< SDO request to process. */
     ec_soe_request_t *soe_request; /**< SoE request to process. */
+    unsigned int diag_domain_index; /**< Index of the domain, whose working
+                                      counter is diagnosed. */
+    unsigned int diag_fmmu_pos; /**< Position of the FMMU configuration
+                                  being diagnosed. */
+    unsigned int diag_step; /**< Register block being read. */
+    unsigned int op_deferred; /**< Number of slaves waiting in SAFEOP for a
+                                grouped transition to OP. */
+    unsigned long group_jiffies; /**< Start of the grouped transition. */
+    unsigned int group_timeout_ms; /**< Timeout of the grouped transition.
+                                    */
 
     ec_fsm_coe_t fsm_coe; /**< CoE state machine */
     ec_fsm_soe_t fsm_soe; /**< SoE state machine */
     ec_fsm_pdo_t fsm_pdo; /**< PDO configuration state machine. */
     ec_fsm_eoe_t fsm_eoe; /**< EoE state machine */
     ec_fsm_change_t fsm_change; /**< State change state machine */
-    ec_fsm_slave_config_t fsm_slave_config; /**< slave state machine */
-    ec_fsm_slave_scan_t fsm_slave_scan; /**< slave state machine */
     ec_fsm_sii_t fsm_sii; /**< SII state machine */
+
+    ec_datagram_t batch_datagrams[EC_FSM_MASTER_BATCH_SIZE - 1]; /**<
+                                  Additional datagrams of a batch. The first
+                                  datagram of a batch is \a datagram. */
+    ec_slave_t *batch_slaves[EC_FSM_MASTER_BATCH_SIZE]; /**< Slaves accessed
+                                                          by the batch. */
+    unsigned int batch_count; /**< Number of datagrams in the batch. */
+    unsigned int batch_index; /**< Batch entry being processed. */
+    unsigned int batch_pending; /**< Number of additional batch datagrams
+                                  to queue. */
+
+    ec_fsm_master_slot_t slots[EC_FSM_MASTER_SLOTS]; /**< Parallel scanning
+                                                       and configuration
+                                                       slots. */
 };
 
 /****************************************************************************/
 
-void ec_fsm_master_init(ec_fsm_master_t *, ec_master_t *, ec_datagram_t *);
+int ec_fsm_master_init(ec_fsm_master_t *, ec_master_t *, ec_datagram_t *);
 void ec_fsm_master_clear(ec_fsm_master_t *);
 
 void ec_fsm_master_reset(ec_fsm_master_t *);
 
 int ec_fsm_master_exec(ec_fsm_master_t *);
+void ec_fsm_master_queue_datagrams(ec_fsm_master_t *);
 int ec_fsm_master_idle(const ec_fsm_master_t *);
 
 /****************************************************************************/
@@ -135,6 +135,12 @@ void ec_fsm_pdo_start_configuration(
         )
 {
     fsm->slave = slave;
+    fsm->conf_valid = slave->pdo_conf_valid;
+    fsm->conf_failed = 0;
+
+    // until the whole configuration has been written successfully, the
+    // slave's PDO configuration is unknown
+    slave->pdo_conf_valid = 0;
     fsm->state = ec_fsm_pdo_conf_state_start;
 }
 
@@ -457,6 +463,8 @@ void ec_fsm_pdo_conf_action_next_sync(
         return;
     }
 
+    // the slave's PDO configuration is known until something resets it
+    fsm->slave->pdo_conf_valid = !fsm->conf_failed;
     fsm->state = ec_fsm_pdo_state_end;
 }
 
@@ -533,7 +541,15 @@ void ec_fsm_pdo_conf_action_check_mapping(
             && fsm->slave->sii.has_general
             && fsm->slave->sii.coe_details.enable_pdo_configuration) {
 
-        // always write PDO mapping
+        if (fsm->conf_valid
+                && ec_pdo_equal_entries(fsm->pdo, &fsm->slave_pdo)) {
+            EC_SLAVE_DBG(fsm->slave, 1, "Mapping of PDO 0x%04X"
+                    " unchanged.\n", fsm->pdo->index);
+            ec_fsm_pdo_conf_action_next_pdo_mapping(fsm, datagram);
+            return;
+        }
+
+        // write PDO mapping
         ec_fsm_pdo_entry_start_configuration(&fsm->fsm_pdo_entry, fsm->slave,
                 fsm->pdo, &fsm->slave_pdo);
         fsm->state = ec_fsm_pdo_conf_state_mapping;
@@ -567,10 +583,12 @@ void ec_fsm_pdo_conf_state_mapping(
         return;
     }
 
-    if (!ec_fsm_pdo_entry_success(&fsm->fsm_pdo_entry))
+    if (!ec_fsm_pdo_entry_success(&fsm->fsm_pdo_entry)) {
         EC_SLAVE_WARN(fsm->slave,
                 "Failed to configure mapping of PDO 0x%04X.\n",
                 fsm->pdo->index);
+        fsm->conf_failed = 1;
+    }
 
     ec_fsm_pdo_conf_action_next_pdo_mapping(fsm, datagram);
 }
@@ -607,7 +625,15 @@ void ec_fsm_pdo_conf_action_check_assignment(
             && fsm->slave->sii.has_general
             && fsm->slave->sii.coe_details.enable_pdo_assign) {
 
-        // always write PDO assignment
+        if (fsm->conf_valid
+                && ec_pdo_list_equal(&fsm->sync->pdos, &fsm->pdos)) {
+            EC_SLAVE_DBG(fsm->slave, 1, "PDO assignment of SM%u"
+                    " unchanged.\n", fsm->sync_index);
+            ec_fsm_pdo_conf_action_next_sync(fsm, datagram);
+            return;
+        }
+
+        // write PDO assignment
         if (fsm->slave->master->debug_level) {
             EC_SLAVE_DBG(fsm->slave, 1, "Setting PDO assignment of SM%u:\n",
                     fsm->sync_index);
@@ -659,6 +685,7 @@ void ec_fsm_pdo_conf_state_zero_pdo_count(
                 fsm->sync_index);
         EC_SLAVE_WARN(fsm->slave, "");
         ec_fsm_pdo_print(fsm);
+        fsm->conf_failed = 1;
         ec_fsm_pdo_conf_action_next_sync(fsm, datagram);
         return;
     }
@@ -58,6 +58,9 @@ struct ec_fsm_pdo
     ec_pdo_t *pdo; /**< Current PDO. */
     unsigned int pdo_pos; /**< Assignment position of current PDOs. */
     unsigned int pdo_count; /**< Number of assigned PDOs. */
+    unsigned int conf_valid; /**< The PDO configuration of the slave was
+                               known to be valid on start. */
+    unsigned int conf_failed; /**< Writing the PDO configuration failed. */
 };
 
 /****************************************************************************/
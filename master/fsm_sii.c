@@ -44,6 +44,19 @@
  */
 #define SII_INHIBIT 5
 
+/** Size of the SII check/fetch datagram.
+ *
+ * Covers the control/status register 0x0502, the address register and the
+ * data register 0x0508 with up to 8 bytes.
+ */
+#define SII_FETCH_SIZE 14
+
+/** Read size bit in the SII control/status register.
+ *
+ * If set, the ESC reads 8 bytes per read operation instead of 4.
+ */
+#define SII_READ_SIZE_8 0x40
+
 //#define SII_DEBUG
 
 /****************************************************************************/
@@ -97,6 +110,7 @@ void ec_fsm_sii_read(ec_fsm_sii_t *fsm, /**< finite state machine */
     fsm->slave = slave;
     fsm->word_offset = word_offset;
     fsm->mode = mode;
+    fsm->value_size = 0;
 }
 
 /****************************************************************************/
@@ -221,10 +235,12 @@ void ec_fsm_sii_state_read_check(
     // issue check/fetch datagram
     switch (fsm->mode) {
         case EC_FSM_SII_USE_INCREMENT_ADDRESS:
-            ec_datagram_aprd(datagram, fsm->slave->ring_position, 0x502, 10);
+            ec_datagram_aprd(datagram, fsm->slave->ring_position, 0x502,
+                    SII_FETCH_SIZE);
             break;
         case EC_FSM_SII_USE_CONFIGURED_ADDRESS:
-            ec_datagram_fprd(datagram, fsm->slave->station_address, 0x502, 10);
+            ec_datagram_fprd(datagram, fsm->slave->station_address, 0x502,
+                    SII_FETCH_SIZE);
             break;
     }
 
@@ -266,7 +282,7 @@ void ec_fsm_sii_state_read_fetch(
 
 #ifdef SII_DEBUG
     EC_SLAVE_DBG(fsm->slave, 0, "checking SII read state:\n");
-    ec_print_data(datagram->data, 10);
+    ec_print_data(datagram->data, SII_FETCH_SIZE);
 #endif
 
     if (EC_READ_U8(datagram->data + 1) & 0x20) {
@@ -298,7 +314,9 @@ void ec_fsm_sii_state_read_fetch(
     }
 
     // SII value received.
-    memcpy(fsm->value, datagram->data + 6, 4);
+    fsm->value_size =
+        EC_READ_U8(datagram->data) & SII_READ_SIZE_8 ? 8 : 4;
+    memcpy(fsm->value, datagram->data + 6, fsm->value_size);
     fsm->state = ec_fsm_sii_state_end;
 }
 
@@ -25,6 +25,8 @@
 
 /****************************************************************************/
 
+#include <linux/slab.h>
+
 #include "globals.h"
 #include "master.h"
 #include "mailbox.h"
@@ -38,10 +40,15 @@ void ec_fsm_slave_state_idle(ec_fsm_slave_t *, ec_datagram_t *);
 void ec_fsm_slave_state_ready(ec_fsm_slave_t *, ec_datagram_t *);
 int ec_fsm_slave_action_process_sdo(ec_fsm_slave_t *, ec_datagram_t *);
 void ec_fsm_slave_state_sdo_request(ec_fsm_slave_t *, ec_datagram_t *);
-int ec_fsm_slave_action_process_reg(ec_fsm_slave_t *, ec_datagram_t *);
-void ec_fsm_slave_state_reg_request(ec_fsm_slave_t *, ec_datagram_t *);
+void ec_fsm_slave_resume(ec_fsm_slave_t *, ec_datagram_t *);
+int ec_fsm_slave_reg_add(ec_fsm_slave_t *, ec_reg_request_t *);
+int ec_fsm_slave_reg_start(ec_fsm_slave_t *, ec_datagram_t *);
+void ec_fsm_slave_reg_complete(ec_fsm_slave_t *);
 int ec_fsm_slave_action_process_foe(ec_fsm_slave_t *, ec_datagram_t *);
 void ec_fsm_slave_state_foe_request(ec_fsm_slave_t *, ec_datagram_t *);
+void ec_fsm_slave_foe_request_done(ec_fsm_slave_t *,
+        ec_internal_request_state_t);
+int ec_fsm_slave_parked(const ec_fsm_slave_t *);
 int ec_fsm_slave_action_process_soe(ec_fsm_slave_t *, ec_datagram_t *);
 void ec_fsm_slave_state_soe_request(ec_fsm_slave_t *, ec_datagram_t *);
 #ifdef EC_EOE
@@ -51,6 +58,29 @@ void ec_fsm_slave_state_eoe_request(ec_fsm_slave_t *, ec_datagram_t *);
 
 /****************************************************************************/
 
+/** Mailbox request actions, that are checked in turn by the READY state.
+ *
+ * The check starts behind the action that was processed last, so that a
+ * steady stream of requests of one type can not starve the others.
+ */
+static int (*const ec_fsm_slave_mbox_actions[])(ec_fsm_slave_t *,
+        ec_datagram_t *) = {
+    ec_fsm_slave_action_process_sdo,
+    ec_fsm_slave_action_process_foe,
+    ec_fsm_slave_action_process_soe,
+#ifdef EC_EOE
+    ec_fsm_slave_action_process_eoe,
+#endif
+};
+
+/** Number of mailbox request actions.
+ */
+#define EC_FSM_SLAVE_MBOX_ACTIONS \
+    (sizeof(ec_fsm_slave_mbox_actions) / \
+     sizeof(ec_fsm_slave_mbox_actions[0]))
+
+/****************************************************************************/
+
 /** Constructor.
  */
 void ec_fsm_slave_init(
@@ -64,7 +94,11 @@ void ec_fsm_slave_init(
     fsm->state = ec_fsm_slave_state_idle;
     fsm->datagram = NULL;
     fsm->sdo_request = NULL;
-    fsm->reg_request = NULL;
+    fsm->mbox_next = 0;
+    fsm->reg_datagram = NULL;
+    fsm->reg_count = 0;
+    fsm->reg_address = 0;
+    fsm->reg_size = 0;
     fsm->foe_request = NULL;
     fsm->soe_request = NULL;
 #ifdef EC_EOE
@@ -95,14 +129,20 @@ void ec_fsm_slave_clear(
         wake_up_all(&fsm->slave->master->request_queue);
     }
 
-    if (fsm->reg_request) {
-        fsm->reg_request->state = EC_INT_REQUEST_FAILURE;
+    if (fsm->reg_count) {
+        unsigned int i;
+
+        for (i = 0; i < fsm->reg_count; i++) {
+            if (fsm->reg_requests[i]) {
+                fsm->reg_requests[i]->state = EC_INT_REQUEST_FAILURE;
+            }
+        }
+        fsm->reg_count = 0;
         wake_up_all(&fsm->slave->master->request_queue);
     }
 
     if (fsm->foe_request) {
-        fsm->foe_request->state = EC_INT_REQUEST_FAILURE;
-        wake_up_all(&fsm->slave->master->request_queue);
+        ec_fsm_slave_foe_request_done(fsm, EC_INT_REQUEST_FAILURE);
     }
 
     if (fsm->soe_request) {
@@ -142,7 +182,7 @@ int ec_fsm_slave_exec(
     fsm->state(fsm, datagram);
 
     datagram_used = fsm->state != ec_fsm_slave_state_idle &&
-        fsm->state != ec_fsm_slave_state_ready;
+        fsm->state != ec_fsm_slave_state_ready && !ec_fsm_slave_parked(fsm);
 
     if (datagram_used) {
         fsm->datagram = datagram;
@@ -155,6 +195,37 @@ int ec_fsm_slave_exec(
 
 /****************************************************************************/
 
+/** Executes the register request lane of the state machine.
+ *
+ * Register requests do not use the mailbox, so they are processed in
+ * parallel to the mailbox requests: The results of the previous register
+ * datagram are evaluated and the pending register requests are coalesced
+ * into \a datagram, which is sent in the same frame as the datagram of the
+ * mailbox lane.
+ *
+ * \return 1 if \a datagram was used, else 0.
+ */
+int ec_fsm_slave_exec_reg(
+        ec_fsm_slave_t *fsm, /**< Slave state machine. */
+        ec_datagram_t *datagram /**< New datagram to use. */
+        )
+{
+    if (fsm->reg_datagram) {
+        ec_fsm_slave_reg_complete(fsm);
+        fsm->reg_datagram = NULL;
+    }
+
+    if (fsm->state == ec_fsm_slave_state_idle
+            || !ec_fsm_slave_reg_start(fsm, datagram)) {
+        return 0;
+    }
+
+    fsm->reg_datagram = datagram;
+    return 1;
+}
+
+/****************************************************************************/
+
 /** Sets the current state of the state machine to READY
  */
 void ec_fsm_slave_set_ready(
@@ -169,6 +240,24 @@ void ec_fsm_slave_set_ready(
 
 /****************************************************************************/
 
+/** Returns, if the FSM waits for the application during a streamed FoE
+ * transfer.
+ *
+ * A parked FSM does not use a datagram, but has to be executed again to
+ * check for new data.
+ *
+ * \return Non-zero if parked.
+ */
+int ec_fsm_slave_parked(
+        const ec_fsm_slave_t *fsm /**< Slave state machine. */
+        )
+{
+    return fsm->state == ec_fsm_slave_state_foe_request
+        && ec_fsm_foe_paused(&fsm->fsm_foe);
+}
+
+/****************************************************************************/
+
 /** Returns, if the FSM is currently not busy and ready to execute.
  *
  * \return Non-zero if ready.
@@ -177,7 +266,31 @@ int ec_fsm_slave_is_ready(
         const ec_fsm_slave_t *fsm /**< Slave state machine. */
         )
 {
-    return fsm->state == ec_fsm_slave_state_ready;
+    return fsm->state == ec_fsm_slave_state_ready || ec_fsm_slave_parked(fsm);
+}
+
+/****************************************************************************/
+
+/** Returns, if a datagram of the FSM was not sent or received yet.
+ *
+ * \return Non-zero if waiting.
+ */
+int ec_fsm_slave_waiting(
+        const ec_fsm_slave_t *fsm /**< Slave state machine. */
+        )
+{
+    const ec_datagram_t *datagrams[] = {fsm->datagram, fsm->reg_datagram};
+    unsigned int i;
+
+    for (i = 0; i < 2; i++) {
+        if (datagrams[i] && (datagrams[i]->state == EC_DATAGRAM_INIT ||
+                    datagrams[i]->state == EC_DATAGRAM_QUEUED ||
+                    datagrams[i]->state == EC_DATAGRAM_SENT)) {
+            return 1;
+        }
+    }
+
+    return 0;
 }
 
 /*****************************************************************************
@@ -203,32 +316,17 @@ void ec_fsm_slave_state_ready(
         ec_datagram_t *datagram /**< Datagram to use. */
         )
 {
-    // Check for pending external SDO requests
-    if (ec_fsm_slave_action_process_sdo(fsm, datagram)) {
-        return;
-    }
-
-    // Check for pending external register requests
-    if (ec_fsm_slave_action_process_reg(fsm, datagram)) {
-        return;
-    }
-
-    // Check for pending FoE requests
-    if (ec_fsm_slave_action_process_foe(fsm, datagram)) {
-        return;
-    }
-
-    // Check for pending SoE requests
-    if (ec_fsm_slave_action_process_soe(fsm, datagram)) {
-        return;
-    }
-
-#ifdef EC_EOE
-    // Check for pending EoE IP parameter requests
-    if (ec_fsm_slave_action_process_eoe(fsm, datagram)) {
-        return;
+    unsigned int i, action;
+
+    // Check for pending SDO, FoE, SoE and EoE IP parameter requests,
+    // starting with the type following the one processed last.
+    for (i = 0; i < EC_FSM_SLAVE_MBOX_ACTIONS; i++) {
+        action = (fsm->mbox_next + i) % EC_FSM_SLAVE_MBOX_ACTIONS;
+        if (ec_fsm_slave_mbox_actions[action](fsm, datagram)) {
+            fsm->mbox_next = (action + 1) % EC_FSM_SLAVE_MBOX_ACTIONS;
+            return;
+        }
     }
-#endif
 }
 
 /****************************************************************************/
@@ -304,7 +402,7 @@ void ec_fsm_slave_state_sdo_request(
         request->state = EC_INT_REQUEST_FAILURE;
         wake_up_all(&slave->master->request_queue);
         fsm->sdo_request = NULL;
-        fsm->state = ec_fsm_slave_state_ready;
+        ec_fsm_slave_resume(fsm, datagram);
         return;
     }
 
@@ -314,125 +412,209 @@ void ec_fsm_slave_state_sdo_request(
     request->state = EC_INT_REQUEST_SUCCESS;
     wake_up_all(&slave->master->request_queue);
     fsm->sdo_request = NULL;
-    fsm->state = ec_fsm_slave_state_ready;
+    ec_fsm_slave_resume(fsm, datagram);
 }
 
 /****************************************************************************/
 
-/** Check for pending register requests and process one.
+/** Continues a paused FoE transfer, or returns to the READY state.
+ */
+void ec_fsm_slave_resume(
+        ec_fsm_slave_t *fsm, /**< Slave state machine. */
+        ec_datagram_t *datagram /**< Datagram to use. */
+        )
+{
+    if (fsm->foe_request) {
+        EC_SLAVE_DBG(fsm->slave, 1, "Resuming FoE request.\n");
+        fsm->state = ec_fsm_slave_state_foe_request;
+        fsm->state(fsm, datagram); // execute immediately
+    } else {
+        fsm->state = ec_fsm_slave_state_ready;
+    }
+}
+
+/****************************************************************************/
+
+/** Adds a register request to the register datagram in preparation.
+ *
+ * Only requests with the same direction are coalesced. Their memory areas
+ * have to be adjacent; read requests may also overlap.
+ *
+ * \return non-zero, if the request was added.
+ */
+int ec_fsm_slave_reg_add(
+        ec_fsm_slave_t *fsm, /**< Slave state machine. */
+        ec_reg_request_t *reg /**< Register request. */
+        )
+{
+    unsigned int start, end, reg_end;
+
+    if (!fsm->reg_count) {
+        fsm->reg_address = reg->address;
+        fsm->reg_size = reg->transfer_size;
+        fsm->reg_requests[fsm->reg_count++] = reg;
+        return 1;
+    }
+
+    if (fsm->reg_count >= EC_FSM_SLAVE_REG_BATCH
+            || reg->dir != fsm->reg_requests[0]->dir) {
+        return 0;
+    }
+
+    start = fsm->reg_address;
+    end = start + fsm->reg_size;
+    reg_end = reg->address + reg->transfer_size;
+
+    if (reg->dir == EC_DIR_INPUT) {
+        if (reg->address > end || reg_end < start) {
+            return 0;
+        }
+    } else if (reg->address != end && reg_end != start) {
+        return 0;
+    }
+
+    start = min(start, (unsigned int) reg->address);
+    end = max(end, reg_end);
+    if (end - start > EC_MAX_DATA_SIZE) {
+        return 0;
+    }
+
+    fsm->reg_address = start;
+    fsm->reg_size = end - start;
+    fsm->reg_requests[fsm->reg_count++] = reg;
+    return 1;
+}
+
+/****************************************************************************/
+
+/** Check for pending register requests and prepare a datagram for them.
+ *
+ * Internal requests are taken first, then external ones. Each queue is
+ * processed in order and only up to the first request, that can not be
+ * coalesced with the previous ones.
  *
- * \return non-zero, if a register request is processed.
+ * \return non-zero, if register requests are processed.
  */
-int ec_fsm_slave_action_process_reg(
+int ec_fsm_slave_reg_start(
         ec_fsm_slave_t *fsm, /**< Slave state machine. */
         ec_datagram_t *datagram /**< Datagram to use. */
         )
 {
     ec_slave_t *slave = fsm->slave;
-    ec_reg_request_t *reg;
+    ec_reg_request_t *reg, *next;
+    unsigned int i;
 
-    fsm->reg_request = NULL;
+    fsm->reg_count = 0;
 
     if (slave->config) {
-        // search the first internal register request to be processed
+        // search the internal register requests to be processed
         list_for_each_entry(reg, &slave->config->reg_requests, list) {
-            if (reg->state == EC_INT_REQUEST_QUEUED) {
-                fsm->reg_request = reg;
+            if (reg->state != EC_INT_REQUEST_QUEUED) {
+                continue;
+            }
+            if (!ec_fsm_slave_reg_add(fsm, reg)) {
                 break;
             }
+            reg->state = EC_INT_REQUEST_BUSY;
         }
     }
 
-    if (!fsm->reg_request && !list_empty(&slave->reg_requests)) {
-        // take the first external request to be processed
-        fsm->reg_request =
-            list_entry(slave->reg_requests.next, ec_reg_request_t, list);
-        list_del_init(&fsm->reg_request->list); // dequeue
+    // take the external requests to be processed
+    list_for_each_entry_safe(reg, next, &slave->reg_requests, list) {
+        if (!ec_fsm_slave_reg_add(fsm, reg)) {
+            break;
+        }
+        list_del_init(&reg->list); // dequeue
+        reg->state = EC_INT_REQUEST_BUSY;
     }
 
-    if (!fsm->reg_request) { // no register request to process
+    if (!fsm->reg_count) { // no register request to process
         return 0;
     }
 
     if (slave->current_state & EC_SLAVE_STATE_ACK_ERR) {
         EC_SLAVE_WARN(slave, "Aborting register request,"
                 " slave has error flag set.\n");
-        fsm->reg_request->state = EC_INT_REQUEST_FAILURE;
+        for (i = 0; i < fsm->reg_count; i++) {
+            fsm->reg_requests[i]->state = EC_INT_REQUEST_FAILURE;
+        }
         wake_up_all(&slave->master->request_queue);
-        fsm->reg_request = NULL;
-        fsm->state = ec_fsm_slave_state_idle;
+        fsm->reg_count = 0;
+        // leave the state of the mailbox lane untouched
         return 0;
     }
 
-    // Found pending register request. Execute it!
-    EC_SLAVE_DBG(slave, 1, "Processing register request...\n");
-
-    fsm->reg_request->state = EC_INT_REQUEST_BUSY;
+    // Found pending register requests. Execute them!
+    EC_SLAVE_DBG(slave, 1, "Processing %u register request(s)"
+            " at 0x%04X, size %zu...\n",
+            fsm->reg_count, fsm->reg_address, fsm->reg_size);
 
     // Start register access
-    if (fsm->reg_request->dir == EC_DIR_INPUT) {
+    if (fsm->reg_requests[0]->dir == EC_DIR_INPUT) {
         ec_datagram_fprd(datagram, slave->station_address,
-                fsm->reg_request->address, fsm->reg_request->transfer_size);
+                fsm->reg_address, fsm->reg_size);
         ec_datagram_zero(datagram);
     } else {
         ec_datagram_fpwr(datagram, slave->station_address,
-                fsm->reg_request->address, fsm->reg_request->transfer_size);
-        memcpy(datagram->data, fsm->reg_request->data,
-                fsm->reg_request->transfer_size);
+                fsm->reg_address, fsm->reg_size);
+        for (i = 0; i < fsm->reg_count; i++) {
+            reg = fsm->reg_requests[i];
+            memcpy(datagram->data + (reg->address - fsm->reg_address),
+                    reg->data, reg->transfer_size);
+        }
     }
     datagram->device_index = slave->device_index;
-    fsm->state = ec_fsm_slave_state_reg_request;
     return 1;
 }
 
 /****************************************************************************/
 
-/** Slave state: Register request.
+/** Evaluates the register datagram and completes its register requests.
  */
-void ec_fsm_slave_state_reg_request(
-        ec_fsm_slave_t *fsm, /**< Slave state machine. */
-        ec_datagram_t *datagram /**< Datagram to use. */
+void ec_fsm_slave_reg_complete(
+        ec_fsm_slave_t *fsm /**< Slave state machine. */
         )
 {
     ec_slave_t *slave = fsm->slave;
-    ec_reg_request_t *reg = fsm->reg_request;
-
-    if (!reg) {
-        // configuration was cleared in the meantime
-        fsm->state = ec_fsm_slave_state_ready;
-        fsm->reg_request = NULL;
-        return;
-    }
+    ec_datagram_t *datagram = fsm->reg_datagram;
+    ec_reg_request_t *reg;
+    ec_internal_request_state_t state;
+    unsigned int i;
 
-    if (fsm->datagram->state != EC_DATAGRAM_RECEIVED) {
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
         EC_SLAVE_ERR(slave, "Failed to receive register"
                 " request datagram: ");
-        ec_datagram_print_state(fsm->datagram);
-        reg->state = EC_INT_REQUEST_FAILURE;
-        wake_up_all(&slave->master->request_queue);
-        fsm->reg_request = NULL;
-        fsm->state = ec_fsm_slave_state_ready;
-        return;
-    }
-
-    if (fsm->datagram->working_counter == 1) {
-        if (reg->dir == EC_DIR_INPUT) { // read request
-            memcpy(reg->data, fsm->datagram->data, reg->transfer_size);
-        }
-
-        reg->state = EC_INT_REQUEST_SUCCESS;
+        ec_datagram_print_state(datagram);
+        state = EC_INT_REQUEST_FAILURE;
+    } else if (datagram->working_counter == 1) {
         EC_SLAVE_DBG(slave, 1, "Register request successful.\n");
+        state = EC_INT_REQUEST_SUCCESS;
     } else {
-        reg->state = EC_INT_REQUEST_FAILURE;
-        ec_datagram_print_state(fsm->datagram);
+        ec_datagram_print_state(datagram);
         EC_SLAVE_ERR(slave, "Register request failed"
                 " (working counter is %u).\n",
-                fsm->datagram->working_counter);
+                datagram->working_counter);
+        state = EC_INT_REQUEST_FAILURE;
     }
 
+    for (i = 0; i < fsm->reg_count; i++) {
+        reg = fsm->reg_requests[i];
+        if (!reg) {
+            // configuration was cleared in the meantime
+            continue;
+        }
+
+        if (state == EC_INT_REQUEST_SUCCESS
+                && reg->dir == EC_DIR_INPUT) { // read request
+            memcpy(reg->data,
+                    datagram->data + (reg->address - fsm->reg_address),
+                    reg->transfer_size);
+        }
+        reg->state = state;
+    }
+
+    fsm->reg_count = 0;
     wake_up_all(&slave->master->request_queue);
-    fsm->reg_request = NULL;
-    fsm->state = ec_fsm_slave_state_ready;
 }
 
 /****************************************************************************/
@@ -489,15 +671,32 @@ void ec_fsm_slave_state_foe_request(
     ec_slave_t *slave = fsm->slave;
     ec_foe_request_t *request = fsm->foe_request;
 
+    // let pending SDO requests use the mailbox between two FoE packets
+    fsm->fsm_foe.pause_request = !list_empty(&slave->sdo_requests);
+
     if (ec_fsm_foe_exec(&fsm->fsm_foe, datagram)) {
         return;
     }
 
+    if (ec_fsm_foe_paused(&fsm->fsm_foe)) {
+        if (!list_empty(&slave->sdo_requests)) {
+            EC_SLAVE_DBG(slave, 1, "Pausing FoE request.\n");
+            if (ec_fsm_slave_action_process_sdo(fsm, datagram)) {
+                return;
+            }
+        }
+
+        // no SDO request started, continue the transfer (a stream stays
+        // paused until the application provided data)
+        fsm->state = ec_fsm_slave_state_foe_request;
+        fsm->fsm_foe.pause_request = 0;
+        ec_fsm_foe_exec(&fsm->fsm_foe, datagram);
+        return;
+    }
+
     if (!ec_fsm_foe_success(&fsm->fsm_foe)) {
         EC_SLAVE_ERR(slave, "Failed to handle FoE request.\n");
-        request->state = EC_INT_REQUEST_FAILURE;
-        wake_up_all(&slave->master->request_queue);
-        fsm->foe_request = NULL;
+        ec_fsm_slave_foe_request_done(fsm, EC_INT_REQUEST_FAILURE);
         fsm->state = ec_fsm_slave_state_ready;
         return;
     }
@@ -506,14 +705,38 @@ void ec_fsm_slave_state_foe_request(
     EC_SLAVE_DBG(slave, 1, "Successfully transferred %zu bytes of FoE"
             " data.\n", request->data_size);
 
-    request->state = EC_INT_REQUEST_SUCCESS;
-    wake_up_all(&slave->master->request_queue);
-    fsm->foe_request = NULL;
+    ec_fsm_slave_foe_request_done(fsm, EC_INT_REQUEST_SUCCESS);
     fsm->state = ec_fsm_slave_state_ready;
 }
 
 /****************************************************************************/
 
+/** Finishes the current FoE request.
+ *
+ * An orphaned request is freed, because nobody waits for it any more.
+ */
+void ec_fsm_slave_foe_request_done(
+        ec_fsm_slave_t *fsm, /**< Slave state machine. */
+        ec_internal_request_state_t state /**< Final request state. */
+        )
+{
+    ec_foe_request_t *request = fsm->foe_request;
+
+    fsm->foe_request = NULL;
+
+    if (request->stream_orphaned) {
+        EC_SLAVE_DBG(fsm->slave, 1, "Freeing orphaned FoE request.\n");
+        ec_foe_request_clear(request);
+        kfree(request);
+        return;
+    }
+
+    request->state = state;
+    wake_up_all(&fsm->slave->master->request_queue);
+}
+
+/****************************************************************************/
+
 /** Check for pending SoE requests and process one.
  *
  * \return non-zero, if a request is processed.
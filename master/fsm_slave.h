@@ -45,6 +45,13 @@
 
 /****************************************************************************/
 
+/** Maximum number of register requests, that are coalesced into one
+ * datagram.
+ */
+#define EC_FSM_SLAVE_REG_BATCH 8
+
+/****************************************************************************/
+
 typedef struct ec_fsm_slave ec_fsm_slave_t; /**< \see ec_fsm_slave */
 
 /** Finite state machine of an EtherCAT slave.
@@ -56,7 +63,17 @@ struct ec_fsm_slave {
     void (*state)(ec_fsm_slave_t *, ec_datagram_t *); /**< State function. */
     ec_datagram_t *datagram; /**< Previous state datagram. */
     ec_sdo_request_t *sdo_request; /**< SDO request to process. */
-    ec_reg_request_t *reg_request; /**< Register request to process. */
+    unsigned int mbox_next; /**< Index of the mailbox request type to
+                              check first. */
+    ec_datagram_t *reg_datagram; /**< Datagram of the register requests in
+                                   process. */
+    ec_reg_request_t *reg_requests[EC_FSM_SLAVE_REG_BATCH]; /**< Register
+                                                              requests in
+                                                              process. */
+    unsigned int reg_count; /**< Number of register requests in process. */
+    uint16_t reg_address; /**< Physical start address of the register
+                            datagram. */
+    size_t reg_size; /**< Size of the register datagram. */
     ec_foe_request_t *foe_request; /**< FoE request to process. */
     off_t foe_index; /**< Index to FoE write request data. */
     ec_soe_request_t *soe_request; /**< SoE request to process. */
@@ -78,8 +95,10 @@ void ec_fsm_slave_init(ec_fsm_slave_t *, ec_slave_t *);
 void ec_fsm_slave_clear(ec_fsm_slave_t *);
 
 int ec_fsm_slave_exec(ec_fsm_slave_t *, ec_datagram_t *);
+int ec_fsm_slave_exec_reg(ec_fsm_slave_t *, ec_datagram_t *);
 void ec_fsm_slave_set_ready(ec_fsm_slave_t *);
 int ec_fsm_slave_is_ready(const ec_fsm_slave_t *);
+int ec_fsm_slave_waiting(const ec_fsm_slave_t *);
 
 /****************************************************************************/
 
@@ -54,6 +54,7 @@
 
 // prototypes for private methods
 int ec_fsm_slave_config_running(const ec_fsm_slave_config_t *);
+void ec_fsm_slave_config_timeline(const ec_fsm_slave_config_t *);
 
 /****************************************************************************/
 
@@ -63,6 +64,7 @@ void ec_fsm_slave_config_state_clear_fmmus(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_clear_sync(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_dc_clear_assign(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_mbox_sync(ec_fsm_slave_config_t *);
+void ec_fsm_slave_config_state_mbox_status(ec_fsm_slave_config_t *);
 #ifdef EC_SII_ASSIGN
 void ec_fsm_slave_config_state_assign_pdi(ec_fsm_slave_config_t *);
 #endif
@@ -86,11 +88,13 @@ void ec_fsm_slave_config_state_wait_safeop(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_safeop(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_soe_conf_safeop(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_state_op(ec_fsm_slave_config_t *);
+void ec_fsm_slave_config_state_start_op(ec_fsm_slave_config_t *);
 
 void ec_fsm_slave_config_enter_init(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_enter_clear_sync(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_enter_dc_clear_assign(ec_fsm_slave_config_t *);
 void ec_fsm_slave_config_enter_mbox_sync(ec_fsm_slave_config_t *);
+void ec_fsm_slave_config_enter_mbox_status(ec_fsm_slave_config_t *);
 #ifdef EC_SII_ASSIGN
 void ec_fsm_slave_config_enter_assign_pdi(ec_fsm_slave_config_t *);
 #endif
@@ -116,6 +120,50 @@ void ec_fsm_slave_config_reconfigure(ec_fsm_slave_config_t *);
 
 /****************************************************************************/
 
+/** State names for the startup timeline.
+ */
+static const struct {
+    void (*state)(ec_fsm_slave_config_t *); /**< State function. */
+    const char *name; /**< State name. */
+} ec_fsm_slave_config_state_names[] = {
+    {ec_fsm_slave_config_state_start, "start"},
+    {ec_fsm_slave_config_state_init, "init"},
+    {ec_fsm_slave_config_state_clear_fmmus, "clear_fmmus"},
+    {ec_fsm_slave_config_state_clear_sync, "clear_sync"},
+    {ec_fsm_slave_config_state_dc_clear_assign, "dc_clear_assign"},
+    {ec_fsm_slave_config_state_mbox_sync, "mbox_sync"},
+    {ec_fsm_slave_config_state_mbox_status, "mbox_status"},
+#ifdef EC_SII_ASSIGN
+    {ec_fsm_slave_config_state_assign_pdi, "assign_pdi"},
+#endif
+    {ec_fsm_slave_config_state_boot_preop, "boot_preop"},
+#ifdef EC_SII_ASSIGN
+    {ec_fsm_slave_config_state_assign_ethercat, "assign_ethercat"},
+#endif
+    {ec_fsm_slave_config_state_sdo_conf, "sdo_conf"},
+    {ec_fsm_slave_config_state_soe_conf_preop, "soe_conf_preop"},
+    {ec_fsm_slave_config_state_eoe_ip_param, "eoe_ip_param"},
+    {ec_fsm_slave_config_state_watchdog_divider, "watchdog_divider"},
+    {ec_fsm_slave_config_state_watchdog, "watchdog"},
+    {ec_fsm_slave_config_state_pdo_sync, "pdo_sync"},
+    {ec_fsm_slave_config_state_pdo_conf, "pdo_conf"},
+    {ec_fsm_slave_config_state_fmmu, "fmmu"},
+    {ec_fsm_slave_config_state_dc_cycle, "dc_cycle"},
+    {ec_fsm_slave_config_state_dc_sync_check, "dc_sync_check"},
+    {ec_fsm_slave_config_state_dc_start, "dc_start"},
+    {ec_fsm_slave_config_state_dc_assign, "dc_assign"},
+    {ec_fsm_slave_config_state_wait_safeop, "wait_safeop"},
+    {ec_fsm_slave_config_state_safeop, "safeop"},
+    {ec_fsm_slave_config_state_soe_conf_safeop, "soe_conf_safeop"},
+    {ec_fsm_slave_config_state_op, "op"},
+    {ec_fsm_slave_config_state_start_op, "start_op"},
+    {ec_fsm_slave_config_state_end, "end"},
+    {ec_fsm_slave_config_state_error, "error"},
+    {}
+};
+
+/****************************************************************************/
+
 /** Constructor.
  */
 void ec_fsm_slave_config_init(
@@ -163,7 +211,26 @@ void ec_fsm_slave_config_start(
         )
 {
     fsm->slave = slave;
+    fsm->defer_op = 0;
     fsm->state = ec_fsm_slave_config_state_start;
+    ec_fsm_slave_config_timeline(fsm);
+}
+
+/****************************************************************************/
+
+/** Start requesting OP for a slave, that is already configured in SAFEOP.
+ *
+ * This is used, if a grouped transition to OP failed.
+ */
+void ec_fsm_slave_config_start_op(
+        ec_fsm_slave_config_t *fsm, /**< slave state machine */
+        ec_slave_t *slave /**< slave to bring to OP */
+        )
+{
+    fsm->slave = slave;
+    fsm->defer_op = 0;
+    fsm->state = ec_fsm_slave_config_state_start_op;
+    ec_fsm_slave_config_timeline(fsm);
 }
 
 /****************************************************************************/
@@ -192,6 +259,8 @@ int ec_fsm_slave_config_exec(
         ec_fsm_slave_config_t *fsm /**< slave state machine */
         )
 {
+    void (*state)(ec_fsm_slave_config_t *) = fsm->state;
+
     if (fsm->datagram->state == EC_DATAGRAM_SENT
         || fsm->datagram->state == EC_DATAGRAM_QUEUED) {
         // datagram was not sent or received yet.
@@ -199,11 +268,36 @@ int ec_fsm_slave_config_exec(
     }
 
     fsm->state(fsm);
+
+    if (fsm->state != state) {
+        ec_fsm_slave_config_timeline(fsm);
+    }
+
     return ec_fsm_slave_config_running(fsm);
 }
 
 /****************************************************************************/
 
+/** Records the current state in the startup timeline.
+ */
+void ec_fsm_slave_config_timeline(
+        const ec_fsm_slave_config_t *fsm /**< slave state machine */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; ec_fsm_slave_config_state_names[i].state; i++) {
+        if (ec_fsm_slave_config_state_names[i].state == fsm->state) {
+            ec_timeline_record(&fsm->slave->master->timeline, fsm->slave,
+                    EC_TIMELINE_CONFIG,
+                    ec_fsm_slave_config_state_names[i].name);
+            return;
+        }
+    }
+}
+
+/****************************************************************************/
+
 /**
  * \return true, if the state machine terminated gracefully
  */
@@ -305,6 +399,8 @@ void ec_fsm_slave_config_state_clear_fmmus(
         return;
     }
 
+    ec_slave_mbox_status_set_mapped(fsm->slave, 0);
+
     ec_fsm_slave_config_enter_clear_sync(fsm);
 }
 
@@ -612,6 +708,66 @@ void ec_fsm_slave_config_state_mbox_sync(
         return;
     }
 
+    ec_fsm_slave_config_enter_mbox_status(fsm);
+}
+
+/****************************************************************************/
+
+/** Map the mailbox status into the master's mailbox status image.
+ */
+void ec_fsm_slave_config_enter_mbox_status(
+        ec_fsm_slave_config_t *fsm /**< slave state machine */
+        )
+{
+    ec_datagram_t *datagram = fsm->datagram;
+    ec_slave_t *slave = fsm->slave;
+    int index = ec_slave_mbox_status_fmmu(slave);
+
+    if (index < 0) {
+        // mailbox checks are sent to the slave
+#ifdef EC_SII_ASSIGN
+        ec_fsm_slave_config_enter_assign_pdi(fsm);
+#else
+        ec_fsm_slave_config_enter_boot_preop(fsm);
+#endif
+        return;
+    }
+
+    EC_SLAVE_DBG(slave, 1, "Mapping mailbox status with FMMU %i.\n",
+            index);
+
+    ec_datagram_fpwr(datagram, slave->station_address,
+            0x0600 + EC_FMMU_PAGE_SIZE * index, EC_FMMU_PAGE_SIZE);
+    ec_slave_mbox_status_page(slave, datagram->data);
+    fsm->retries = EC_FSM_RETRIES;
+    fsm->state = ec_fsm_slave_config_state_mbox_status;
+}
+
+/****************************************************************************/
+
+/** Slave configuration state: MBOX STATUS.
+ */
+void ec_fsm_slave_config_state_mbox_status(
+        ec_fsm_slave_config_t *fsm /**< slave state machine */
+        )
+{
+    ec_datagram_t *datagram = fsm->datagram;
+    ec_slave_t *slave = fsm->slave;
+
+    if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--)
+        return;
+
+    if (datagram->state != EC_DATAGRAM_RECEIVED) {
+        EC_SLAVE_WARN(slave, "Failed to receive mailbox status FMMU"
+                " datagram: ");
+        ec_datagram_print_state(datagram);
+    } else if (datagram->working_counter != 1) {
+        EC_SLAVE_WARN(slave, "Failed to map mailbox status: ");
+        ec_datagram_print_wc_error(datagram);
+    } else {
+        ec_slave_mbox_status_set_mapped(slave, 1);
+    }
+
 #ifdef EC_SII_ASSIGN
     ec_fsm_slave_config_enter_assign_pdi(fsm);
 #else
@@ -691,6 +847,8 @@ void ec_fsm_slave_config_enter_boot_preop(
         ec_fsm_change_start(fsm->fsm_change,
                 fsm->slave, EC_SLAVE_STATE_PREOP);
     } else { // BOOT
+        // a firmware update may change the PDO configuration
+        fsm->slave->pdo_conf_valid = 0;
         ec_fsm_change_start(fsm->fsm_change,
                 fsm->slave, EC_SLAVE_STATE_BOOT);
     }
@@ -1314,6 +1472,17 @@ void ec_fsm_slave_config_enter_fmmu(
                 datagram->data + EC_FMMU_PAGE_SIZE * i);
     }
 
+    // keep the mailbox status mapped, if its FMMU is still spare
+    if (slave->mbox_status_mapped) {
+        int index = ec_slave_mbox_status_fmmu(slave);
+        if (index >= 0) {
+            ec_slave_mbox_status_page(slave,
+                    datagram->data + EC_FMMU_PAGE_SIZE * index);
+        } else {
+            ec_slave_mbox_status_set_mapped(slave, 0);
+        }
+    }
+
     fsm->retries = EC_FSM_RETRIES;
     fsm->state = ec_fsm_slave_config_state_fmmu;
 }
@@ -1787,12 +1956,31 @@ void ec_fsm_slave_config_state_soe_conf_safeop(
 
 /****************************************************************************/
 
+/** Slave configuration state: START OP.
+ */
+void ec_fsm_slave_config_state_start_op(
+        ec_fsm_slave_config_t *fsm /**< slave state machine */
+        )
+{
+    EC_SLAVE_DBG(fsm->slave, 1, "Requesting OP.\n");
+    ec_fsm_slave_config_enter_op(fsm);
+}
+
+/****************************************************************************/
+
 /** Bring slave to OP.
  */
 void ec_fsm_slave_config_enter_op(
         ec_fsm_slave_config_t *fsm /**< slave state machine */
         )
 {
+    if (fsm->defer_op) {
+        // the master requests OP for all slaves at once
+        EC_SLAVE_DBG(fsm->slave, 1, "Deferring transition to OP.\n");
+        fsm->state = ec_fsm_slave_config_state_end;
+        return;
+    }
+
     // set state to OP
     fsm->state = ec_fsm_slave_config_state_op;
     ec_fsm_change_start(fsm->fsm_change, fsm->slave, EC_SLAVE_STATE_OP);
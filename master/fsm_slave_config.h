@@ -62,6 +62,9 @@ struct ec_fsm_slave_config
     unsigned long jiffies_start; /**< For timeout calculations. */
     unsigned int take_time; /**< Store jiffies after datagram reception. */
     unsigned long wait_ms; /**< Wait time (used to wait before SAFEOP). */
+    unsigned int defer_op; /**< Finish in SAFEOP instead of requesting OP,
+                             so that OP can be requested for a group of
+                             slaves at once. */
 };
 
 /****************************************************************************/
@@ -72,6 +75,7 @@ void ec_fsm_slave_config_init(ec_fsm_slave_config_t *, ec_datagram_t *,
 void ec_fsm_slave_config_clear(ec_fsm_slave_config_t *);
 
 void ec_fsm_slave_config_start(ec_fsm_slave_config_t *, ec_slave_t *);
+void ec_fsm_slave_config_start_op(ec_fsm_slave_config_t *, ec_slave_t *);
 
 int ec_fsm_slave_config_exec(ec_fsm_slave_config_t *);
 int ec_fsm_slave_config_success(const ec_fsm_slave_config_t *);
@@ -37,7 +37,12 @@
 
 // prototypes for private methods
 int ec_fsm_slave_scan_running(const ec_fsm_slave_scan_t *);
+void ec_fsm_slave_scan_enter_sii(ec_fsm_slave_scan_t *);
+#ifdef EC_SII_CACHE
+void ec_fsm_slave_scan_enter_sii_ident(ec_fsm_slave_scan_t *);
+#endif
 void ec_fsm_slave_scan_enter_sii_size(ec_fsm_slave_scan_t *);
+void ec_fsm_slave_scan_evaluate_sii(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_enter_assign_sii(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_enter_datalink(ec_fsm_slave_scan_t *);
 #ifdef EC_REGALIAS
@@ -45,6 +50,7 @@ void ec_fsm_slave_scan_enter_regalias(ec_fsm_slave_scan_t *);
 #endif
 void ec_fsm_slave_scan_enter_preop(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_enter_pdos(ec_fsm_slave_scan_t *);
+void ec_fsm_slave_scan_timeline(const ec_fsm_slave_scan_t *);
 
 /****************************************************************************/
 
@@ -58,6 +64,9 @@ void ec_fsm_slave_scan_state_datalink(ec_fsm_slave_scan_t *);
 #ifdef EC_SII_ASSIGN
 void ec_fsm_slave_scan_state_assign_sii(ec_fsm_slave_scan_t *);
 #endif
+#ifdef EC_SII_CACHE
+void ec_fsm_slave_scan_state_sii_ident(ec_fsm_slave_scan_t *);
+#endif
 void ec_fsm_slave_scan_state_sii_size(ec_fsm_slave_scan_t *);
 void ec_fsm_slave_scan_state_sii_data(ec_fsm_slave_scan_t *);
 #ifdef EC_REGALIAS
@@ -72,6 +81,40 @@ void ec_fsm_slave_scan_state_error(ec_fsm_slave_scan_t *);
 
 /****************************************************************************/
 
+/** State names for the startup timeline.
+ */
+static const struct {
+    void (*state)(ec_fsm_slave_scan_t *); /**< State function. */
+    const char *name; /**< State name. */
+} ec_fsm_slave_scan_state_names[] = {
+    {ec_fsm_slave_scan_state_start, "start"},
+    {ec_fsm_slave_scan_state_address, "address"},
+    {ec_fsm_slave_scan_state_state, "state"},
+    {ec_fsm_slave_scan_state_base, "base"},
+    {ec_fsm_slave_scan_state_dc_cap, "dc_cap"},
+    {ec_fsm_slave_scan_state_dc_times, "dc_times"},
+    {ec_fsm_slave_scan_state_datalink, "datalink"},
+#ifdef EC_SII_ASSIGN
+    {ec_fsm_slave_scan_state_assign_sii, "assign_sii"},
+#endif
+#ifdef EC_SII_CACHE
+    {ec_fsm_slave_scan_state_sii_ident, "sii_ident"},
+#endif
+    {ec_fsm_slave_scan_state_sii_size, "sii_size"},
+    {ec_fsm_slave_scan_state_sii_data, "sii_data"},
+#ifdef EC_REGALIAS
+    {ec_fsm_slave_scan_state_regalias, "regalias"},
+#endif
+    {ec_fsm_slave_scan_state_preop, "preop"},
+    {ec_fsm_slave_scan_state_sync, "sync"},
+    {ec_fsm_slave_scan_state_pdos, "pdos"},
+    {ec_fsm_slave_scan_state_end, "end"},
+    {ec_fsm_slave_scan_state_error, "error"},
+    {}
+};
+
+/****************************************************************************/
+
 /** Constructor.
  */
 void ec_fsm_slave_scan_init(
@@ -113,6 +156,7 @@ void ec_fsm_slave_scan_start(
 {
     fsm->slave = slave;
     fsm->state = ec_fsm_slave_scan_state_start;
+    ec_fsm_slave_scan_timeline(fsm);
 }
 
 /****************************************************************************/
@@ -140,6 +184,8 @@ int ec_fsm_slave_scan_running(
 
 int ec_fsm_slave_scan_exec(ec_fsm_slave_scan_t *fsm /**< slave state machine */)
 {
+    void (*state)(ec_fsm_slave_scan_t *) = fsm->state;
+
     if (fsm->datagram->state == EC_DATAGRAM_SENT
         || fsm->datagram->state == EC_DATAGRAM_QUEUED) {
         // datagram was not sent or received yet.
@@ -147,11 +193,35 @@ int ec_fsm_slave_scan_exec(ec_fsm_slave_scan_t *fsm /**< slave state machine */)
     }
 
     fsm->state(fsm);
+
+    if (fsm->state != state) {
+        ec_fsm_slave_scan_timeline(fsm);
+    }
+
     return ec_fsm_slave_scan_running(fsm);
 }
 
 /****************************************************************************/
 
+/** Records the current state in the startup timeline.
+ */
+void ec_fsm_slave_scan_timeline(
+        const ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; ec_fsm_slave_scan_state_names[i].state; i++) {
+        if (ec_fsm_slave_scan_state_names[i].state == fsm->state) {
+            ec_timeline_record(&fsm->slave->master->timeline, fsm->slave,
+                    EC_TIMELINE_SCAN, ec_fsm_slave_scan_state_names[i].name);
+            return;
+        }
+    }
+}
+
+/****************************************************************************/
+
 /**
    \return true, if the state machine terminated gracefully
 */
@@ -324,6 +394,18 @@ void ec_fsm_slave_scan_state_base(
     slave->base_dc_supported = (octet >> 2) & 0x01;
     slave->base_dc_range = ((octet >> 3) & 0x01) ? EC_DC_64 : EC_DC_32;
 
+    if (ec_snapshot_adopt(&slave->master->snapshot, slave)) {
+        // DC capabilities, receive times and DL status are known
+        EC_SLAVE_DBG(slave, 1, "Using DC and link information"
+                " of the snapshot.\n");
+#ifdef EC_SII_ASSIGN
+        ec_fsm_slave_scan_enter_assign_sii(fsm);
+#else
+        ec_fsm_slave_scan_enter_sii(fsm);
+#endif
+        return;
+    }
+
     if (slave->base_dc_supported) {
         // read DC capabilities
         ec_datagram_fprd(datagram, slave->station_address, 0x0910,
@@ -442,6 +524,44 @@ void ec_fsm_slave_scan_enter_datalink(
 
 /****************************************************************************/
 
+/** Start reading the SII.
+ *
+ * If the SII cache is enabled, only the identity words are read first.
+ */
+void ec_fsm_slave_scan_enter_sii(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+#ifdef EC_SII_CACHE
+    ec_fsm_slave_scan_enter_sii_ident(fsm);
+#else
+    ec_fsm_slave_scan_enter_sii_size(fsm);
+#endif
+}
+
+/****************************************************************************/
+
+#ifdef EC_SII_CACHE
+
+/** Enter slave scan state SII_IDENT.
+ */
+void ec_fsm_slave_scan_enter_sii_ident(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    EC_SLAVE_DBG(fsm->slave, 1, "Reading SII identity.\n");
+
+    fsm->sii_offset = EC_SII_IDENT_OFFSET;
+    ec_fsm_sii_read(&fsm->fsm_sii, fsm->slave, fsm->sii_offset,
+            EC_FSM_SII_USE_CONFIGURED_ADDRESS);
+    fsm->state = ec_fsm_slave_scan_state_sii_ident;
+    fsm->state(fsm); // execute state immediately
+}
+
+#endif
+
+/****************************************************************************/
+
 /** Enter slave scan state SII_SIZE.
  */
 void ec_fsm_slave_scan_enter_sii_size(
@@ -495,8 +615,6 @@ void ec_fsm_slave_scan_state_datalink(
 {
     ec_datagram_t *datagram = fsm->datagram;
     ec_slave_t *slave = fsm->slave;
-    uint16_t dl_status;
-    unsigned int i;
 
     if (datagram->state == EC_DATAGRAM_TIMED_OUT && fsm->retries--)
         return;
@@ -516,20 +634,12 @@ void ec_fsm_slave_scan_state_datalink(
         return;
     }
 
-    dl_status = EC_READ_U16(datagram->data);
-    for (i = 0; i < EC_MAX_PORTS; i++) {
-        slave->ports[i].link.link_up =
-            dl_status & (1 << (4 + i)) ? 1 : 0;
-        slave->ports[i].link.loop_closed =
-            dl_status & (1 << (8 + i * 2)) ? 1 : 0;
-        slave->ports[i].link.signal_detected =
-            dl_status & (1 << (9 + i * 2)) ? 1 : 0;
-    }
+    ec_slave_set_dl_status(slave, EC_READ_U16(datagram->data));
 
 #ifdef EC_SII_ASSIGN
     ec_fsm_slave_scan_enter_assign_sii(fsm);
 #else
-    ec_fsm_slave_scan_enter_sii_size(fsm);
+    ec_fsm_slave_scan_enter_sii(fsm);
 #endif
 }
 
@@ -566,7 +676,83 @@ void ec_fsm_slave_scan_state_assign_sii(
     }
 
 continue_with_sii_size:
-    ec_fsm_slave_scan_enter_sii_size(fsm);
+    ec_fsm_slave_scan_enter_sii(fsm);
+}
+
+#endif
+
+/****************************************************************************/
+
+#ifdef EC_SII_CACHE
+
+/** Slave scan state: SII IDENT.
+ *
+ * Reads the identity words and looks up the SII image in the cache.
+ */
+void ec_fsm_slave_scan_state_sii_ident(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+    const ec_sii_image_t *image;
+    unsigned int words;
+
+    if (ec_fsm_sii_exec(&fsm->fsm_sii))
+        return;
+
+    if (!ec_fsm_sii_success(&fsm->fsm_sii)) {
+        EC_SLAVE_WARN(slave, "Failed to read SII identity."
+                " Reading complete SII.\n");
+        ec_fsm_slave_scan_enter_sii_size(fsm);
+        return;
+    }
+
+    // 2 or 4 words fetched
+    words = fsm->fsm_sii.value_size / 2;
+    if (fsm->sii_offset + words > EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS) {
+        words = EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS - fsm->sii_offset;
+    }
+    memcpy(fsm->sii_ident + fsm->sii_offset - EC_SII_IDENT_OFFSET,
+            fsm->fsm_sii.value, words * 2);
+
+    if (fsm->sii_offset + words <
+            EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS) {
+        fsm->sii_offset += words;
+        ec_fsm_sii_read(&fsm->fsm_sii, slave, fsm->sii_offset,
+                EC_FSM_SII_USE_CONFIGURED_ADDRESS);
+        ec_fsm_sii_exec(&fsm->fsm_sii); // execute state immediately
+        return;
+    }
+
+    image = ec_sii_cache_find(&slave->master->sii_cache, fsm->sii_ident);
+    if (!image) {
+        EC_SLAVE_DBG(slave, 1, "SII image not cached.\n");
+        ec_fsm_slave_scan_enter_sii_size(fsm);
+        return;
+    }
+
+    if (slave->sii_words) {
+        EC_SLAVE_WARN(slave, "Freeing old SII data...\n");
+        kfree(slave->sii_words);
+    }
+
+    if (!(slave->sii_words =
+                (uint16_t *) kmalloc(image->nwords * 2, GFP_KERNEL))) {
+        EC_SLAVE_ERR(slave, "Failed to allocate %zu words of SII data.\n",
+               image->nwords);
+        slave->sii_nwords = 0;
+        slave->error_flag = 1;
+        fsm->state = ec_fsm_slave_scan_state_error;
+        return;
+    }
+
+    memcpy(slave->sii_words, image->words, image->nwords * 2);
+    slave->sii_nwords = image->nwords;
+
+    EC_SLAVE_DBG(slave, 1, "Using cached SII image with %zu words.\n",
+            slave->sii_nwords);
+
+    ec_fsm_slave_scan_evaluate_sii(fsm);
 }
 
 #endif
@@ -658,7 +844,7 @@ void ec_fsm_slave_scan_state_sii_data(ec_fsm_slave_scan_t *fsm
         /**< slave state machine */)
 {
     ec_slave_t *slave = fsm->slave;
-    uint16_t *cat_word, cat_type, cat_size;
+    unsigned int words;
 
     if (ec_fsm_sii_exec(&fsm->fsm_sii)) return;
 
@@ -669,26 +855,51 @@ void ec_fsm_slave_scan_state_sii_data(ec_fsm_slave_scan_t *fsm
         return;
     }
 
-    // 2 words fetched
+    // 2 or 4 words fetched, depending on the read size of the ESC
 
-    if (fsm->sii_offset + 2 <= slave->sii_nwords) { // 2 words fit
-        memcpy(slave->sii_words + fsm->sii_offset, fsm->fsm_sii.value, 4);
-    } else { // copy the last word
-        memcpy(slave->sii_words + fsm->sii_offset, fsm->fsm_sii.value, 2);
+    if (fsm->sii_offset == 0x0000 && fsm->fsm_sii.value_size == 8) {
+        EC_SLAVE_DBG(slave, 1, "Using 8 byte SII read size.\n");
     }
 
-    if (fsm->sii_offset + 2 < slave->sii_nwords) {
-        // fetch the next 2 words
-        fsm->sii_offset += 2;
+    words = fsm->fsm_sii.value_size / 2;
+    if (fsm->sii_offset + words > slave->sii_nwords) { // copy the last words
+        words = slave->sii_nwords - fsm->sii_offset;
+    }
+    memcpy(slave->sii_words + fsm->sii_offset, fsm->fsm_sii.value,
+            words * 2);
+
+    if (fsm->sii_offset + words < slave->sii_nwords) {
+        // fetch the next words
+        fsm->sii_offset += words;
         ec_fsm_sii_read(&fsm->fsm_sii, slave, fsm->sii_offset,
                         EC_FSM_SII_USE_CONFIGURED_ADDRESS);
         ec_fsm_sii_exec(&fsm->fsm_sii); // execute state immediately
         return;
     }
 
-    // Evaluate SII contents
+#ifdef EC_SII_CACHE
+    if (!slave->error_flag) {
+        ec_sii_cache_store(&slave->master->sii_cache, slave->sii_words,
+                slave->sii_nwords);
+    }
+#endif
+
+    ec_fsm_slave_scan_evaluate_sii(fsm);
+}
+
+/****************************************************************************/
+
+/** Evaluate the SII contents of the slave.
+ */
+void ec_fsm_slave_scan_evaluate_sii(
+        ec_fsm_slave_scan_t *fsm /**< slave state machine */
+        )
+{
+    ec_slave_t *slave = fsm->slave;
+    uint16_t *cat_word, cat_type, cat_size;
 
     ec_slave_clear_sync_managers(slave);
+    ec_snapshot_verify(&slave->master->snapshot, slave);
 
     slave->sii.alias =
         EC_READ_U16(slave->sii_words + 0x0004);
@@ -36,6 +36,7 @@
 #include "fsm_change.h"
 #include "fsm_coe.h"
 #include "fsm_pdo.h"
+#include "sii_cache.h"
 
 /****************************************************************************/
 
@@ -55,6 +56,9 @@ struct ec_fsm_slave_scan
 
     void (*state)(ec_fsm_slave_scan_t *); /**< State function. */
     uint16_t sii_offset; /**< SII offset in words. */
+#ifdef EC_SII_CACHE
+    uint16_t sii_ident[EC_SII_IDENT_WORDS]; /**< SII identity words. */
+#endif
 
     ec_fsm_sii_t fsm_sii; /**< SII state machine. */
 };
@@ -202,6 +202,28 @@ typedef enum {
 
 extern const char *ec_device_names[2]; // only main and backup!
 
+/** Working counter diagnosis findings.
+ *
+ * Reasons, why a slave configuration does not contribute to the working
+ * counter of its domain.
+ */
+enum {
+    EC_WC_DIAG_OFFLINE = 0x01, /**< No slave attached to the configuration. */
+    EC_WC_DIAG_NO_RESPONSE = 0x02, /**< Slave did not respond. */
+    EC_WC_DIAG_AL_STATE = 0x04, /**< AL state too low for the direction. */
+    EC_WC_DIAG_AL_ERROR = 0x08, /**< AL error indicator set. */
+    EC_WC_DIAG_FMMU = 0x10, /**< FMMU disabled or configured differently. */
+    EC_WC_DIAG_SM = 0x20 /**< Sync manager disabled. */
+};
+
+/** Working counter diagnosis state of a domain.
+ */
+typedef enum {
+    EC_WC_DIAG_IDLE, /**< No diagnosis done yet. */
+    EC_WC_DIAG_BUSY, /**< Diagnosis in progress. */
+    EC_WC_DIAG_DONE /**< Diagnosis finished. */
+} ec_wc_diag_state_t;
+
 /****************************************************************************/
 
 /** Convenience macro for printing EtherCAT-specific information to syslog.
@@ -204,6 +204,8 @@ static ATTRIBUTES int ec_ioctl_master(
     io.dc_ref_time = master->dc_ref_time;
     io.ref_clock =
         master->dc_ref_clock ? master->dc_ref_clock->ring_position : 0xffff;
+    io.fsm_slots = master->fsm_slots;
+    io.ext_ring_size = master->ext_ring_size;
 
     if (copy_to_user((void __user *) arg, &io, sizeof(io))) {
         return -EFAULT;
@@ -516,6 +518,9 @@ static ATTRIBUTES int ec_ioctl_domain(
     }
     data.expected_working_counter = domain->expected_working_counter;
     data.fmmu_count = ec_domain_fmmu_count(domain);
+    data.diag_state = domain->diag_state;
+    data.diag_working_counter = domain->diag_working_counter;
+    data.diag_count = domain->diag_count;
 
     up(&master->master_sem);
 
@@ -568,6 +573,9 @@ static ATTRIBUTES int ec_ioctl_domain_fmmu(
     data.dir = fmmu->dir;
     data.logical_address = fmmu->logical_start_address;
     data.data_size = fmmu->data_size;
+    data.diag_flags = fmmu->diag_flags;
+    data.diag_al_state = fmmu->diag_al_state;
+    data.diag_al_status_code = fmmu->diag_al_status_code;
 
     up(&master->master_sem);
 
@@ -624,82 +632,159 @@ static ATTRIBUTES int ec_ioctl_domain_data(
 
 /****************************************************************************/
 
-/** Set master debug level.
+/** Read the flight recorder of a domain.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_master_debug(
+static ATTRIBUTES int ec_ioctl_recorder_read(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg /**< Userspace address to store the results. */
         )
 {
-    return ec_master_debug_level(master, (unsigned long) arg);
+    ec_ioctl_recorder_read_t data;
+    const ec_domain_t *domain;
+    const ec_recorder_t *rec;
+    size_t size;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(domain = ec_master_find_domain_const(master, data.domain_index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Domain %u does not exist!\n",
+                data.domain_index);
+        return -EINVAL;
+    }
+
+    rec = &domain->recorder;
+    if (!rec->header) {
+        memset(&data.header, 0, sizeof(data.header));
+        data.header.state = EC_RECORDER_OFF;
+        data.size = 0;
+    } else {
+        data.header = *rec->header;
+        size = rec->mem_size - EC_RECORDER_HEADER_SIZE;
+        if (data.target && data.size) {
+            /* The ring is copied only, after the realtime path acknowledged
+             * the freeze. Re-arm requests are excluded via master_sem. */
+            if (!ec_recorder_frozen(rec)) {
+                up(&master->master_sem);
+                return -EBUSY;
+            }
+            data.header = *rec->header;
+            if (data.size < size) {
+                size = data.size;
+            }
+            if (copy_to_user((void __user *) data.target, rec->records,
+                        size)) {
+                up(&master->master_sem);
+                return -EFAULT;
+            }
+        }
+        data.size = size;
+    }
+
+    up(&master->master_sem);
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Issue a bus scan.
+/** Freeze the flight recorder of a domain.
  *
- * \return Always zero (success).
+ * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_master_rescan(
+static ATTRIBUTES int ec_ioctl_recorder_freeze(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    master->fsm.rescan_required = 1;
-    return 0;
+    ec_domain_t *domain;
+    int ret;
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(domain = ec_master_find_domain(master, (unsigned long) arg))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    ret = ec_recorder_freeze(&domain->recorder);
+    up(&master->master_sem);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Set slave state.
+/** Enable or disable merging of domain datagrams.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_state(
+static ATTRIBUTES int ec_ioctl_domain_merging(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_slave_state_t data;
-    ec_slave_t *slave;
+    return ecrt_master_set_domain_merging(master, (unsigned long) arg != 0);
+}
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
-        return -EFAULT;
-    }
+/****************************************************************************/
+
+/** Re-arm the flight recorder of a domain.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_recorder_arm(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_domain_t *domain;
+    int ret;
 
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(slave = ec_master_find_slave(
-                    master, 0, data.slave_position))) {
+    if (!(domain = ec_master_find_domain(master, (unsigned long) arg))) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                data.slave_position);
-        return -EINVAL;
+        return -ENOENT;
     }
 
-    ec_slave_request_state(slave, data.al_state);
-
+    ret = ec_recorder_arm(&domain->recorder);
     up(&master->master_sem);
-    return 0;
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Get slave SDO information.
+/** Read the startup timeline.
+ *
+ * The available events are copied from the oldest to the newest one.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_sdo(
+static ATTRIBUTES int ec_ioctl_timeline(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg /**< Userspace address to store the results. */
         )
 {
-    ec_ioctl_slave_sdo_t data;
-    const ec_slave_t *slave;
-    const ec_sdo_t *sdo;
+    ec_ioctl_timeline_t data;
+    ec_ioctl_timeline_event_t event;
+    const ec_timeline_t *timeline = &master->timeline;
+    const ec_timeline_event_t *ev;
+    ec_ioctl_timeline_event_t __user *target;
+    uint64_t first;
+    uint32_t i, count;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
@@ -708,48 +793,84 @@ static ATTRIBUTES int ec_ioctl_slave_sdo(
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(slave = ec_master_find_slave_const(
-                    master, 0, data.slave_position))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                data.slave_position);
-        return -EINVAL;
+    data.size = EC_TIMELINE_SIZE;
+    data.write_count = timeline->write_count;
+
+    if (timeline->write_count > EC_TIMELINE_SIZE) {
+        first = timeline->write_count - EC_TIMELINE_SIZE;
+        count = EC_TIMELINE_SIZE;
+    } else {
+        first = 0;
+        count = timeline->write_count;
     }
 
-    if (!(sdo = ec_slave_get_sdo_by_pos_const(
-                    slave, data.sdo_position))) {
-        up(&master->master_sem);
-        EC_SLAVE_ERR(slave, "SDO %u does not exist!\n", data.sdo_position);
-        return -EINVAL;
+    if (!data.events) {
+        data.count = 0;
+    }
+    if (count > data.count) {
+        count = data.count;
     }
 
-    data.sdo_index = sdo->index;
-    data.max_subindex = sdo->max_subindex;
-    ec_ioctl_strcpy(data.name, sdo->name);
+    target = (ec_ioctl_timeline_event_t __user *) data.events;
+    memset(&event, 0, sizeof(event));
+
+    for (i = 0; i < count; i++) {
+        ev = &timeline->events[(first + i) % EC_TIMELINE_SIZE];
+        event.time = ev->time;
+        event.slave_position = ev->position;
+        event.fsm = ev->fsm;
+        strncpy(event.state, ev->state, EC_TIMELINE_STATE_SIZE - 1);
+        if (copy_to_user(target + i, &event, sizeof(event))) {
+            up(&master->master_sem);
+            return -EFAULT;
+        }
+    }
 
+    data.count = count;
     up(&master->master_sem);
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+    if (copy_to_user((void __user *) arg, &data, sizeof(data))) {
         return -EFAULT;
+    }
 
     return 0;
 }
 
 /****************************************************************************/
 
-/** Get slave SDO entry information.
+/** Discard the events of the startup timeline.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_sdo_entry(
+static ATTRIBUTES int ec_ioctl_timeline_reset(
+        ec_master_t *master /**< EtherCAT master. */
+        )
+{
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ec_timeline_reset(&master->timeline);
+    up(&master->master_sem);
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Export a warm-start snapshot.
+ *
+ * If the target memory is too small, only the required size is returned.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_snapshot(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg /**< Userspace address to store the results. */
         )
 {
-    ec_ioctl_slave_sdo_entry_t data;
-    const ec_slave_t *slave;
-    const ec_sdo_t *sdo;
-    const ec_sdo_entry_t *entry;
+    ec_ioctl_snapshot_t data;
+    uint8_t *buffer = NULL;
+    size_t length;
+    int ret = 0;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
@@ -758,171 +879,177 @@ static ATTRIBUTES int ec_ioctl_slave_sdo_entry(
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(slave = ec_master_find_slave_const(
-                    master, 0, data.slave_position))) {
+    if (master->scan_busy) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                data.slave_position);
-        return -EINVAL;
+        return -EAGAIN;
     }
 
-    if (data.sdo_spec <= 0) {
-        if (!(sdo = ec_slave_get_sdo_by_pos_const(
-                        slave, -data.sdo_spec))) {
-            up(&master->master_sem);
-            EC_SLAVE_ERR(slave, "SDO %u does not exist!\n", -data.sdo_spec);
-            return -EINVAL;
-        }
-    } else {
-        if (!(sdo = ec_slave_get_sdo_const(
-                        slave, data.sdo_spec))) {
+    length = ec_snapshot_export(master, NULL, 0);
+
+    if (data.data && data.size >= length) {
+        if (!(buffer = vmalloc(length))) {
             up(&master->master_sem);
-            EC_SLAVE_ERR(slave, "SDO 0x%04X does not exist!\n",
-                    data.sdo_spec);
-            return -EINVAL;
+            return -ENOMEM;
         }
+        ec_snapshot_export(master, buffer, length);
     }
 
-    if (!(entry = ec_sdo_get_entry_const(
-                    sdo, data.sdo_entry_subindex))) {
-        up(&master->master_sem);
-        EC_SLAVE_ERR(slave, "SDO entry 0x%04X:%02X does not exist!\n",
-                sdo->index, data.sdo_entry_subindex);
-        return -EINVAL;
-    }
+    up(&master->master_sem);
 
-    data.data_type = entry->data_type;
-    data.bit_length = entry->bit_length;
-    data.read_access[EC_SDO_ENTRY_ACCESS_PREOP] =
-        entry->read_access[EC_SDO_ENTRY_ACCESS_PREOP];
-    data.read_access[EC_SDO_ENTRY_ACCESS_SAFEOP] =
-        entry->read_access[EC_SDO_ENTRY_ACCESS_SAFEOP];
-    data.read_access[EC_SDO_ENTRY_ACCESS_OP] =
-        entry->read_access[EC_SDO_ENTRY_ACCESS_OP];
-    data.write_access[EC_SDO_ENTRY_ACCESS_PREOP] =
-        entry->write_access[EC_SDO_ENTRY_ACCESS_PREOP];
-    data.write_access[EC_SDO_ENTRY_ACCESS_SAFEOP] =
-        entry->write_access[EC_SDO_ENTRY_ACCESS_SAFEOP];
-    data.write_access[EC_SDO_ENTRY_ACCESS_OP] =
-        entry->write_access[EC_SDO_ENTRY_ACCESS_OP];
-    ec_ioctl_strcpy(data.description, entry->description);
+    if (buffer) {
+        if (copy_to_user((void __user *) data.data, buffer, length)) {
+            ret = -EFAULT;
+        }
+        vfree(buffer);
+        if (ret) {
+            return ret;
+        }
+    }
 
-    up(&master->master_sem);
+    data.length = length;
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+    if (copy_to_user((void __user *) arg, &data, sizeof(data))) {
         return -EFAULT;
+    }
 
     return 0;
 }
 
 /****************************************************************************/
 
-/** Upload SDO.
+/** Export the SDO dictionary of a slave.
+ *
+ * If the target memory is too small, only the required size is returned.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_sdo_upload(
+static ATTRIBUTES int ec_ioctl_slave_sdo_dict(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg /**< Userspace address to store the results. */
         )
 {
-    ec_ioctl_slave_sdo_upload_t data;
-    uint8_t *target;
-    int ret;
+    ec_ioctl_slave_sdo_dict_t data;
+    const ec_slave_t *slave;
+    uint8_t *buffer = NULL;
+    size_t length;
+    int ret = 0;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (!(target = kmalloc(data.target_size, GFP_KERNEL))) {
-        EC_MASTER_ERR(master, "Failed to allocate %zu bytes"
-                " for SDO upload.\n", data.target_size);
-        return -ENOMEM;
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(slave = ec_master_find_slave_const(
+                    master, 0, data.slave_position))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                data.slave_position);
+        return -EINVAL;
     }
 
-    ret = ecrt_master_sdo_upload(master, data.slave_position,
-            data.sdo_index, data.sdo_entry_subindex, target,
-            data.target_size, &data.data_size, &data.abort_code);
+    if (!slave->sdo_dict) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
 
-    if (!ret) {
-        if (copy_to_user((void __user *) data.target,
-                    target, data.data_size)) {
-            kfree(target);
-            return -EFAULT;
+    length = ec_sdo_dict_export(slave->sdo_dict, NULL, 0);
+
+    if (data.data && data.size >= length) {
+        if (!(buffer = vmalloc(length))) {
+            up(&master->master_sem);
+            return -ENOMEM;
         }
+        ec_sdo_dict_export(slave->sdo_dict, buffer, length);
     }
 
-    kfree(target);
+    up(&master->master_sem);
 
-    if (__copy_to_user((void __user *) arg, &data, sizeof(data))) {
+    if (buffer) {
+        if (copy_to_user((void __user *) data.data, buffer, length)) {
+            ret = -EFAULT;
+        }
+        vfree(buffer);
+        if (ret) {
+            return ret;
+        }
+    }
+
+    data.length = length;
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data))) {
         return -EFAULT;
     }
 
-    return ret;
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Download SDO.
+/** Set master debug level.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_sdo_download(
+static ATTRIBUTES int ec_ioctl_master_debug(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_slave_sdo_download_t data;
-    uint8_t *sdo_data;
-    int retval;
+    return ec_master_debug_level(master, (unsigned long) arg);
+}
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
-        return -EFAULT;
-    }
+/****************************************************************************/
 
-    if (!(sdo_data = kmalloc(data.data_size, GFP_KERNEL))) {
-        EC_MASTER_ERR(master, "Failed to allocate %zu bytes"
-                " for SDO download.\n", data.data_size);
-        return -ENOMEM;
-    }
+/** Set the maximum number of slave FSMs executed in parallel.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_master_fsm_slots(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    int ret;
 
-    if (copy_from_user(sdo_data, (void __user *) data.data, data.data_size)) {
-        kfree(sdo_data);
-        return -EFAULT;
-    }
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
 
-    if (data.complete_access) {
-        retval = ecrt_master_sdo_download_complete(master, data.slave_position,
-                data.sdo_index, sdo_data, data.data_size, &data.abort_code);
-    } else {
-        retval = ecrt_master_sdo_download(master, data.slave_position,
-                data.sdo_index, data.sdo_entry_subindex, sdo_data,
-                data.data_size, &data.abort_code);
-    }
+    ret = ec_master_set_fsm_slots(master, (unsigned long) arg);
 
-    kfree(sdo_data);
+    up(&master->master_sem);
+    return ret;
+}
 
-    if (__copy_to_user((void __user *) arg, &data, sizeof(data))) {
-        retval = -EFAULT;
-    }
+/****************************************************************************/
 
-    return retval;
+/** Issue a bus scan.
+ *
+ * \return Always zero (success).
+ */
+static ATTRIBUTES int ec_ioctl_master_rescan(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    master->fsm.rescan_required = 1;
+    master->fsm.hotplug = 0;
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Read a slave's SII.
+/** Set slave state.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_sii_read(
+static ATTRIBUTES int ec_ioctl_slave_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_slave_sii_t data;
-    const ec_slave_t *slave;
-    int retval;
+    ec_ioctl_slave_state_t data;
+    ec_slave_t *slave;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
@@ -931,7 +1058,7 @@ static ATTRIBUTES int ec_ioctl_slave_sii_read(
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(slave = ec_master_find_slave_const(
+    if (!(slave = ec_master_find_slave(
                     master, 0, data.slave_position))) {
         up(&master->master_sem);
         EC_MASTER_ERR(master, "Slave %u does not exist!\n",
@@ -939,764 +1066,718 @@ static ATTRIBUTES int ec_ioctl_slave_sii_read(
         return -EINVAL;
     }
 
-    if (!data.nwords
-            || data.offset + data.nwords > slave->sii_nwords) {
-        up(&master->master_sem);
-        EC_SLAVE_ERR(slave, "Invalid SII read offset/size %u/%u for slave SII"
-                " size %zu!\n", data.offset, data.nwords, slave->sii_nwords);
-        return -EINVAL;
-    }
-
-    if (copy_to_user((void __user *) data.words,
-                slave->sii_words + data.offset, data.nwords * 2))
-        retval = -EFAULT;
-    else
-        retval = 0;
+    ec_slave_request_state(slave, data.al_state);
 
     up(&master->master_sem);
-    return retval;
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Write a slave's SII.
+/** Get slave SDO information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_sii_write(
+static ATTRIBUTES int ec_ioctl_slave_sdo(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_slave_sii_t data;
-    ec_slave_t *slave;
-    unsigned int byte_size;
-    uint16_t *words;
-    ec_sii_write_request_t request;
+    ec_ioctl_slave_sdo_t data;
+    const ec_slave_t *slave;
+    const ec_sdo_t *sdo;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (!data.nwords) {
-        return 0;
-    }
-
-    byte_size = sizeof(uint16_t) * data.nwords;
-    if (!(words = kmalloc(byte_size, GFP_KERNEL))) {
-        EC_MASTER_ERR(master, "Failed to allocate %u bytes"
-                " for SII contents.\n", byte_size);
-        return -ENOMEM;
-    }
-
-    if (copy_from_user(words,
-                (void __user *) data.words, byte_size)) {
-        kfree(words);
-        return -EFAULT;
-    }
-
-    if (down_interruptible(&master->master_sem)) {
-        kfree(words);
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
-    }
 
-    if (!(slave = ec_master_find_slave(
+    if (!(slave = ec_master_find_slave_const(
                     master, 0, data.slave_position))) {
         up(&master->master_sem);
         EC_MASTER_ERR(master, "Slave %u does not exist!\n",
                 data.slave_position);
-        kfree(words);
         return -EINVAL;
     }
 
-    // init SII write request
-    INIT_LIST_HEAD(&request.list);
-    request.slave = slave;
-    request.words = words;
-    request.offset = data.offset;
-    request.nwords = data.nwords;
-    request.state = EC_INT_REQUEST_QUEUED;
-
-    // schedule SII write request.
-    list_add_tail(&request.list, &master->sii_requests);
-
-    up(&master->master_sem);
-
-    // wait for processing through FSM
-    if (wait_event_interruptible(master->request_queue,
-                request.state != EC_INT_REQUEST_QUEUED)) {
-        // interrupted by signal
-        down(&master->master_sem);
-        if (request.state == EC_INT_REQUEST_QUEUED) {
-            // abort request
-            list_del(&request.list);
-            up(&master->master_sem);
-            kfree(words);
-            return -EINTR;
-        }
+    if (!(sdo = ec_slave_get_sdo_by_pos_const(
+                    slave, data.sdo_position))) {
         up(&master->master_sem);
+        EC_SLAVE_ERR(slave, "SDO %u does not exist!\n", data.sdo_position);
+        return -EINVAL;
     }
 
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+    data.sdo_index = sdo->index;
+    data.max_subindex = sdo->max_subindex;
+    ec_ioctl_strcpy(data.name, sdo->name);
 
-    kfree(words);
+    up(&master->master_sem);
 
-    return request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Read a slave's registers.
+/** Get slave SDO entry information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_reg_read(
+static ATTRIBUTES int ec_ioctl_slave_sdo_entry(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_slave_reg_t io;
-    ec_slave_t *slave;
-    ec_reg_request_t request;
-    int ret;
+    ec_ioctl_slave_sdo_entry_t data;
+    const ec_slave_t *slave;
+    const ec_sdo_t *sdo;
+    const ec_sdo_entry_t *entry;
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (!io.size) {
-        return 0;
-    }
-
-    // init register request
-    ret = ec_reg_request_init(&request, io.size);
-    if (ret) {
-        return ret;
-    }
-
-    ret = ecrt_reg_request_read(&request, io.address, io.size);
-    if (ret) {
-        return ret;
-    }
-
-    if (down_interruptible(&master->master_sem)) {
-        ec_reg_request_clear(&request);
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
-    }
 
-    if (!(slave = ec_master_find_slave(
-                    master, 0, io.slave_position))) {
+    if (!(slave = ec_master_find_slave_const(
+                    master, 0, data.slave_position))) {
         up(&master->master_sem);
-        ec_reg_request_clear(&request);
         EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                io.slave_position);
+                data.slave_position);
         return -EINVAL;
     }
 
-    // schedule request.
-    list_add_tail(&request.list, &slave->reg_requests);
-
-    up(&master->master_sem);
-
-    // wait for processing through FSM
-    if (wait_event_interruptible(master->request_queue,
-                request.state != EC_INT_REQUEST_QUEUED)) {
-        // interrupted by signal
-        down(&master->master_sem);
-        if (request.state == EC_INT_REQUEST_QUEUED) {
-            // abort request
-            list_del(&request.list);
+    if (data.sdo_spec <= 0) {
+        if (!(sdo = ec_slave_get_sdo_by_pos_const(
+                        slave, -data.sdo_spec))) {
             up(&master->master_sem);
-            ec_reg_request_clear(&request);
-            return -EINTR;
+            EC_SLAVE_ERR(slave, "SDO %u does not exist!\n", -data.sdo_spec);
+            return -EINVAL;
         }
+    } else {
+        if (!(sdo = ec_slave_get_sdo_const(
+                        slave, data.sdo_spec))) {
+            up(&master->master_sem);
+            EC_SLAVE_ERR(slave, "SDO 0x%04X does not exist!\n",
+                    data.sdo_spec);
+            return -EINVAL;
+        }
+    }
+
+    if (!(entry = ec_sdo_get_entry_const(
+                    sdo, data.sdo_entry_subindex))) {
         up(&master->master_sem);
+        EC_SLAVE_ERR(slave, "SDO entry 0x%04X:%02X does not exist!\n",
+                sdo->index, data.sdo_entry_subindex);
+        return -EINVAL;
     }
 
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+    data.data_type = entry->data_type;
+    data.bit_length = entry->bit_length;
+    data.read_access[EC_SDO_ENTRY_ACCESS_PREOP] =
+        entry->read_access[EC_SDO_ENTRY_ACCESS_PREOP];
+    data.read_access[EC_SDO_ENTRY_ACCESS_SAFEOP] =
+        entry->read_access[EC_SDO_ENTRY_ACCESS_SAFEOP];
+    data.read_access[EC_SDO_ENTRY_ACCESS_OP] =
+        entry->read_access[EC_SDO_ENTRY_ACCESS_OP];
+    data.write_access[EC_SDO_ENTRY_ACCESS_PREOP] =
+        entry->write_access[EC_SDO_ENTRY_ACCESS_PREOP];
+    data.write_access[EC_SDO_ENTRY_ACCESS_SAFEOP] =
+        entry->write_access[EC_SDO_ENTRY_ACCESS_SAFEOP];
+    data.write_access[EC_SDO_ENTRY_ACCESS_OP] =
+        entry->write_access[EC_SDO_ENTRY_ACCESS_OP];
+    ec_ioctl_strcpy(data.description, entry->description);
 
-    if (request.state == EC_INT_REQUEST_SUCCESS) {
-        if (copy_to_user((void __user *) io.data, request.data, io.size)) {
-            return -EFAULT;
-        }
-    }
-    ec_reg_request_clear(&request);
+    up(&master->master_sem);
 
-    return request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Write a slave's registers.
+/** Upload SDO.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_reg_write(
+static ATTRIBUTES int ec_ioctl_slave_sdo_upload(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_slave_reg_t io;
-    ec_slave_t *slave;
-    ec_reg_request_t request;
+    ec_ioctl_slave_sdo_upload_t data;
+    uint8_t *target;
     int ret;
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
-        return -EFAULT;
-    }
-
-    if (!io.size) {
-        return 0;
-    }
-
-    // init register request
-    ret = ec_reg_request_init(&request, io.size);
-    if (ret) {
-        return ret;
-    }
-
-    if (copy_from_user(request.data, (void __user *) io.data, io.size)) {
-        ec_reg_request_clear(&request);
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    ret = ecrt_reg_request_write(&request, io.address, io.size);
-    if (ret) {
-        return ret;
+    if (!(target = kmalloc(data.target_size, GFP_KERNEL))) {
+        EC_MASTER_ERR(master, "Failed to allocate %zu bytes"
+                " for SDO upload.\n", data.target_size);
+        return -ENOMEM;
     }
 
-    if (down_interruptible(&master->master_sem)) {
-        ec_reg_request_clear(&request);
-        return -EINTR;
+    if (data.complete_access) {
+        ret = ecrt_master_sdo_upload_complete(master, data.slave_position,
+                data.sdo_index, target, data.target_size, &data.data_size,
+                &data.abort_code);
+    } else {
+        ret = ecrt_master_sdo_upload(master, data.slave_position,
+                data.sdo_index, data.sdo_entry_subindex, target,
+                data.target_size, &data.data_size, &data.abort_code);
     }
 
-    if (io.emergency) {
-        request.ring_position = io.slave_position;
-        // schedule request.
-        list_add_tail(&request.list, &master->emerg_reg_requests);
-    }
-    else {
-        if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
-            up(&master->master_sem);
-            ec_reg_request_clear(&request);
-            EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                    io.slave_position);
-            return -EINVAL;
+    if (!ret) {
+        if (copy_to_user((void __user *) data.target,
+                    target, data.data_size)) {
+            kfree(target);
+            return -EFAULT;
         }
-
-        // schedule request.
-        list_add_tail(&request.list, &slave->reg_requests);
     }
 
-    up(&master->master_sem);
+    kfree(target);
 
-    // wait for processing through FSM
-    if (wait_event_interruptible(master->request_queue,
-                request.state != EC_INT_REQUEST_QUEUED)) {
-        // interrupted by signal
-        down(&master->master_sem);
-        if (request.state == EC_INT_REQUEST_QUEUED) {
-            // abort request
-            list_del(&request.list);
-            up(&master->master_sem);
-            ec_reg_request_clear(&request);
-            return -EINTR;
-        }
-        up(&master->master_sem);
+    if (__copy_to_user((void __user *) arg, &data, sizeof(data))) {
+        return -EFAULT;
     }
 
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
-
-    ec_reg_request_clear(&request);
-
-    return request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Get slave configuration information.
+/** Download SDO.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config(
+static ATTRIBUTES int ec_ioctl_slave_sdo_download(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_config_t data;
-    const ec_slave_config_t *sc;
-    uint8_t i;
+    ec_ioctl_slave_sdo_download_t data;
+    uint8_t *sdo_data;
+    int retval;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (down_interruptible(&master->master_sem))
-        return -EINTR;
-
-    if (!(sc = ec_master_get_config_const(
-                    master, data.config_index))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                data.config_index);
-        return -EINVAL;
+    if (!(sdo_data = kmalloc(data.data_size, GFP_KERNEL))) {
+        EC_MASTER_ERR(master, "Failed to allocate %zu bytes"
+                " for SDO download.\n", data.data_size);
+        return -ENOMEM;
     }
 
-    data.alias = sc->alias;
-    data.position = sc->position;
-    data.vendor_id = sc->vendor_id;
-    data.product_code = sc->product_code;
-    for (i = 0; i < EC_MAX_SYNC_MANAGERS; i++) {
-        data.syncs[i].dir = sc->sync_configs[i].dir;
-        data.syncs[i].watchdog_mode = sc->sync_configs[i].watchdog_mode;
-        data.syncs[i].pdo_count =
-            ec_pdo_list_count(&sc->sync_configs[i].pdos);
+    if (copy_from_user(sdo_data, (void __user *) data.data, data.data_size)) {
+        kfree(sdo_data);
+        return -EFAULT;
     }
-    data.watchdog_divider = sc->watchdog_divider;
-    data.watchdog_intervals = sc->watchdog_intervals;
-    data.sdo_count = ec_slave_config_sdo_count(sc);
-    data.idn_count = ec_slave_config_idn_count(sc);
-    data.flag_count = ec_slave_config_flag_count(sc);
-    data.slave_position = sc->slave ? sc->slave->ring_position : -1;
-    data.dc_assign_activate = sc->dc_assign_activate;
-    for (i = 0; i < EC_SYNC_SIGNAL_COUNT; i++) {
-        data.dc_sync[i] = sc->dc_sync[i];
+
+    if (data.complete_access) {
+        retval = ecrt_master_sdo_download_complete(master, data.slave_position,
+                data.sdo_index, sdo_data, data.data_size, &data.abort_code);
+    } else {
+        retval = ecrt_master_sdo_download(master, data.slave_position,
+                data.sdo_index, data.sdo_entry_subindex, sdo_data,
+                data.data_size, &data.abort_code);
     }
 
-    up(&master->master_sem);
+    kfree(sdo_data);
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
-        return -EFAULT;
+    if (__copy_to_user((void __user *) arg, &data, sizeof(data))) {
+        retval = -EFAULT;
+    }
 
-    return 0;
+    return retval;
 }
 
 /****************************************************************************/
 
-/** Get slave configuration PDO information.
+/** Read a slave's SII.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config_pdo(
+static ATTRIBUTES int ec_ioctl_slave_sii_read(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_config_pdo_t data;
-    const ec_slave_config_t *sc;
-    const ec_pdo_t *pdo;
+    ec_ioctl_slave_sii_t data;
+    const ec_slave_t *slave;
+    int retval;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (data.sync_index >= EC_MAX_SYNC_MANAGERS) {
-        EC_MASTER_ERR(master, "Invalid sync manager index %u!\n",
-                data.sync_index);
-        return -EINVAL;
-    }
-
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(sc = ec_master_get_config_const(
-                    master, data.config_index))) {
+    if (!(slave = ec_master_find_slave_const(
+                    master, 0, data.slave_position))) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                data.config_index);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                data.slave_position);
         return -EINVAL;
     }
 
-    if (!(pdo = ec_pdo_list_find_pdo_by_pos_const(
-                    &sc->sync_configs[data.sync_index].pdos,
-                    data.pdo_pos))) {
+    if (!data.nwords
+            || data.offset + data.nwords > slave->sii_nwords) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Invalid PDO position!\n");
+        EC_SLAVE_ERR(slave, "Invalid SII read offset/size %u/%u for slave SII"
+                " size %zu!\n", data.offset, data.nwords, slave->sii_nwords);
         return -EINVAL;
     }
 
-    data.index = pdo->index;
-    data.entry_count = ec_pdo_entry_count(pdo);
-    ec_ioctl_strcpy(data.name, pdo->name);
+    if (copy_to_user((void __user *) data.words,
+                slave->sii_words + data.offset, data.nwords * 2))
+        retval = -EFAULT;
+    else
+        retval = 0;
 
     up(&master->master_sem);
-
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
-        return -EFAULT;
-
-    return 0;
+    return retval;
 }
 
 /****************************************************************************/
 
-/** Get slave configuration PDO entry information.
+/** Write a slave's SII.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config_pdo_entry(
+static ATTRIBUTES int ec_ioctl_slave_sii_write(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_config_pdo_entry_t data;
-    const ec_slave_config_t *sc;
-    const ec_pdo_t *pdo;
-    const ec_pdo_entry_t *entry;
+    ec_ioctl_slave_sii_t data;
+    ec_slave_t *slave;
+    unsigned int byte_size;
+    uint16_t *words;
+    ec_sii_write_request_t request;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (data.sync_index >= EC_MAX_SYNC_MANAGERS) {
-        EC_MASTER_ERR(master, "Invalid sync manager index %u!\n",
-                data.sync_index);
-        return -EINVAL;
+    if (!data.nwords) {
+        return 0;
     }
 
-    if (down_interruptible(&master->master_sem))
-        return -EINTR;
+    byte_size = sizeof(uint16_t) * data.nwords;
+    if (!(words = kmalloc(byte_size, GFP_KERNEL))) {
+        EC_MASTER_ERR(master, "Failed to allocate %u bytes"
+                " for SII contents.\n", byte_size);
+        return -ENOMEM;
+    }
 
-    if (!(sc = ec_master_get_config_const(
-                    master, data.config_index))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                data.config_index);
-        return -EINVAL;
+    if (copy_from_user(words,
+                (void __user *) data.words, byte_size)) {
+        kfree(words);
+        return -EFAULT;
     }
 
-    if (!(pdo = ec_pdo_list_find_pdo_by_pos_const(
-                    &sc->sync_configs[data.sync_index].pdos,
-                    data.pdo_pos))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Invalid PDO position!\n");
-        return -EINVAL;
+    if (down_interruptible(&master->master_sem)) {
+        kfree(words);
+        return -EINTR;
     }
 
-    if (!(entry = ec_pdo_find_entry_by_pos_const(
-                    pdo, data.entry_pos))) {
+    if (!(slave = ec_master_find_slave(
+                    master, 0, data.slave_position))) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Entry not found!\n");
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                data.slave_position);
+        kfree(words);
         return -EINVAL;
     }
 
-    data.index = entry->index;
-    data.subindex = entry->subindex;
-    data.bit_length = entry->bit_length;
-    ec_ioctl_strcpy(data.name, entry->name);
+    // init SII write request
+    INIT_LIST_HEAD(&request.list);
+    request.slave = slave;
+    request.words = words;
+    request.offset = data.offset;
+    request.nwords = data.nwords;
+    request.state = EC_INT_REQUEST_QUEUED;
 
-    up(&master->master_sem);
+    // schedule SII write request.
+    list_add_tail(&request.list, &master->sii_requests);
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
-        return -EFAULT;
+    up(&master->master_sem);
 
-    return 0;
+    // wait for processing through FSM
+    if (wait_event_interruptible(master->request_queue,
+                request.state != EC_INT_REQUEST_QUEUED)) {
+        // interrupted by signal
+        down(&master->master_sem);
+        if (request.state == EC_INT_REQUEST_QUEUED) {
+            // abort request
+            list_del(&request.list);
+            up(&master->master_sem);
+            kfree(words);
+            return -EINTR;
+        }
+        up(&master->master_sem);
+    }
+
+    // wait until master FSM has finished processing
+    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+
+    kfree(words);
+
+    return request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
 }
 
 /****************************************************************************/
 
-/** Get slave configuration SDO information.
+/** Read a slave's registers.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config_sdo(
+static ATTRIBUTES int ec_ioctl_slave_reg_read(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_config_sdo_t *ioctl;
-    const ec_slave_config_t *sc;
-    const ec_sdo_request_t *req;
+    ec_ioctl_slave_reg_t io;
+    ec_slave_t *slave;
+    ec_reg_request_t request;
+    int ret;
 
-    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
-        return -ENOMEM;
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+        return -EFAULT;
     }
 
-    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
-        kfree(ioctl);
-        return -EFAULT;
+    if (!io.size) {
+        return 0;
+    }
+
+    // init register request
+    ret = ec_reg_request_init(&request, io.size);
+    if (ret) {
+        return ret;
+    }
+
+    ret = ecrt_reg_request_read(&request, io.address, io.size);
+    if (ret) {
+        return ret;
     }
 
     if (down_interruptible(&master->master_sem)) {
-        kfree(ioctl);
+        ec_reg_request_clear(&request);
         return -EINTR;
     }
 
-    if (!(sc = ec_master_get_config_const(
-                    master, ioctl->config_index))) {
+    if (!(slave = ec_master_find_slave(
+                    master, 0, io.slave_position))) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                ioctl->config_index);
-        kfree(ioctl);
+        ec_reg_request_clear(&request);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                io.slave_position);
         return -EINVAL;
     }
 
-    if (!(req = ec_slave_config_get_sdo_by_pos_const(
-                    sc, ioctl->sdo_pos))) {
+    // schedule request.
+    list_add_tail(&request.list, &slave->reg_requests);
+
+    up(&master->master_sem);
+
+    // wait for processing through FSM
+    if (wait_event_interruptible(master->request_queue,
+                request.state != EC_INT_REQUEST_QUEUED)) {
+        // interrupted by signal
+        down(&master->master_sem);
+        if (request.state == EC_INT_REQUEST_QUEUED) {
+            // abort request
+            list_del(&request.list);
+            up(&master->master_sem);
+            ec_reg_request_clear(&request);
+            return -EINTR;
+        }
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Invalid SDO position!\n");
-        kfree(ioctl);
-        return -EINVAL;
     }
 
-    ioctl->index = req->index;
-    ioctl->subindex = req->subindex;
-    ioctl->size = req->data_size;
-    memcpy(ioctl->data, req->data,
-            min((u32) ioctl->size, (u32) EC_MAX_SDO_DATA_SIZE));
-    ioctl->complete_access = req->complete_access;
-
-    up(&master->master_sem);
+    // wait until master FSM has finished processing
+    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
 
-    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
-        kfree(ioctl);
-        return -EFAULT;
+    if (request.state == EC_INT_REQUEST_SUCCESS) {
+        if (copy_to_user((void __user *) io.data, request.data, io.size)) {
+            return -EFAULT;
+        }
     }
+    ec_reg_request_clear(&request);
 
-    kfree(ioctl);
-    return 0;
+    return request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
 }
 
 /****************************************************************************/
 
-/** Get slave configuration IDN information.
+/** Write a slave's registers.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config_idn(
+static ATTRIBUTES int ec_ioctl_slave_reg_write(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_config_idn_t *ioctl;
-    const ec_slave_config_t *sc;
-    const ec_soe_request_t *req;
+    ec_ioctl_slave_reg_t io;
+    ec_slave_t *slave;
+    ec_reg_request_t request;
+    int ret;
 
-    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
-        return -ENOMEM;
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+        return -EFAULT;
     }
 
-    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
-        kfree(ioctl);
+    if (!io.size) {
+        return 0;
+    }
+
+    // init register request
+    ret = ec_reg_request_init(&request, io.size);
+    if (ret) {
+        return ret;
+    }
+
+    if (copy_from_user(request.data, (void __user *) io.data, io.size)) {
+        ec_reg_request_clear(&request);
         return -EFAULT;
     }
 
+    ret = ecrt_reg_request_write(&request, io.address, io.size);
+    if (ret) {
+        return ret;
+    }
+
     if (down_interruptible(&master->master_sem)) {
-        kfree(ioctl);
+        ec_reg_request_clear(&request);
         return -EINTR;
     }
 
-    if (!(sc = ec_master_get_config_const(
-                    master, ioctl->config_index))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                ioctl->config_index);
-        kfree(ioctl);
-        return -EINVAL;
+    if (io.emergency) {
+        request.ring_position = io.slave_position;
+        // schedule request.
+        list_add_tail(&request.list, &master->emerg_reg_requests);
     }
+    else {
+        if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
+            up(&master->master_sem);
+            ec_reg_request_clear(&request);
+            EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                    io.slave_position);
+            return -EINVAL;
+        }
 
-    if (!(req = ec_slave_config_get_idn_by_pos_const(
-                    sc, ioctl->idn_pos))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Invalid IDN position!\n");
-        kfree(ioctl);
-        return -EINVAL;
+        // schedule request.
+        list_add_tail(&request.list, &slave->reg_requests);
     }
 
-    ioctl->drive_no = req->drive_no;
-    ioctl->idn = req->idn;
-    ioctl->state = req->al_state;
-    ioctl->size = req->data_size;
-    memcpy(ioctl->data, req->data,
-            min((u32) ioctl->size, (u32) EC_MAX_IDN_DATA_SIZE));
-
     up(&master->master_sem);
 
-    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
-        kfree(ioctl);
-        return -EFAULT;
+    // wait for processing through FSM
+    if (wait_event_interruptible(master->request_queue,
+                request.state != EC_INT_REQUEST_QUEUED)) {
+        // interrupted by signal
+        down(&master->master_sem);
+        if (request.state == EC_INT_REQUEST_QUEUED) {
+            // abort request
+            list_del(&request.list);
+            up(&master->master_sem);
+            ec_reg_request_clear(&request);
+            return -EINTR;
+        }
+        up(&master->master_sem);
     }
 
-    kfree(ioctl);
-    return 0;
+    // wait until master FSM has finished processing
+    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+
+    ec_reg_request_clear(&request);
+
+    return request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
 }
 
 /****************************************************************************/
 
-/** Get slave configuration feature flag information.
+/** Get slave configuration information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config_flag(
+static ATTRIBUTES int ec_ioctl_config(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_config_flag_t *ioctl;
+    ec_ioctl_config_t data;
     const ec_slave_config_t *sc;
-    const ec_flag_t *flag;
-    size_t size;
-
-    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
-        return -ENOMEM;
-    }
+    uint8_t i;
 
-    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
-        kfree(ioctl);
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (down_interruptible(&master->master_sem)) {
-        kfree(ioctl);
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
-    }
 
     if (!(sc = ec_master_get_config_const(
-                    master, ioctl->config_index))) {
+                    master, data.config_index))) {
         up(&master->master_sem);
         EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                ioctl->config_index);
-        kfree(ioctl);
+                data.config_index);
         return -EINVAL;
     }
 
-    if (!(flag = ec_slave_config_get_flag_by_pos_const(
-                    sc, ioctl->flag_pos))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Invalid flag position!\n");
-        kfree(ioctl);
-        return -EINVAL;
+    data.alias = sc->alias;
+    data.position = sc->position;
+    data.vendor_id = sc->vendor_id;
+    data.product_code = sc->product_code;
+    for (i = 0; i < EC_MAX_SYNC_MANAGERS; i++) {
+        data.syncs[i].dir = sc->sync_configs[i].dir;
+        data.syncs[i].watchdog_mode = sc->sync_configs[i].watchdog_mode;
+        data.syncs[i].pdo_count =
+            ec_pdo_list_count(&sc->sync_configs[i].pdos);
+    }
+    data.watchdog_divider = sc->watchdog_divider;
+    data.watchdog_intervals = sc->watchdog_intervals;
+    data.sdo_count = ec_slave_config_sdo_count(sc);
+    data.idn_count = ec_slave_config_idn_count(sc);
+    data.flag_count = ec_slave_config_flag_count(sc);
+    data.slave_position = sc->slave ? sc->slave->ring_position : -1;
+    data.dc_assign_activate = sc->dc_assign_activate;
+    for (i = 0; i < EC_SYNC_SIGNAL_COUNT; i++) {
+        data.dc_sync[i] = sc->dc_sync[i];
     }
 
-    size = min((u32) strlen(flag->key), (u32) EC_MAX_FLAG_KEY_SIZE - 1);
-    memcpy(ioctl->key, flag->key, size);
-    ioctl->key[size] = 0x00;
-    ioctl->value = flag->value;
-
     up(&master->master_sem);
 
-    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
-        kfree(ioctl);
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
         return -EFAULT;
-    }
 
-    kfree(ioctl);
     return 0;
 }
 
 /****************************************************************************/
 
-#ifdef EC_EOE
-
-/** Get configured EoE IP parameters for a given slave configuration.
+/** Get slave configuration PDO information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_config_ip(
+static ATTRIBUTES int ec_ioctl_config_pdo(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_eoe_ip_t *ioctl;
+    ec_ioctl_config_pdo_t data;
     const ec_slave_config_t *sc;
-    const ec_eoe_request_t *req;
+    const ec_pdo_t *pdo;
 
-    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
-        return -ENOMEM;
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
     }
 
-    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
-        kfree(ioctl);
-        return -EFAULT;
+    if (data.sync_index >= EC_MAX_SYNC_MANAGERS) {
+        EC_MASTER_ERR(master, "Invalid sync manager index %u!\n",
+                data.sync_index);
+        return -EINVAL;
     }
 
-    if (down_interruptible(&master->master_sem)) {
-        kfree(ioctl);
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
-    }
 
-    if (!(sc = ec_master_get_config_const(master, ioctl->config_index))) {
+    if (!(sc = ec_master_get_config_const(
+                    master, data.config_index))) {
         up(&master->master_sem);
         EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
-                ioctl->config_index);
-        kfree(ioctl);
+                data.config_index);
         return -EINVAL;
     }
 
-    req = &sc->eoe_ip_param_request;
-
-    ioctl->mac_address_included = req->mac_address_included;
-    ioctl->ip_address_included = req->ip_address_included;
-    ioctl->subnet_mask_included = req->subnet_mask_included;
-    ioctl->gateway_included = req->gateway_included;
-    ioctl->dns_included = req->dns_included;
-    ioctl->name_included = req->name_included;
+    if (!(pdo = ec_pdo_list_find_pdo_by_pos_const(
+                    &sc->sync_configs[data.sync_index].pdos,
+                    data.pdo_pos))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Invalid PDO position!\n");
+        return -EINVAL;
+    }
 
-    memcpy(ioctl->mac_address, req->mac_address, EC_ETH_ALEN);
-    ioctl->ip_address = req->ip_address;
-    ioctl->subnet_mask = req->subnet_mask;
-    ioctl->gateway = req->gateway;
-    ioctl->dns = req->dns;
-    strncpy(ioctl->name, req->name, EC_MAX_HOSTNAME_SIZE);
+    data.index = pdo->index;
+    data.entry_count = ec_pdo_entry_count(pdo);
+    ec_ioctl_strcpy(data.name, pdo->name);
 
     up(&master->master_sem);
 
-    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
-        kfree(ioctl);
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
         return -EFAULT;
-    }
 
-    kfree(ioctl);
     return 0;
 }
 
-#endif
-
 /****************************************************************************/
 
-#ifdef EC_EOE
-
-/** Get EoE handler information.
+/** Get slave configuration PDO entry information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_eoe_handler(
+static ATTRIBUTES int ec_ioctl_config_pdo_entry(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_eoe_handler_t data;
-    const ec_eoe_t *eoe;
+    ec_ioctl_config_pdo_entry_t data;
+    const ec_slave_config_t *sc;
+    const ec_pdo_t *pdo;
+    const ec_pdo_entry_t *entry;
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
+    if (data.sync_index >= EC_MAX_SYNC_MANAGERS) {
+        EC_MASTER_ERR(master, "Invalid sync manager index %u!\n",
+                data.sync_index);
+        return -EINVAL;
+    }
+
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(eoe = ec_master_get_eoe_handler_const(master, data.eoe_index))) {
+    if (!(sc = ec_master_get_config_const(
+                    master, data.config_index))) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "EoE handler %u does not exist!\n",
-                data.eoe_index);
+        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
+                data.config_index);
         return -EINVAL;
     }
 
-    if (eoe->slave) {
-        data.slave_position = eoe->slave->ring_position;
-    } else {
-        data.slave_position = 0xffff;
+    if (!(pdo = ec_pdo_list_find_pdo_by_pos_const(
+                    &sc->sync_configs[data.sync_index].pdos,
+                    data.pdo_pos))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Invalid PDO position!\n");
+        return -EINVAL;
     }
-    snprintf(data.name, EC_DATAGRAM_NAME_SIZE, eoe->dev->name);
-    data.open = eoe->opened;
-    data.rx_bytes = eoe->stats.tx_bytes;
-    data.rx_rate = eoe->tx_rate;
-    data.tx_bytes = eoe->stats.rx_bytes;
-    data.tx_rate = eoe->tx_rate;
-    data.tx_queued_frames = eoe->tx_queued_frames;
-    data.tx_queue_size = eoe->tx_queue_size;
+
+    if (!(entry = ec_pdo_find_entry_by_pos_const(
+                    pdo, data.entry_pos))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Entry not found!\n");
+        return -EINVAL;
+    }
+
+    data.index = entry->index;
+    data.subindex = entry->subindex;
+    data.bit_length = entry->bit_length;
+    ec_ioctl_strcpy(data.name, entry->name);
 
     up(&master->master_sem);
 
@@ -1706,183 +1787,783 @@ static ATTRIBUTES int ec_ioctl_eoe_handler(
     return 0;
 }
 
-#endif
-
 /****************************************************************************/
 
-#ifdef EC_EOE
-/** Request EoE IP parameter setting.
+/** Get slave configuration SDO information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_eoe_ip_param(
+static ATTRIBUTES int ec_ioctl_config_sdo(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_eoe_ip_t io;
-    ec_eoe_request_t req;
-    ec_slave_t *slave;
+    ec_ioctl_config_sdo_t *ioctl;
+    const ec_slave_config_t *sc;
+    const ec_sdo_request_t *req;
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
-        return -EFAULT;
+    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
+        return -ENOMEM;
     }
 
-    // init EoE request
-    ec_eoe_request_init(&req);
-
-    req.mac_address_included = io.mac_address_included;
-    req.ip_address_included = io.ip_address_included;
-    req.subnet_mask_included = io.subnet_mask_included;
-    req.gateway_included = io.gateway_included;
-    req.dns_included = io.dns_included;
-    req.name_included = io.name_included;
-
-    memcpy(req.mac_address, io.mac_address, EC_ETH_ALEN);
-    req.ip_address = io.ip_address;
-    req.subnet_mask = io.subnet_mask;
-    req.gateway = io.gateway;
-    req.dns = io.dns;
-    memcpy(req.name, io.name, EC_MAX_HOSTNAME_SIZE);
-
-    req.state = EC_INT_REQUEST_QUEUED;
+    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
 
     if (down_interruptible(&master->master_sem)) {
+        kfree(ioctl);
         return -EINTR;
     }
 
-    if (!(slave = ec_master_find_slave(
-                    master, 0, io.slave_position))) {
+    if (!(sc = ec_master_get_config_const(
+                    master, ioctl->config_index))) {
         up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                io.slave_position);
+        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
+                ioctl->config_index);
+        kfree(ioctl);
         return -EINVAL;
     }
 
-    EC_MASTER_DBG(master, 1, "Scheduling EoE request.\n");
-
-    // schedule request.
-    list_add_tail(&req.list, &slave->eoe_requests);
-
-    up(&master->master_sem);
-
-    // wait for processing through FSM
-    if (wait_event_interruptible(master->request_queue,
-                req.state != EC_INT_REQUEST_QUEUED)) {
-        // interrupted by signal
-        down(&master->master_sem);
-        if (req.state == EC_INT_REQUEST_QUEUED) {
-            // abort request
-            list_del(&req.list);
-            up(&master->master_sem);
-            return -EINTR;
-        }
+    if (!(req = ec_slave_config_get_sdo_by_pos_const(
+                    sc, ioctl->sdo_pos))) {
         up(&master->master_sem);
+        EC_MASTER_ERR(master, "Invalid SDO position!\n");
+        kfree(ioctl);
+        return -EINVAL;
     }
 
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, req.state != EC_INT_REQUEST_BUSY);
+    ioctl->index = req->index;
+    ioctl->subindex = req->subindex;
+    ioctl->size = req->data_size;
+    memcpy(ioctl->data, req->data,
+            min((u32) ioctl->size, (u32) EC_MAX_SDO_DATA_SIZE));
+    ioctl->complete_access = req->complete_access;
 
-    io.result = req.result;
+    up(&master->master_sem);
 
-    if (copy_to_user((void __user *) arg, &io, sizeof(io))) {
+    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
+        kfree(ioctl);
         return -EFAULT;
     }
 
-    return req.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+    kfree(ioctl);
+    return 0;
 }
-#endif
 
-/*****************************************************************************/
+/****************************************************************************/
 
-/** Request the master from userspace.
+/** Get slave configuration IDN information.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_request(
+static ATTRIBUTES int ec_ioctl_config_idn(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        void *arg /**< ioctl() argument. */
         )
 {
-    ec_master_t *m;
-    int ret = 0;
+    ec_ioctl_config_idn_t *ioctl;
+    const ec_slave_config_t *sc;
+    const ec_soe_request_t *req;
 
-    m = ecrt_request_master_err(master->index);
-    if (IS_ERR(m)) {
-        ret = PTR_ERR(m);
-    } else {
-        ctx->requested = 1;
+    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
+        return -ENOMEM;
     }
 
-    return ret;
-}
-
-/****************************************************************************/
+    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
 
-/** Create a domain.
- *
- * \return Domain index on success, otherwise a negative error code.
- */
-static ATTRIBUTES int ec_ioctl_create_domain(
-        ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
-        )
-{
-    ec_domain_t *domain;
+    if (down_interruptible(&master->master_sem)) {
+        kfree(ioctl);
+        return -EINTR;
+    }
 
+    if (!(sc = ec_master_get_config_const(
+                    master, ioctl->config_index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
+                ioctl->config_index);
+        kfree(ioctl);
+        return -EINVAL;
+    }
+
+    if (!(req = ec_slave_config_get_idn_by_pos_const(
+                    sc, ioctl->idn_pos))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Invalid IDN position!\n");
+        kfree(ioctl);
+        return -EINVAL;
+    }
+
+    ioctl->drive_no = req->drive_no;
+    ioctl->idn = req->idn;
+    ioctl->state = req->al_state;
+    ioctl->size = req->data_size;
+    memcpy(ioctl->data, req->data,
+            min((u32) ioctl->size, (u32) EC_MAX_IDN_DATA_SIZE));
+
+    up(&master->master_sem);
+
+    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
+
+    kfree(ioctl);
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Get slave configuration feature flag information.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_config_flag(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_config_flag_t *ioctl;
+    const ec_slave_config_t *sc;
+    const ec_flag_t *flag;
+    size_t size;
+
+    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
+        return -ENOMEM;
+    }
+
+    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        kfree(ioctl);
+        return -EINTR;
+    }
+
+    if (!(sc = ec_master_get_config_const(
+                    master, ioctl->config_index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
+                ioctl->config_index);
+        kfree(ioctl);
+        return -EINVAL;
+    }
+
+    if (!(flag = ec_slave_config_get_flag_by_pos_const(
+                    sc, ioctl->flag_pos))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Invalid flag position!\n");
+        kfree(ioctl);
+        return -EINVAL;
+    }
+
+    size = min((u32) strlen(flag->key), (u32) EC_MAX_FLAG_KEY_SIZE - 1);
+    memcpy(ioctl->key, flag->key, size);
+    ioctl->key[size] = 0x00;
+    ioctl->value = flag->value;
+
+    up(&master->master_sem);
+
+    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
+
+    kfree(ioctl);
+    return 0;
+}
+
+/****************************************************************************/
+
+#ifdef EC_EOE
+
+/** Get configured EoE IP parameters for a given slave configuration.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_config_ip(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_eoe_ip_t *ioctl;
+    const ec_slave_config_t *sc;
+    const ec_eoe_request_t *req;
+
+    if (!(ioctl = kmalloc(sizeof(*ioctl), GFP_KERNEL))) {
+        return -ENOMEM;
+    }
+
+    if (copy_from_user(ioctl, (void __user *) arg, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        kfree(ioctl);
+        return -EINTR;
+    }
+
+    if (!(sc = ec_master_get_config_const(master, ioctl->config_index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave config %u does not exist!\n",
+                ioctl->config_index);
+        kfree(ioctl);
+        return -EINVAL;
+    }
+
+    req = &sc->eoe_ip_param_request;
+
+    ioctl->mac_address_included = req->mac_address_included;
+    ioctl->ip_address_included = req->ip_address_included;
+    ioctl->subnet_mask_included = req->subnet_mask_included;
+    ioctl->gateway_included = req->gateway_included;
+    ioctl->dns_included = req->dns_included;
+    ioctl->name_included = req->name_included;
+
+    memcpy(ioctl->mac_address, req->mac_address, EC_ETH_ALEN);
+    ioctl->ip_address = req->ip_address;
+    ioctl->subnet_mask = req->subnet_mask;
+    ioctl->gateway = req->gateway;
+    ioctl->dns = req->dns;
+    strncpy(ioctl->name, req->name, EC_MAX_HOSTNAME_SIZE);
+
+    up(&master->master_sem);
+
+    if (copy_to_user((void __user *) arg, ioctl, sizeof(*ioctl))) {
+        kfree(ioctl);
+        return -EFAULT;
+    }
+
+    kfree(ioctl);
+    return 0;
+}
+
+#endif
+
+/****************************************************************************/
+
+#ifdef EC_EOE
+
+/** Get EoE handler information.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_eoe_handler(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_eoe_handler_t data;
+    const ec_eoe_t *eoe;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(eoe = ec_master_get_eoe_handler_const(master, data.eoe_index))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "EoE handler %u does not exist!\n",
+                data.eoe_index);
+        return -EINVAL;
+    }
+
+    if (eoe->slave) {
+        data.slave_position = eoe->slave->ring_position;
+    } else {
+        data.slave_position = 0xffff;
+    }
+    snprintf(data.name, EC_DATAGRAM_NAME_SIZE, eoe->dev->name);
+    data.open = eoe->opened;
+    data.rx_bytes = eoe->stats.tx_bytes;
+    data.rx_rate = eoe->tx_rate;
+    data.tx_bytes = eoe->stats.rx_bytes;
+    data.tx_rate = eoe->tx_rate;
+    data.tx_queued_frames = eoe->tx_queued_frames;
+    data.tx_queue_size = eoe->tx_queue_size;
+
+    up(&master->master_sem);
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+        return -EFAULT;
+
+    return 0;
+}
+
+#endif
+
+/****************************************************************************/
+
+#ifdef EC_EOE
+/** Request EoE IP parameter setting.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_slave_eoe_ip_param(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_eoe_ip_t io;
+    ec_eoe_request_t req;
+    ec_slave_t *slave;
+
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+        return -EFAULT;
+    }
+
+    // init EoE request
+    ec_eoe_request_init(&req);
+
+    req.mac_address_included = io.mac_address_included;
+    req.ip_address_included = io.ip_address_included;
+    req.subnet_mask_included = io.subnet_mask_included;
+    req.gateway_included = io.gateway_included;
+    req.dns_included = io.dns_included;
+    req.name_included = io.name_included;
+
+    memcpy(req.mac_address, io.mac_address, EC_ETH_ALEN);
+    req.ip_address = io.ip_address;
+    req.subnet_mask = io.subnet_mask;
+    req.gateway = io.gateway;
+    req.dns = io.dns;
+    memcpy(req.name, io.name, EC_MAX_HOSTNAME_SIZE);
+
+    req.state = EC_INT_REQUEST_QUEUED;
+
+    if (down_interruptible(&master->master_sem)) {
+        return -EINTR;
+    }
+
+    if (!(slave = ec_master_find_slave(
+                    master, 0, io.slave_position))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                io.slave_position);
+        return -EINVAL;
+    }
+
+    EC_MASTER_DBG(master, 1, "Scheduling EoE request.\n");
+
+    // schedule request.
+    list_add_tail(&req.list, &slave->eoe_requests);
+
+    up(&master->master_sem);
+
+    // wait for processing through FSM
+    if (wait_event_interruptible(master->request_queue,
+                req.state != EC_INT_REQUEST_QUEUED)) {
+        // interrupted by signal
+        down(&master->master_sem);
+        if (req.state == EC_INT_REQUEST_QUEUED) {
+            // abort request
+            list_del(&req.list);
+            up(&master->master_sem);
+            return -EINTR;
+        }
+        up(&master->master_sem);
+    }
+
+    // wait until master FSM has finished processing
+    wait_event(master->request_queue, req.state != EC_INT_REQUEST_BUSY);
+
+    io.result = req.result;
+
+    if (copy_to_user((void __user *) arg, &io, sizeof(io))) {
+        return -EFAULT;
+    }
+
+    return req.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+}
+#endif
+
+/*****************************************************************************/
+
+/** Request the master from userspace.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_request(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_master_t *m;
+    int ret = 0;
+
+    m = ecrt_request_master_err(master->index);
+    if (IS_ERR(m)) {
+        ret = PTR_ERR(m);
+    } else {
+        ctx->requested = 1;
+    }
+
+    return ret;
+}
+
+/****************************************************************************/
+
+/** Create a domain.
+ *
+ * \return Domain index on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_create_domain(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_domain_t *domain;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    domain = ecrt_master_create_domain_err(master);
+    if (IS_ERR(domain))
+        return PTR_ERR(domain);
+
+    return domain->index;
+}
+
+/****************************************************************************/
+
+/** Create a slave configuration.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_create_slave_config(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_config_t data;
+    ec_slave_config_t *sc, *entry;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    sc = ecrt_master_slave_config_err(master, data.alias, data.position,
+            data.vendor_id, data.product_code);
+    if (IS_ERR(sc))
+        return PTR_ERR(sc);
+
+    data.config_index = 0;
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    list_for_each_entry(entry, &master->configs, list) {
+        if (entry == sc)
+            break;
+        data.config_index++;
+    }
+
+    up(&master->master_sem);
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+        return -EFAULT;
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Select the DC reference clock.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_select_ref_clock(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    unsigned long config_index = (unsigned long) arg;
+    ec_slave_config_t *sc = NULL;
+    int ret = 0;
+
+    if (unlikely(!ctx->requested)) {
+        ret = -EPERM;
+        goto out_return;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        ret = -EINTR;
+        goto out_return;
+    }
+
+    if (config_index != 0xFFFFFFFF) {
+        if (!(sc = ec_master_get_config(master, config_index))) {
+            ret = -ENOENT;
+            goto out_up;
+        }
+    }
+
+    ecrt_master_select_reference_clock(master, sc);
+
+out_up:
+    up(&master->master_sem);
+out_return:
+    return ret;
+}
+
+/****************************************************************************/
+
+/** Activates the master.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_activate(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_ioctl_master_activate_t io;
+    ec_domain_t *domain;
+    off_t offset;
+    int ret;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    io.process_data = NULL;
+
+    /* Get the sum of the domains' process data sizes. */
+
+    ctx->process_data_size = 0;
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    list_for_each_entry(domain, &master->domains, list) {
+        ctx->process_data_size += ecrt_domain_size(domain);
+    }
+
+    up(&master->master_sem);
+
+    if (ctx->process_data_size) {
+        ctx->process_data = vmalloc(ctx->process_data_size);
+        if (!ctx->process_data) {
+            ctx->process_data_size = 0;
+            return -ENOMEM;
+        }
+
+        /* Set the memory as external process data memory for the
+         * domains.
+         */
+        offset = 0;
+        list_for_each_entry(domain, &master->domains, list) {
+            ecrt_domain_external_memory(domain,
+                    ctx->process_data + offset);
+            offset += ecrt_domain_size(domain);
+        }
+
+#if defined(EC_IOCTL_RTDM) && !defined(EC_RTDM_XENOMAI_V3)
+        /* RTDM uses a different approach for memory-mapping, which has to be
+         * initiated by the kernel.
+         */
+        ret = ec_rtdm_mmap(ctx, &io.process_data);
+        if (ret < 0) {
+            EC_MASTER_ERR(master, "Failed to map process data"
+                    " memory to user space (code %i).\n", ret);
+            return ret;
+        }
+#endif
+    }
+
+    io.process_data_size = ctx->process_data_size;
+
+#ifndef EC_IOCTL_RTDM
+    /* RTDM does not support locking yet. */
+    ecrt_master_callbacks(master, ec_master_internal_send_cb,
+            ec_master_internal_receive_cb, master);
+#endif
+
+    ret = ecrt_master_activate(master);
+    if (ret < 0)
+        return ret;
+
+    if (copy_to_user((void __user *) arg, &io,
+                sizeof(ec_ioctl_master_activate_t)))
+        return -EFAULT;
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Deactivates the master.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_deactivate(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    domain = ecrt_master_create_domain_err(master);
-    if (IS_ERR(domain))
-        return PTR_ERR(domain);
+    return ecrt_master_deactivate(master);
+}
 
-    return domain->index;
+/****************************************************************************/
+
+/** Set max. number of databytes in a cycle
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_set_send_interval(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    size_t send_interval;
+
+    if (unlikely(!ctx->requested)) {
+        return -EPERM;
+    }
+
+    if (copy_from_user(&send_interval, (void __user *) arg,
+                sizeof(send_interval))) {
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    ec_master_set_send_interval(master, send_interval);
+
+    up(&master->master_sem);
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Create a slave configuration.
+/** Configure the flight recorder of a domain.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_create_slave_config(
+static ATTRIBUTES int ec_ioctl_domain_recorder(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_config_t data;
-    ec_slave_config_t *sc, *entry;
+    ec_ioctl_recorder_t data;
+    ec_domain_t *domain;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
     if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    sc = ecrt_master_slave_config_err(master, data.alias, data.position,
-            data.vendor_id, data.product_code);
-    if (IS_ERR(sc))
-        return PTR_ERR(sc);
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
 
-    data.config_index = 0;
+    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
 
-    if (down_interruptible(&master->master_sem))
+    up(&master->master_sem); /** \todo domain could be invalidated */
+
+    return ecrt_domain_recorder(domain, data.depth, data.post_trigger,
+            data.triggers);
+}
+
+/****************************************************************************/
+
+/** Send frames.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_send(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    int ret;
+
+    if (unlikely(!ctx->requested)) {
+        return -EPERM;
+    }
+
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
         return -EINTR;
 
-    list_for_each_entry(entry, &master->configs, list) {
-        if (entry == sc)
-            break;
-        data.config_index++;
+    ret = ecrt_master_send(master);
+    ec_ioctl_unlock(&master->io_mutex);
+    return ret;
+}
+
+/****************************************************************************/
+
+/** Receive frames.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_receive(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    int ret;
+
+    if (unlikely(!ctx->requested)) {
+        return -EPERM;
     }
 
-    up(&master->master_sem);
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+        return -EINTR;
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+    ret = ecrt_master_receive(master);
+    ec_ioctl_unlock(&master->io_mutex);
+    return ret;
+}
+
+/****************************************************************************/
+
+/** Get the master state.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_master_state(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    ec_master_state_t data;
+    int ret;
+
+    ret = ecrt_master_state(master, &data);
+    if (ret)
+        return ret;
+
+    if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
         return -EFAULT;
 
     return 0;
@@ -1890,186 +2571,181 @@ static ATTRIBUTES int ec_ioctl_create_slave_config(
 
 /****************************************************************************/
 
-/** Select the DC reference clock.
+/** Get the link state.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_select_ref_clock(
+static ATTRIBUTES int ec_ioctl_master_link_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    unsigned long config_index = (unsigned long) arg;
-    ec_slave_config_t *sc = NULL;
-    int ret = 0;
+    ec_ioctl_link_state_t ioctl;
+    ec_master_link_state_t state;
+    int ret;
 
-    if (unlikely(!ctx->requested)) {
-        ret = -EPERM;
-        goto out_return;
+    if (ec_copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl), ctx)) {
+        return -EFAULT;
     }
 
-    if (down_interruptible(&master->master_sem)) {
-        ret = -EINTR;
-        goto out_return;
+    ret = ecrt_master_link_state(master, ioctl.dev_idx, &state);
+    if (ret < 0) {
+        return ret;
     }
 
-    if (config_index != 0xFFFFFFFF) {
-        if (!(sc = ec_master_get_config(master, config_index))) {
-            ret = -ENOENT;
-            goto out_up;
-        }
+    if (ec_copy_to_user((void __user *) ioctl.state,
+                        &state, sizeof(state), ctx)) {
+        return -EFAULT;
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Set the master DC application time.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_app_time(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    uint64_t time;
+
+    if (unlikely(!ctx->requested))
+        return -EPERM;
+
+    if (ec_copy_from_user(&time, (void __user *) arg, sizeof(time), ctx)) {
+        return -EFAULT;
     }
 
-    ecrt_master_select_reference_clock(master, sc);
-
-out_up:
-    up(&master->master_sem);
-out_return:
-    return ret;
+    return ecrt_master_application_time(master, time);
 }
 
 /****************************************************************************/
 
-/** Activates the master.
+/** Sync the reference clock.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_activate(
+static ATTRIBUTES int ec_ioctl_sync_ref(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_master_activate_t io;
-    ec_domain_t *domain;
-    off_t offset;
     int ret;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    io.process_data = NULL;
-
-    /* Get the sum of the domains' process data sizes. */
-
-    ctx->process_data_size = 0;
-
-    if (down_interruptible(&master->master_sem))
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
         return -EINTR;
 
-    list_for_each_entry(domain, &master->domains, list) {
-        ctx->process_data_size += ecrt_domain_size(domain);
-    }
+    ret = ecrt_master_sync_reference_clock(master);
+    ec_ioctl_unlock(&master->io_mutex);
+    return ret;
+}
 
-    up(&master->master_sem);
+/****************************************************************************/
 
-    if (ctx->process_data_size) {
-        ctx->process_data = vmalloc(ctx->process_data_size);
-        if (!ctx->process_data) {
-            ctx->process_data_size = 0;
-            return -ENOMEM;
-        }
+/** Sync the reference clock.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_sync_ref_to(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+    int ret;
+    uint64_t time;
 
-        /* Set the memory as external process data memory for the
-         * domains.
-         */
-        offset = 0;
-        list_for_each_entry(domain, &master->domains, list) {
-            ecrt_domain_external_memory(domain,
-                    ctx->process_data + offset);
-            offset += ecrt_domain_size(domain);
-        }
+    if (unlikely(!ctx->requested))
+        return -EPERM;
 
-#if defined(EC_IOCTL_RTDM) && !defined(EC_RTDM_XENOMAI_V3)
-        /* RTDM uses a different approach for memory-mapping, which has to be
-         * initiated by the kernel.
-         */
-        ret = ec_rtdm_mmap(ctx, &io.process_data);
-        if (ret < 0) {
-            EC_MASTER_ERR(master, "Failed to map process data"
-                    " memory to user space (code %i).\n", ret);
-            return ret;
-        }
-#endif
+    if (ec_copy_from_user(&time, (void __user *) arg, sizeof(time), ctx)) {
+        return -EFAULT;
     }
 
-    io.process_data_size = ctx->process_data_size;
-
-#ifndef EC_IOCTL_RTDM
-    /* RTDM does not support locking yet. */
-    ecrt_master_callbacks(master, ec_master_internal_send_cb,
-            ec_master_internal_receive_cb, master);
-#endif
-
-    ret = ecrt_master_activate(master);
-    if (ret < 0)
-        return ret;
-
-    if (copy_to_user((void __user *) arg, &io,
-                sizeof(ec_ioctl_master_activate_t)))
-        return -EFAULT;
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+        return -EINTR;
 
-    return 0;
+    ret = ecrt_master_sync_reference_clock_to(master, time);
+    ec_ioctl_unlock(&master->io_mutex);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Deactivates the master.
+/** Sync the slave clocks.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_deactivate(
+static ATTRIBUTES int ec_ioctl_sync_slaves(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    if (unlikely(!ctx->requested))
+    int ret;
+
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    return ecrt_master_deactivate(master);
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+        return -EINTR;
+
+    ret = ecrt_master_sync_slave_clocks(master);
+    ec_ioctl_unlock(&master->io_mutex);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Set max. number of databytes in a cycle
+/** Get the system time of the reference clock.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_set_send_interval(
+static ATTRIBUTES int ec_ioctl_ref_clock_time(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    size_t send_interval;
+    uint32_t time;
+    int ret;
 
     if (unlikely(!ctx->requested)) {
         return -EPERM;
     }
 
-    if (copy_from_user(&send_interval, (void __user *) arg,
-                sizeof(send_interval))) {
-        return -EFAULT;
+    ret = ecrt_master_reference_clock_time(master, &time);
+    if (ret) {
+        return ret;
     }
 
-    if (down_interruptible(&master->master_sem))
-        return -EINTR;
-
-    ec_master_set_send_interval(master, send_interval);
+    if (ec_copy_to_user((void __user *) arg, &time, sizeof(time), ctx)) {
+        return -EFAULT;
+    }
 
-    up(&master->master_sem);
     return 0;
 }
 
 /****************************************************************************/
 
-/** Send frames.
+/** Queue the sync monitoring datagram.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_send(
+static ATTRIBUTES int ec_ioctl_sync_mon_queue(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
@@ -2084,365 +2760,446 @@ static ATTRIBUTES int ec_ioctl_send(
     if (ec_ioctl_lock_interruptible(&master->io_mutex))
         return -EINTR;
 
-    ret = ecrt_master_send(master);
+    ret = ecrt_master_sync_monitor_queue(master);
     ec_ioctl_unlock(&master->io_mutex);
     return ret;
 }
 
 /****************************************************************************/
 
-/** Receive frames.
+/** Processes the sync monitoring datagram.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_receive(
+static ATTRIBUTES int ec_ioctl_sync_mon_process(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    int ret;
+    uint32_t time_diff;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
-        return -EINTR;
+    time_diff = ecrt_master_sync_monitor_process(master);
 
-    ret = ecrt_master_receive(master);
-    ec_ioctl_unlock(&master->io_mutex);
-    return ret;
+    if (ec_copy_to_user((void __user *) arg, &time_diff,
+                        sizeof(time_diff), ctx))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Get the master state.
+/** Reset configuration.
+ *
+ * \return Always zero (success).
+ */
+static ATTRIBUTES int ec_ioctl_reset(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        )
+{
+#ifdef EC_IOCTL_RTDM
+    /* Xenomai/LXRT is like NMI context, so we do a two-stage schedule. */
+    irq_work_queue(&master->sc_reset_work_kicker);
+#else
+    schedule_work(&master->sc_reset_work);
+#endif
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Configure a sync manager.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_master_state(
+static ATTRIBUTES int ec_ioctl_sc_sync(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_master_state_t data;
-    int ret;
+    ec_ioctl_config_t data;
+    ec_slave_config_t *sc;
+    unsigned int i;
+    int ret = 0;
 
-    ret = ecrt_master_state(master, &data);
-    if (ret)
-        return ret;
+    if (unlikely(!ctx->requested)) {
+        ret = -EPERM;
+        goto out_return;
+    }
 
-    if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
-        return -EFAULT;
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        ret = -EFAULT;
+        goto out_return;
+    }
 
-    return 0;
+    if (down_interruptible(&master->master_sem)) {
+        ret = -EINTR;
+        goto out_return;
+    }
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        ret = -ENOENT;
+        goto out_up;
+    }
+
+    for (i = 0; i < EC_MAX_SYNC_MANAGERS; i++) {
+        if (data.syncs[i].config_this) {
+            ret = ecrt_slave_config_sync_manager(sc, i, data.syncs[i].dir,
+                        data.syncs[i].watchdog_mode);
+            if (ret) {
+                goto out_up;
+            }
+        }
+    }
+
+out_up:
+    up(&master->master_sem);
+out_return:
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Get the link state.
+/** Configure a slave's watchdogs.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_master_link_state(
+static ATTRIBUTES int ec_ioctl_sc_watchdog(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_link_state_t ioctl;
-    ec_master_link_state_t state;
-    int ret;
+    ec_ioctl_config_t data;
+    ec_slave_config_t *sc;
+    int ret = 0;
 
-    if (ec_copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl), ctx)) {
-        return -EFAULT;
+    if (unlikely(!ctx->requested)) {
+        ret = -EPERM;
+        goto out_return;
     }
 
-    ret = ecrt_master_link_state(master, ioctl.dev_idx, &state);
-    if (ret < 0) {
-        return ret;
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+        ret = -EFAULT;
+        goto out_return;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        ret = -EINTR;
+        goto out_return;
     }
 
-    if (ec_copy_to_user((void __user *) ioctl.state,
-                        &state, sizeof(state), ctx)) {
-        return -EFAULT;
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        ret = -ENOENT;
+        goto out_up;
     }
 
-    return 0;
+    ret = ecrt_slave_config_watchdog(sc,
+            data.watchdog_divider, data.watchdog_intervals);
+
+out_up:
+    up(&master->master_sem);
+out_return:
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Set the master DC application time.
+/** Add a PDO to the assignment.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_app_time(
+static ATTRIBUTES int ec_ioctl_sc_add_pdo(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    uint64_t time;
+    ec_ioctl_config_pdo_t data;
+    ec_slave_config_t *sc;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (ec_copy_from_user(&time, (void __user *) arg, sizeof(time), ctx)) {
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
         return -EFAULT;
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
     }
 
-    return ecrt_master_application_time(master, time);
+    up(&master->master_sem); /** \todo sc could be invalidated */
+
+    return ecrt_slave_config_pdo_assign_add(sc, data.sync_index, data.index);
 }
 
 /****************************************************************************/
 
-/** Sync the reference clock.
+/** Clears the PDO assignment.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sync_ref(
+static ATTRIBUTES int ec_ioctl_sc_clear_pdos(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    int ret;
+    ec_ioctl_config_pdo_t data;
+    ec_slave_config_t *sc;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+        return -EFAULT;
+
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    ret = ecrt_master_sync_reference_clock(master);
-    ec_ioctl_unlock(&master->io_mutex);
-    return ret;
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    up(&master->master_sem); /** \todo sc could be invalidated */
+
+    return ecrt_slave_config_pdo_assign_clear(sc, data.sync_index);
 }
 
 /****************************************************************************/
 
-/** Sync the reference clock.
+/** Add an entry to a PDO's mapping.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sync_ref_to(
+static ATTRIBUTES int ec_ioctl_sc_add_entry(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    int ret;
-    uint64_t time;
+    ec_ioctl_add_pdo_entry_t data;
+    ec_slave_config_t *sc;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (ec_copy_from_user(&time, (void __user *) arg, sizeof(time), ctx)) {
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
         return -EFAULT;
-    }
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    ret = ecrt_master_sync_reference_clock_to(master, time);
-    ec_ioctl_unlock(&master->io_mutex);
-    return ret;
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    up(&master->master_sem); /** \todo sc could be invalidated */
+
+    return ecrt_slave_config_pdo_mapping_add(sc, data.pdo_index,
+            data.entry_index, data.entry_subindex, data.entry_bit_length);
 }
 
 /****************************************************************************/
 
-/** Sync the slave clocks.
+/** Clears the mapping of a PDO.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sync_slaves(
+static ATTRIBUTES int ec_ioctl_sc_clear_entries(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    int ret;
+    ec_ioctl_config_pdo_t data;
+    ec_slave_config_t *sc;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+        return -EFAULT;
+
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    ret = ecrt_master_sync_slave_clocks(master);
-    ec_ioctl_unlock(&master->io_mutex);
-    return ret;
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    up(&master->master_sem); /** \todo sc could be invalidated */
+
+    return ecrt_slave_config_pdo_mapping_clear(sc, data.index);
 }
 
 /****************************************************************************/
 
-/** Get the system time of the reference clock.
+/** Registers a PDO entry.
  *
- * \return Zero on success, otherwise a negative error code.
+ * \return Process data offset on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_ref_clock_time(
+static ATTRIBUTES int ec_ioctl_sc_reg_pdo_entry(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    uint32_t time;
+    ec_ioctl_reg_pdo_entry_t data;
+    ec_slave_config_t *sc;
+    ec_domain_t *domain;
     int ret;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
+
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+        return -EFAULT;
+
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
     }
 
-    ret = ecrt_master_reference_clock_time(master, &time);
-    if (ret) {
-        return ret;
+    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
     }
 
-    if (ec_copy_to_user((void __user *) arg, &time, sizeof(time), ctx)) {
+    up(&master->master_sem); /** \todo sc or domain could be invalidated */
+
+    ret = ecrt_slave_config_reg_pdo_entry(sc, data.entry_index,
+            data.entry_subindex, domain, &data.bit_position);
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
         return -EFAULT;
-    }
 
-    return 0;
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Queue the sync monitoring datagram.
+/** Registers a PDO entry by its position.
  *
- * \return Zero on success, otherwise a negative error code.
+ * \return Process data offset on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sync_mon_queue(
+static ATTRIBUTES int ec_ioctl_sc_reg_pdo_pos(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
+    ec_ioctl_reg_pdo_pos_t io;
+    ec_slave_config_t *sc;
+    ec_domain_t *domain;
     int ret;
 
     if (unlikely(!ctx->requested)) {
         return -EPERM;
     }
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
-        return -EINTR;
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+        return -EFAULT;
+    }
 
-    ret = ecrt_master_sync_monitor_queue(master);
-    ec_ioctl_unlock(&master->io_mutex);
-    return ret;
-}
+    if (down_interruptible(&master->master_sem)) {
+        return -EINTR;
+    }
 
-/****************************************************************************/
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
 
-/** Processes the sync monitoring datagram.
- *
- * \return Zero on success, otherwise a negative error code.
- */
-static ATTRIBUTES int ec_ioctl_sync_mon_process(
-        ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
-        )
-{
-    uint32_t time_diff;
+    if (!(domain = ec_master_find_domain(master, io.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
 
-    if (unlikely(!ctx->requested))
-        return -EPERM;
+    up(&master->master_sem); /** \todo sc or domain could be invalidated */
 
-    time_diff = ecrt_master_sync_monitor_process(master);
+    ret = ecrt_slave_config_reg_pdo_entry_pos(sc, io.sync_index,
+            io.pdo_pos, io.entry_pos, domain, &io.bit_position);
 
-    if (ec_copy_to_user((void __user *) arg, &time_diff,
-                        sizeof(time_diff), ctx))
+    if (copy_to_user((void __user *) arg, &io, sizeof(io)))
         return -EFAULT;
 
-    return 0;
-}
-
-/****************************************************************************/
-
-/** Reset configuration.
- *
- * \return Always zero (success).
- */
-static ATTRIBUTES int ec_ioctl_reset(
-        ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
-        )
-{
-#ifdef EC_IOCTL_RTDM
-    /* Xenomai/LXRT is like NMI context, so we do a two-stage schedule. */
-    irq_work_queue(&master->sc_reset_work_kicker);
-#else
-    schedule_work(&master->sc_reset_work);
-#endif
-    return 0;
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Configure a sync manager.
+/** Registers a complete PDO.
  *
- * \return Zero on success, otherwise a negative error code.
+ * \return Process data offset on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_sync(
+static ATTRIBUTES int ec_ioctl_sc_reg_pdo(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_config_t data;
+    ec_ioctl_reg_pdo_t io;
     ec_slave_config_t *sc;
-    unsigned int i;
-    int ret = 0;
+    ec_domain_t *domain;
+    int ret;
 
     if (unlikely(!ctx->requested)) {
-        ret = -EPERM;
-        goto out_return;
+        return -EPERM;
     }
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
-        ret = -EFAULT;
-        goto out_return;
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+        return -EFAULT;
     }
 
     if (down_interruptible(&master->master_sem)) {
-        ret = -EINTR;
-        goto out_return;
-    }
-
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        ret = -ENOENT;
-        goto out_up;
+        return -EINTR;
     }
 
-    for (i = 0; i < EC_MAX_SYNC_MANAGERS; i++) {
-        if (data.syncs[i].config_this) {
-            ret = ecrt_slave_config_sync_manager(sc, i, data.syncs[i].dir,
-                        data.syncs[i].watchdog_mode);
-            if (ret) {
-                goto out_up;
-            }
-        }
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
     }
 
-out_up:
-    up(&master->master_sem);
-out_return:
+    if (!(domain = ec_master_find_domain(master, io.domain_index))) {
+        up(&master->master_sem);
+        return -ENOENT;
+    }
+
+    up(&master->master_sem); /** \todo sc or domain could be invalidated */
+
+    ret = ecrt_slave_config_reg_pdo(sc, io.pdo_index, domain, &io.size);
+
+    if (copy_to_user((void __user *) arg, &io, sizeof(io)))
+        return -EFAULT;
+
     return ret;
 }
 
 /****************************************************************************/
 
-/** Configure a slave's watchdogs.
+/** Sets the DC AssignActivate word and the sync signal times.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_watchdog(
+static ATTRIBUTES int ec_ioctl_sc_dc(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
@@ -2450,51 +3207,49 @@ static ATTRIBUTES int ec_ioctl_sc_watchdog(
 {
     ec_ioctl_config_t data;
     ec_slave_config_t *sc;
-    int ret = 0;
+    int ret;
 
-    if (unlikely(!ctx->requested)) {
-        ret = -EPERM;
-        goto out_return;
-    }
+    if (unlikely(!ctx->requested))
+        return -EPERM;
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
-        ret = -EFAULT;
-        goto out_return;
-    }
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+        return -EFAULT;
 
-    if (down_interruptible(&master->master_sem)) {
-        ret = -EINTR;
-        goto out_return;
-    }
+    if (down_interruptible(&master->master_sem))
+        return -EINTR;
 
     if (!(sc = ec_master_get_config(master, data.config_index))) {
-        ret = -ENOENT;
-        goto out_up;
+        up(&master->master_sem);
+        return -ENOENT;
     }
 
-    ret = ecrt_slave_config_watchdog(sc,
-            data.watchdog_divider, data.watchdog_intervals);
+    ret = ecrt_slave_config_dc(sc, data.dc_assign_activate,
+            data.dc_sync[0].cycle_time,
+            data.dc_sync[0].shift_time,
+            data.dc_sync[1].cycle_time,
+            data.dc_sync[1].shift_time);
 
-out_up:
     up(&master->master_sem);
-out_return:
+
     return ret;
 }
 
 /****************************************************************************/
 
-/** Add a PDO to the assignment.
+/** Configures an SDO.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_add_pdo(
+static ATTRIBUTES int ec_ioctl_sc_sdo(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_config_pdo_t data;
+    ec_ioctl_sc_sdo_t data;
     ec_slave_config_t *sc;
+    uint8_t *sdo_data = NULL;
+    int ret;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -2502,1106 +3257,1109 @@ static ATTRIBUTES int ec_ioctl_sc_add_pdo(
     if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
         return -EFAULT;
 
-    if (down_interruptible(&master->master_sem))
+    if (!data.size)
+        return -EINVAL;
+
+    if (!(sdo_data = kmalloc(data.size, GFP_KERNEL))) {
+        return -ENOMEM;
+    }
+
+    if (copy_from_user(sdo_data, (void __user *) data.data, data.size)) {
+        kfree(sdo_data);
+        return -EFAULT;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        kfree(sdo_data);
         return -EINTR;
+    }
 
     if (!(sc = ec_master_get_config(master, data.config_index))) {
         up(&master->master_sem);
+        kfree(sdo_data);
         return -ENOENT;
     }
 
     up(&master->master_sem); /** \todo sc could be invalidated */
 
-    return ecrt_slave_config_pdo_assign_add(sc, data.sync_index, data.index);
+    if (data.complete_access) {
+        ret = ecrt_slave_config_complete_sdo(sc,
+                data.index, sdo_data, data.size);
+    } else {
+        ret = ecrt_slave_config_sdo(sc, data.index, data.subindex, sdo_data,
+                data.size);
+    }
+    kfree(sdo_data);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Clears the PDO assignment.
+/** Set the emergency ring buffer size.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_clear_pdos(
+static ATTRIBUTES int ec_ioctl_sc_emerg_size(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_config_pdo_t data;
+    ec_ioctl_sc_emerg_t io;
     ec_slave_config_t *sc;
+    int ret;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io)))
         return -EFAULT;
 
-    if (down_interruptible(&master->master_sem))
+    if (down_interruptible(&master->master_sem)) {
         return -EINTR;
+    }
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         up(&master->master_sem);
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
+    ret = ecrt_slave_config_emerg_size(sc, io.size);
 
-    return ecrt_slave_config_pdo_assign_clear(sc, data.sync_index);
+    up(&master->master_sem);
+
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Add an entry to a PDO's mapping.
+/** Get an emergency message from the ring.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_add_entry(
+static ATTRIBUTES int ec_ioctl_sc_emerg_pop(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_add_pdo_entry_t data;
+    ec_ioctl_sc_emerg_t io;
     ec_slave_config_t *sc;
+    u8 msg[EC_COE_EMERGENCY_MSG_SIZE];
+    int ret;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    if (down_interruptible(&master->master_sem))
-        return -EINTR;
+    /* no locking of master_sem needed, because configuration will not be
+     * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        up(&master->master_sem);
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
+    ret = ecrt_slave_config_emerg_pop(sc, msg);
+    if (ret < 0) {
+        return ret;
+    }
 
-    return ecrt_slave_config_pdo_mapping_add(sc, data.pdo_index,
-            data.entry_index, data.entry_subindex, data.entry_bit_length);
+    if (ec_copy_to_user((void __user *) io.target, msg, sizeof(msg), ctx)) {
+        return -EFAULT;
+    }
+
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Clears the mapping of a PDO.
+/** Clear the emergency ring.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_clear_entries(
+static ATTRIBUTES int ec_ioctl_sc_emerg_clear(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_config_pdo_t data;
+    ec_ioctl_sc_emerg_t io;
     ec_slave_config_t *sc;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    if (down_interruptible(&master->master_sem))
-        return -EINTR;
+    /* no locking of master_sem needed, because configuration will not be
+     * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        up(&master->master_sem);
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
-
-    return ecrt_slave_config_pdo_mapping_clear(sc, data.index);
+    return ecrt_slave_config_emerg_clear(sc);
 }
 
 /****************************************************************************/
 
-/** Registers a PDO entry.
+/** Get the number of emergency overruns.
  *
- * \return Process data offset on success, otherwise a negative error code.
+ * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_reg_pdo_entry(
+static ATTRIBUTES int ec_ioctl_sc_emerg_overruns(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_pdo_entry_t data;
+    ec_ioctl_sc_emerg_t io;
     ec_slave_config_t *sc;
-    ec_domain_t *domain;
     int ret;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    if (down_interruptible(&master->master_sem))
-        return -EINTR;
+    /* no locking of master_sem needed, because configuration will not be
+     * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        up(&master->master_sem);
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    if (!(domain = ec_master_find_domain(master, data.domain_index))) {
-        up(&master->master_sem);
-        return -ENOENT;
+    ret = ecrt_slave_config_emerg_overruns(sc);
+    if (ret < 0) {
+        return ret;
     }
 
-    up(&master->master_sem); /** \todo sc or domain could be invalidated */
-
-    ret = ecrt_slave_config_reg_pdo_entry(sc, data.entry_index,
-            data.entry_subindex, domain, &data.bit_position);
+    io.overruns = ret;
 
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+    if (ec_copy_to_user((void __user *) arg, &io, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    return ret;
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Registers a PDO entry by its position.
+/** Create an SDO request.
  *
- * \return Process data offset on success, otherwise a negative error code.
+ * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_reg_pdo_pos(
+static ATTRIBUTES int ec_ioctl_sc_create_sdo_request(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_pdo_pos_t io;
+    ec_ioctl_sdo_request_t data;
     ec_slave_config_t *sc;
-    ec_domain_t *domain;
-    int ret;
+    ec_sdo_request_t *req;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
     }
 
-    if (down_interruptible(&master->master_sem)) {
+    data.request_index = 0;
+
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
-    }
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    sc = ec_master_get_config(master, data.config_index);
+    if (!sc) {
         up(&master->master_sem);
         return -ENOENT;
     }
 
-    if (!(domain = ec_master_find_domain(master, io.domain_index))) {
-        up(&master->master_sem);
-        return -ENOENT;
+    list_for_each_entry(req, &sc->sdo_requests, list) {
+        data.request_index++;
     }
 
-    up(&master->master_sem); /** \todo sc or domain could be invalidated */
+    up(&master->master_sem); /** \todo sc could be invalidated */
 
-    ret = ecrt_slave_config_reg_pdo_entry_pos(sc, io.sync_index,
-            io.pdo_pos, io.entry_pos, domain, &io.bit_position);
+    req = ecrt_slave_config_create_sdo_request_err(sc, data.sdo_index,
+            data.sdo_subindex, data.size);
+    if (IS_ERR(req))
+        return PTR_ERR(req);
 
-    if (copy_to_user((void __user *) arg, &io, sizeof(io)))
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
         return -EFAULT;
 
-    return ret;
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Sets the DC AssignActivate word and the sync signal times.
+/** Create an SoE request.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_dc(
+static ATTRIBUTES int ec_ioctl_sc_create_soe_request(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_config_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    int ret;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
+    }
+
+    data.request_index = 0;
 
     if (down_interruptible(&master->master_sem))
         return -EINTR;
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    sc = ec_master_get_config(master, data.config_index);
+    if (!sc) {
         up(&master->master_sem);
         return -ENOENT;
     }
 
-    ret = ecrt_slave_config_dc(sc, data.dc_assign_activate,
-            data.dc_sync[0].cycle_time,
-            data.dc_sync[0].shift_time,
-            data.dc_sync[1].cycle_time,
-            data.dc_sync[1].shift_time);
+    list_for_each_entry(req, &sc->soe_requests, list) {
+        data.request_index++;
+    }
 
-    up(&master->master_sem);
+    up(&master->master_sem); /** \todo sc could be invalidated */
 
-    return ret;
+    req = ecrt_slave_config_create_soe_request_err(sc, data.drive_no,
+            data.idn, data.size);
+    if (IS_ERR(req)) {
+        return PTR_ERR(req);
+    }
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data))) {
+        return -EFAULT;
+    }
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Configures an SDO.
+/** Create a register request.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_sdo(
+static ATTRIBUTES int ec_ioctl_sc_create_reg_request(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_sdo_t data;
+    ec_ioctl_reg_request_t io;
     ec_slave_config_t *sc;
-    uint8_t *sdo_data = NULL;
-    int ret;
+    ec_reg_request_t *reg;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
-
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data)))
-        return -EFAULT;
-
-    if (!data.size)
-        return -EINVAL;
-
-    if (!(sdo_data = kmalloc(data.size, GFP_KERNEL))) {
-        return -ENOMEM;
     }
 
-    if (copy_from_user(sdo_data, (void __user *) data.data, data.size)) {
-        kfree(sdo_data);
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
     }
 
+    io.request_index = 0;
+
     if (down_interruptible(&master->master_sem)) {
-        kfree(sdo_data);
         return -EINTR;
     }
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    sc = ec_master_get_config(master, io.config_index);
+    if (!sc) {
         up(&master->master_sem);
-        kfree(sdo_data);
         return -ENOENT;
     }
 
+    list_for_each_entry(reg, &sc->reg_requests, list) {
+        io.request_index++;
+    }
+
     up(&master->master_sem); /** \todo sc could be invalidated */
 
-    if (data.complete_access) {
-        ret = ecrt_slave_config_complete_sdo(sc,
-                data.index, sdo_data, data.size);
-    } else {
-        ret = ecrt_slave_config_sdo(sc, data.index, data.subindex, sdo_data,
-                data.size);
+    reg = ecrt_slave_config_create_reg_request_err(sc, io.mem_size);
+    if (IS_ERR(reg)) {
+        return PTR_ERR(reg);
     }
-    kfree(sdo_data);
-    return ret;
+
+    if (copy_to_user((void __user *) arg, &io, sizeof(io))) {
+        return -EFAULT;
+    }
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Set the emergency ring buffer size.
+/** Create a VoE handler.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_emerg_size(
+static ATTRIBUTES int ec_ioctl_sc_create_voe_handler(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_emerg_t io;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    int ret;
+    ec_voe_handler_t *voe;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io)))
+    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
         return -EFAULT;
+    }
 
-    if (down_interruptible(&master->master_sem)) {
+    data.voe_index = 0;
+
+    if (down_interruptible(&master->master_sem))
         return -EINTR;
-    }
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    sc = ec_master_get_config(master, data.config_index);
+    if (!sc) {
         up(&master->master_sem);
         return -ENOENT;
     }
 
-    ret = ecrt_slave_config_emerg_size(sc, io.size);
+    list_for_each_entry(voe, &sc->voe_handlers, list) {
+        data.voe_index++;
+    }
 
-    up(&master->master_sem);
+    up(&master->master_sem); /** \todo sc could be invalidated */
 
-    return ret;
+    voe = ecrt_slave_config_create_voe_handler_err(sc, data.size);
+    if (IS_ERR(voe))
+        return PTR_ERR(voe);
+
+    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Get an emergency message from the ring.
+/** Get the slave configuration's state.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_emerg_pop(
+static ATTRIBUTES int ec_ioctl_sc_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_emerg_t io;
-    ec_slave_config_t *sc;
-    u8 msg[EC_COE_EMERGENCY_MSG_SIZE];
+    ec_ioctl_sc_state_t data;
+    const ec_slave_config_t *sc;
+    ec_slave_config_state_t state;
     int ret;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx)) {
         return -EFAULT;
     }
 
-    /* no locking of master_sem needed, because configuration will not be
-     * deleted in the meantime. */
+    /* no locking of master_sem needed, because sc will not be deleted in the
+     * meantime. */
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    if (!(sc = ec_master_get_config_const(master, data.config_index))) {
         return -ENOENT;
     }
 
-    ret = ecrt_slave_config_emerg_pop(sc, msg);
-    if (ret < 0) {
+    ret = ecrt_slave_config_state(sc, &state);
+    if (ret)
         return ret;
-    }
 
-    if (ec_copy_to_user((void __user *) io.target, msg, sizeof(msg), ctx)) {
+    if (ec_copy_to_user((void __user *) data.state,
+                        &state, sizeof(state), ctx))
         return -EFAULT;
-    }
 
-    return ret;
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Clear the emergency ring.
+/** Configures an IDN.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_emerg_clear(
+static ATTRIBUTES int ec_ioctl_sc_idn(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_emerg_t io;
+    ec_ioctl_sc_idn_t ioctl;
     ec_slave_config_t *sc;
+    uint8_t *data = NULL;
+    int ret;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
+
+    if (copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl)))
+        return -EFAULT;
+
+    if (!ioctl.size)
+        return -EINVAL;
+
+    if (!(data = kmalloc(ioctl.size, GFP_KERNEL))) {
+        return -ENOMEM;
     }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (copy_from_user(data, (void __user *) ioctl.data, ioctl.size)) {
+        kfree(data);
         return -EFAULT;
     }
 
-    /* no locking of master_sem needed, because configuration will not be
-     * deleted in the meantime. */
+    if (down_interruptible(&master->master_sem)) {
+        kfree(data);
+        return -EINTR;
+    }
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    if (!(sc = ec_master_get_config(master, ioctl.config_index))) {
+        up(&master->master_sem);
+        kfree(data);
         return -ENOENT;
     }
 
-    return ecrt_slave_config_emerg_clear(sc);
+    up(&master->master_sem); /** \todo sc could be invalidated */
+
+    ret = ecrt_slave_config_idn(
+            sc, ioctl.drive_no, ioctl.idn, ioctl.al_state, data, ioctl.size);
+    kfree(data);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Get the number of emergency overruns.
+/** Configures a feature flag.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_emerg_overruns(
+static ATTRIBUTES int ec_ioctl_sc_flag(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_emerg_t io;
+    ec_ioctl_sc_flag_t ioctl;
     ec_slave_config_t *sc;
+    uint8_t *key;
     int ret;
 
     if (unlikely(!ctx->requested)) {
         return -EPERM;
     }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl))) {
         return -EFAULT;
     }
 
-    /* no locking of master_sem needed, because configuration will not be
-     * deleted in the meantime. */
+    if (!ioctl.key_size) {
+        return -EINVAL;
+    }
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
-        return -ENOENT;
+    if (!(key = kmalloc(ioctl.key_size + 1, GFP_KERNEL))) {
+        return -ENOMEM;
     }
 
-    ret = ecrt_slave_config_emerg_overruns(sc);
-    if (ret < 0) {
-        return ret;
+    if (copy_from_user(key, (void __user *) ioctl.key, ioctl.key_size)) {
+        kfree(key);
+        return -EFAULT;
     }
+    key[ioctl.key_size] = '\0';
 
-    io.overruns = ret;
+    if (down_interruptible(&master->master_sem)) {
+        kfree(key);
+        return -EINTR;
+    }
 
-    if (ec_copy_to_user((void __user *) arg, &io, sizeof(io), ctx)) {
-        return -EFAULT;
+    if (!(sc = ec_master_get_config(master, ioctl.config_index))) {
+        up(&master->master_sem);
+        kfree(key);
+        return -ENOENT;
     }
 
-    return 0;
+    up(&master->master_sem); /** \todo sc could be invalidated */
+
+    ret = ecrt_slave_config_flag(sc, key, ioctl.value);
+    kfree(key);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Create an SDO request.
+/** Sets an AL state transition timeout.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_create_sdo_request(
+static ATTRIBUTES int ec_ioctl_sc_state_timeout(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_sc_state_timeout_t ioctl;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    int ret;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+    if (copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl))) {
         return -EFAULT;
     }
 
-    data.request_index = 0;
-
-    if (down_interruptible(&master->master_sem))
+    if (down_interruptible(&master->master_sem)) {
         return -EINTR;
+    }
 
-    sc = ec_master_get_config(master, data.config_index);
-    if (!sc) {
+    if (!(sc = ec_master_get_config(master, ioctl.config_index))) {
         up(&master->master_sem);
         return -ENOENT;
     }
 
-    list_for_each_entry(req, &sc->sdo_requests, list) {
-        data.request_index++;
-    }
-
-    up(&master->master_sem); /** \todo sc could be invalidated */
-
-    req = ecrt_slave_config_create_sdo_request_err(sc, data.sdo_index,
-            data.sdo_subindex, data.size);
-    if (IS_ERR(req))
-        return PTR_ERR(req);
-
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
-        return -EFAULT;
+    up(&master->master_sem); /** \todo sc could be invalidated */
 
-    return 0;
+    ret = ecrt_slave_config_state_timeout(sc, ioctl.from_state,
+            ioctl.to_state, ioctl.timeout_ms);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Create an SoE request.
+#ifdef EC_EOE
+
+/** Configures EoE IP parameters.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_create_soe_request(
+static ATTRIBUTES int ec_ioctl_sc_ip(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_eoe_ip_t io;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
     }
 
-    data.request_index = 0;
-
-    if (down_interruptible(&master->master_sem))
+    if (down_interruptible(&master->master_sem)) {
         return -EINTR;
+    }
 
-    sc = ec_master_get_config(master, data.config_index);
-    if (!sc) {
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         up(&master->master_sem);
         return -ENOENT;
     }
 
-    list_for_each_entry(req, &sc->soe_requests, list) {
-        data.request_index++;
-    }
-
     up(&master->master_sem); /** \todo sc could be invalidated */
 
-    req = ecrt_slave_config_create_soe_request_err(sc, data.drive_no,
-            data.idn, data.size);
-    if (IS_ERR(req)) {
-        return PTR_ERR(req);
+    /* the kernel versions of the EoE set IP methods never fail. */
+    if (io.mac_address_included) {
+        ecrt_slave_config_eoe_mac_address(sc, io.mac_address);
     }
-
-    if (copy_to_user((void __user *) arg, &data, sizeof(data))) {
-        return -EFAULT;
+    if (io.ip_address_included) {
+        ecrt_slave_config_eoe_ip_address(sc, io.ip_address);
+    }
+    if (io.subnet_mask_included) {
+        ecrt_slave_config_eoe_subnet_mask(sc, io.subnet_mask);
+    }
+    if (io.gateway_included) {
+        ecrt_slave_config_eoe_default_gateway(sc, io.gateway);
+    }
+    if (io.dns_included) {
+        ecrt_slave_config_eoe_dns_address(sc, io.dns);
+    }
+    if (io.name_included) {
+        ecrt_slave_config_eoe_hostname(sc, io.name);
     }
 
     return 0;
 }
 
+#endif
+
 /****************************************************************************/
 
-/** Create a register request.
+/** Gets the domain's data size.
  *
- * \return Zero on success, otherwise a negative error code.
+ * \return Domain size, or a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_create_reg_request(
+static ATTRIBUTES int ec_ioctl_domain_size(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_request_t io;
-    ec_slave_config_t *sc;
-    ec_reg_request_t *reg;
+    const ec_domain_t *domain;
 
     if (unlikely(!ctx->requested)) {
         return -EPERM;
     }
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
-        return -EFAULT;
-    }
-
-    io.request_index = 0;
-
     if (down_interruptible(&master->master_sem)) {
         return -EINTR;
     }
 
-    sc = ec_master_get_config(master, io.config_index);
-    if (!sc) {
-        up(&master->master_sem);
-        return -ENOENT;
-    }
-
-    list_for_each_entry(reg, &sc->reg_requests, list) {
-        io.request_index++;
-    }
-
-    up(&master->master_sem); /** \todo sc could be invalidated */
-
-    reg = ecrt_slave_config_create_reg_request_err(sc, io.mem_size);
-    if (IS_ERR(reg)) {
-        return PTR_ERR(reg);
-    }
-
-    if (copy_to_user((void __user *) arg, &io, sizeof(io))) {
-        return -EFAULT;
+    list_for_each_entry(domain, &master->domains, list) {
+        if (domain->index == (unsigned long) arg) {
+            size_t size = ecrt_domain_size(domain);
+            up(&master->master_sem);
+            return size;
+        }
     }
 
-    return 0;
+    up(&master->master_sem);
+    return -ENOENT;
 }
 
 /****************************************************************************/
 
-/** Create a VoE handler.
+/** Gets the domain's offset in the total process data.
  *
- * \return Zero on success, otherwise a negative error code.
+ * \return Domain offset, or a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_create_voe_handler(
+static ATTRIBUTES int ec_ioctl_domain_offset(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
+    int offset = 0;
+    const ec_domain_t *domain;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (copy_from_user(&data, (void __user *) arg, sizeof(data))) {
-        return -EFAULT;
-    }
-
-    data.voe_index = 0;
-
-    if (down_interruptible(&master->master_sem))
+    if (down_interruptible(&master->master_sem)) {
         return -EINTR;
-
-    sc = ec_master_get_config(master, data.config_index);
-    if (!sc) {
-        up(&master->master_sem);
-        return -ENOENT;
     }
 
-    list_for_each_entry(voe, &sc->voe_handlers, list) {
-        data.voe_index++;
+    list_for_each_entry(domain, &master->domains, list) {
+        if (domain->index == (unsigned long) arg) {
+            up(&master->master_sem);
+            return offset;
+        }
+        offset += ecrt_domain_size(domain);
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
-
-    voe = ecrt_slave_config_create_voe_handler_err(sc, data.size);
-    if (IS_ERR(voe))
-        return PTR_ERR(voe);
-
-    if (copy_to_user((void __user *) arg, &data, sizeof(data)))
-        return -EFAULT;
-
-    return 0;
+    up(&master->master_sem);
+    return -ENOENT;
 }
 
 /****************************************************************************/
 
-/** Get the slave configuration's state.
+/** Process the domain.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_state(
+static ATTRIBUTES int ec_ioctl_domain_process(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_state_t data;
-    const ec_slave_config_t *sc;
-    ec_slave_config_state_t state;
-    int ret;
+    ec_domain_t *domain;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx)) {
-        return -EFAULT;
-    }
-
-    /* no locking of master_sem needed, because sc will not be deleted in the
-     * meantime. */
+    /* no locking of master_sem needed, because domain will not be deleted in
+     * the meantime. */
 
-    if (!(sc = ec_master_get_config_const(master, data.config_index))) {
+    if (!(domain = ec_master_find_domain(master, (unsigned long) arg))) {
         return -ENOENT;
     }
 
-    ret = ecrt_slave_config_state(sc, &state);
-    if (ret)
-        return ret;
-
-    if (ec_copy_to_user((void __user *) data.state,
-                        &state, sizeof(state), ctx))
-        return -EFAULT;
-
-    return 0;
+    return ecrt_domain_process(domain);
 }
 
 /****************************************************************************/
 
-/** Configures an IDN.
+/** Queue the domain.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_idn(
+static ATTRIBUTES int ec_ioctl_domain_queue(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_idn_t ioctl;
-    ec_slave_config_t *sc;
-    uint8_t *data = NULL;
+    ec_domain_t *domain;
     int ret;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl)))
-        return -EFAULT;
-
-    if (!ioctl.size)
-        return -EINVAL;
-
-    if (!(data = kmalloc(ioctl.size, GFP_KERNEL))) {
-        return -ENOMEM;
-    }
-
-    if (copy_from_user(data, (void __user *) ioctl.data, ioctl.size)) {
-        kfree(data);
-        return -EFAULT;
-    }
-
-    if (down_interruptible(&master->master_sem)) {
-        kfree(data);
-        return -EINTR;
-    }
+    /* no locking of master_sem needed, because domain will not be deleted in
+     * the meantime. */
 
-    if (!(sc = ec_master_get_config(master, ioctl.config_index))) {
-        up(&master->master_sem);
-        kfree(data);
+    if (!(domain = ec_master_find_domain(master, (unsigned long) arg))) {
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+        return -EINTR;
 
-    ret = ecrt_slave_config_idn(
-            sc, ioctl.drive_no, ioctl.idn, ioctl.al_state, data, ioctl.size);
-    kfree(data);
+    ret = ecrt_domain_queue(domain);
+    ec_ioctl_unlock(&master->io_mutex);
     return ret;
 }
 
 /****************************************************************************/
 
-/** Configures a feature flag.
+/** Get the domain state.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_flag(
+static ATTRIBUTES int ec_ioctl_domain_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_flag_t ioctl;
-    ec_slave_config_t *sc;
-    uint8_t *key;
+    ec_ioctl_domain_state_t data;
+    const ec_domain_t *domain;
+    ec_domain_state_t state;
     int ret;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
-
-    if (copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl))) {
-        return -EFAULT;
-    }
-
-    if (!ioctl.key_size) {
-        return -EINVAL;
-    }
-
-    if (!(key = kmalloc(ioctl.key_size + 1, GFP_KERNEL))) {
-        return -ENOMEM;
-    }
 
-    if (copy_from_user(key, (void __user *) ioctl.key, ioctl.key_size)) {
-        kfree(key);
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx)) {
         return -EFAULT;
     }
-    key[ioctl.key_size] = '\0';
-
-    if (down_interruptible(&master->master_sem)) {
-        kfree(key);
-        return -EINTR;
-    }
 
-    if (!(sc = ec_master_get_config(master, ioctl.config_index))) {
-        up(&master->master_sem);
-        kfree(key);
+    /* no locking of master_sem needed, because domain will not be deleted in
+     * the meantime. */
+
+    if (!(domain = ec_master_find_domain_const(master, data.domain_index))) {
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
+    ret = ecrt_domain_state(domain, &state);
+    if (ret)
+        return ret;
 
-    ret = ecrt_slave_config_flag(sc, key, ioctl.value);
-    kfree(key);
-    return ret;
+    if (ec_copy_to_user((void __user *) data.state, &state, sizeof(state),
+                ctx))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Sets an AL state transition timeout.
+/** Sets an SDO request's SDO index and subindex.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_state_timeout(
+static ATTRIBUTES int ec_ioctl_sdo_request_index(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sc_state_timeout_t ioctl;
+    ec_ioctl_sdo_request_t data;
     ec_slave_config_t *sc;
-    int ret;
+    ec_sdo_request_t *req;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (copy_from_user(&ioctl, (void __user *) arg, sizeof(ioctl))) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
 
-    if (down_interruptible(&master->master_sem)) {
-        return -EINTR;
-    }
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, ioctl.config_index))) {
-        up(&master->master_sem);
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
+    }
 
-    ret = ecrt_slave_config_state_timeout(sc, ioctl.from_state,
-            ioctl.to_state, ioctl.timeout_ms);
-    return ret;
+    return ecrt_sdo_request_index(req, data.sdo_index, data.sdo_subindex);
 }
 
 /****************************************************************************/
 
-#ifdef EC_EOE
-
-/** Configures EoE IP parameters.
+/** Sets an SDO request's timeout.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sc_ip(
+static ATTRIBUTES int ec_ioctl_sdo_request_timeout(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_eoe_ip_t io;
+    ec_ioctl_sdo_request_t data;
     ec_slave_config_t *sc;
+    ec_sdo_request_t *req;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
 
-    if (down_interruptible(&master->master_sem)) {
-        return -EINTR;
-    }
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
-        up(&master->master_sem);
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    up(&master->master_sem); /** \todo sc could be invalidated */
-
-    /* the kernel versions of the EoE set IP methods never fail. */
-    if (io.mac_address_included) {
-        ecrt_slave_config_eoe_mac_address(sc, io.mac_address);
-    }
-    if (io.ip_address_included) {
-        ecrt_slave_config_eoe_ip_address(sc, io.ip_address);
-    }
-    if (io.subnet_mask_included) {
-        ecrt_slave_config_eoe_subnet_mask(sc, io.subnet_mask);
-    }
-    if (io.gateway_included) {
-        ecrt_slave_config_eoe_default_gateway(sc, io.gateway);
-    }
-    if (io.dns_included) {
-        ecrt_slave_config_eoe_dns_address(sc, io.dns);
-    }
-    if (io.name_included) {
-        ecrt_slave_config_eoe_hostname(sc, io.name);
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
     }
 
-    return 0;
+    return ecrt_sdo_request_timeout(req, data.timeout);
 }
 
-#endif
-
 /****************************************************************************/
 
-/** Gets the domain's data size.
+/** Selects the CompleteAccess method for an SDO request.
  *
- * \return Domain size, or a negative error code.
+ * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_domain_size(
+static ATTRIBUTES int ec_ioctl_sdo_request_complete(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    const ec_domain_t *domain;
+    ec_ioctl_sdo_request_t data;
+    ec_slave_config_t *sc;
+    ec_sdo_request_t *req;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (down_interruptible(&master->master_sem)) {
-        return -EINTR;
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+        return -EFAULT;
+
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        return -ENOENT;
     }
 
-    list_for_each_entry(domain, &master->domains, list) {
-        if (domain->index == (unsigned long) arg) {
-            size_t size = ecrt_domain_size(domain);
-            up(&master->master_sem);
-            return size;
-        }
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
     }
 
-    up(&master->master_sem);
-    return -ENOENT;
+    return ecrt_sdo_request_complete_access(req, data.complete_access);
 }
 
 /****************************************************************************/
 
-/** Gets the domain's offset in the total process data.
+/** Gets an SDO request's state.
  *
- * \return Domain offset, or a negative error code.
+ * Also pre-fetches the size of incoming data.
+ *
+ * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_domain_offset(
+static ATTRIBUTES int ec_ioctl_sdo_request_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    int offset = 0;
-    const ec_domain_t *domain;
+    ec_ioctl_sdo_request_t data;
+    ec_slave_config_t *sc;
+    ec_sdo_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (down_interruptible(&master->master_sem)) {
-        return -EINTR;
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+        return -EFAULT;
+
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
+        return -ENOENT;
     }
 
-    list_for_each_entry(domain, &master->domains, list) {
-        if (domain->index == (unsigned long) arg) {
-            up(&master->master_sem);
-            return offset;
-        }
-        offset += ecrt_domain_size(domain);
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
     }
 
-    up(&master->master_sem);
-    return -ENOENT;
+    data.state = ecrt_sdo_request_state(req);
+    if (data.state == EC_REQUEST_SUCCESS && req->dir == EC_DIR_INPUT)
+        data.size = ecrt_sdo_request_data_size(req);
+    else
+        data.size = 0;
+
+    if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Process the domain.
+/** Starts an SDO read operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_domain_process(
+static ATTRIBUTES int ec_ioctl_sdo_request_read(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_domain_t *domain;
+    ec_ioctl_sdo_request_t data;
+    ec_slave_config_t *sc;
+    ec_sdo_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    /* no locking of master_sem needed, because domain will not be deleted in
-     * the meantime. */
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+        return -EFAULT;
 
-    if (!(domain = ec_master_find_domain(master, (unsigned long) arg))) {
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    return ecrt_domain_process(domain);
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
+    }
+
+    return ecrt_sdo_request_read(req);
 }
 
 /****************************************************************************/
 
-/** Queue the domain.
+/** Starts an SDO write operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_domain_queue(
+static ATTRIBUTES int ec_ioctl_sdo_request_write(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_domain_t *domain;
-    int ret;
+    ec_ioctl_sdo_request_t data;
+    ec_slave_config_t *sc;
+    ec_sdo_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    /* no locking of master_sem needed, because domain will not be deleted in
-     * the meantime. */
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+        return -EFAULT;
 
-    if (!(domain = ec_master_find_domain(master, (unsigned long) arg))) {
+    if (!data.size) {
+        EC_MASTER_ERR(master, "SDO download: Data size may not be zero!\n");
+        return -EINVAL;
+    }
+
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
+
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
-        return -EINTR;
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
+    }
 
-    ret = ecrt_domain_queue(domain);
-    ec_ioctl_unlock(&master->io_mutex);
-    return ret;
+    if (data.size > req->mem_size)
+        return -ENOBUFS;
+
+    if (ec_copy_from_user(req->data, (void __user *) data.data,
+                          data.size, ctx))
+        return -EFAULT;
+
+    req->data_size = data.size;
+    return ecrt_sdo_request_write(req);
 }
 
 /****************************************************************************/
 
-/** Get the domain state.
+/** Read SDO data.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_domain_state(
+static ATTRIBUTES int ec_ioctl_sdo_request_data(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_domain_state_t data;
-    const ec_domain_t *domain;
-    ec_domain_state_t state;
-    int ret;
+    ec_ioctl_sdo_request_t data;
+    ec_slave_config_t *sc;
+    ec_sdo_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx)) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
 
-    /* no locking of master_sem needed, because domain will not be deleted in
-     * the meantime. */
+    /* no locking of master_sem needed, because neither sc nor req will not be
+     * deleted in the meantime. */
 
-    if (!(domain = ec_master_find_domain_const(master, data.domain_index))) {
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    ret = ecrt_domain_state(domain, &state);
-    if (ret)
-        return ret;
+    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+        return -ENOENT;
+    }
 
-    if (ec_copy_to_user((void __user *) data.state, &state, sizeof(state),
-                ctx))
+    if (ec_copy_to_user((void __user *) data.data, ecrt_sdo_request_data(req),
+                ecrt_sdo_request_data_size(req), ctx))
         return -EFAULT;
 
     return 0;
@@ -3609,19 +4367,19 @@ static ATTRIBUTES int ec_ioctl_domain_state(
 
 /****************************************************************************/
 
-/** Sets an SDO request's SDO index and subindex.
+/** Sets an SoE request's drive number and IDN.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sdo_request_index(
+static ATTRIBUTES int ec_ioctl_soe_request_index(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -3636,28 +4394,28 @@ static ATTRIBUTES int ec_ioctl_sdo_request_index(
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
         return -ENOENT;
     }
 
-    return ecrt_sdo_request_index(req, data.sdo_index, data.sdo_subindex);
+    return ecrt_soe_request_idn(req, data.drive_no, data.idn);
 }
 
 /****************************************************************************/
 
-/** Sets an SDO request's timeout.
+/** Sets an CoE request's timeout.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sdo_request_timeout(
+static ATTRIBUTES int ec_ioctl_soe_request_timeout(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -3672,30 +4430,28 @@ static ATTRIBUTES int ec_ioctl_sdo_request_timeout(
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
         return -ENOENT;
     }
 
-    return ecrt_sdo_request_timeout(req, data.timeout);
+    return ecrt_soe_request_timeout(req, data.timeout);
 }
 
 /****************************************************************************/
 
-/** Gets an SDO request's state.
- *
- * Also pre-fetches the size of incoming data.
+/** Gets an SoE request's state.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sdo_request_state(
+static ATTRIBUTES int ec_ioctl_soe_request_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -3710,15 +4466,17 @@ static ATTRIBUTES int ec_ioctl_sdo_request_state(
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
         return -ENOENT;
     }
 
-    data.state = ecrt_sdo_request_state(req);
-    if (data.state == EC_REQUEST_SUCCESS && req->dir == EC_DIR_INPUT)
-        data.size = ecrt_sdo_request_data_size(req);
-    else
+    data.state = ecrt_soe_request_state(req);
+    if (data.state == EC_REQUEST_SUCCESS && req->dir == EC_DIR_INPUT) {
+        data.size = ecrt_soe_request_data_size(req);
+    }
+    else {
         data.size = 0;
+    }
 
     if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
         return -EFAULT;
@@ -3728,19 +4486,19 @@ static ATTRIBUTES int ec_ioctl_sdo_request_state(
 
 /****************************************************************************/
 
-/** Starts an SDO read operation.
+/** Starts an SoE IDN read operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sdo_request_read(
+static ATTRIBUTES int ec_ioctl_soe_request_read(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -3755,28 +4513,28 @@ static ATTRIBUTES int ec_ioctl_sdo_request_read(
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
         return -ENOENT;
     }
 
-    return ecrt_sdo_request_read(req);
+    return ecrt_soe_request_read(req);
 }
 
 /****************************************************************************/
 
-/** Starts an SDO write operation.
+/** Starts an SoE IDN write operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sdo_request_write(
+static ATTRIBUTES int ec_ioctl_soe_request_write(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -3785,7 +4543,7 @@ static ATTRIBUTES int ec_ioctl_sdo_request_write(
         return -EFAULT;
 
     if (!data.size) {
-        EC_MASTER_ERR(master, "SDO download: Data size may not be zero!\n");
+        EC_MASTER_ERR(master, "IDN write: Data size may not be zero!\n");
         return -EINVAL;
     }
 
@@ -3796,7 +4554,7 @@ static ATTRIBUTES int ec_ioctl_sdo_request_write(
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
         return -ENOENT;
     }
 
@@ -3808,24 +4566,24 @@ static ATTRIBUTES int ec_ioctl_sdo_request_write(
         return -EFAULT;
 
     req->data_size = data.size;
-    return ecrt_sdo_request_write(req);
+    return ecrt_soe_request_write(req);
 }
 
 /****************************************************************************/
 
-/** Read SDO data.
+/** Read SoE IDN data.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_sdo_request_data(
+static ATTRIBUTES int ec_ioctl_soe_request_data(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_sdo_request_t data;
+    ec_ioctl_soe_request_t data;
     ec_slave_config_t *sc;
-    ec_sdo_request_t *req;
+    ec_soe_request_t *req;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -3840,12 +4598,12 @@ static ATTRIBUTES int ec_ioctl_sdo_request_data(
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_sdo_request(sc, data.request_index))) {
+    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
         return -ENOENT;
     }
 
-    if (ec_copy_to_user((void __user *) data.data, ecrt_sdo_request_data(req),
-                ecrt_sdo_request_data_size(req), ctx))
+    if (ec_copy_to_user((void __user *) data.data, ecrt_soe_request_data(req),
+                ecrt_soe_request_data_size(req), ctx))
         return -EFAULT;
 
     return 0;
@@ -3853,174 +4611,202 @@ static ATTRIBUTES int ec_ioctl_sdo_request_data(
 
 /****************************************************************************/
 
-/** Sets an SoE request's drive number and IDN.
+/** Read register data.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_soe_request_index(
+static ATTRIBUTES int ec_ioctl_reg_request_data(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_reg_request_t io;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
+    ec_reg_request_t *reg;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor req will not be
+    if (io.mem_size <= 0) {
+        return 0;
+    }
+
+    /* no locking of master_sem needed, because neither sc nor reg will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
+    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
         return -ENOENT;
     }
 
-    return ecrt_soe_request_idn(req, data.drive_no, data.idn);
+    if (ec_copy_to_user((void __user *) io.data, ecrt_reg_request_data(reg),
+                min(reg->mem_size, io.mem_size), ctx)) {
+        return -EFAULT;
+    }
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Sets an CoE request's timeout.
+/** Gets an register request's state.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_soe_request_timeout(
+static ATTRIBUTES int ec_ioctl_reg_request_state(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_reg_request_t io;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
+    ec_reg_request_t *reg;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor req will not be
+    /* no locking of master_sem needed, because neither sc nor reg will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
+    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
         return -ENOENT;
     }
 
-    return ecrt_soe_request_timeout(req, data.timeout);
+    io.state = ecrt_reg_request_state(reg);
+    io.new_data = io.state == EC_REQUEST_SUCCESS && reg->dir == EC_DIR_INPUT;
+
+    if (ec_copy_to_user((void __user *) arg, &io, sizeof(io), ctx)) {
+        return -EFAULT;
+    }
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Gets an SoE request's state.
+/** Starts an register write operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_soe_request_state(
+static ATTRIBUTES int ec_ioctl_reg_request_write(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_reg_request_t io;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
+    ec_reg_request_t *reg;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor req will not be
+    /* no locking of master_sem needed, because neither sc nor reg will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
+    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
         return -ENOENT;
     }
 
-    data.state = ecrt_soe_request_state(req);
-    if (data.state == EC_REQUEST_SUCCESS && req->dir == EC_DIR_INPUT) {
-        data.size = ecrt_soe_request_data_size(req);
-    }
-    else {
-        data.size = 0;
+    if (io.transfer_size > reg->mem_size) {
+        return -ENOBUFS;
     }
 
-    if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
+    if (ec_copy_from_user(reg->data, (void __user *) io.data,
+                io.transfer_size, ctx)) {
         return -EFAULT;
+    }
 
-    return 0;
+    return ecrt_reg_request_write(reg, io.address, io.transfer_size);
 }
 
 /****************************************************************************/
 
-/** Starts an SoE IDN read operation.
+/** Starts an register read operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_soe_request_read(
+static ATTRIBUTES int ec_ioctl_reg_request_read(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_reg_request_t io;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
+    ec_reg_request_t *reg;
 
-    if (unlikely(!ctx->requested))
+    if (unlikely(!ctx->requested)) {
         return -EPERM;
+    }
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor req will not be
+    /* no locking of master_sem needed, because neither sc nor reg will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
+    if (!(sc = ec_master_get_config(master, io.config_index))) {
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
+    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
         return -ENOENT;
     }
 
-    return ecrt_soe_request_read(req);
+    if (io.transfer_size > reg->mem_size) {
+        return -ENOBUFS;
+    }
+
+    return ecrt_reg_request_read(reg, io.address, io.transfer_size);
 }
 
 /****************************************************************************/
 
-/** Starts an SoE IDN write operation.
+/** Sets the VoE send header.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_soe_request_write(
+static ATTRIBUTES int ec_ioctl_voe_send_header(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
+    ec_voe_handler_t *voe;
+    uint32_t vendor_id;
+    uint16_t vendor_type;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -4028,48 +4814,45 @@ static ATTRIBUTES int ec_ioctl_soe_request_write(
     if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
 
-    if (!data.size) {
-        EC_MASTER_ERR(master, "IDN write: Data size may not be zero!\n");
-        return -EINVAL;
-    }
+    if (ec_copy_from_user(&vendor_id, data.vendor_id, sizeof(vendor_id), ctx))
+        return -EFAULT;
 
-    /* no locking of master_sem needed, because neither sc nor req will not be
+    if (ec_copy_from_user(&vendor_type, data.vendor_type,
+                          sizeof(vendor_type), ctx))
+        return -EFAULT;
+
+    /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
     if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
+    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
         return -ENOENT;
     }
 
-    if (data.size > req->mem_size)
-        return -ENOBUFS;
-
-    if (ec_copy_from_user(req->data, (void __user *) data.data,
-                          data.size, ctx))
-        return -EFAULT;
-
-    req->data_size = data.size;
-    return ecrt_soe_request_write(req);
+    return ecrt_voe_handler_send_header(voe, vendor_id, vendor_type);
 }
 
 /****************************************************************************/
 
-/** Read SoE IDN data.
+/** Gets the received VoE header.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_soe_request_data(
+static ATTRIBUTES int ec_ioctl_voe_rec_header(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_soe_request_t data;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    ec_soe_request_t *req;
+    ec_voe_handler_t *voe;
+    uint32_t vendor_id;
+    uint16_t vendor_type;
+    int ret;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -4077,212 +4860,207 @@ static ATTRIBUTES int ec_ioctl_soe_request_data(
     if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
 
-    /* no locking of master_sem needed, because neither sc nor req will not be
+    /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
     if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (!(req = ec_slave_config_find_soe_request(sc, data.request_index))) {
+    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
         return -ENOENT;
     }
 
-    if (ec_copy_to_user((void __user *) data.data, ecrt_soe_request_data(req),
-                ecrt_soe_request_data_size(req), ctx))
-        return -EFAULT;
+    ret = ecrt_voe_handler_received_header(voe, &vendor_id, &vendor_type);
+    if (ret)
+        return ret;
+
+    if (likely(data.vendor_id))
+        if (ec_copy_to_user(data.vendor_id, &vendor_id,
+                            sizeof(vendor_id), ctx))
+            return -EFAULT;
+
+    if (likely(data.vendor_type))
+        if (ec_copy_to_user(data.vendor_type, &vendor_type,
+            sizeof(vendor_type), ctx))
+            return -EFAULT;
 
     return 0;
 }
 
 /****************************************************************************/
 
-/** Read register data.
+/** Starts a VoE read operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_reg_request_data(
+static ATTRIBUTES int ec_ioctl_voe_read(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_request_t io;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    ec_reg_request_t *reg;
+    ec_voe_handler_t *voe;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
-
-    if (io.mem_size <= 0) {
-        return 0;
-    }
 
-    /* no locking of master_sem needed, because neither sc nor reg will not be
+    /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
+    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
         return -ENOENT;
     }
 
-    if (ec_copy_to_user((void __user *) io.data, ecrt_reg_request_data(reg),
-                min(reg->mem_size, io.mem_size), ctx)) {
-        return -EFAULT;
-    }
-
-    return 0;
+    return ecrt_voe_handler_read(voe);
 }
 
 /****************************************************************************/
 
-/** Gets an register request's state.
+/** Starts a VoE read operation without sending a sync message first.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_reg_request_state(
+static ATTRIBUTES int ec_ioctl_voe_read_nosync(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_request_t io;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    ec_reg_request_t *reg;
+    ec_voe_handler_t *voe;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
 
-    /* no locking of master_sem needed, because neither sc nor reg will not be
+    /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
+    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
         return -ENOENT;
     }
 
-    io.state = ecrt_reg_request_state(reg);
-    io.new_data = io.state == EC_REQUEST_SUCCESS && reg->dir == EC_DIR_INPUT;
-
-    if (ec_copy_to_user((void __user *) arg, &io, sizeof(io), ctx)) {
-        return -EFAULT;
-    }
-
-    return 0;
+    return ecrt_voe_handler_read_nosync(voe);
 }
 
 /****************************************************************************/
 
-/** Starts an register write operation.
+/** Starts a VoE write operation.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_reg_request_write(
+static ATTRIBUTES int ec_ioctl_voe_write(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_request_t io;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    ec_reg_request_t *reg;
+    ec_voe_handler_t *voe;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
 
-    /* no locking of master_sem needed, because neither sc nor reg will not be
+    /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
+    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
         return -ENOENT;
     }
 
-    if (io.transfer_size > reg->mem_size) {
-        return -ENOBUFS;
-    }
+    if (data.size) {
+        if (data.size > ec_voe_handler_mem_size(voe))
+            return -ENOBUFS;
 
-    if (ec_copy_from_user(reg->data, (void __user *) io.data,
-                io.transfer_size, ctx)) {
-        return -EFAULT;
+        if (ec_copy_from_user(ecrt_voe_handler_data(voe),
+                    (void __user *) data.data, data.size, ctx))
+            return -EFAULT;
     }
 
-    return ecrt_reg_request_write(reg, io.address, io.transfer_size);
+    return ecrt_voe_handler_write(voe, data.size);
 }
 
 /****************************************************************************/
 
-/** Starts an register read operation.
+/** Executes the VoE state machine.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_reg_request_read(
+static ATTRIBUTES int ec_ioctl_voe_exec(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_reg_request_t io;
+    ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
-    ec_reg_request_t *reg;
+    ec_voe_handler_t *voe;
 
-    if (unlikely(!ctx->requested)) {
+    if (unlikely(!ctx->requested))
         return -EPERM;
-    }
 
-    if (ec_copy_from_user(&io, (void __user *) arg, sizeof(io), ctx)) {
+    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
-    }
 
-    /* no locking of master_sem needed, because neither sc nor reg will not be
+    /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
-    if (!(sc = ec_master_get_config(master, io.config_index))) {
+    if (!(sc = ec_master_get_config(master, data.config_index))) {
         return -ENOENT;
     }
 
-    if (!(reg = ec_slave_config_find_reg_request(sc, io.request_index))) {
+    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
         return -ENOENT;
     }
 
-    if (io.transfer_size > reg->mem_size) {
-        return -ENOBUFS;
-    }
+    if (ec_ioctl_lock_interruptible(&master->io_mutex))
+        return -EINTR;
 
-    return ecrt_reg_request_read(reg, io.address, io.transfer_size);
+    data.state = ecrt_voe_handler_execute(voe);
+    ec_ioctl_unlock(&master->io_mutex);
+    if (data.state == EC_REQUEST_SUCCESS && voe->dir == EC_DIR_INPUT)
+        data.size = ecrt_voe_handler_data_size(voe);
+    else
+        data.size = 0;
+
+    if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Sets the VoE send header.
+/** Reads the received VoE data.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_voe_send_header(
+static ATTRIBUTES int ec_ioctl_voe_data(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
@@ -4291,8 +5069,6 @@ static ATTRIBUTES int ec_ioctl_voe_send_header(
     ec_ioctl_voe_t data;
     ec_slave_config_t *sc;
     ec_voe_handler_t *voe;
-    uint32_t vendor_id;
-    uint16_t vendor_type;
 
     if (unlikely(!ctx->requested))
         return -EPERM;
@@ -4300,13 +5076,6 @@ static ATTRIBUTES int ec_ioctl_voe_send_header(
     if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
         return -EFAULT;
 
-    if (ec_copy_from_user(&vendor_id, data.vendor_id, sizeof(vendor_id), ctx))
-        return -EFAULT;
-
-    if (ec_copy_from_user(&vendor_type, data.vendor_type,
-                          sizeof(vendor_type), ctx))
-        return -EFAULT;
-
     /* no locking of master_sem needed, because neither sc nor voe will not be
      * deleted in the meantime. */
 
@@ -4318,449 +5087,654 @@ static ATTRIBUTES int ec_ioctl_voe_send_header(
         return -ENOENT;
     }
 
-    return ecrt_voe_handler_send_header(voe, vendor_id, vendor_type);
+    if (ec_copy_to_user((void __user *) data.data, ecrt_voe_handler_data(voe),
+                ecrt_voe_handler_data_size(voe), ctx))
+        return -EFAULT;
+
+    return 0;
 }
 
 /****************************************************************************/
 
-/** Gets the received VoE header.
+/** Read a file from a slave via FoE.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_voe_rec_header(
+static ATTRIBUTES int ec_ioctl_slave_foe_read(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
-    uint32_t vendor_id;
-    uint16_t vendor_type;
+    ec_ioctl_slave_foe_t io;
+    ec_foe_request_t request;
+    ec_slave_t *slave;
     int ret;
 
-    if (unlikely(!ctx->requested))
-        return -EPERM;
-
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor voe will not be
-     * deleted in the meantime. */
+    ec_foe_request_init(&request, io.file_name);
+    ret = ec_foe_request_alloc(&request, 10000); // FIXME
+    if (ret) {
+        ec_foe_request_clear(&request);
+        return ret;
+    }
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        return -ENOENT;
+    ec_foe_request_read(&request);
+
+    if (down_interruptible(&master->master_sem)) {
+        ec_foe_request_clear(&request);
+        return -EINTR;
     }
 
-    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
-        return -ENOENT;
+    if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
+        up(&master->master_sem);
+        ec_foe_request_clear(&request);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                io.slave_position);
+        return -EINVAL;
     }
 
-    ret = ecrt_voe_handler_received_header(voe, &vendor_id, &vendor_type);
-    if (ret)
-        return ret;
+    EC_SLAVE_DBG(slave, 1, "Scheduling FoE read request.\n");
 
-    if (likely(data.vendor_id))
-        if (ec_copy_to_user(data.vendor_id, &vendor_id,
-                            sizeof(vendor_id), ctx))
+    // schedule request.
+    list_add_tail(&request.list, &slave->foe_requests);
+
+    up(&master->master_sem);
+
+    // wait for processing through FSM
+    if (wait_event_interruptible(master->request_queue,
+                request.state != EC_INT_REQUEST_QUEUED)) {
+        // interrupted by signal
+        down(&master->master_sem);
+        if (request.state == EC_INT_REQUEST_QUEUED) {
+            list_del(&request.list);
+            up(&master->master_sem);
+            ec_foe_request_clear(&request);
+            return -EINTR;
+        }
+        // request already processing: interrupt not possible.
+        up(&master->master_sem);
+    }
+
+    // wait until master FSM has finished processing
+    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+
+    io.result = request.result;
+    io.error_code = request.error_code;
+
+    if (request.state != EC_INT_REQUEST_SUCCESS) {
+        io.data_size = 0;
+        ret = -EIO;
+    } else {
+        if (request.data_size > io.buffer_size) {
+            EC_SLAVE_ERR(slave, "%s(): Buffer too small.\n", __func__);
+            ec_foe_request_clear(&request);
+            return -ENOBUFS;
+        }
+        io.data_size = request.data_size;
+        if (copy_to_user((void __user *) io.buffer,
+                    request.buffer, io.data_size)) {
+            ec_foe_request_clear(&request);
             return -EFAULT;
+        }
+        ret = 0;
+    }
 
-    if (likely(data.vendor_type))
-        if (ec_copy_to_user(data.vendor_type, &vendor_type,
-            sizeof(vendor_type), ctx))
-            return -EFAULT;
+    if (__copy_to_user((void __user *) arg, &io, sizeof(io))) {
+        ret = -EFAULT;
+    }
 
-    return 0;
+    ec_foe_request_clear(&request);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Starts a VoE read operation.
+/** Write a file to a slave via FoE
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_voe_read(
+static ATTRIBUTES int ec_ioctl_slave_foe_write(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        void *arg /**< ioctl() argument. */
         )
 {
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
-
-    if (unlikely(!ctx->requested))
-        return -EPERM;
+    ec_ioctl_slave_foe_t io;
+    ec_foe_request_t request;
+    ec_slave_t *slave;
+    int ret;
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor voe will not be
-     * deleted in the meantime. */
+    ec_foe_request_init(&request, io.file_name);
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        return -ENOENT;
+    ret = ec_foe_request_alloc(&request, io.buffer_size);
+    if (ret) {
+        ec_foe_request_clear(&request);
+        return ret;
     }
 
-    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
-        return -ENOENT;
+    if (copy_from_user(request.buffer,
+                (void __user *) io.buffer, io.buffer_size)) {
+        ec_foe_request_clear(&request);
+        return -EFAULT;
     }
 
-    return ecrt_voe_handler_read(voe);
-}
+    request.data_size = io.buffer_size;
+    ec_foe_request_write(&request);
 
-/****************************************************************************/
+    if (down_interruptible(&master->master_sem)) {
+        ec_foe_request_clear(&request);
+        return -EINTR;
+    }
 
-/** Starts a VoE read operation without sending a sync message first.
- *
- * \return Zero on success, otherwise a negative error code.
- */
-static ATTRIBUTES int ec_ioctl_voe_read_nosync(
-        ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
-        )
-{
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
+    if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                io.slave_position);
+        ec_foe_request_clear(&request);
+        return -EINVAL;
+    }
 
-    if (unlikely(!ctx->requested))
-        return -EPERM;
+    EC_SLAVE_DBG(slave, 1, "Scheduling FoE write request.\n");
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
-        return -EFAULT;
+    // schedule FoE write request.
+    list_add_tail(&request.list, &slave->foe_requests);
 
-    /* no locking of master_sem needed, because neither sc nor voe will not be
-     * deleted in the meantime. */
+    up(&master->master_sem);
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        return -ENOENT;
+    // wait for processing through FSM
+    if (wait_event_interruptible(master->request_queue,
+                request.state != EC_INT_REQUEST_QUEUED)) {
+        // interrupted by signal
+        down(&master->master_sem);
+        if (request.state == EC_INT_REQUEST_QUEUED) {
+            // abort request
+            list_del(&request.list);
+            up(&master->master_sem);
+            ec_foe_request_clear(&request);
+            return -EINTR;
+        }
+        up(&master->master_sem);
     }
 
-    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
-        return -ENOENT;
+    // wait until master FSM has finished processing
+    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
+
+    io.result = request.result;
+    io.error_code = request.error_code;
+
+    ret = request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+
+    if (__copy_to_user((void __user *) arg, &io, sizeof(io))) {
+        ret = -EFAULT;
     }
 
-    return ecrt_voe_handler_read_nosync(voe);
+    ec_foe_request_clear(&request);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Starts a VoE write operation.
+/** Window size of a streamed FoE transfer.
  *
- * \return Zero on success, otherwise a negative error code.
+ * This is the kernel memory used per transfer, independent of the file size.
  */
-static ATTRIBUTES int ec_ioctl_voe_write(
-        ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
-        )
-{
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
-
-    if (unlikely(!ctx->requested))
-        return -EPERM;
-
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
-        return -EFAULT;
+#define EC_IOCTL_FOE_STREAM_WINDOW 65536
 
-    /* no locking of master_sem needed, because neither sc nor voe will not be
-     * deleted in the meantime. */
+/** Streamed FoE transfer of a file handle.
+ *
+ * The request has to be the first member, because an orphaned request is
+ * freed by the slave FSM via kfree().
+ */
+struct ec_ioctl_foe_stream {
+    ec_foe_request_t request; /**< FoE request with the ring buffer. */
+    char file_name[32]; /**< File name. */
+};
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        return -ENOENT;
-    }
+/****************************************************************************/
 
-    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
-        return -ENOENT;
-    }
+/** Returns, if the FSM has finished processing a streamed transfer.
+ *
+ * \return Non-zero, if finished.
+ */
+static int ec_ioctl_foe_stream_done(
+        const ec_foe_request_t *request /**< FoE request. */
+        )
+{
+    return request->state != EC_INT_REQUEST_QUEUED
+        && request->state != EC_INT_REQUEST_BUSY;
+}
 
-    if (data.size) {
-        if (data.size > ec_voe_handler_mem_size(voe))
-            return -ENOBUFS;
+/****************************************************************************/
 
-        if (ec_copy_from_user(ecrt_voe_handler_data(voe),
-                    (void __user *) data.data, data.size, ctx))
-            return -EFAULT;
+/** Aborts a streamed FoE transfer.
+ *
+ * A queued transfer is dequeued, a running transfer is aborted at the next
+ * packet boundary. Does not wait for the slave FSM.
+ */
+static void ec_ioctl_foe_stream_abort(
+        ec_master_t *master, /**< EtherCAT master. */
+        ec_foe_request_t *request /**< FoE request. */
+        )
+{
+    down(&master->master_sem);
+    if (request->state == EC_INT_REQUEST_QUEUED) {
+        list_del(&request->list);
+        request->state = EC_INT_REQUEST_FAILURE;
+    } else if (request->state == EC_INT_REQUEST_BUSY) {
+        request->stream_abort = 1;
     }
-
-    return ecrt_voe_handler_write(voe, data.size);
+    up(&master->master_sem);
 }
 
 /****************************************************************************/
 
-/** Executes the VoE state machine.
+/** Ends a streamed FoE transfer and frees it.
  *
- * \return Zero on success, otherwise a negative error code.
+ * An unfinished transfer is aborted. If the slave FSM still processes it,
+ * the request is orphaned and freed by the FSM, so that closing the file
+ * handle does not block.
+ *
+ * Has to be called with \a foe_stream_sem held, or on release of the file
+ * handle.
  */
-static ATTRIBUTES int ec_ioctl_voe_exec(
+#ifdef EC_IOCTL_RTDM
+void ec_ioctl_rtdm_foe_stream_clear
+#else
+void ec_ioctl_foe_stream_clear
+#endif
+        (
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg, /**< ioctl() argument. */
-        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
+        ec_ioctl_context_t *ctx /**< Device context. */
         )
 {
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
-
-    if (unlikely(!ctx->requested))
-        return -EPERM;
+    struct ec_ioctl_foe_stream *stream = ctx->foe_stream;
+    ec_foe_request_t *request;
+    int orphaned = 0;
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
-        return -EFAULT;
-
-    /* no locking of master_sem needed, because neither sc nor voe will not be
-     * deleted in the meantime. */
-
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        return -ENOENT;
+    if (!stream) {
+        return;
     }
+    request = &stream->request;
+    ctx->foe_stream = NULL;
 
-    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
-        return -ENOENT;
+    down(&master->master_sem);
+    if (request->state == EC_INT_REQUEST_QUEUED) {
+        list_del(&request->list);
+        request->state = EC_INT_REQUEST_FAILURE;
+    } else if (request->state == EC_INT_REQUEST_BUSY) {
+        request->stream_abort = 1;
+        request->stream_orphaned = 1;
+        orphaned = 1;
     }
+    up(&master->master_sem);
 
-    if (ec_ioctl_lock_interruptible(&master->io_mutex))
-        return -EINTR;
-
-    data.state = ecrt_voe_handler_execute(voe);
-    ec_ioctl_unlock(&master->io_mutex);
-    if (data.state == EC_REQUEST_SUCCESS && voe->dir == EC_DIR_INPUT)
-        data.size = ecrt_voe_handler_data_size(voe);
-    else
-        data.size = 0;
-
-    if (ec_copy_to_user((void __user *) arg, &data, sizeof(data), ctx))
-        return -EFAULT;
-
-    return 0;
+    if (!orphaned) {
+        ec_foe_request_clear(request);
+        kfree(stream);
+    }
 }
 
 /****************************************************************************/
 
-/** Reads the received VoE data.
+/** Starts a streamed FoE transfer.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_voe_data(
+static ATTRIBUTES int ec_ioctl_slave_foe_stream_start(
         ec_master_t *master, /**< EtherCAT master. */
         void *arg, /**< ioctl() argument. */
         ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_voe_t data;
-    ec_slave_config_t *sc;
-    ec_voe_handler_t *voe;
-
-    if (unlikely(!ctx->requested))
-        return -EPERM;
+    ec_ioctl_slave_foe_stream_t io;
+    struct ec_ioctl_foe_stream *stream;
+    ec_slave_t *slave;
+    int ret;
 
-    if (ec_copy_from_user(&data, (void __user *) arg, sizeof(data), ctx))
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
+    }
 
-    /* no locking of master_sem needed, because neither sc nor voe will not be
-     * deleted in the meantime. */
+    if (down_interruptible(&ctx->foe_stream_sem)) {
+        return -EINTR;
+    }
 
-    if (!(sc = ec_master_get_config(master, data.config_index))) {
-        return -ENOENT;
+    if (ctx->foe_stream) {
+        ret = -EBUSY;
+        goto out_up;
     }
 
-    if (!(voe = ec_slave_config_find_voe_handler(sc, data.voe_index))) {
-        return -ENOENT;
+    if (!(stream = kmalloc(sizeof(*stream), GFP_KERNEL))) {
+        ret = -ENOMEM;
+        goto out_up;
     }
 
-    if (ec_copy_to_user((void __user *) data.data, ecrt_voe_handler_data(voe),
-                ecrt_voe_handler_data_size(voe), ctx))
-        return -EFAULT;
+    memcpy(stream->file_name, io.file_name, sizeof(stream->file_name));
+    stream->file_name[sizeof(stream->file_name) - 1] = 0;
+
+    ec_foe_request_init(&stream->request, stream->file_name);
+    ret = ec_foe_request_stream(&stream->request,
+            EC_IOCTL_FOE_STREAM_WINDOW);
+    if (ret) {
+        goto out_free;
+    }
+
+    if (io.write) {
+        ec_foe_request_write(&stream->request);
+    } else {
+        ec_foe_request_read(&stream->request);
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        ret = -EINTR;
+        goto out_free;
+    }
+
+    if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
+        up(&master->master_sem);
+        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                io.slave_position);
+        ret = -EINVAL;
+        goto out_free;
+    }
+
+    EC_SLAVE_DBG(slave, 1, "Scheduling streamed FoE %s request.\n",
+            io.write ? "write" : "read");
+
+    // schedule request; it is processed, while data are passed.
+    list_add_tail(&stream->request.list, &slave->foe_requests);
+
+    up(&master->master_sem);
 
+    ctx->foe_stream = stream;
+    up(&ctx->foe_stream_sem);
     return 0;
+
+out_free:
+    ec_foe_request_clear(&stream->request);
+    kfree(stream);
+out_up:
+    up(&ctx->foe_stream_sem);
+    return ret;
 }
 
 /****************************************************************************/
 
-/** Read a file from a slave via FoE.
+/** Passes the next chunk of a streamed FoE transfer.
+ *
+ * When writing, as much of the chunk is taken as fits into the window, and
+ * the number of bytes taken is returned in \a data_size. When reading, up to
+ * \a buffer_size bytes are returned. A data size of zero marks the end of
+ * the file.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_foe_read(
+static ATTRIBUTES int ec_ioctl_slave_foe_stream_data(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_slave_foe_t io;
-    ec_foe_request_t request;
-    ec_slave_t *slave;
-    int ret;
+    ec_ioctl_slave_foe_stream_t io;
+    ec_foe_request_t *request;
+    size_t offset, size, pos, first;
+    int ret = 0;
 
     if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
     }
 
-    ec_foe_request_init(&request, io.file_name);
-    ret = ec_foe_request_alloc(&request, 10000); // FIXME
-    if (ret) {
-        ec_foe_request_clear(&request);
-        return ret;
-    }
-
-    ec_foe_request_read(&request);
-
-    if (down_interruptible(&master->master_sem)) {
-        ec_foe_request_clear(&request);
+    if (down_interruptible(&ctx->foe_stream_sem)) {
         return -EINTR;
     }
 
-    if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
-        up(&master->master_sem);
-        ec_foe_request_clear(&request);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                io.slave_position);
-        return -EINVAL;
+    if (!ctx->foe_stream) {
+        ret = -EINVAL;
+        goto out_up;
     }
+    request = &ctx->foe_stream->request;
 
-    EC_SLAVE_DBG(slave, 1, "Scheduling FoE read request.\n");
-
-    // schedule request.
-    list_add_tail(&request.list, &slave->foe_requests);
+    if (request->dir == EC_DIR_OUTPUT) {
+        if (request->stream_eof) {
+            ret = -EINVAL;
+            goto out_up;
+        }
 
-    up(&master->master_sem);
+        // wait for space in the window
+        if (io.buffer_size && wait_event_interruptible(master->request_queue,
+                    ec_foe_request_stream_space(request)
+                    || ec_ioctl_foe_stream_done(request))) {
+            ret = -EINTR;
+            goto out_up;
+        }
 
-    // wait for processing through FSM
-    if (wait_event_interruptible(master->request_queue,
-                request.state != EC_INT_REQUEST_QUEUED)) {
-        // interrupted by signal
-        down(&master->master_sem);
-        if (request.state == EC_INT_REQUEST_QUEUED) {
-            list_del(&request.list);
+        if (down_interruptible(&master->master_sem)) {
+            ret = -EINTR;
+            goto out_up;
+        }
+        if (ec_ioctl_foe_stream_done(request)) {
             up(&master->master_sem);
-            ec_foe_request_clear(&request);
-            return -EINTR;
+            ret = -EIO;
+            goto out_up;
         }
-        // request already processing: interrupt not possible.
+        offset = request->stream_head;
+        size = min(io.buffer_size, ec_foe_request_stream_space(request));
         up(&master->master_sem);
-    }
-
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
 
-    io.result = request.result;
-    io.error_code = request.error_code;
+        // the FSM does not touch the free part of the window
+        pos = offset % request->buffer_size;
+        first = min(size, request->buffer_size - pos);
+        if (copy_from_user(request->buffer + pos,
+                    (void __user *) io.buffer, first)
+                || copy_from_user(request->buffer,
+                    (void __user *) (io.buffer + first), size - first)) {
+            ret = -EFAULT;
+            goto out_up;
+        }
 
-    if (request.state != EC_INT_REQUEST_SUCCESS) {
-        io.data_size = 0;
-        ret = -EIO;
+        down(&master->master_sem);
+        request->stream_head += size;
+        if (io.last && size == io.buffer_size) {
+            request->stream_eof = 1;
+        }
+        up(&master->master_sem);
     } else {
-        if (request.data_size > io.buffer_size) {
-            EC_SLAVE_ERR(slave, "%s(): Buffer too small.\n", __func__);
-            ec_foe_request_clear(&request);
-            return -ENOBUFS;
+        // wait for data in the window
+        if (wait_event_interruptible(master->request_queue,
+                    ec_foe_request_stream_avail(request)
+                    || ec_ioctl_foe_stream_done(request))) {
+            ret = -EINTR;
+            goto out_up;
         }
-        io.data_size = request.data_size;
+
+        if (down_interruptible(&master->master_sem)) {
+            ret = -EINTR;
+            goto out_up;
+        }
+        if (request->state == EC_INT_REQUEST_FAILURE) {
+            up(&master->master_sem);
+            ret = -EIO;
+            goto out_up;
+        }
+        offset = request->stream_tail;
+        size = min(io.buffer_size, ec_foe_request_stream_avail(request));
+        up(&master->master_sem);
+
+        // the FSM does not touch the filled part of the window
+        pos = offset % request->buffer_size;
+        first = min(size, request->buffer_size - pos);
         if (copy_to_user((void __user *) io.buffer,
-                    request.buffer, io.data_size)) {
-            ec_foe_request_clear(&request);
-            return -EFAULT;
+                    request->buffer + pos, first)
+                || copy_to_user((void __user *) (io.buffer + first),
+                    request->buffer, size - first)) {
+            ret = -EFAULT;
+            goto out_up;
         }
-        ret = 0;
+
+        down(&master->master_sem);
+        request->stream_tail += size;
+        up(&master->master_sem);
     }
 
+    io.data_size = size;
+    io.result = request->result;
+    io.error_code = request->error_code;
+
     if (__copy_to_user((void __user *) arg, &io, sizeof(io))) {
         ret = -EFAULT;
     }
 
-    ec_foe_request_clear(&request);
+out_up:
+    up(&ctx->foe_stream_sem);
     return ret;
 }
 
 /****************************************************************************/
 
-/** Write a file to a slave via FoE
+/** Finishes a streamed FoE transfer.
+ *
+ * Waits for the end of the transfer. An incomplete transfer is aborted. If
+ * the wait is interrupted, the transfer is kept and finishing can be
+ * repeated.
  *
  * \return Zero on success, otherwise a negative error code.
  */
-static ATTRIBUTES int ec_ioctl_slave_foe_write(
+static ATTRIBUTES int ec_ioctl_slave_foe_stream_finish(
         ec_master_t *master, /**< EtherCAT master. */
-        void *arg /**< ioctl() argument. */
+        void *arg, /**< ioctl() argument. */
+        ec_ioctl_context_t *ctx /**< Private data structure of file handle. */
         )
 {
-    ec_ioctl_slave_foe_t io;
-    ec_foe_request_t request;
-    ec_slave_t *slave;
+    ec_ioctl_slave_foe_stream_t io;
+    ec_foe_request_t *request;
     int ret;
 
     if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
         return -EFAULT;
     }
 
-    ec_foe_request_init(&request, io.file_name);
+    if (down_interruptible(&ctx->foe_stream_sem)) {
+        return -EINTR;
+    }
 
-    ret = ec_foe_request_alloc(&request, io.buffer_size);
-    if (ret) {
-        ec_foe_request_clear(&request);
-        return ret;
+    if (!ctx->foe_stream) {
+        ret = -EINVAL;
+        goto out_up;
     }
+    request = &ctx->foe_stream->request;
 
-    if (copy_from_user(request.buffer,
-                (void __user *) io.buffer, io.buffer_size)) {
-        ec_foe_request_clear(&request);
-        return -EFAULT;
+    if (request->dir == EC_DIR_OUTPUT && request->stream_eof) {
+        // wait until the remaining data are sent
+        if (wait_event_interruptible(master->request_queue,
+                    ec_ioctl_foe_stream_done(request))) {
+            ret = -EINTR;
+            goto out_up;
+        }
     }
 
-    request.data_size = io.buffer_size;
-    ec_foe_request_write(&request);
+    // an incomplete transfer is aborted
+    ec_ioctl_foe_stream_abort(master, request);
+    if (wait_event_interruptible(master->request_queue,
+                request->state != EC_INT_REQUEST_BUSY)) {
+        ret = -EINTR;
+        goto out_up;
+    }
 
-    if (down_interruptible(&master->master_sem)) {
-        ec_foe_request_clear(&request);
-        return -EINTR;
+    io.data_size = request->stream_head;
+    io.result = request->result;
+    io.error_code = request->error_code;
+    ret = request->state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+
+#ifdef EC_IOCTL_RTDM
+    ec_ioctl_rtdm_foe_stream_clear(master, ctx);
+#else
+    ec_ioctl_foe_stream_clear(master, ctx);
+#endif
+
+    if (__copy_to_user((void __user *) arg, &io, sizeof(io))) {
+        ret = -EFAULT;
     }
 
-    if (!(slave = ec_master_find_slave(master, 0, io.slave_position))) {
-        up(&master->master_sem);
-        EC_MASTER_ERR(master, "Slave %u does not exist!\n",
-                io.slave_position);
-        ec_foe_request_clear(&request);
+out_up:
+    up(&ctx->foe_stream_sem);
+    return ret;
+}
+
+/****************************************************************************/
+
+/** Write a file to several slaves via FoE.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static ATTRIBUTES int ec_ioctl_slave_foe_write_multi(
+        ec_master_t *master, /**< EtherCAT master. */
+        void *arg /**< ioctl() argument. */
+        )
+{
+    ec_ioctl_slave_foe_multi_t io;
+    ec_foe_target_t *targets;
+    uint8_t *data = NULL;
+    size_t size;
+    int ret;
+
+    if (copy_from_user(&io, (void __user *) arg, sizeof(io))) {
+        return -EFAULT;
+    }
+
+    // every slave can be addressed only once
+    if (!io.target_count || io.target_count > master->slave_count) {
         return -EINVAL;
     }
 
-    EC_SLAVE_DBG(slave, 1, "Scheduling FoE write request.\n");
+    size = io.target_count * sizeof(ec_foe_target_t);
+    if (!(targets = kcalloc(io.target_count, sizeof(ec_foe_target_t),
+                    GFP_KERNEL))) {
+        return -ENOMEM;
+    }
 
-    // schedule FoE write request.
-    list_add_tail(&request.list, &slave->foe_requests);
+    if (copy_from_user(targets, (void __user *) io.targets, size)) {
+        kfree(targets);
+        return -EFAULT;
+    }
 
-    up(&master->master_sem);
+    // the file is held once for all slaves
+    if (io.buffer_size) {
+        if (!(data = vmalloc(io.buffer_size))) {
+            EC_MASTER_ERR(master, "Failed to allocate %zu bytes"
+                    " of FoE memory.\n", io.buffer_size);
+            kfree(targets);
+            return -ENOMEM;
+        }
 
-    // wait for processing through FSM
-    if (wait_event_interruptible(master->request_queue,
-                request.state != EC_INT_REQUEST_QUEUED)) {
-        // interrupted by signal
-        down(&master->master_sem);
-        if (request.state == EC_INT_REQUEST_QUEUED) {
-            // abort request
-            list_del(&request.list);
-            up(&master->master_sem);
-            ec_foe_request_clear(&request);
-            return -EINTR;
+        if (copy_from_user(data, (void __user *) io.buffer,
+                    io.buffer_size)) {
+            vfree(data);
+            kfree(targets);
+            return -EFAULT;
         }
-        up(&master->master_sem);
     }
 
-    // wait until master FSM has finished processing
-    wait_event(master->request_queue, request.state != EC_INT_REQUEST_BUSY);
-
-    io.result = request.result;
-    io.error_code = request.error_code;
+    io.file_name[sizeof(io.file_name) - 1] = 0;
 
-    ret = request.state == EC_INT_REQUEST_SUCCESS ? 0 : -EIO;
+    ret = ecrt_master_foe_write(master, targets, io.target_count,
+            io.file_name, data, io.buffer_size);
 
-    if (__copy_to_user((void __user *) arg, &io, sizeof(io))) {
-        ret = -EFAULT;
+    if (ret == 0 || ret == -EIO) {
+        if (copy_to_user((void __user *) io.targets, targets, size)) {
+            ret = -EFAULT;
+        }
     }
 
-    ec_foe_request_clear(&request);
+    if (data) {
+        vfree(data);
+    }
+    kfree(targets);
     return ret;
 }
 
@@ -4916,6 +5890,13 @@ static long ec_ioctl_both(
             }
             ret = ec_ioctl_sdo_request_timeout(master, arg, ctx);
             break;
+        case EC_IOCTL_SDO_REQUEST_COMPLETE:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_sdo_request_complete(master, arg, ctx);
+            break;
         case EC_IOCTL_SDO_REQUEST_DATA:
             ret = ec_ioctl_sdo_request_data(master, arg, ctx);
             break;
@@ -4942,6 +5923,20 @@ static long ec_ioctl_both(
         case EC_IOCTL_VOE_DATA:
             ret = ec_ioctl_voe_data(master, arg, ctx);
             break;
+        case EC_IOCTL_RECORDER_FREEZE:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_recorder_freeze(master, arg);
+            break;
+        case EC_IOCTL_DOMAIN_MERGING:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_domain_merging(master, arg);
+            break;
         default:
 #ifdef EC_IOCTL_RTDM
             ret = -ENOTTY;
@@ -5251,6 +6246,32 @@ static long ec_ioctl_nrt
         case EC_IOCTL_DOMAIN_DATA:
             ret = ec_ioctl_domain_data(master, arg);
             break;
+        case EC_IOCTL_RECORDER_READ:
+            ret = ec_ioctl_recorder_read(master, arg);
+            break;
+        case EC_IOCTL_TIMELINE:
+            ret = ec_ioctl_timeline(master, arg);
+            break;
+        case EC_IOCTL_TIMELINE_RESET:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_timeline_reset(master);
+            break;
+        case EC_IOCTL_SNAPSHOT:
+            ret = ec_ioctl_snapshot(master, arg);
+            break;
+        case EC_IOCTL_SLAVE_SDO_DICT:
+            ret = ec_ioctl_slave_sdo_dict(master, arg);
+            break;
+        case EC_IOCTL_RECORDER_ARM:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_recorder_arm(master, arg);
+            break;
         case EC_IOCTL_MASTER_DEBUG:
             if (!ctx->writable) {
                 ret = -EPERM;
@@ -5258,6 +6279,13 @@ static long ec_ioctl_nrt
             }
             ret = ec_ioctl_master_debug(master, arg);
             break;
+        case EC_IOCTL_MASTER_FSM_SLOTS:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_master_fsm_slots(master, arg);
+            break;
         case EC_IOCTL_SLAVE_STATE:
             if (!ctx->writable) {
                 ret = -EPERM;
@@ -5323,6 +6351,34 @@ static long ec_ioctl_nrt
             }
             ret = ec_ioctl_slave_foe_write(master, arg);
             break;
+        case EC_IOCTL_SLAVE_FOE_STREAM_START:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_slave_foe_stream_start(master, arg, ctx);
+            break;
+        case EC_IOCTL_SLAVE_FOE_STREAM_DATA:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_slave_foe_stream_data(master, arg, ctx);
+            break;
+        case EC_IOCTL_SLAVE_FOE_STREAM_FINISH:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_slave_foe_stream_finish(master, arg, ctx);
+            break;
+        case EC_IOCTL_SLAVE_FOE_WRITE_MULTI:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_slave_foe_write_multi(master, arg);
+            break;
         case EC_IOCTL_SLAVE_SOE_READ:
             if (!ctx->writable) {
                 ret = -EPERM;
@@ -5473,6 +6529,13 @@ static long ec_ioctl_nrt
             }
             ret = ec_ioctl_sc_reg_pdo_pos(master, arg, ctx);
             break;
+        case EC_IOCTL_SC_REG_PDO:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_sc_reg_pdo(master, arg, ctx);
+            break;
         case EC_IOCTL_SC_DC:
             if (!ctx->writable) {
                 ret = -EPERM;
@@ -5565,6 +6628,13 @@ static long ec_ioctl_nrt
             }
             ret = ec_ioctl_set_send_interval(master, arg, ctx);
             break;
+        case EC_IOCTL_DOMAIN_RECORDER:
+            if (!ctx->writable) {
+                ret = -EPERM;
+                break;
+            }
+            ret = ec_ioctl_domain_recorder(master, arg, ctx);
+            break;
         default:
 #ifdef EC_IOCTL_RTDM
             ret = ec_ioctl_both(master, ctx, cmd, arg);
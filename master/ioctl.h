@@ -47,7 +47,7 @@
  *
  * Increment this when changing the ioctl interface!
  */
-#define EC_IOCTL_VERSION_MAGIC 37
+#define EC_IOCTL_VERSION_MAGIC 48
 
 // Command-line tool
 #define EC_IOCTL_MODULE                EC_IOR(0x00, ec_ioctl_module_t)
@@ -161,6 +161,26 @@
 #define EC_IOCTL_VOE_EXEC             EC_IOWR(0x64, ec_ioctl_voe_t)
 #define EC_IOCTL_VOE_DATA             EC_IOWR(0x65, ec_ioctl_voe_t)
 #define EC_IOCTL_SET_SEND_INTERVAL     EC_IOW(0x66, size_t)
+#define EC_IOCTL_DOMAIN_RECORDER       EC_IOW(0x67, ec_ioctl_recorder_t)
+#define EC_IOCTL_RECORDER_READ        EC_IOWR(0x68, ec_ioctl_recorder_read_t)
+#define EC_IOCTL_RECORDER_FREEZE        EC_IO(0x69)
+#define EC_IOCTL_RECORDER_ARM           EC_IO(0x6a)
+#define EC_IOCTL_SC_REG_PDO           EC_IOWR(0x6b, ec_ioctl_reg_pdo_t)
+#define EC_IOCTL_DOMAIN_MERGING         EC_IO(0x6c)
+#define EC_IOCTL_TIMELINE             EC_IOWR(0x6d, ec_ioctl_timeline_t)
+#define EC_IOCTL_TIMELINE_RESET         EC_IO(0x6e)
+#define EC_IOCTL_SNAPSHOT             EC_IOWR(0x6f, ec_ioctl_snapshot_t)
+#define EC_IOCTL_MASTER_FSM_SLOTS       EC_IO(0x70)
+#define EC_IOCTL_SDO_REQUEST_COMPLETE EC_IOWR(0x71, ec_ioctl_sdo_request_t)
+#define EC_IOCTL_SLAVE_SDO_DICT      EC_IOWR(0x72, ec_ioctl_slave_sdo_dict_t)
+#define EC_IOCTL_SLAVE_FOE_STREAM_START \
+                                EC_IOW(0x73, ec_ioctl_slave_foe_stream_t)
+#define EC_IOCTL_SLAVE_FOE_STREAM_DATA \
+                               EC_IOWR(0x74, ec_ioctl_slave_foe_stream_t)
+#define EC_IOCTL_SLAVE_FOE_STREAM_FINISH \
+                               EC_IOWR(0x75, ec_ioctl_slave_foe_stream_t)
+#define EC_IOCTL_SLAVE_FOE_WRITE_MULTI \
+                                EC_IOW(0x76, ec_ioctl_slave_foe_multi_t)
 
 /****************************************************************************/
 
@@ -168,6 +188,63 @@
 
 /****************************************************************************/
 
+/** Flight recorder states.
+ */
+typedef enum {
+    EC_RECORDER_OFF, /**< No recorder memory allocated. */
+    EC_RECORDER_ARMED, /**< Recording, waiting for a trigger. */
+    EC_RECORDER_TRIGGERED, /**< Triggered, recording post-trigger cycles. */
+    EC_RECORDER_FROZEN /**< Frozen, ring contents are stable. */
+} ec_recorder_state_t;
+
+/** Size of the flight recorder header area in bytes.
+ *
+ * The records follow at this offset in the recorder memory.
+ */
+#define EC_RECORDER_HEADER_SIZE 64
+
+/** Bit shift of the flight recorder mmap() offsets.
+ */
+#define EC_RECORDER_MMAP_SHIFT 24
+
+/** Offset of a domain's flight recorder for mmap().
+ *
+ * The process data are mapped at offset zero, the recorder memory of domain
+ * \a IDX is mapped at this byte offset.
+ */
+#define EC_RECORDER_MMAP_OFFSET(IDX) \
+    (((unsigned long) (IDX) + 1) << EC_RECORDER_MMAP_SHIFT)
+
+/** Flight recorder header.
+ *
+ * Located at the start of the recorder memory. \a write_count is
+ * incremented after each completed record, so that the record with index
+ * (write_count - 1) % depth is the newest one.
+ */
+typedef struct {
+    uint32_t depth; /**< Number of records in the ring. */
+    uint32_t record_size; /**< Size of a record (incl. header) in bytes. */
+    uint32_t data_size; /**< Size of the process data image. */
+    uint32_t state; /**< Recorder state (ec_recorder_state_t). */
+    uint32_t trigger; /**< Trigger that froze the recorder. */
+    uint32_t post_trigger; /**< Records taken after the trigger. */
+    uint64_t write_count; /**< Number of records written. */
+    uint64_t trigger_count; /**< Value of \a write_count at trigger time. */
+} ec_recorder_header_t;
+
+/** Flight recorder record header.
+ *
+ * Followed by \a data_size bytes of process data.
+ */
+typedef struct {
+    uint64_t cycle; /**< Cycle counter of the domain. */
+    uint64_t app_time; /**< Application time of the cycle. */
+    uint16_t working_counter[EC_MAX_NUM_DEVICES]; /**< Working counters. */
+    uint16_t expected_working_counter; /**< Expected working counter. */
+} ec_recorder_record_t;
+
+/****************************************************************************/
+
 typedef struct {
     uint32_t ioctl_version_magic;
     uint32_t master_count;
@@ -211,6 +288,8 @@ typedef struct {
     uint64_t app_time;
     uint64_t dc_ref_time;
     uint16_t ref_clock;
+    uint32_t fsm_slots;
+    uint32_t ext_ring_size;
 } ec_ioctl_master_t;
 
 /****************************************************************************/
@@ -319,6 +398,9 @@ typedef struct {
     uint16_t working_counter[EC_MAX_NUM_DEVICES];
     uint16_t expected_working_counter;
     uint32_t fmmu_count;
+    uint8_t diag_state;
+    uint16_t diag_working_counter;
+    uint32_t diag_count;
 } ec_ioctl_domain_t;
 
 /****************************************************************************/
@@ -335,6 +417,9 @@ typedef struct {
     ec_direction_t dir;
     uint32_t logical_address;
     uint32_t data_size;
+    uint8_t diag_flags;
+    uint8_t diag_al_state;
+    uint16_t diag_al_status_code;
 } ec_ioctl_domain_fmmu_t;
 
 /****************************************************************************/
@@ -390,6 +475,7 @@ typedef struct {
     uint16_t slave_position;
     uint16_t sdo_index;
     uint8_t sdo_entry_subindex;
+    uint8_t complete_access;
     size_t target_size;
     uint8_t *target;
 
@@ -452,6 +538,36 @@ typedef struct {
 
 /****************************************************************************/
 
+typedef struct {
+    // inputs
+    uint16_t slave_position;
+    uint8_t write;
+    uint8_t last;
+    size_t buffer_size;
+    uint8_t *buffer;
+    char file_name[32];
+
+    // outputs
+    size_t data_size;
+    uint32_t result;
+    uint32_t error_code;
+} ec_ioctl_slave_foe_stream_t;
+
+/****************************************************************************/
+
+typedef struct {
+    // inputs
+    char file_name[32];
+    size_t buffer_size;
+    const uint8_t *buffer;
+    uint32_t target_count;
+
+    // inputs/outputs
+    ec_foe_target_t *targets;
+} ec_ioctl_slave_foe_multi_t;
+
+/****************************************************************************/
+
 typedef struct {
     // inputs
     uint16_t slave_position;
@@ -694,6 +810,18 @@ typedef struct {
 
 /****************************************************************************/
 
+typedef struct {
+    // inputs
+    uint32_t config_index;
+    uint16_t pdo_index;
+    uint32_t domain_index;
+
+    // outputs
+    unsigned int size;
+} ec_ioctl_reg_pdo_t;
+
+/****************************************************************************/
+
 typedef struct {
     // inputs
     uint32_t config_index;
@@ -778,6 +906,7 @@ typedef struct {
     uint32_t request_index;
     uint16_t sdo_index;
     uint8_t sdo_subindex;
+    uint8_t complete_access;
     size_t size;
     uint8_t *data;
     uint32_t timeout;
@@ -843,6 +972,85 @@ typedef struct {
 
 /****************************************************************************/
 
+typedef struct {
+    // inputs
+    uint32_t domain_index;
+    uint32_t depth;
+    uint32_t post_trigger;
+    uint32_t triggers;
+} ec_ioctl_recorder_t;
+
+/****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint32_t domain_index;
+    uint32_t size;
+    uint8_t *target;
+
+    // outputs
+    ec_recorder_header_t header;
+} ec_ioctl_recorder_read_t;
+
+/****************************************************************************/
+
+/** State machines recorded in the startup timeline.
+ */
+typedef enum {
+    EC_TIMELINE_SCAN, /**< Slave scan state machine. */
+    EC_TIMELINE_CONFIG /**< Slave configuration state machine. */
+} ec_timeline_fsm_t;
+
+/** Maximum size of a state name in the startup timeline.
+ */
+#define EC_TIMELINE_STATE_SIZE 24
+
+typedef struct {
+    uint64_t time; /**< Monotonic time stamp in ns. */
+    uint16_t slave_position; /**< Ring position of the slave. */
+    uint8_t fsm; /**< State machine (ec_timeline_fsm_t). */
+    char state[EC_TIMELINE_STATE_SIZE]; /**< Name of the entered state. */
+} ec_ioctl_timeline_event_t;
+
+/****************************************************************************/
+
+typedef struct {
+    // inputs
+    ec_ioctl_timeline_event_t *events;
+
+    // inputs/outputs
+    uint32_t count;
+
+    // outputs
+    uint32_t size;
+    uint64_t write_count;
+} ec_ioctl_timeline_t;
+
+/****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint8_t *data;
+    uint32_t size;
+
+    // outputs
+    uint32_t length;
+} ec_ioctl_snapshot_t;
+
+/****************************************************************************/
+
+typedef struct {
+    // inputs
+    uint16_t slave_position;
+    uint8_t *data;
+    uint32_t size;
+
+    // outputs
+    uint32_t length;
+} ec_ioctl_slave_sdo_dict_t;
+
+/****************************************************************************/
+
 #ifdef __KERNEL__
 
 /** Context data structure for file handles.
@@ -852,10 +1060,14 @@ typedef struct {
     unsigned int requested; /**< Master was requested via this file handle. */
     uint8_t *process_data; /**< Total process data area. */
     size_t process_data_size; /**< Size of the \a process_data. */
+    struct ec_ioctl_foe_stream *foe_stream; /**< Streamed FoE transfer. */
+    struct semaphore foe_stream_sem; /**< Semaphore protecting
+                                       \a foe_stream. */
 } ec_ioctl_context_t;
 
 long ec_ioctl(ec_master_t *, ec_ioctl_context_t *, unsigned int,
         void __user *);
+void ec_ioctl_foe_stream_clear(ec_master_t *, ec_ioctl_context_t *);
 
 #ifdef EC_RTDM
 
@@ -863,6 +1075,7 @@ long ec_ioctl_rtdm_rt(ec_master_t *, ec_ioctl_context_t *, unsigned int,
         void __user *);
 long ec_ioctl_rtdm_nrt(ec_master_t *, ec_ioctl_context_t *, unsigned int,
         void __user *);
+void ec_ioctl_rtdm_foe_stream_clear(ec_master_t *, ec_ioctl_context_t *);
 
 #ifndef EC_RTDM_XENOMAI_V3
 int ec_rtdm_mmap(ec_ioctl_context_t *, void **);
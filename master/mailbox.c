@@ -32,6 +32,7 @@
 #include "mailbox.h"
 #include "datagram.h"
 #include "master.h"
+#include "slave_config.h"
 
 /****************************************************************************/
 
@@ -94,6 +95,11 @@ int ec_slave_mbox_prepare_check(const ec_slave_t *slave, /**< slave */
         return ret;
 
     ec_datagram_zero(datagram);
+
+    if (slave->mbox_status_mapped) {
+        // may be answered from the master's mailbox status image
+        datagram->mbox_status_bit = slave - slave->master->slaves;
+    }
     return 0;
 }
 
@@ -111,6 +117,88 @@ int ec_slave_mbox_check(const ec_datagram_t *datagram /**< datagram */)
 
 /****************************************************************************/
 
+/** Determines the FMMU, that maps the mailbox status of a slave.
+ *
+ * The "mailbox full" bit of SM1 is mapped bit-wise into the master's
+ * mailbox status image, at the slave's index. This needs a slave at the
+ * main device, that supports FMMU bit operation and has a spare FMMU above
+ * the ones used for process data. The last FMMU is used.
+ *
+ * \return FMMU index, or -1, if the mailbox status can not be mapped.
+ */
+int ec_slave_mbox_status_fmmu(const ec_slave_t *slave /**< slave */)
+{
+    unsigned int bit = slave - slave->master->slaves;
+    unsigned int used = slave->config ? slave->config->used_fmmus : 0;
+
+    if (slave->device_index != EC_DEVICE_MAIN
+            || !slave->sii.mailbox_protocols
+            || !slave->base_fmmu_bit_operation
+            || slave->base_fmmu_count <= used
+            || bit >= EC_MAX_DATA_SIZE * 8) {
+        return -1;
+    }
+
+    return slave->base_fmmu_count - 1;
+}
+
+/****************************************************************************/
+
+/** Writes the FMMU configuration page mapping the mailbox status.
+ */
+void ec_slave_mbox_status_page(
+        const ec_slave_t *slave, /**< slave */
+        uint8_t *data /**< Configuration page memory. */
+        )
+{
+    unsigned int bit = slave - slave->master->slaves;
+
+    EC_WRITE_U32(data, ec_master_mbox_status_address(slave->master)
+            + bit / 8);
+    EC_WRITE_U16(data + 4,  1); // size of fmmu
+    EC_WRITE_U8 (data + 6,  bit % 8); // logical start bit
+    EC_WRITE_U8 (data + 7,  bit % 8); // logical end bit
+    EC_WRITE_U16(data + 8,  0x080D); // SM1 status
+    EC_WRITE_U8 (data + 10, 3); // mailbox full bit
+    EC_WRITE_U8 (data + 11, 0x01); // read
+    EC_WRITE_U16(data + 12, 0x0001); // enable
+    EC_WRITE_U16(data + 14, 0x0000); // reserved
+}
+
+/****************************************************************************/
+
+/** Marks the mailbox status of a slave as (un-)mapped.
+ */
+void ec_slave_mbox_status_set_mapped(
+        ec_slave_t *slave, /**< slave */
+        unsigned int mapped /**< Mailbox status FMMU is configured. */
+        )
+{
+    ec_master_t *master = slave->master;
+    unsigned int size;
+
+    if (!mapped == !slave->mbox_status_mapped) {
+        return;
+    }
+
+    if (mapped) {
+        size = (slave - master->slaves) / 8 + 1;
+        if (size > master->mbox_status_size) {
+            master->mbox_status_size = size;
+        }
+        master->mbox_status_mapped++;
+        slave->mbox_status_mapped = 1;
+    } else {
+        master->mbox_status_mapped--;
+        slave->mbox_status_mapped = 0;
+    }
+
+    // give the changed image another try
+    master->mbox_status_errors = 0;
+}
+
+/****************************************************************************/
+
 /**
    Prepares a datagram to fetch mailbox data.
    \return 0 in case of success, else < 0
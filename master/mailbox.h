@@ -55,6 +55,9 @@ uint8_t *ec_slave_mbox_prepare_send(const ec_slave_t *, ec_datagram_t *,
                                     uint8_t, size_t);
 int      ec_slave_mbox_prepare_check(const ec_slave_t *, ec_datagram_t *);
 int      ec_slave_mbox_check(const ec_datagram_t *);
+int      ec_slave_mbox_status_fmmu(const ec_slave_t *);
+void     ec_slave_mbox_status_page(const ec_slave_t *, uint8_t *);
+void     ec_slave_mbox_status_set_mapped(ec_slave_t *, unsigned int);
 int      ec_slave_mbox_prepare_fetch(const ec_slave_t *, ec_datagram_t *);
 uint8_t *ec_slave_mbox_fetch(const ec_slave_t *, const ec_datagram_t *,
                              uint8_t *, size_t *);
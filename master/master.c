@@ -37,12 +37,14 @@
 #include <linux/version.h>
 #include <linux/hrtimer.h>
 #include <linux/kthread.h>
+#include <linux/vmalloc.h>
 
 #include "globals.h"
 #include "slave.h"
 #include "slave_config.h"
 #include "device.h"
 #include "datagram.h"
+#include "datagram_pair.h"
 
 #ifdef EC_EOE
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(4, 11, 0)
@@ -73,6 +75,15 @@
  */
 #define FORCE_OUTPUT_CORRUPTED 0
 
+/** Number of send cycles, for which domain datagram merging is suspended
+ * after a merged datagram returned with an unexpected working counter.
+ *
+ * The working counter of a merged datagram can only be attributed to the
+ * individual domains if it is complete, so the domains are sent separately
+ * for a while to get exact per-domain diagnostics.
+ */
+#define EC_MERGE_HOLD_CYCLES 1000
+
 /** SDO injection timeout in microseconds. */
 #define EC_SDO_INJECTION_TIMEOUT 10000
 
@@ -113,10 +124,24 @@ int ec_master_thread_start(ec_master_t *, int (*)(void *), const char *);
 void ec_master_thread_stop(ec_master_t *);
 void ec_master_inject_external_datagrams(ec_master_t *);
 ec_datagram_t *ec_master_get_external_datagram(ec_master_t *);
+int ec_master_grow_ext_ring(ec_master_t *, unsigned int);
+void ec_master_clear_ext_ring(ec_master_t *);
+void ec_master_swap_ext_ring(ec_master_t *);
+unsigned int ec_master_fsm_exec_limit(const ec_master_t *);
 void ec_master_exec_slave_fsms(ec_master_t *);
 void ec_master_send_datagrams(ec_master_t *, ec_device_index_t);
+void ec_master_prepare_merging(ec_master_t *);
+void ec_master_queue_mbox_status(ec_master_t *);
+int ec_master_attach_mbox_check(ec_master_t *, ec_datagram_t *);
+void ec_master_mbox_status_sent(ec_master_t *);
+void ec_master_complete_mbox_checks(ec_master_t *);
+void ec_master_fail_mbox_checks(ec_master_t *);
 int ec_master_calc_topology_rec(ec_master_t *, ec_slave_t *, unsigned int *);
 void ec_master_calc_topology(ec_master_t *);
+unsigned int ec_master_count_foe_requests(const ec_foe_request_t *, size_t,
+        ec_internal_request_state_t);
+int ec_master_sdo_upload(ec_master_t *, uint16_t, uint16_t, uint8_t,
+        uint8_t, uint8_t *, size_t, size_t *, uint32_t *);
 void ec_master_calc_transmission_delays(ec_master_t *);
 static int ec_master_idle_thread(void *);
 static int ec_master_operation_thread(void *);
@@ -161,11 +186,18 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
         dev_t device_number, /**< Character device number. */
         struct class *class, /**< Device class. */
         unsigned int debug_level, /**< Debug level (module parameter). */
-        unsigned int run_on_cpu /**< bind created kernel threads to a cpu */
+        unsigned int run_on_cpu, /**< bind created kernel threads to a cpu */
+        unsigned int config_slots, /**< Maximum number of parallel slave
+                                     configurations (module parameter). */
+        unsigned int hotplug_slaves, /**< Number of slaves, that can be
+                                      hot-connected without a full rescan
+                                      (module parameter). */
+        unsigned int fsm_slots /**< Maximum number of slave FSMs executed in
+                                 parallel (module parameter). */
         )
 {
     int ret;
-    unsigned int dev_idx, i;
+    unsigned int dev_idx;
 
     master->index = index;
     master->reserved = 0;
@@ -199,6 +231,15 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
 
     master->slaves = NULL;
     master->slave_count = 0;
+    master->slave_capacity = 0;
+
+    master->mbox_status_pending = 0;
+    master->mbox_status_gen = 0;
+    master->mbox_checks_gen = 0;
+    master->mbox_status_size = 0;
+    master->mbox_status_mapped = 0;
+    master->mbox_status_expected = 0;
+    master->mbox_status_errors = 0;
 
     INIT_LIST_HEAD(&master->configs);
     INIT_LIST_HEAD(&master->domains);
@@ -222,25 +263,38 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     INIT_LIST_HEAD(&master->ext_datagram_queue);
     sema_init(&master->ext_queue_sem, 1);
 
+    master->ext_datagram_ring = NULL;
+    master->ext_ring_size = 0;
     master->ext_ring_idx_rt = 0;
     master->ext_ring_idx_fsm = 0;
-
-    // init external datagram ring
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_t *datagram = &master->ext_datagram_ring[i];
-        ec_datagram_init(datagram);
-        snprintf(datagram->name, EC_DATAGRAM_NAME_SIZE, "ext-%u", i);
-    }
+    master->ext_ring_next = NULL;
+    master->ext_ring_next_size = 0;
+    master->ext_ring_old = NULL;
 
     // send interval in IDLE phase
     ec_master_set_send_interval(master, 1000000 / HZ);
 
+    master->merge_domains = 0;
+    master->merge_hold = 0;
+
     master->fsm_slave = NULL;
     INIT_LIST_HEAD(&master->fsm_exec_list);
     master->fsm_exec_count = 0U;
 
     master->debug_level = debug_level;
     master->run_on_cpu = run_on_cpu;
+    if (config_slots < 1 || config_slots > EC_FSM_MASTER_SLOTS) {
+        EC_MASTER_WARN(master, "Invalid number of configuration slots %u."
+                " Using %u.\n", config_slots, EC_FSM_MASTER_SLOTS);
+        config_slots = EC_FSM_MASTER_SLOTS;
+    }
+    master->config_slots = config_slots;
+    master->hotplug_slaves = hotplug_slaves;
+    if (ec_master_set_fsm_slots(master, fsm_slots)) {
+        EC_MASTER_WARN(master, "Invalid number of slave FSM slots %u."
+                " Using %u.\n", fsm_slots, EC_FSM_SLOTS);
+        master->fsm_slots = EC_FSM_SLOTS;
+    }
     master->stats.timeouts = 0;
     master->stats.corrupted = 0;
     master->stats.unmatched = 0;
@@ -251,6 +305,8 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
 #ifdef EC_EOE
     master->eoe_thread = NULL;
     INIT_LIST_HEAD(&master->eoe_handlers);
+    init_waitqueue_head(&master->eoe_queue);
+    master->eoe_event = 0;
 #endif
 
     rt_mutex_init(&master->io_mutex);
@@ -262,10 +318,20 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     master->app_cb_data = NULL;
 
     INIT_LIST_HEAD(&master->sii_requests);
+#ifdef EC_SII_CACHE
+    ec_sii_cache_init(&master->sii_cache, master);
+#endif
+    ec_sdo_cache_init(&master->sdo_cache, master);
+    ec_snapshot_init(&master->snapshot, master);
     INIT_LIST_HEAD(&master->emerg_reg_requests);
 
     init_waitqueue_head(&master->request_queue);
 
+    ret = ec_timeline_init(&master->timeline, master);
+    if (ret < 0) {
+        return ret;
+    }
+
     // init devices
     for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
             dev_idx++) {
@@ -286,17 +352,18 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     }
 
     // create state machine object
-    ec_fsm_master_init(&master->fsm, master, &master->fsm_datagram);
+    ret = ec_fsm_master_init(&master->fsm, master, &master->fsm_datagram);
+    if (ret < 0) {
+        ec_datagram_clear(&master->fsm_datagram);
+        goto out_clear_devices;
+    }
 
     // alloc external datagram ring
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_t *datagram = &master->ext_datagram_ring[i];
-        ret = ec_datagram_prealloc(datagram, EC_MAX_DATA_SIZE);
-        if (ret) {
-            EC_MASTER_ERR(master, "Failed to allocate external"
-                    " datagram %u.\n", i);
-            goto out_clear_ext_datagrams;
-        }
+    ret = ec_master_grow_ext_ring(master, EC_EXT_RING_SIZE);
+    if (ret) {
+        EC_MASTER_ERR(master, "Failed to allocate external"
+                " datagram ring.\n");
+        goto out_clear_ext_datagrams;
     }
 
     // init reference sync datagram
@@ -334,6 +401,19 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
         goto out_clear_sync;
     }
 
+    // init mailbox status datagram
+    ec_datagram_init(&master->mbox_status_datagram);
+    snprintf(master->mbox_status_datagram.name, EC_DATAGRAM_NAME_SIZE,
+            "mbox-status");
+    ret = ec_datagram_prealloc(&master->mbox_status_datagram,
+            EC_MAX_DATA_SIZE);
+    if (ret < 0) {
+        ec_datagram_clear(&master->mbox_status_datagram);
+        EC_MASTER_ERR(master, "Failed to allocate mailbox"
+                " status datagram.\n");
+        goto out_clear_sync_mon;
+    }
+
     master->dc_ref_config = NULL;
     master->dc_ref_clock = NULL;
 
@@ -343,7 +423,7 @@ int ec_master_init(ec_master_t *master, /**< EtherCAT master */
     // init character device
     ret = ec_cdev_init(&master->cdev, master, device_number);
     if (ret)
-        goto out_clear_sync_mon;
+        goto out_clear_mbox_status;
 
     master->class_device = device_create(class, NULL,
             MKDEV(MAJOR(device_number), master->index), NULL,
@@ -370,6 +450,8 @@ out_unregister_class_device:
 #endif
 out_clear_cdev:
     ec_cdev_clear(&master->cdev);
+out_clear_mbox_status:
+    ec_datagram_clear(&master->mbox_status_datagram);
 out_clear_sync_mon:
     ec_datagram_clear(&master->sync_mon_datagram);
 out_clear_sync:
@@ -377,15 +459,14 @@ out_clear_sync:
 out_clear_ref_sync:
     ec_datagram_clear(&master->ref_sync_datagram);
 out_clear_ext_datagrams:
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_clear(&master->ext_datagram_ring[i]);
-    }
+    ec_master_clear_ext_ring(master);
     ec_fsm_master_clear(&master->fsm);
     ec_datagram_clear(&master->fsm_datagram);
 out_clear_devices:
     for (; dev_idx > 0; dev_idx--) {
         ec_device_clear(&master->devices[dev_idx - 1]);
     }
+    ec_timeline_clear(&master->timeline);
     return ret;
 }
 
@@ -397,7 +478,7 @@ void ec_master_clear(
         ec_master_t *master /**< EtherCAT master */
         )
 {
-    unsigned int dev_idx, i;
+    unsigned int dev_idx;
 
 #ifdef EC_RTDM
     ec_rtdm_dev_clear(&master->rtdm_dev);
@@ -416,14 +497,19 @@ void ec_master_clear(
     ec_master_clear_domains(master);
     ec_master_clear_slave_configs(master);
     ec_master_clear_slaves(master);
+#ifdef EC_SII_CACHE
+    ec_sii_cache_clear(&master->sii_cache);
+#endif
+    ec_sdo_cache_clear(&master->sdo_cache);
+    ec_snapshot_clear(&master->snapshot);
+    ec_timeline_clear(&master->timeline);
 
+    ec_datagram_clear(&master->mbox_status_datagram);
     ec_datagram_clear(&master->sync_mon_datagram);
     ec_datagram_clear(&master->sync_datagram);
     ec_datagram_clear(&master->ref_sync_datagram);
 
-    for (i = 0; i < EC_EXT_RING_SIZE; i++) {
-        ec_datagram_clear(&master->ext_datagram_ring[i]);
-    }
+    ec_master_clear_ext_ring(master);
 
     ec_fsm_master_clear(&master->fsm);
     ec_datagram_clear(&master->fsm_datagram);
@@ -511,6 +597,15 @@ void ec_master_clear_slaves(ec_master_t *master)
     }
 
     master->slave_count = 0;
+    master->slave_capacity = 0;
+
+    // the next scan maps the mailbox states into a fresh area. Checks still
+    // parked in the datagram queue are failed from the realtime side,
+    // because the queue may be in use there.
+    master->mbox_status_gen++;
+    master->mbox_status_size = 0;
+    master->mbox_status_mapped = 0;
+    master->mbox_status_errors = 0;
 }
 
 /****************************************************************************/
@@ -811,6 +906,10 @@ void ec_master_inject_external_datagrams(
     unsigned int datagram_count = 0;
 #endif
 
+    if (unlikely(master->ext_ring_next)) {
+        ec_master_swap_ext_ring(master);
+    }
+
     if (master->ext_ring_idx_rt == master->ext_ring_idx_fsm) {
         // nothing to inject
         return;
@@ -828,12 +927,12 @@ void ec_master_inject_external_datagrams(
 #endif
 
     while (master->ext_ring_idx_rt != master->ext_ring_idx_fsm) {
-        datagram = &master->ext_datagram_ring[master->ext_ring_idx_rt];
+        datagram = master->ext_datagram_ring[master->ext_ring_idx_rt];
 
         if (datagram->state != EC_DATAGRAM_INIT) {
             // skip datagram
             master->ext_ring_idx_rt =
-                (master->ext_ring_idx_rt + 1) % EC_EXT_RING_SIZE;
+                (master->ext_ring_idx_rt + 1) % master->ext_ring_size;
             continue;
         }
 
@@ -902,7 +1001,7 @@ void ec_master_inject_external_datagrams(
         }
 
         master->ext_ring_idx_rt =
-            (master->ext_ring_idx_rt + 1) % EC_EXT_RING_SIZE;
+            (master->ext_ring_idx_rt + 1) % master->ext_ring_size;
     }
 
 #if DEBUG_INJECT
@@ -928,6 +1027,19 @@ void ec_master_set_send_interval(
 
 /****************************************************************************/
 
+/** Enables or disables merging of adjacent domain datagrams.
+ */
+void ec_master_set_domain_merging(
+        ec_master_t *master, /**< EtherCAT master */
+        unsigned int enable /**< Non-zero to enable merging. */
+        )
+{
+    master->merge_domains = enable ? 1 : 0;
+    master->merge_hold = 0;
+}
+
+/****************************************************************************/
+
 /** Searches for a free datagram in the external datagram ring.
  *
  * \return Next free datagram, or NULL.
@@ -936,10 +1048,10 @@ ec_datagram_t *ec_master_get_external_datagram(
         ec_master_t *master /**< EtherCAT master */
         )
 {
-    if ((master->ext_ring_idx_fsm + 1) % EC_EXT_RING_SIZE !=
+    if ((master->ext_ring_idx_fsm + 1) % master->ext_ring_size !=
             master->ext_ring_idx_rt) {
         ec_datagram_t *datagram =
-            &master->ext_datagram_ring[master->ext_ring_idx_fsm];
+            master->ext_datagram_ring[master->ext_ring_idx_fsm];
         return datagram;
     }
     else {
@@ -949,6 +1061,381 @@ ec_datagram_t *ec_master_get_external_datagram(
 
 /****************************************************************************/
 
+/** Grows the external datagram ring.
+ *
+ * The datagrams already in the ring keep their places, so that slave FSMs
+ * and the datagram queue may still reference them. The ring must be empty
+ * (all datagrams injected).
+ *
+ * The first ring is installed directly. A grown ring is only handed over to
+ * the realtime side, which takes it over with ec_master_swap_ext_ring() as
+ * soon as it injects external datagrams the next time. Until then, the FSM
+ * side must not use the ring. The replaced ring is freed by
+ * ec_master_exec_slave_fsms() afterwards.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_master_grow_ext_ring(
+        ec_master_t *master, /**< EtherCAT master */
+        unsigned int size /**< New number of datagrams. */
+        )
+{
+    ec_datagram_t **ring, **old_ring = master->ext_datagram_ring;
+    unsigned int i;
+
+    ring = kmalloc(sizeof(ec_datagram_t *) * size, GFP_KERNEL);
+    if (!ring) {
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < master->ext_ring_size; i++) {
+        ring[i] = old_ring[i];
+    }
+
+    for (; i < size; i++) {
+        ec_datagram_t *datagram = kmalloc(sizeof(ec_datagram_t), GFP_KERNEL);
+        if (!datagram) {
+            goto out_free;
+        }
+        ec_datagram_init(datagram);
+        snprintf(datagram->name, EC_DATAGRAM_NAME_SIZE, "ext-%u", i);
+        if (ec_datagram_prealloc(datagram, EC_MAX_DATA_SIZE)) {
+            ec_datagram_clear(datagram);
+            kfree(datagram);
+            goto out_free;
+        }
+        ring[i] = datagram;
+    }
+
+    if (!old_ring) {
+        master->ext_datagram_ring = ring;
+        master->ext_ring_size = size;
+    } else {
+        master->ext_ring_next_size = size;
+        smp_wmb();
+        master->ext_ring_next = ring;
+    }
+
+    EC_MASTER_DBG(master, 1, "External datagram ring has %u datagrams.\n",
+            size);
+    return 0;
+
+out_free:
+    while (i-- > master->ext_ring_size) {
+        ec_datagram_clear(ring[i]);
+        kfree(ring[i]);
+    }
+    kfree(ring);
+    return -ENOMEM;
+}
+
+/****************************************************************************/
+
+/** Takes over a grown external datagram ring.
+ *
+ * Called by the realtime side. The ring is only replaced, if all external
+ * datagrams have been injected, so that the indices are valid for both
+ * rings.
+ */
+void ec_master_swap_ext_ring(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    if (master->ext_ring_idx_rt != master->ext_ring_idx_fsm) {
+        return;
+    }
+
+    smp_rmb();
+    master->ext_ring_old = master->ext_datagram_ring;
+    master->ext_datagram_ring = master->ext_ring_next;
+    master->ext_ring_size = master->ext_ring_next_size;
+    smp_wmb();
+    master->ext_ring_next = NULL;
+}
+
+/****************************************************************************/
+
+/** Frees the external datagram ring.
+ */
+void ec_master_clear_ext_ring(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    unsigned int i;
+
+    if (master->ext_ring_next) { // grown ring was not taken over
+        for (i = master->ext_ring_size; i < master->ext_ring_next_size;
+                i++) {
+            ec_datagram_clear(master->ext_ring_next[i]);
+            kfree(master->ext_ring_next[i]);
+        }
+        kfree(master->ext_ring_next);
+        master->ext_ring_next = NULL;
+    }
+
+    if (master->ext_ring_old) {
+        kfree(master->ext_ring_old);
+        master->ext_ring_old = NULL;
+    }
+
+    for (i = 0; i < master->ext_ring_size; i++) {
+        ec_datagram_clear(master->ext_datagram_ring[i]);
+        kfree(master->ext_datagram_ring[i]);
+    }
+
+    if (master->ext_datagram_ring) {
+        kfree(master->ext_datagram_ring);
+        master->ext_datagram_ring = NULL;
+    }
+    master->ext_ring_size = 0;
+}
+
+/****************************************************************************/
+
+/** Sets the maximum number of slave FSMs executed in parallel.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_master_set_fsm_slots(
+        ec_master_t *master, /**< EtherCAT master */
+        unsigned int fsm_slots /**< Number of slave FSM slots. */
+        )
+{
+    if (fsm_slots < 1 || fsm_slots > EC_MAX_FSM_SLOTS) {
+        return -EINVAL;
+    }
+
+    master->fsm_slots = fsm_slots;
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Determines, how many slave FSMs may be executed in parallel.
+ *
+ * Besides the \a fsm_slots setting, the limit depends on the number of
+ * slaves and the frame space of one send interval. The latter never limits
+ * below half the initial ring size.
+ *
+ * \return Maximum number of slave FSMs to execute.
+ */
+unsigned int ec_master_fsm_exec_limit(
+        const ec_master_t *master /**< EtherCAT master */
+        )
+{
+    unsigned int limit = master->fsm_slots;
+    unsigned int budget = master->max_queue_size / EC_FSM_SLOT_FRAME_SPACE;
+
+    if (budget < EC_EXT_RING_SIZE / 2) {
+        budget = EC_EXT_RING_SIZE / 2;
+    }
+    if (limit > budget) {
+        limit = budget;
+    }
+    if (limit > master->slave_count) {
+        limit = master->slave_count;
+    }
+    return limit;
+}
+
+/****************************************************************************/
+
+/** Queues the mailbox status datagram.
+ */
+void ec_master_queue_mbox_status(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_datagram_t *datagram = &master->mbox_status_datagram;
+
+    ec_datagram_lrd(datagram, ec_master_mbox_status_address(master),
+            master->mbox_status_size);
+    ec_datagram_zero(datagram);
+    master->mbox_status_expected = master->mbox_status_mapped;
+    master->mbox_status_pending = 1;
+    ec_master_queue_datagram(master, datagram);
+}
+
+/****************************************************************************/
+
+/** Lets a mailbox check datagram be answered by the mailbox status datagram.
+ *
+ * An attached check is parked in the datagram queue: It is not sent itself,
+ * but answered by ec_master_complete_mbox_checks(). Parked checks therefore
+ * share the queue and its locking discipline with all other datagrams.
+ *
+ * After several errors of the mailbox status datagram, the checks are sent
+ * as single datagrams. Every #EC_MBOX_STATUS_RETRY_CHECKS checks, the
+ * mailbox status datagram is tried again, so that a successful reception
+ * can re-enable it.
+ *
+ * \return Non-zero, if the check was attached, zero, if it has to be sent
+ *         itself.
+ */
+int ec_master_attach_mbox_check(
+        ec_master_t *master, /**< EtherCAT master */
+        ec_datagram_t *datagram /**< Mailbox check datagram. */
+        )
+{
+    if ((unsigned int) datagram->mbox_status_bit
+            >= master->mbox_status_size * 8) {
+        return 0;
+    }
+
+    if (master->mbox_status_errors >= EC_MBOX_STATUS_MAX_ERRORS) {
+        if (!master->mbox_status_pending && ++master->mbox_status_errors
+                >= EC_MBOX_STATUS_MAX_ERRORS + EC_MBOX_STATUS_RETRY_CHECKS) {
+            master->mbox_status_errors = EC_MBOX_STATUS_MAX_ERRORS - 1;
+            ec_master_queue_mbox_status(master);
+        }
+        return 0;
+    }
+
+    if (!master->mbox_status_pending) {
+        ec_master_queue_mbox_status(master);
+    }
+    return 1;
+}
+
+/****************************************************************************/
+
+/** Marks the parked mailbox checks as sent together with the mailbox status
+ * datagram.
+ *
+ * Checks parked later wait for the next mailbox status datagram.
+ */
+void ec_master_mbox_status_sent(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    const ec_datagram_t *status = &master->mbox_status_datagram;
+    ec_datagram_t *datagram;
+
+    list_for_each_entry(datagram, &master->datagram_queue, queue) {
+        if (!datagram->mbox_parked
+                || datagram->state != EC_DATAGRAM_QUEUED) {
+            continue;
+        }
+        datagram->state = EC_DATAGRAM_SENT;
+#ifdef EC_HAVE_CYCLES
+        datagram->cycles_sent = status->cycles_sent;
+#endif
+        datagram->jiffies_sent = status->jiffies_sent;
+    }
+}
+
+/****************************************************************************/
+
+/** Answers the parked mailbox checks from the received mailbox status
+ * datagram.
+ *
+ * The check datagrams look as if they had been read from the slaves. If the
+ * working counter does not match the number of mapped slaves, the image is
+ * not trusted and all mailboxes are reported empty, so that the checks are
+ * repeated. After several errors in a row, the checks are sent as single
+ * datagrams again (see ec_master_attach_mbox_check()). Parked checks, that
+ * timed out, have already been dequeued by ecrt_master_receive().
+ */
+void ec_master_complete_mbox_checks(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    const ec_datagram_t *status = &master->mbox_status_datagram;
+    ec_datagram_t *datagram, *next;
+    unsigned int valid = 0, waiting = 0;
+
+    if (unlikely(master->mbox_checks_gen != master->mbox_status_gen)) {
+        ec_master_fail_mbox_checks(master);
+    }
+
+    if (!master->mbox_status_pending
+            || status->state == EC_DATAGRAM_QUEUED
+            || status->state == EC_DATAGRAM_SENT) {
+        return;
+    }
+    master->mbox_status_pending = 0;
+
+    if (status->state == EC_DATAGRAM_RECEIVED) {
+        if (status->working_counter == master->mbox_status_expected) {
+            master->mbox_status_errors = 0;
+            valid = 1;
+        } else if (++master->mbox_status_errors
+                == EC_MBOX_STATUS_MAX_ERRORS) {
+#ifdef EC_RT_SYSLOG
+            EC_MASTER_WARN(master, "Mailbox status datagram failed"
+                    " (working counter %u, expected %u). Checking"
+                    " mailboxes separately.\n", status->working_counter,
+                    master->mbox_status_expected);
+#endif
+        }
+    }
+
+    list_for_each_entry_safe(datagram, next, &master->datagram_queue,
+            queue) {
+        if (!datagram->mbox_parked) {
+            continue;
+        }
+
+        if (datagram->state != EC_DATAGRAM_SENT
+                && status->state != EC_DATAGRAM_ERROR) {
+            waiting = 1; // parked after the status datagram was sent
+            continue;
+        }
+
+        list_del_init(&datagram->queue);
+        datagram->mbox_parked = 0;
+#ifdef EC_HAVE_CYCLES
+        datagram->cycles_received = status->cycles_received;
+#endif
+        datagram->jiffies_received = status->jiffies_received;
+
+        if (status->state != EC_DATAGRAM_RECEIVED) {
+            datagram->state = status->state;
+            continue;
+        }
+
+        ec_datagram_zero(datagram);
+        if (valid && status->data[datagram->mbox_status_bit / 8]
+                & (1 << (datagram->mbox_status_bit % 8))) {
+            EC_WRITE_U8(datagram->data + 5, 0x08); // SM1 mailbox full
+        }
+        datagram->working_counter = 1;
+        datagram->state = EC_DATAGRAM_RECEIVED;
+    }
+
+    if (waiting) {
+        ec_master_queue_mbox_status(master);
+    }
+}
+
+/****************************************************************************/
+
+/** Fails and dequeues all parked mailbox checks.
+ *
+ * This has to be done, if the mailbox status datagram can not be sent any
+ * more or its image becomes invalid.
+ */
+void ec_master_fail_mbox_checks(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_datagram_t *datagram, *next;
+
+    list_for_each_entry_safe(datagram, next, &master->datagram_queue,
+            queue) {
+        if (!datagram->mbox_parked) {
+            continue;
+        }
+        list_del_init(&datagram->queue);
+        datagram->mbox_parked = 0;
+        datagram->state = EC_DATAGRAM_ERROR;
+    }
+
+    master->mbox_checks_gen = master->mbox_status_gen;
+}
+
+/****************************************************************************/
+
 /** Places a datagram in the datagram queue.
  */
 void ec_master_queue_datagram(
@@ -958,6 +1445,13 @@ void ec_master_queue_datagram(
 {
     ec_datagram_t *queued_datagram;
 
+    if (unlikely(master->mbox_checks_gen != master->mbox_status_gen)) {
+        ec_master_fail_mbox_checks(master);
+    }
+
+    datagram->mbox_parked = datagram->mbox_status_bit >= 0
+        && ec_master_attach_mbox_check(master, datagram);
+
     /* It is possible, that a datagram in the queue is re-initialized with the
      * ec_datagram_<type>() methods and then shall be queued with this method.
      * In that case, the state is already reset to EC_DATAGRAM_INIT. Check if
@@ -1004,10 +1498,11 @@ void ec_master_send_datagrams(
         ec_device_index_t device_index /**< Device index. */
         )
 {
-    ec_datagram_t *datagram, *next;
+    ec_datagram_t *datagram, *next, *merge_head, *merge_tail = NULL;
     size_t datagram_size;
     uint8_t *frame_data, *cur_data = NULL;
     void *follows_word;
+    unsigned int merge;
 #ifdef EC_HAVE_CYCLES
     cycles_t cycles_start, cycles_sent, cycles_end;
 #endif
@@ -1024,14 +1519,18 @@ void ec_master_send_datagrams(
     EC_MASTER_DBG(master, 2, "%s(device_index = %u)\n",
             __func__, device_index);
 
+    merge = master->merge_domains && !master->merge_hold;
+
     do {
         frame_data = NULL;
         follows_word = NULL;
+        merge_head = NULL;
         more_datagrams_waiting = 0;
 
         // fill current frame with datagrams
         list_for_each_entry(datagram, &master->datagram_queue, queue) {
             if (datagram->state != EC_DATAGRAM_QUEUED ||
+                    datagram->mbox_parked ||
                     datagram->device_index != device_index) {
                 continue;
             }
@@ -1043,6 +1542,41 @@ void ec_master_send_datagrams(
                 cur_data = frame_data + EC_FRAME_HEADER_SIZE;
             }
 
+            // can the datagram be appended to the previous one? This is the
+            // case for domain datagrams with adjacent logical addresses.
+            if (merge && merge_head
+                    && datagram->expected_working_counter
+                    && merge_head->expected_working_counter
+                    && datagram->type == merge_head->type
+                    && EC_READ_U32(merge_head->address) >=
+                    datagram->merge_base
+                    && EC_READ_U32(datagram->address) ==
+                    EC_READ_U32(merge_head->address) + merge_head->merge_size
+                    && merge_head->merge_size + datagram->data_size
+                    <= EC_MAX_DATA_SIZE
+                    && cur_data - frame_data + datagram->data_size
+                    <= ETH_DATA_LEN) {
+                list_add_tail(&datagram->sent, &sent_datagrams);
+                datagram->index = merge_head->index;
+                datagram->merge_next = NULL;
+                merge_tail->merge_next = datagram;
+                merge_tail = datagram;
+                merge_head->merge_size += datagram->data_size;
+
+                EC_MASTER_DBG(master, 2, "Merging datagram %s"
+                        " into 0x%02X\n", datagram->name, datagram->index);
+
+                EC_WRITE_U16(follows_word, merge_head->merge_size & 0x7FF);
+
+                // replace the footer of the previous datagram
+                cur_data -= EC_DATAGRAM_FOOTER_SIZE;
+                memcpy(cur_data, datagram->data, datagram->data_size);
+                cur_data += datagram->data_size;
+                EC_WRITE_U16(cur_data, 0x0000); // reset working counter
+                cur_data += EC_DATAGRAM_FOOTER_SIZE;
+                continue;
+            }
+
             // does the current datagram fit in the frame?
             datagram_size = EC_DATAGRAM_HEADER_SIZE + datagram->data_size
                 + EC_DATAGRAM_FOOTER_SIZE;
@@ -1053,6 +1587,10 @@ void ec_master_send_datagrams(
 
             list_add_tail(&datagram->sent, &sent_datagrams);
             datagram->index = master->datagram_index++;
+            datagram->merge_next = NULL;
+            datagram->merge_size = datagram->data_size;
+            merge_head = datagram;
+            merge_tail = datagram;
 
             EC_MASTER_DBG(master, 2, "Adding datagram 0x%02X\n",
                     datagram->index);
@@ -1112,6 +1650,9 @@ void ec_master_send_datagrams(
 #endif
             datagram->jiffies_sent = jiffies_sent;
             list_del_init(&datagram->sent); // empty list of sent datagrams
+            if (unlikely(datagram == &master->mbox_status_datagram)) {
+                ec_master_mbox_status_sent(master);
+            }
         }
 
         frame_count++;
@@ -1130,6 +1671,163 @@ void ec_master_send_datagrams(
 
 /****************************************************************************/
 
+/** Checks, if two domain datagram pairs address a common slave.
+ *
+ * \return Non-zero, if an FMMU of the same slave configuration lies in both
+ *         datagram ranges.
+ */
+static int ec_master_datagram_pairs_overlap(
+        const ec_datagram_pair_t *pair1, /**< First datagram pair. */
+        const ec_datagram_pair_t *pair2 /**< Second datagram pair. */
+        )
+{
+    const ec_datagram_t *d1 = &pair1->datagrams[EC_DEVICE_MAIN],
+          *d2 = &pair2->datagrams[EC_DEVICE_MAIN];
+    uint32_t start1 = EC_READ_U32(d1->address),
+             start2 = EC_READ_U32(d2->address);
+    const ec_fmmu_config_t *fmmu1, *fmmu2;
+
+    list_for_each_entry(fmmu1, &pair1->domain->fmmu_configs, list) {
+        if (fmmu1->logical_start_address < start1 ||
+                fmmu1->logical_start_address >= start1 + d1->data_size) {
+            continue;
+        }
+
+        list_for_each_entry(fmmu2, &pair2->domain->fmmu_configs, list) {
+            if (fmmu2->logical_start_address >= start2 &&
+                    fmmu2->logical_start_address < start2 + d2->data_size
+                    && fmmu2->sc == fmmu1->sc) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Determines, which domain datagrams may be merged when sending.
+ *
+ * A slave increments the working counter of a logical datagram only once,
+ * regardless of the number of its FMMUs, that are addressed. The working
+ * counter of a merged datagram is therefore only the sum of the expected
+ * working counters of its members, if their slaves are disjoint. For every
+ * domain datagram, the logical address behind the last preceding datagram
+ * with a common slave is stored as the lowest address of a physical datagram
+ * it may be appended to.
+ *
+ * Has to be called after all domains are finished.
+ */
+void ec_master_prepare_merging(
+        ec_master_t *master /**< EtherCAT master */
+        )
+{
+    ec_domain_t *domain, *prev_domain;
+    ec_datagram_pair_t *pair, *prev;
+    const ec_datagram_t *datagram;
+    uint32_t base;
+    unsigned int dev_idx;
+
+    list_for_each_entry(domain, &master->domains, list) {
+        list_for_each_entry(pair, &domain->datagram_pairs, list) {
+            base = 0;
+
+            // visit all datagram pairs with lower addresses
+            list_for_each_entry(prev_domain, &master->domains, list) {
+                list_for_each_entry(prev, &prev_domain->datagram_pairs,
+                        list) {
+                    if (prev == pair) {
+                        goto found;
+                    }
+                    if (ec_master_datagram_pairs_overlap(prev, pair)) {
+                        datagram = &prev->datagrams[EC_DEVICE_MAIN];
+                        base = EC_READ_U32(datagram->address)
+                            + datagram->data_size;
+                    }
+                }
+            }
+found:
+            for (dev_idx = EC_DEVICE_MAIN;
+                    dev_idx < ec_master_num_devices(master); dev_idx++) {
+                pair->datagrams[dev_idx].merge_base = base;
+            }
+        }
+    }
+}
+
+/****************************************************************************/
+
+/** Distributes a received merged datagram to its member datagrams.
+ *
+ * The received data are copied to the datagrams that were appended to the
+ * \a head datagram when sending. The members address disjoint slaves (see
+ * ec_master_prepare_merging()), so if the working counter matches the sum of
+ * the expected working counters, every datagram gets its expected share.
+ * Otherwise the shares are scaled down, so that each affected domain reports
+ * an incomplete working counter, and merging is suspended for
+ * #EC_MERGE_HOLD_CYCLES send cycles to get exact values.
+ */
+static void ec_master_split_merged_datagram(
+        ec_master_t *master, /**< EtherCAT master */
+        ec_datagram_t *head, /**< First datagram of the merged datagram. */
+        const uint8_t *data /**< Received datagram data. */
+        )
+{
+    ec_datagram_t *datagram;
+    unsigned int working_counter = head->working_counter, expected = 0;
+    size_t offset = head->data_size;
+
+    for (datagram = head; datagram; datagram = datagram->merge_next) {
+        expected += datagram->expected_working_counter;
+    }
+
+    if (working_counter != expected) {
+        master->merge_hold = EC_MERGE_HOLD_CYCLES;
+    }
+
+    if (working_counter >= expected) {
+        // surplus is accounted to the first datagram
+        head->working_counter =
+            head->expected_working_counter + working_counter - expected;
+    } else {
+        head->working_counter =
+            head->expected_working_counter * working_counter / expected;
+    }
+
+    for (datagram = head->merge_next; datagram;
+            datagram = datagram->merge_next) {
+        if (datagram->state != EC_DATAGRAM_SENT) {
+            offset += datagram->data_size;
+            continue;
+        }
+
+        if (datagram->type != EC_DATAGRAM_LWR) {
+            memcpy(datagram->data, data + offset, datagram->data_size);
+        }
+        offset += datagram->data_size;
+
+        if (working_counter >= expected) {
+            datagram->working_counter = datagram->expected_working_counter;
+        } else {
+            datagram->working_counter =
+                datagram->expected_working_counter * working_counter
+                / expected;
+        }
+
+        datagram->state = EC_DATAGRAM_RECEIVED;
+#ifdef EC_HAVE_CYCLES
+        datagram->cycles_received =
+            master->devices[EC_DEVICE_MAIN].cycles_poll;
+#endif
+        datagram->jiffies_received =
+            master->devices[EC_DEVICE_MAIN].jiffies_poll;
+        list_del_init(&datagram->queue);
+    }
+}
+
+/****************************************************************************/
+
 /** Processes a received frame.
  *
  * This function is called by the network driver for every received frame.
@@ -1213,8 +1911,10 @@ void ec_master_receive_datagrams(
         list_for_each_entry(datagram, &master->datagram_queue, queue) {
             if (datagram->index == datagram_index
                 && datagram->state == EC_DATAGRAM_SENT
+                && !datagram->mbox_parked
                 && datagram->type == datagram_type
-                && datagram->data_size == data_size) {
+                && (datagram->merge_next ? datagram->merge_size :
+                    datagram->data_size) == data_size) {
                 matched = 1;
                 break;
             }
@@ -1247,13 +1947,16 @@ void ec_master_receive_datagrams(
                 datagram->type != EC_DATAGRAM_LWR) {
             // copy received data into the datagram memory,
             // if something has been read
-            memcpy(datagram->data, cur_data, data_size);
+            memcpy(datagram->data, cur_data, datagram->data_size);
         }
-        cur_data += data_size;
 
         // set the datagram's working counter
-        datagram->working_counter = EC_READ_U16(cur_data);
-        cur_data += EC_DATAGRAM_FOOTER_SIZE;
+        datagram->working_counter = EC_READ_U16(cur_data + data_size);
+
+        if (unlikely(datagram->merge_next)) {
+            ec_master_split_merged_datagram(master, datagram, cur_data);
+        }
+        cur_data += data_size + EC_DATAGRAM_FOOTER_SIZE;
 
         // dequeue the received datagram
         datagram->state = EC_DATAGRAM_RECEIVED;
@@ -1444,10 +2147,22 @@ void ec_master_exec_slave_fsms(
 {
     ec_datagram_t *datagram;
     ec_fsm_slave_t *fsm, *next;
-    unsigned int count = 0;
+    unsigned int count = 0, limit;
+    int used;
+
+    if (master->ext_ring_next) {
+        // wait, until the realtime side has taken over the grown ring
+        return;
+    }
+
+    if (master->ext_ring_old) {
+        smp_rmb();
+        kfree(master->ext_ring_old);
+        master->ext_ring_old = NULL;
+    }
 
     list_for_each_entry_safe(fsm, next, &master->fsm_exec_list, list) {
-        if (!fsm->datagram) {
+        if (!fsm->datagram && !fsm->reg_datagram) {
             EC_MASTER_WARN(master, "Slave %u FSM has zero datagram."
                     "This is a bug!\n", fsm->slave->ring_position);
             list_del_init(&fsm->list);
@@ -1455,36 +2170,48 @@ void ec_master_exec_slave_fsms(
             return;
         }
 
-        if (fsm->datagram->state == EC_DATAGRAM_INIT ||
-                fsm->datagram->state == EC_DATAGRAM_QUEUED ||
-                fsm->datagram->state == EC_DATAGRAM_SENT) {
+        if (ec_fsm_slave_waiting(fsm)) {
             // previous datagram was not sent or received yet.
             // wait until next thread execution
             return;
         }
 
-        datagram = ec_master_get_external_datagram(master);
-        if (!datagram) {
-            // no free datagrams at the moment
-            EC_MASTER_WARN(master, "No free datagram during"
-                    " slave FSM execution. This is a bug!\n");
-            continue;
-        }
-
 #if DEBUG_INJECT
         EC_MASTER_DBG(master, 1, "Executing slave %u FSM.\n",
                 fsm->slave->ring_position);
 #endif
-        if (ec_fsm_slave_exec(fsm, datagram)) {
-            // FSM consumed datagram
+        used = 0;
+
+        if (fsm->datagram) { // mailbox lane is busy
+            datagram = ec_master_get_external_datagram(master);
+            if (!datagram) {
+                // no free datagrams at the moment
+                EC_MASTER_WARN(master, "No free datagram during"
+                        " slave FSM execution. This is a bug!\n");
+                continue;
+            }
+
+            if (ec_fsm_slave_exec(fsm, datagram)) {
+                // FSM consumed datagram
 #if DEBUG_INJECT
-            EC_MASTER_DBG(master, 1, "FSM consumed datagram %s\n",
-                    datagram->name);
+                EC_MASTER_DBG(master, 1, "FSM consumed datagram %s\n",
+                        datagram->name);
 #endif
+                master->ext_ring_idx_fsm =
+                    (master->ext_ring_idx_fsm + 1) % master->ext_ring_size;
+                used = 1;
+            }
+        }
+
+        // register requests go into the same frame
+        datagram = ec_master_get_external_datagram(master);
+        if (datagram && ec_fsm_slave_exec_reg(fsm, datagram)) {
             master->ext_ring_idx_fsm =
-                (master->ext_ring_idx_fsm + 1) % EC_EXT_RING_SIZE;
+                (master->ext_ring_idx_fsm + 1) % master->ext_ring_size;
+            used = 1;
         }
-        else {
+
+        if (!used) {
             // FSM finished
             list_del_init(&fsm->list);
             master->fsm_exec_count--;
@@ -1495,22 +2222,54 @@ void ec_master_exec_slave_fsms(
         }
     }
 
-    while (master->fsm_exec_count < EC_EXT_RING_SIZE / 2
+    /* Every slave FSM needs up to four ring datagrams (two lanes, one frame
+     * in flight). Grow the ring, if it is the limiting factor and all its
+     * datagrams have been injected. */
+    limit = ec_master_fsm_exec_limit(master);
+    if (master->ext_ring_size < 4 * limit
+            && master->fsm_exec_count >= master->ext_ring_size / 4
+            && master->ext_ring_idx_rt == master->ext_ring_idx_fsm) {
+        if (!ec_master_grow_ext_ring(master, 4 * limit)) {
+            // the ring must not be used until it is taken over
+            return;
+        }
+        EC_MASTER_WARN(master, "Failed to grow external datagram ring."
+                " Limiting slave FSM slots to %u.\n",
+                master->ext_ring_size / 4);
+        master->fsm_slots = master->ext_ring_size / 4;
+    }
+    if (limit > master->ext_ring_size / 4) {
+        limit = master->ext_ring_size / 4;
+    }
+
+    while (master->fsm_exec_count < limit
             && count < master->slave_count) {
+        fsm = &master->fsm_slave->fsm;
+
+        if (list_empty(&fsm->list) && ec_fsm_slave_is_ready(fsm)) {
+            used = 0;
 
-        if (ec_fsm_slave_is_ready(&master->fsm_slave->fsm)) {
             datagram = ec_master_get_external_datagram(master);
+            if (ec_fsm_slave_exec(fsm, datagram)) {
+                master->ext_ring_idx_fsm =
+                    (master->ext_ring_idx_fsm + 1) % master->ext_ring_size;
+                used = 1;
+            }
 
-            if (ec_fsm_slave_exec(&master->fsm_slave->fsm, datagram)) {
+            datagram = ec_master_get_external_datagram(master);
+            if (datagram && ec_fsm_slave_exec_reg(fsm, datagram)) {
                 master->ext_ring_idx_fsm =
-                    (master->ext_ring_idx_fsm + 1) % EC_EXT_RING_SIZE;
-                list_add_tail(&master->fsm_slave->fsm.list,
-                        &master->fsm_exec_list);
+                    (master->ext_ring_idx_fsm + 1) % master->ext_ring_size;
+                used = 1;
+            }
+
+            if (used) {
+                list_add_tail(&fsm->list, &master->fsm_exec_list);
                 master->fsm_exec_count++;
 #if DEBUG_INJECT
                 EC_MASTER_DBG(master, 1, "New slave %u FSM"
-                        " consumed datagram %s, now %u FSMs in list.\n",
-                        master->fsm_slave->ring_position, datagram->name,
+                        " consumed datagrams, now %u FSMs in list.\n",
+                        master->fsm_slave->ring_position,
                         master->fsm_exec_count);
 #endif
             }
@@ -1552,6 +2311,11 @@ static int ec_master_idle_thread(void *priv_data)
         ecrt_master_receive(master);
         rt_mutex_unlock(&master->io_mutex);
 
+#ifdef EC_EOE
+        // cycle completed
+        ec_master_eoe_wakeup(master);
+#endif
+
         // execute master & slave state machines
         if (down_interruptible(&master->master_sem)) {
             break;
@@ -1567,7 +2331,7 @@ static int ec_master_idle_thread(void *priv_data)
         if (ec_rt_lock_interruptible(&master->io_mutex))
             break;
         if (fsm_exec) {
-            ec_master_queue_datagram(master, &master->fsm_datagram);
+            ec_fsm_master_queue_datagrams(&master->fsm);
         }
         ecrt_master_send(master);
 #ifdef EC_USE_HRTIMER
@@ -1612,6 +2376,11 @@ static int ec_master_operation_thread(void *priv_data)
     while (!kthread_should_stop()) {
         ec_datagram_output_stats(&master->fsm_datagram);
 
+#ifdef EC_EOE
+        // the application has completed at least one cycle
+        ec_master_eoe_wakeup(master);
+#endif
+
         if (master->injection_seq_rt == master->injection_seq_fsm) {
             // output statistics
             ec_master_output_stats(master);
@@ -1717,19 +2486,40 @@ void ec_master_eoe_stop(ec_master_t *master /**< EtherCAT master */)
 
 /****************************************************************************/
 
+/** Wakes up the EoE thread.
+ *
+ * Called, when a frame was passed to an EoE net_device, and after every
+ * cycle of the master thread, so that received datagrams are processed
+ * without delay.
+ */
+void ec_master_eoe_wakeup(ec_master_t *master /**< EtherCAT master */)
+{
+    master->eoe_event = 1;
+    wake_up_interruptible(&master->eoe_queue);
+}
+
+/****************************************************************************/
+
 /** Does the Ethernet over EtherCAT processing.
+ *
+ * The thread sleeps until it is woken up by ec_master_eoe_wakeup() (or for
+ * one jiffy at most). The datagrams of all EoE handlers are queued together
+ * and sent with one call of the send callback.
  */
 static int ec_master_eoe_thread(void *priv_data)
 {
     ec_master_t *master = (ec_master_t *) priv_data;
     ec_eoe_t *eoe;
-    unsigned int none_open, sth_to_send, all_idle;
+    unsigned int none_open, sth_to_send;
 
     EC_MASTER_DBG(master, 1, "EoE thread running.\n");
 
     while (!kthread_should_stop()) {
+        wait_event_interruptible_timeout(master->eoe_queue,
+                master->eoe_event || kthread_should_stop(), 1);
+        master->eoe_event = 0;
+
         none_open = 1;
-        all_idle = 1;
 
         list_for_each_entry(eoe, &master->eoe_handlers, list) {
             if (ec_eoe_is_open(eoe)) {
@@ -1738,7 +2528,7 @@ static int ec_master_eoe_thread(void *priv_data)
             }
         }
         if (none_open)
-            goto schedule;
+            continue;
 
         // receive datagrams
         master->receive_cb(master->cb_data);
@@ -1747,12 +2537,9 @@ static int ec_master_eoe_thread(void *priv_data)
         sth_to_send = 0;
         list_for_each_entry(eoe, &master->eoe_handlers, list) {
             ec_eoe_run(eoe);
-            if (eoe->queue_datagram) {
+            if (ec_eoe_has_datagram(eoe)) {
                 sth_to_send = 1;
             }
-            if (!ec_eoe_is_idle(eoe)) {
-                all_idle = 0;
-            }
         }
 
         if (sth_to_send) {
@@ -1762,14 +2549,6 @@ static int ec_master_eoe_thread(void *priv_data)
             // (try to) send datagrams
             master->send_cb(master->cb_data);
         }
-
-schedule:
-        if (all_idle) {
-            set_current_state(TASK_INTERRUPTIBLE);
-            schedule_timeout(1);
-        } else {
-            schedule();
-        }
     }
 
     EC_MASTER_DBG(master, 1, "EoE thread exiting...\n");
@@ -2325,6 +3104,8 @@ int ecrt_master_activate(ec_master_t *master)
         domain_offset += domain->data_size;
     }
 
+    ec_master_prepare_merging(master);
+
     up(&master->master_sem);
 
     // restart EoE process and master thread with new locking
@@ -2394,6 +3175,7 @@ int ecrt_master_deactivate(ec_master_t *master)
     master->receive_cb = ec_master_internal_receive_cb;
     master->cb_data = master;
 
+    ec_master_fail_mbox_checks(master);
     ec_master_clear_config(master);
 
     for (slave = master->slaves;
@@ -2419,6 +3201,7 @@ int ecrt_master_deactivate(ec_master_t *master)
 
     master->app_time = 0ULL;
     master->dc_ref_time = 0ULL;
+    ec_master_set_domain_merging(master, 0);
 
 #ifdef EC_EOE
     if (eoe_was_running) {
@@ -2440,19 +3223,31 @@ int ecrt_master_deactivate(ec_master_t *master)
 
 /****************************************************************************/
 
+int ecrt_master_set_domain_merging(ec_master_t *master, int enable)
+{
+    ec_master_set_domain_merging(master, enable);
+    return 0;
+}
+
+/****************************************************************************/
+
 int ecrt_master_send(ec_master_t *master)
 {
     ec_datagram_t *datagram, *n;
     ec_device_index_t dev_idx;
 
     if (master->injection_seq_rt != master->injection_seq_fsm) {
-        // inject datagram produced by master FSM
-        ec_master_queue_datagram(master, &master->fsm_datagram);
+        // inject datagrams produced by master FSM
+        ec_fsm_master_queue_datagrams(&master->fsm);
         master->injection_seq_rt = master->injection_seq_fsm;
     }
 
     ec_master_inject_external_datagrams(master);
 
+    if (unlikely(master->merge_hold)) {
+        master->merge_hold--;
+    }
+
     for (dev_idx = EC_DEVICE_MAIN; dev_idx < ec_master_num_devices(master);
             dev_idx++) {
         if (unlikely(!master->devices[dev_idx].link_state)) {
@@ -2465,6 +3260,10 @@ int ecrt_master_send(ec_master_t *master)
                 }
             }
 
+            if (dev_idx == master->mbox_status_datagram.device_index) {
+                ec_master_fail_mbox_checks(master);
+            }
+
             if (!master->devices[dev_idx].dev) {
                 continue;
             }
@@ -2533,6 +3332,8 @@ int ecrt_master_receive(ec_master_t *master)
 #endif /* RT_SYSLOG */
         }
     }
+
+    ec_master_complete_mbox_checks(master);
     return 0;
 }
 
@@ -3045,23 +3846,29 @@ int ecrt_master_sdo_download_complete(ec_master_t *master,
 
 /****************************************************************************/
 
-int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
-        uint16_t index, uint8_t subindex, uint8_t *target,
-        size_t target_size, size_t *result_size, uint32_t *abort_code)
+/** Executes an SDO upload request, optionally via complete access.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_master_sdo_upload(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint16_t slave_position, /**< Slave position. */
+        uint16_t index, /**< Index of the SDO. */
+        uint8_t subindex, /**< Subindex of the SDO. */
+        uint8_t complete_access, /**< Upload the SDO completely. */
+        uint8_t *target, /**< Target buffer for the upload. */
+        size_t target_size, /**< Size of the target buffer. */
+        size_t *result_size, /**< Uploaded data size. */
+        uint32_t *abort_code /**< Abort code of the SDO upload. */
+        )
 {
     ec_sdo_request_t request;
     ec_slave_t *slave;
     int ret = 0;
 
-    EC_MASTER_DBG(master, 1, "%s(master = 0x%p,"
-            " slave_position = %u, index = 0x%04X, subindex = 0x%02X,"
-            " target = 0x%p, target_size = %zu, result_size = 0x%p,"
-            " abort_code = 0x%p)\n",
-            __func__, master, slave_position, index, subindex,
-            target, target_size, result_size, abort_code);
-
     ec_sdo_request_init(&request);
     ecrt_sdo_request_index(&request, index, subindex);
+    request.complete_access = complete_access;
     ecrt_sdo_request_read(&request);
 
     if (down_interruptible(&master->master_sem)) {
@@ -3076,7 +3883,8 @@ int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
         return -EINVAL;
     }
 
-    EC_SLAVE_DBG(slave, 1, "Scheduling SDO upload request.\n");
+    EC_SLAVE_DBG(slave, 1, "Scheduling SDO upload request%s.\n",
+            complete_access ? " (complete access)" : "");
 
     // schedule request.
     list_add_tail(&request.list, &slave->sdo_requests);
@@ -3128,6 +3936,190 @@ int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
 
 /****************************************************************************/
 
+int ecrt_master_sdo_upload(ec_master_t *master, uint16_t slave_position,
+        uint16_t index, uint8_t subindex, uint8_t *target,
+        size_t target_size, size_t *result_size, uint32_t *abort_code)
+{
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p,"
+            " slave_position = %u, index = 0x%04X, subindex = 0x%02X,"
+            " target = 0x%p, target_size = %zu, result_size = 0x%p,"
+            " abort_code = 0x%p)\n",
+            __func__, master, slave_position, index, subindex,
+            target, target_size, result_size, abort_code);
+
+    return ec_master_sdo_upload(master, slave_position, index, subindex, 0,
+            target, target_size, result_size, abort_code);
+}
+
+/****************************************************************************/
+
+int ecrt_master_sdo_upload_complete(ec_master_t *master,
+        uint16_t slave_position, uint16_t index, uint8_t *target,
+        size_t target_size, size_t *result_size, uint32_t *abort_code)
+{
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p,"
+            " slave_position = %u, index = 0x%04X,"
+            " target = 0x%p, target_size = %zu, result_size = 0x%p,"
+            " abort_code = 0x%p)\n",
+            __func__, master, slave_position, index,
+            target, target_size, result_size, abort_code);
+
+    return ec_master_sdo_upload(master, slave_position, index, 0, 1,
+            target, target_size, result_size, abort_code);
+}
+
+/****************************************************************************/
+
+/** Counts the FoE requests in a certain state.
+ *
+ * \return Number of requests.
+ */
+unsigned int ec_master_count_foe_requests(
+        const ec_foe_request_t *requests, /**< FoE requests. */
+        size_t count, /**< Number of requests. */
+        ec_internal_request_state_t state /**< Request state. */
+        )
+{
+    unsigned int n = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        if (requests[i].state == state) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/****************************************************************************/
+
+int ecrt_master_foe_write(ec_master_t *master, ec_foe_target_t *targets,
+        size_t target_count, const char *file_name, const uint8_t *data,
+        size_t data_size)
+{
+    ec_foe_request_t *requests, *request;
+    ec_slave_t *slave;
+    size_t i;
+    int ret = 0;
+
+    EC_MASTER_DBG(master, 1, "%s(master = 0x%p, targets = 0x%p,"
+            " target_count = %zu, file_name = %s, data = 0x%p,"
+            " data_size = %zu)\n", __func__, master, targets, target_count,
+            file_name, data, data_size);
+
+    if (!target_count) {
+        return 0;
+    }
+
+    requests = vmalloc(target_count * sizeof(ec_foe_request_t));
+    if (!requests) {
+        EC_MASTER_ERR(master, "Failed to allocate %zu FoE requests.\n",
+                target_count);
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < target_count; i++) {
+        ec_foe_request_init(&requests[i], (uint8_t *) file_name);
+        // the data are shared by all requests and only read
+        requests[i].buffer = (uint8_t *) data;
+        requests[i].buffer_size = data_size;
+        requests[i].data_size = data_size;
+        ec_foe_request_write(&requests[i]);
+        targets[i].error = 0;
+    }
+
+    if (down_interruptible(&master->master_sem)) {
+        ret = -EINTR;
+        goto out_free;
+    }
+
+    for (i = 0; i < target_count; i++) {
+        if (!(slave = ec_master_find_slave(
+                        master, 0, targets[i].slave_position))) {
+            EC_MASTER_ERR(master, "Slave %u does not exist!\n",
+                    targets[i].slave_position);
+            requests[i].state = EC_INT_REQUEST_FAILURE;
+            targets[i].error = -EINVAL;
+            continue;
+        }
+
+        // the slave FSMs can not take requests while the master semaphore
+        // is held, so a queued request of this call means a duplicate
+        list_for_each_entry(request, &slave->foe_requests, list) {
+            if (request >= requests && request < requests + target_count) {
+                EC_SLAVE_ERR(slave, "Slave listed more than once"
+                        " as FoE target!\n");
+                goto out_duplicate;
+            }
+        }
+
+        EC_SLAVE_DBG(slave, 1, "Scheduling FoE write request.\n");
+
+        // the slave FSMs process the requests in parallel
+        list_add_tail(&requests[i].list, &slave->foe_requests);
+    }
+
+    up(&master->master_sem);
+
+    // wait for processing through FSMs
+    if (wait_event_interruptible(master->request_queue,
+                !ec_master_count_foe_requests(requests, target_count,
+                    EC_INT_REQUEST_QUEUED))) {
+        // interrupted by signal: abort the requests, that did not start
+        down(&master->master_sem);
+        for (i = 0; i < target_count; i++) {
+            if (requests[i].state == EC_INT_REQUEST_QUEUED) {
+                list_del(&requests[i].list);
+                requests[i].state = EC_INT_REQUEST_FAILURE;
+                targets[i].error = -EINTR;
+            }
+        }
+        up(&master->master_sem);
+    }
+
+    // wait until the slave FSMs have finished processing
+    wait_event(master->request_queue,
+            !ec_master_count_foe_requests(requests, target_count,
+                EC_INT_REQUEST_BUSY));
+
+    for (i = 0; i < target_count; i++) {
+        if (requests[i].state != EC_INT_REQUEST_SUCCESS) {
+            if (!targets[i].error) {
+                targets[i].error = -EIO;
+            }
+            ret = -EIO;
+        }
+        targets[i].result = requests[i].result;
+        targets[i].error_code = requests[i].error_code;
+        targets[i].data_size = requests[i].progress;
+
+        requests[i].buffer = NULL; // not owned by the request
+        ec_foe_request_clear(&requests[i]);
+    }
+
+    vfree(requests);
+    return ret;
+
+out_duplicate:
+    while (i--) {
+        if (!list_empty(&requests[i].list)) {
+            list_del_init(&requests[i].list);
+        }
+    }
+    up(&master->master_sem);
+    ret = -EINVAL;
+out_free:
+    for (i = 0; i < target_count; i++) {
+        requests[i].buffer = NULL;
+        ec_foe_request_clear(&requests[i]);
+    }
+    vfree(requests);
+    return ret;
+}
+
+/****************************************************************************/
+
 int ecrt_master_write_idn(ec_master_t *master, uint16_t slave_position,
         uint8_t drive_no, uint16_t idn, const uint8_t *data, size_t data_size,
         uint16_t *error_code)
@@ -3328,6 +4320,7 @@ static void sc_reset_task(struct work_struct *work)
 EXPORT_SYMBOL(ecrt_master_create_domain);
 EXPORT_SYMBOL(ecrt_master_activate);
 EXPORT_SYMBOL(ecrt_master_deactivate);
+EXPORT_SYMBOL(ecrt_master_set_domain_merging);
 EXPORT_SYMBOL(ecrt_master_send);
 EXPORT_SYMBOL(ecrt_master_send_ext);
 EXPORT_SYMBOL(ecrt_master_receive);
@@ -3349,6 +4342,8 @@ EXPORT_SYMBOL(ecrt_master_sync_monitor_process);
 EXPORT_SYMBOL(ecrt_master_sdo_download);
 EXPORT_SYMBOL(ecrt_master_sdo_download_complete);
 EXPORT_SYMBOL(ecrt_master_sdo_upload);
+EXPORT_SYMBOL(ecrt_master_sdo_upload_complete);
+EXPORT_SYMBOL(ecrt_master_foe_write);
 EXPORT_SYMBOL(ecrt_master_write_idn);
 EXPORT_SYMBOL(ecrt_master_read_idn);
 EXPORT_SYMBOL(ecrt_master_reset);
@@ -42,6 +42,10 @@
 #include "domain.h"
 #include "ethernet.h"
 #include "fsm_master.h"
+#include "sii_cache.h"
+#include "sdo_cache.h"
+#include "snapshot.h"
+#include "timeline.h"
 #include "cdev.h"
 
 #ifdef EC_RTDM
@@ -106,12 +110,46 @@
     } while (0)
 
 
-/** Size of the external datagram ring.
+/** Initial size of the external datagram ring.
  *
- * The external datagram ring is used for slave FSMs.
+ * The external datagram ring is used for slave FSMs. It grows on demand, so
+ * that it holds four datagrams for every slave FSM executed in parallel.
  */
 #define EC_EXT_RING_SIZE 32
 
+/** Default number of slave FSMs, that are executed in parallel.
+ */
+#define EC_FSM_SLOTS 64
+
+/** Maximum number of slave FSMs, that are executed in parallel.
+ */
+#define EC_MAX_FSM_SLOTS 1024
+
+/** Frame space in bytes, that is reserved for each slave FSM executed in
+ * parallel.
+ *
+ * Limits the parallel slave FSMs to what the frames of one send interval
+ * can carry.
+ */
+#define EC_FSM_SLOT_FRAME_SPACE 64
+
+/** Logical base address of the mailbox status images.
+ *
+ * Each bus scan uses the next of 256 areas of 64 kByte, so that mailbox
+ * status FMMUs left over from an earlier scan do not hit the current image.
+ */
+#define EC_MBOX_STATUS_ADDRESS 0xFF000000
+
+/** Number of consecutive working counter errors of the mailbox status
+ * datagram, after which mailbox checks fall back to single datagrams.
+ */
+#define EC_MBOX_STATUS_MAX_ERRORS 3
+
+/** Number of mailbox checks sent as single datagrams, after which a failed
+ * mailbox status datagram is tried again.
+ */
+#define EC_MBOX_STATUS_RETRY_CHECKS 1000
+
 /** Maximum number of masters.
  */
 #define EC_MAX_MASTERS 32
@@ -219,6 +257,8 @@ struct ec_master {
 
     ec_slave_t *slaves; /**< Array of slaves on the bus. */
     unsigned int slave_count; /**< Number of slaves on the bus. */
+    unsigned int slave_capacity; /**< Number of slaves, that fit into the
+                                   allocated slave array. */
 
     /* Configuration applied by the application. */
     struct list_head configs; /**< List of slave configurations. */
@@ -232,6 +272,25 @@ struct ec_master {
                                    compensation. */
     ec_datagram_t sync_mon_datagram; /**< Datagram used for DC synchronisation
                                        monitoring. */
+    ec_datagram_t mbox_status_datagram; /**< Datagram reading the mailbox
+                                          status image. */
+    unsigned int mbox_status_pending; /**< The mailbox status datagram was
+                                        queued and its result was not
+                                        evaluated yet. */
+    unsigned int mbox_status_gen; /**< Number of the mailbox status area
+                                    used for the current bus scan. */
+    unsigned int mbox_checks_gen; /**< Mailbox status area, the parked
+                                    mailbox checks refer to. */
+    unsigned int mbox_status_size; /**< Size of the mailbox status image in
+                                     bytes. */
+    unsigned int mbox_status_mapped; /**< Number of slaves with a mapped
+                                       mailbox status. */
+    unsigned int mbox_status_expected; /**< Expected working counter of the
+                                         queued mailbox status datagram. */
+    unsigned int mbox_status_errors; /**< Consecutive working counter errors
+                                       of the mailbox status datagram, plus
+                                       the checks sent as single datagrams
+                                       since. */
     ec_slave_config_t *dc_ref_config; /**< Application-selected DC reference
                                         clock slave config. */
     ec_slave_t *dc_ref_clock; /**< DC reference clock slave. */
@@ -244,7 +303,7 @@ struct ec_master {
     wait_queue_head_t scan_queue; /**< Queue for processes that wait for
                                     slave scanning. */
 
-    unsigned int config_busy; /**< State of slave configuration. */
+    unsigned int config_busy; /**< Number of slaves being configured. */
     struct semaphore config_sem; /**< Semaphore protecting the \a config_busy
                                    variable and the allow_config flag. */
     wait_queue_head_t config_queue; /**< Queue for processes that wait for
@@ -258,15 +317,26 @@ struct ec_master {
     struct semaphore ext_queue_sem; /**< Semaphore protecting the \a
                                       ext_datagram_queue. */
 
-    ec_datagram_t ext_datagram_ring[EC_EXT_RING_SIZE]; /**< External datagram
-                                                         ring. */
+    ec_datagram_t **ext_datagram_ring; /**< External datagram ring. */
+    unsigned int ext_ring_size; /**< Number of datagrams in the external
+                                  datagram ring. */
     unsigned int ext_ring_idx_rt; /**< Index in external datagram ring for RT
                                     side. */
     unsigned int ext_ring_idx_fsm; /**< Index in external datagram ring for
                                      FSM side. */
+    ec_datagram_t **ext_ring_next; /**< Grown ring, that waits to be taken
+                                     over by the RT side. */
+    unsigned int ext_ring_next_size; /**< Size of \a ext_ring_next. */
+    ec_datagram_t **ext_ring_old; /**< Replaced ring, that is freed by the
+                                    FSM side. */
     unsigned int send_interval; /**< Interval between two calls to
                                   ecrt_master_send(). */
     size_t max_queue_size; /**< Maximum size of datagram queue */
+    unsigned int merge_domains; /**< Merge adjacent domain datagrams into
+                                  one physical datagram when sending. */
+    unsigned int merge_hold; /**< Number of send cycles, for which merging
+                               is suspended after a working counter
+                               mismatch. */
 
     ec_slave_t *fsm_slave; /**< Slave that is queried next for FSM exec. */
     struct list_head fsm_exec_list; /**< Slave FSM execution list. */
@@ -274,6 +344,12 @@ struct ec_master {
 
     unsigned int debug_level; /**< Master debug level. */
     unsigned int run_on_cpu;  /**< bind kernel threads to this cpu */
+    unsigned int config_slots; /**< Maximum number of slaves, that are
+                                 configured in parallel. */
+    unsigned int hotplug_slaves; /**< Number of additional slaves, for that
+                                   memory is reserved on a bus scan. */
+    unsigned int fsm_slots; /**< Maximum number of slave FSMs, that are
+                              executed in parallel. */
     ec_stats_t stats; /**< Cyclic statistics. */
 
     struct task_struct *thread; /**< Master thread. */
@@ -281,6 +357,8 @@ struct ec_master {
 #ifdef EC_EOE
     struct task_struct *eoe_thread; /**< EoE thread. */
     struct list_head eoe_handlers; /**< Ethernet over EtherCAT handlers. */
+    wait_queue_head_t eoe_queue; /**< Wait queue of the EoE thread. */
+    unsigned int eoe_event; /**< The EoE thread has to run. */
 #endif
 
     struct rt_mutex io_mutex;  /**< Mutex used in \a IDLE and \a OP phase. */
@@ -295,6 +373,12 @@ struct ec_master {
     void *app_cb_data; /**< Application callback data. */
 
     struct list_head sii_requests; /**< SII write requests. */
+#ifdef EC_SII_CACHE
+    ec_sii_cache_t sii_cache; /**< SII image cache. */
+#endif
+    ec_sdo_cache_t sdo_cache; /**< SDO dictionary cache. */
+    ec_timeline_t timeline; /**< Startup timeline. */
+    ec_snapshot_t snapshot; /**< Warm-start snapshot. */
     struct list_head emerg_reg_requests; /**< Emergency register access
                                            requests. */
 
@@ -312,7 +396,8 @@ void ec_master_init_static(void);
 
 // master creation/deletion
 int ec_master_init(ec_master_t *, unsigned int, const uint8_t *,
-        const uint8_t *, dev_t, struct class *, unsigned int, unsigned int);
+        const uint8_t *, dev_t, struct class *, unsigned int, unsigned int,
+        unsigned int, unsigned int, unsigned int);
 void ec_master_clear(ec_master_t *);
 
 /** Number of Ethernet devices.
@@ -323,6 +408,11 @@ void ec_master_clear(ec_master_t *);
 #define ec_master_num_devices(MASTER) 1
 #endif
 
+/** Logical address of the mailbox status image of the current bus scan.
+ */
+#define ec_master_mbox_status_address(MASTER) \
+    (EC_MBOX_STATUS_ADDRESS + (((MASTER)->mbox_status_gen & 0xff) << 16))
+
 // phase transitions
 int ec_master_enter_idle_phase(ec_master_t *);
 void ec_master_leave_idle_phase(ec_master_t *);
@@ -333,6 +423,7 @@ void ec_master_leave_operation_phase(ec_master_t *);
 // EoE
 void ec_master_eoe_start(ec_master_t *);
 void ec_master_eoe_stop(ec_master_t *);
+void ec_master_eoe_wakeup(ec_master_t *);
 #endif
 
 // datagram IO
@@ -343,6 +434,8 @@ void ec_master_queue_datagram_ext(ec_master_t *, ec_datagram_t *);
 
 // misc.
 void ec_master_set_send_interval(ec_master_t *, unsigned int);
+void ec_master_set_domain_merging(ec_master_t *, unsigned int);
+int ec_master_set_fsm_slots(ec_master_t *, unsigned int);
 void ec_master_attach_slave_configs(ec_master_t *);
 ec_slave_t *ec_master_find_slave(ec_master_t *, uint16_t, uint16_t);
 const ec_slave_t *ec_master_find_slave_const(const ec_master_t *, uint16_t,
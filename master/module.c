@@ -56,6 +56,16 @@ static unsigned int debug_level;  /**< Debug level parameter. */
 static unsigned int run_on_cpu = 0xffffffff; /**< Bind created kernel threads
                                                to a cpu. Default do not bind.
                                               */
+static unsigned int config_slots = EC_FSM_MASTER_SLOTS; /**< Maximum number
+                                                          of slaves configured
+                                                          in parallel. */
+static unsigned int hotplug_slaves = EC_HOTPLUG_SLAVES; /**< Number of
+                                                          slaves, that can
+                                                          be hot-connected
+                                                          without a full
+                                                          rescan. */
+static unsigned int fsm_slots = EC_FSM_SLOTS; /**< Maximum number of slave
+                                                FSMs executed in parallel. */
 
 static ec_master_t *masters; /**< Array of masters. */
 static struct semaphore master_sem; /**< Master semaphore. */
@@ -84,6 +94,13 @@ module_param_named(debug_level, debug_level, uint, S_IRUGO);
 MODULE_PARM_DESC(debug_level, "Debug level");
 module_param_named(run_on_cpu, run_on_cpu, uint, S_IRUGO);
 MODULE_PARM_DESC(run_on_cpu, "Bind kthreads to a specific cpu");
+module_param_named(config_slots, config_slots, uint, S_IRUGO);
+MODULE_PARM_DESC(config_slots, "Number of slaves configured in parallel");
+module_param_named(hotplug_slaves, hotplug_slaves, uint, S_IRUGO);
+MODULE_PARM_DESC(hotplug_slaves, "Number of slaves, that can be"
+        " hot-connected without a full rescan");
+module_param_named(fsm_slots, fsm_slots, uint, S_IRUGO);
+MODULE_PARM_DESC(fsm_slots, "Number of slave FSMs executed in parallel");
 
 /** \endcond */
 
@@ -153,7 +170,8 @@ int __init ec_init_module(void)
 
     for (i = 0; i < master_count; i++) {
         ret = ec_master_init(&masters[i], i, macs[i][0], macs[i][1],
-                    device_number, class, debug_level, run_on_cpu);
+                    device_number, class, debug_level, run_on_cpu,
+                    config_slots, hotplug_slaves, fsm_slots);
         if (ret)
             goto out_free_masters;
     }
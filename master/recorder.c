@@ -0,0 +1,357 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT process data flight recorder methods.
+ */
+
+/****************************************************************************/
+
+#include <linux/vmalloc.h>
+
+#include "master.h"
+#include "domain.h"
+#include "recorder.h"
+
+/****************************************************************************/
+
+/** Maximum size of the recorder memory.
+ *
+ * Limited by the spacing of the mmap() offsets.
+ */
+#define EC_RECORDER_MAX_SIZE EC_RECORDER_MMAP_OFFSET(0)
+
+/****************************************************************************/
+
+/** Flight recorder constructor.
+ */
+void ec_recorder_init(
+        ec_recorder_t *rec, /**< Flight recorder. */
+        ec_domain_t *domain /**< Parent domain. */
+        )
+{
+    rec->domain = domain;
+    rec->depth = 0;
+    rec->post_trigger = 0;
+    rec->triggers = 0;
+    rec->memory = NULL;
+    rec->mem_size = 0;
+    rec->header = NULL;
+    rec->records = NULL;
+    rec->record_size = 0;
+    rec->ring_depth = 0;
+    rec->write_index = 0;
+    rec->cycle = 0;
+    rec->post_count = 0;
+    rec->wc_complete = 0;
+    rec->arm_requested = 0;
+    rec->arm_applied = 0;
+    rec->freeze_requested = 0;
+    rec->freeze_applied = 0;
+}
+
+/****************************************************************************/
+
+/** Flight recorder destructor.
+ */
+void ec_recorder_clear(
+        ec_recorder_t *rec /**< Flight recorder. */
+        )
+{
+    if (rec->memory) {
+        vfree(rec->memory);
+    }
+
+    rec->memory = NULL;
+    rec->mem_size = 0;
+    rec->header = NULL;
+    rec->records = NULL;
+    rec->ring_depth = 0;
+}
+
+/****************************************************************************/
+
+/** Configure the flight recorder.
+ *
+ * The memory is allocated later with ec_recorder_alloc(). The configuration
+ * can not be changed any more, once the memory is allocated, because the
+ * realtime path writes to the ring without locking.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_recorder_config(
+        ec_recorder_t *rec, /**< Flight recorder. */
+        unsigned int depth, /**< Number of records, zero to disable. */
+        unsigned int post_trigger, /**< Records to take after a trigger. */
+        unsigned int triggers /**< Enabled triggers. */
+        )
+{
+    if (rec->domain->master->active || rec->memory) {
+        EC_MASTER_ERR(rec->domain->master, "Domain %u: Recorder can not"
+                " be configured after activation!\n", rec->domain->index);
+        return -EBUSY;
+    }
+
+    if (depth && post_trigger >= depth) {
+        EC_MASTER_ERR(rec->domain->master, "Domain %u: Post-trigger count"
+                " %u exceeds recorder depth %u!\n", rec->domain->index,
+                post_trigger, depth);
+        return -EINVAL;
+    }
+
+    rec->depth = depth;
+    rec->post_trigger = post_trigger;
+    rec->triggers = triggers;
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Allocate the recorder memory.
+ *
+ * Has to be called after the domain size is known and before the first call
+ * of ec_recorder_record().
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_recorder_alloc(
+        ec_recorder_t *rec /**< Flight recorder. */
+        )
+{
+    ec_domain_t *domain = rec->domain;
+    size_t size;
+
+    ec_recorder_clear(rec);
+
+    if (!rec->depth || !domain->data_size) {
+        return 0;
+    }
+
+    rec->record_size = ALIGN(sizeof(ec_recorder_record_t) +
+            domain->data_size, 8);
+    size = PAGE_ALIGN(EC_RECORDER_HEADER_SIZE +
+            (size_t) rec->depth * rec->record_size);
+    if (size > EC_RECORDER_MAX_SIZE) {
+        EC_MASTER_ERR(domain->master, "Domain %u: Recorder size %zu"
+                " exceeds maximum of %lu byte!\n", domain->index, size,
+                EC_RECORDER_MAX_SIZE);
+        return -EINVAL;
+    }
+
+    if (!(rec->memory = vmalloc(size))) {
+        EC_MASTER_ERR(domain->master, "Failed to allocate %zu bytes"
+                " of recorder memory for domain %u!\n",
+                size, domain->index);
+        return -ENOMEM;
+    }
+
+    memset(rec->memory, 0, size);
+    rec->mem_size = size;
+    rec->header = (ec_recorder_header_t *) rec->memory;
+    rec->records = rec->memory + EC_RECORDER_HEADER_SIZE;
+    rec->ring_depth = rec->depth;
+    rec->write_index = 0;
+
+    rec->header->depth = rec->depth;
+    rec->header->record_size = rec->record_size;
+    rec->header->data_size = domain->data_size;
+    rec->header->post_trigger = rec->post_trigger;
+    rec->header->state = EC_RECORDER_ARMED;
+
+    rec->cycle = 0;
+    rec->post_count = 0;
+    rec->wc_complete = 0;
+    rec->arm_applied = rec->arm_requested;
+    rec->freeze_applied = rec->freeze_requested;
+
+    EC_MASTER_INFO(domain->master, "Domain %u: Flight recorder with %u"
+            " records of %zu byte.\n", domain->index, rec->depth,
+            rec->record_size);
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Append the current process data image to the ring.
+ *
+ * Called from ecrt_domain_process() in realtime context.
+ */
+void ec_recorder_record(
+        ec_recorder_t *rec, /**< Flight recorder. */
+        uint16_t wc_total /**< Sum of the working counters. */
+        )
+{
+    ec_domain_t *domain = rec->domain;
+    ec_recorder_header_t *header = rec->header;
+    ec_recorder_record_t *record;
+    unsigned int dev_idx;
+
+    rec->cycle++;
+
+    if (!header) {
+        return;
+    }
+
+    if (unlikely(rec->arm_applied != rec->arm_requested)) {
+        header->state = EC_RECORDER_FROZEN;
+        smp_wmb();
+        header->write_count = 0;
+        rec->write_index = 0;
+        header->trigger_count = 0;
+        header->trigger = 0;
+        rec->post_count = 0;
+        rec->wc_complete = 0;
+        rec->arm_applied = rec->arm_requested;
+        smp_wmb();
+        header->state = EC_RECORDER_ARMED;
+    }
+
+    if (unlikely(rec->freeze_applied != rec->freeze_requested)) {
+        rec->freeze_applied = rec->freeze_requested;
+        ec_recorder_trigger(rec, EC_RECORDER_TRIGGER_MANUAL);
+    }
+
+    if (header->state == EC_RECORDER_FROZEN) {
+        return;
+    }
+
+    record = (ec_recorder_record_t *) (rec->records +
+            (size_t) rec->write_index * rec->record_size);
+    record->cycle = rec->cycle;
+    record->app_time = domain->master->app_time;
+    for (dev_idx = EC_DEVICE_MAIN;
+            dev_idx < ec_master_num_devices(domain->master); dev_idx++) {
+        record->working_counter[dev_idx] = domain->working_counter[dev_idx];
+    }
+    record->expected_working_counter = domain->expected_working_counter;
+    memcpy(record + 1, domain->data, domain->data_size);
+
+    /* make the record visible before publishing it to mmap() readers */
+    smp_wmb();
+    header->write_count++;
+    if (++rec->write_index >= rec->ring_depth) {
+        rec->write_index = 0;
+    }
+
+    if (header->state == EC_RECORDER_TRIGGERED) {
+        if (rec->post_count) {
+            rec->post_count--;
+        }
+        if (!rec->post_count) {
+            header->state = EC_RECORDER_FROZEN;
+        }
+    } else if ((rec->triggers & EC_RECORDER_TRIGGER_WC) && rec->wc_complete
+            && wc_total < domain->expected_working_counter) {
+        ec_recorder_trigger(rec, EC_RECORDER_TRIGGER_WC);
+    }
+
+    rec->wc_complete = wc_total == domain->expected_working_counter;
+}
+
+/****************************************************************************/
+
+/** Trigger the recorder.
+ *
+ * The recorder freezes after the configured number of post-trigger records.
+ */
+void ec_recorder_trigger(
+        ec_recorder_t *rec, /**< Flight recorder. */
+        uint32_t trigger /**< Trigger source. */
+        )
+{
+    ec_recorder_header_t *header = rec->header;
+
+    if (!header || header->state != EC_RECORDER_ARMED) {
+        return;
+    }
+
+    header->trigger = trigger;
+    header->trigger_count = header->write_count;
+    rec->post_count = rec->post_trigger;
+    header->state = rec->post_count ?
+        EC_RECORDER_TRIGGERED : EC_RECORDER_FROZEN;
+}
+
+/****************************************************************************/
+
+/** Request to freeze the recorder, as if a trigger fired.
+ *
+ * The request is applied by the next ec_recorder_record() call.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_recorder_freeze(
+        ec_recorder_t *rec /**< Flight recorder. */
+        )
+{
+    if (!rec->header) {
+        return -ENOENT;
+    }
+
+    rec->freeze_requested++;
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Request to re-arm a triggered or frozen recorder.
+ *
+ * The request is applied by the next ec_recorder_record() call.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_recorder_arm(
+        ec_recorder_t *rec /**< Flight recorder. */
+        )
+{
+    if (!rec->header) {
+        return -ENOENT;
+    }
+
+    rec->arm_requested++;
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Checks, if the realtime path has stopped writing to the ring.
+ *
+ * This is the case, if the recorder is frozen and no re-arm request is
+ * pending. The caller has to prevent new re-arm requests, while it reads the
+ * ring.
+ *
+ * \return Non-zero, if the ring can be read.
+ */
+int ec_recorder_frozen(
+        const ec_recorder_t *rec /**< Flight recorder. */
+        )
+{
+    int frozen = rec->header && rec->header->state == EC_RECORDER_FROZEN
+        && rec->arm_applied == rec->arm_requested;
+
+    /* read the ring only after the state */
+    smp_rmb();
+    return frozen;
+}
+
+/****************************************************************************/
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT process data flight recorder.
+ */
+
+/****************************************************************************/
+
+#ifndef __EC_RECORDER_H__
+#define __EC_RECORDER_H__
+
+#include "globals.h"
+#include "ioctl.h"
+
+/****************************************************************************/
+
+/** EtherCAT process data flight recorder.
+ *
+ * Keeps the last \a depth process data images of a domain together with
+ * the working counters in a ring. The memory is allocated on activation, so
+ * that recording does not allocate anything in the realtime path.
+ *
+ * Only the realtime path writes to the ring and the header. Freezing and
+ * re-arming are requested by incrementing the respective request counter.
+ * ec_recorder_record() applies the request and acknowledges it by updating
+ * the matching counter and the recorder state.
+ */
+typedef struct {
+    ec_domain_t *domain; /**< Domain owning the recorder. */
+
+    unsigned int depth; /**< Requested number of records. */
+    unsigned int post_trigger; /**< Number of records to take after a
+                                 trigger. */
+    unsigned int triggers; /**< Enabled triggers (EC_RECORDER_TRIGGER_*). */
+
+    uint8_t *memory; /**< Recorder memory (header and records). */
+    size_t mem_size; /**< Size of \a memory (multiple of PAGE_SIZE). */
+    ec_recorder_header_t *header; /**< Header at the start of \a memory. */
+    uint8_t *records; /**< First record in \a memory. */
+    size_t record_size; /**< Size of a record in bytes. */
+    unsigned int ring_depth; /**< Number of records in \a records. */
+    unsigned int write_index; /**< Index of the next record to write. */
+
+    uint64_t cycle; /**< Cycle counter. */
+    unsigned int post_count; /**< Remaining post-trigger records. */
+    unsigned int wc_complete; /**< Last working counter was complete. */
+
+    unsigned int arm_requested; /**< Re-arm requests. */
+    unsigned int arm_applied; /**< Re-arm requests applied by the realtime
+                                path. */
+    unsigned int freeze_requested; /**< Freeze requests. */
+    unsigned int freeze_applied; /**< Freeze requests applied by the realtime
+                                   path. */
+} ec_recorder_t;
+
+/****************************************************************************/
+
+void ec_recorder_init(ec_recorder_t *, ec_domain_t *);
+void ec_recorder_clear(ec_recorder_t *);
+
+int ec_recorder_config(ec_recorder_t *, unsigned int, unsigned int,
+        unsigned int);
+int ec_recorder_alloc(ec_recorder_t *);
+void ec_recorder_record(ec_recorder_t *, uint16_t);
+void ec_recorder_trigger(ec_recorder_t *, uint32_t);
+int ec_recorder_freeze(ec_recorder_t *);
+int ec_recorder_arm(ec_recorder_t *);
+int ec_recorder_frozen(const ec_recorder_t *);
+
+/****************************************************************************/
+
+#endif
@@ -53,6 +53,8 @@ static int ec_rtdm_open(struct rtdm_fd *fd, int oflags)
 	ctx->ioctl_ctx.requested = 0;
 	ctx->ioctl_ctx.process_data = NULL;
 	ctx->ioctl_ctx.process_data_size = 0;
+	ctx->ioctl_ctx.foe_stream = NULL;
+	sema_init(&ctx->ioctl_ctx.foe_stream_sem, 1);
 
 #if DEBUG_RTDM
 	EC_MASTER_INFO(rtdm_dev->master, "RTDM device %s opened.\n",
@@ -70,6 +72,8 @@ static void ec_rtdm_close(struct rtdm_fd *fd)
 	struct rtdm_device *dev = rtdm_fd_device(fd);
 	ec_rtdm_dev_t *rtdm_dev = dev->device_data;
 
+	ec_ioctl_rtdm_foe_stream_clear(rtdm_dev->master, &ctx->ioctl_ctx);
+
 	if (ctx->ioctl_ctx.requested)
 		ecrt_release_master(rtdm_dev->master);
 
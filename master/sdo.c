@@ -38,16 +38,16 @@
  */
 void ec_sdo_init(
         ec_sdo_t *sdo, /**< SDO. */
-        ec_slave_t *slave, /**< Parent slave. */
         uint16_t index /**< SDO index. */
         )
 {
-    sdo->slave = slave;
     sdo->index = index;
     sdo->object_code = 0x00;
     sdo->name = NULL;
     sdo->max_subindex = 0;
     INIT_LIST_HEAD(&sdo->entries);
+    sdo->entry_array = NULL;
+    sdo->entry_count = 0;
 }
 
 /****************************************************************************/
@@ -75,6 +75,33 @@ void ec_sdo_clear(
 
 /****************************************************************************/
 
+/** Searches the sorted entry array of a compacted SDO.
+ *
+ * \return Pointer to the entry, or NULL.
+ */
+static ec_sdo_entry_t *ec_sdo_search_entry(
+        const ec_sdo_t *sdo, /**< SDO. */
+        uint8_t subindex /**< Entry subindex. */
+        )
+{
+    unsigned int low = 0, high = sdo->entry_count, mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (sdo->entry_array[mid].subindex < subindex) {
+            low = mid + 1;
+        } else if (sdo->entry_array[mid].subindex > subindex) {
+            high = mid;
+        } else {
+            return &sdo->entry_array[mid];
+        }
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
 /** Get an SDO entry from an SDO via its subindex.
  *
  * \retval >0 Pointer to the requested SDO entry.
@@ -87,6 +114,10 @@ ec_sdo_entry_t *ec_sdo_get_entry(
 {
     ec_sdo_entry_t *entry;
 
+    if (sdo->entry_array) {
+        return ec_sdo_search_entry(sdo, subindex);
+    }
+
     list_for_each_entry(entry, &sdo->entries, list) {
         if (entry->subindex != subindex)
             continue;
@@ -112,6 +143,10 @@ const ec_sdo_entry_t *ec_sdo_get_entry_const(
 {
     const ec_sdo_entry_t *entry;
 
+    if (sdo->entry_array) {
+        return ec_sdo_search_entry(sdo, subindex);
+    }
+
     list_for_each_entry(entry, &sdo->entries, list) {
         if (entry->subindex != subindex)
             continue;
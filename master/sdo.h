@@ -40,17 +40,19 @@
  */
 struct ec_sdo {
     struct list_head list; /**< List item. */
-    ec_slave_t *slave; /**< Parent slave. */
     uint16_t index; /**< SDO index. */
     uint8_t object_code; /**< Object code. */
     char *name; /**< SDO name. */
     uint8_t max_subindex; /**< Maximum subindex. */
     struct list_head entries; /**< List of entries. */
+    ec_sdo_entry_t *entry_array; /**< Entries sorted by subindex, if the
+                                   dictionary is compacted. */
+    unsigned int entry_count; /**< Number of entries in \a entry_array. */
 };
 
 /****************************************************************************/
 
-void ec_sdo_init(ec_sdo_t *, ec_slave_t *, uint16_t);
+void ec_sdo_init(ec_sdo_t *, uint16_t);
 void ec_sdo_clear(ec_sdo_t *);
 
 ec_sdo_entry_t *ec_sdo_get_entry(ec_sdo_t *, uint8_t);
@@ -0,0 +1,753 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT SDO dictionary cache.
+ *
+ * Fetching the SDO dictionary of a slave takes an SDO information request
+ * per object and per entry. Dictionaries are therefore kept in memory and
+ * shared among all slaves with the same vendor ID, product code and
+ * revision number, so that they are fetched only once per device type.
+ * Additionally, dictionary images (like the output of 'ethercat sdos
+ * --output-file') can be provided persistently via the firmware loader,
+ * named ethercat/sdo-<vendor>-<product>-<revision>.bin with the numbers in
+ * lower-case hexadecimal (8 digits).
+ */
+
+/****************************************************************************/
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
+#include <linux/version.h>
+#include <linux/vmalloc.h>
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 14, 0)
+#include <linux/firmware.h>
+#define EC_SDO_CACHE_FIRMWARE
+#endif
+
+#include "master.h"
+#include "sdo.h"
+#include "sdo_entry.h"
+#include "sdo_cache.h"
+
+/****************************************************************************/
+
+/** Frees a dictionary and all its SDOs.
+ */
+static void ec_sdo_dict_free(
+        ec_sdo_dict_t *dict /**< SDO dictionary. */
+        )
+{
+    ec_sdo_t *sdo, *next;
+
+    if (dict->arena) {
+        vfree(dict->arena); // SDOs, entries and strings
+    } else {
+        list_for_each_entry_safe(sdo, next, &dict->sdos, list) {
+            list_del(&sdo->list);
+            ec_sdo_clear(sdo);
+            kfree(sdo);
+        }
+    }
+
+    kfree(dict);
+}
+
+/****************************************************************************/
+
+/** Allocates an empty dictionary.
+ *
+ * The caller holds the only reference.
+ *
+ * \return Pointer to the new dictionary, or NULL on error.
+ */
+ec_sdo_dict_t *ec_sdo_dict_alloc(
+        uint32_t vendor_id, /**< Vendor ID. */
+        uint32_t product_code, /**< Product code. */
+        uint32_t revision_number /**< Revision number. */
+        )
+{
+    ec_sdo_dict_t *dict;
+
+    if (!(dict = kmalloc(sizeof(ec_sdo_dict_t), GFP_KERNEL))) {
+        return NULL;
+    }
+
+    INIT_LIST_HEAD(&dict->list); // mark as not cached
+    dict->vendor_id = vendor_id;
+    dict->product_code = product_code;
+    dict->revision_number = revision_number;
+    INIT_LIST_HEAD(&dict->sdos);
+    dict->refs = 1;
+    dict->arena = NULL;
+    dict->sdo_array = NULL;
+    dict->sdo_count = 0;
+    return dict;
+}
+
+/****************************************************************************/
+
+/** Takes a reference to a dictionary.
+ *
+ * \return The dictionary.
+ */
+ec_sdo_dict_t *ec_sdo_dict_get(
+        ec_sdo_dict_t *dict /**< SDO dictionary. */
+        )
+{
+    dict->refs++;
+    return dict;
+}
+
+/****************************************************************************/
+
+/** Releases a reference to a dictionary.
+ *
+ * The dictionary is freed with the last reference.
+ */
+void ec_sdo_dict_put(
+        ec_sdo_dict_t *dict /**< SDO dictionary. */
+        )
+{
+    if (!--dict->refs) {
+        ec_sdo_dict_free(dict);
+    }
+}
+
+/****************************************************************************/
+
+/** String table node used for interning while compacting.
+ */
+typedef struct {
+    const char *str; /**< Original string. */
+    char *copy; /**< Interned copy in the arena. */
+    unsigned int next; /**< Next node in the bucket plus one, or zero. */
+} ec_sdo_dict_string_t;
+
+/** String table used for interning while compacting.
+ */
+typedef struct {
+    ec_sdo_dict_string_t *nodes; /**< Nodes. */
+    unsigned int node_count; /**< Number of used nodes. */
+    unsigned int *buckets; /**< First node of each bucket plus one. */
+    unsigned int bucket_mask; /**< Number of buckets minus one. */
+    size_t size; /**< Size of all unique strings including zeros. */
+} ec_sdo_dict_strtab_t;
+
+/****************************************************************************/
+
+/** Looks up a string in the string table and adds it, if it is new.
+ *
+ * \return Pointer to the node, or NULL for a NULL string.
+ */
+static ec_sdo_dict_string_t *ec_sdo_dict_intern(
+        ec_sdo_dict_strtab_t *tab, /**< String table. */
+        const char *str /**< String, or NULL. */
+        )
+{
+    ec_sdo_dict_string_t *node;
+    const char *c;
+    uint32_t hash = 2166136261U; // FNV-1a
+    unsigned int *link;
+
+    if (!str) {
+        return NULL;
+    }
+
+    for (c = str; *c; c++) {
+        hash = (hash ^ (uint8_t) *c) * 16777619U;
+    }
+
+    link = &tab->buckets[hash & tab->bucket_mask];
+    while (*link) {
+        node = &tab->nodes[*link - 1];
+        if (!strcmp(node->str, str)) {
+            return node;
+        }
+        link = &node->next;
+    }
+
+    node = &tab->nodes[tab->node_count++];
+    node->str = str;
+    node->copy = NULL;
+    node->next = 0;
+    *link = tab->node_count;
+    tab->size += strlen(str) + 1;
+    return node;
+}
+
+/****************************************************************************/
+
+/** Compares SDOs by index for sort().
+ */
+static int ec_sdo_dict_cmp_sdo(const void *a, const void *b)
+{
+    const ec_sdo_t *sdo_a = *(const ec_sdo_t **) a;
+    const ec_sdo_t *sdo_b = *(const ec_sdo_t **) b;
+
+    return (int) sdo_a->index - (int) sdo_b->index;
+}
+
+/****************************************************************************/
+
+/** Compares SDO entries by subindex for sort().
+ */
+static int ec_sdo_dict_cmp_entry(const void *a, const void *b)
+{
+    return (int) ((const ec_sdo_entry_t *) a)->subindex
+        - (int) ((const ec_sdo_entry_t *) b)->subindex;
+}
+
+/****************************************************************************/
+
+/** Compacts a dictionary into a single memory block.
+ *
+ * The individually allocated SDOs, entries and strings are replaced by
+ * copies in the arena and freed. The dictionary must not be in use by a
+ * CoE state machine.
+ *
+ * \return Zero on success, otherwise a negative error code. On error, the
+ * dictionary is left unchanged.
+ */
+int ec_sdo_dict_compact(
+        ec_sdo_dict_t *dict /**< SDO dictionary. */
+        )
+{
+    ec_sdo_dict_strtab_t tab;
+    ec_sdo_t *sdo, *next, **sorted, *sdos;
+    ec_sdo_entry_t *entry, *entries;
+    unsigned int sdo_count = 0, entry_count = 0, buckets = 1, i, j, e;
+    size_t temp_size, sdo_size, entry_size;
+    void *temp;
+    char *strings;
+
+    if (dict->arena || list_empty(&dict->sdos)) {
+        return 0;
+    }
+
+    list_for_each_entry(sdo, &dict->sdos, list) {
+        sdo_count++;
+        list_for_each_entry(entry, &sdo->entries, list) {
+            entry_count++;
+        }
+    }
+
+    while (buckets < sdo_count + entry_count) {
+        buckets <<= 1;
+    }
+
+    // temporary memory for the sorted SDO pointers and the string table
+    temp_size = sdo_count * sizeof(ec_sdo_t *)
+        + (sdo_count + entry_count) * sizeof(ec_sdo_dict_string_t)
+        + buckets * sizeof(unsigned int);
+    if (!(temp = vmalloc(temp_size))) {
+        return -ENOMEM;
+    }
+
+    sorted = temp;
+    tab.nodes = (ec_sdo_dict_string_t *) (sorted + sdo_count);
+    tab.node_count = 0;
+    tab.buckets = (unsigned int *) (tab.nodes + sdo_count + entry_count);
+    tab.bucket_mask = buckets - 1;
+    tab.size = 0;
+    memset(tab.buckets, 0x00, buckets * sizeof(unsigned int));
+
+    i = 0;
+    list_for_each_entry(sdo, &dict->sdos, list) {
+        sorted[i++] = sdo;
+        ec_sdo_dict_intern(&tab, sdo->name);
+        list_for_each_entry(entry, &sdo->entries, list) {
+            ec_sdo_dict_intern(&tab, entry->description);
+        }
+    }
+
+    sort(sorted, sdo_count, sizeof(ec_sdo_t *), ec_sdo_dict_cmp_sdo, NULL);
+
+    sdo_size = sdo_count * sizeof(ec_sdo_t);
+    entry_size = entry_count * sizeof(ec_sdo_entry_t);
+    if (!(dict->arena = vmalloc(sdo_size + entry_size + tab.size))) {
+        vfree(temp);
+        return -ENOMEM;
+    }
+
+    sdos = dict->arena;
+    entries = (ec_sdo_entry_t *) ((uint8_t *) dict->arena + sdo_size);
+    strings = (char *) dict->arena + sdo_size + entry_size;
+
+    for (i = 0; i < tab.node_count; i++) {
+        tab.nodes[i].copy = strings;
+        strcpy(strings, tab.nodes[i].str);
+        strings += strlen(strings) + 1;
+    }
+
+    e = 0;
+    for (i = 0; i < sdo_count; i++) {
+        ec_sdo_init(&sdos[i], sorted[i]->index);
+        sdos[i].object_code = sorted[i]->object_code;
+        sdos[i].max_subindex = sorted[i]->max_subindex;
+        if (sorted[i]->name) {
+            sdos[i].name = ec_sdo_dict_intern(&tab, sorted[i]->name)->copy;
+        }
+
+        sdos[i].entry_array = entries + e;
+        list_for_each_entry(entry, &sorted[i]->entries, list) {
+            entries[e] = *entry;
+            entries[e].sdo = &sdos[i];
+            if (entry->description) {
+                entries[e].description =
+                    ec_sdo_dict_intern(&tab, entry->description)->copy;
+            }
+            e++;
+        }
+        sdos[i].entry_count = entries + e - sdos[i].entry_array;
+
+        sort(sdos[i].entry_array, sdos[i].entry_count,
+                sizeof(ec_sdo_entry_t), ec_sdo_dict_cmp_entry, NULL);
+        for (j = 0; j < sdos[i].entry_count; j++) {
+            list_add_tail(&sdos[i].entry_array[j].list, &sdos[i].entries);
+        }
+    }
+
+    vfree(temp);
+
+    list_for_each_entry_safe(sdo, next, &dict->sdos, list) {
+        list_del(&sdo->list);
+        ec_sdo_clear(sdo);
+        kfree(sdo);
+    }
+
+    for (i = 0; i < sdo_count; i++) {
+        list_add_tail(&sdos[i].list, &dict->sdos);
+    }
+
+    dict->sdo_array = sdos;
+    dict->sdo_count = sdo_count;
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Looks up an SDO by its index.
+ *
+ * Compacted dictionaries are searched binary, others linear.
+ *
+ * \return Pointer to the SDO, or NULL.
+ */
+ec_sdo_t *ec_sdo_dict_find(
+        const ec_sdo_dict_t *dict, /**< SDO dictionary. */
+        uint16_t index /**< SDO index. */
+        )
+{
+    unsigned int low = 0, high = dict->sdo_count, mid;
+    ec_sdo_t *sdo;
+
+    if (!dict->arena) {
+        list_for_each_entry(sdo, &dict->sdos, list) {
+            if (sdo->index == index) {
+                return sdo;
+            }
+        }
+        return NULL;
+    }
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (dict->sdo_array[mid].index < index) {
+            low = mid + 1;
+        } else if (dict->sdo_array[mid].index > index) {
+            high = mid;
+        } else {
+            return &dict->sdo_array[mid];
+        }
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+
+/** Returns the length of a string in a dictionary image.
+ *
+ * \return String length.
+ */
+static size_t ec_sdo_dict_strlen(
+        const char *str /**< String, or NULL. */
+        )
+{
+    return str ? min(strlen(str), (size_t) 0xffff) : 0;
+}
+
+/****************************************************************************/
+
+/** Exports a dictionary as a binary image.
+ *
+ * \return Length of the image in bytes. If \a data is NULL or \a size is
+ * too small, only the length is returned.
+ */
+size_t ec_sdo_dict_export(
+        const ec_sdo_dict_t *dict, /**< SDO dictionary. */
+        uint8_t *data, /**< Target memory, or NULL. */
+        size_t size /**< Size of the target memory. */
+        )
+{
+    const ec_sdo_t *sdo;
+    const ec_sdo_entry_t *entry;
+    size_t length = EC_SDO_DICT_HEADER_SIZE, len;
+    unsigned int sdo_count = 0, entry_count, i;
+    uint8_t *rec, *sdo_rec, read_access, write_access;
+
+    list_for_each_entry(sdo, &dict->sdos, list) {
+        length += EC_SDO_DICT_SDO_SIZE + ec_sdo_dict_strlen(sdo->name);
+        list_for_each_entry(entry, &sdo->entries, list) {
+            length += EC_SDO_DICT_ENTRY_SIZE
+                + ec_sdo_dict_strlen(entry->description);
+        }
+        sdo_count++;
+    }
+
+    if (!data || size < length) {
+        return length;
+    }
+
+    EC_WRITE_U32(data, EC_SDO_DICT_MAGIC);
+    EC_WRITE_U16(data + 4, EC_SDO_DICT_VERSION);
+    EC_WRITE_U16(data + 6, sdo_count);
+    EC_WRITE_U32(data + 8, dict->vendor_id);
+    EC_WRITE_U32(data + 12, dict->product_code);
+    EC_WRITE_U32(data + 16, dict->revision_number);
+    rec = data + EC_SDO_DICT_HEADER_SIZE;
+
+    list_for_each_entry(sdo, &dict->sdos, list) {
+        sdo_rec = rec;
+        len = ec_sdo_dict_strlen(sdo->name);
+        EC_WRITE_U16(rec, sdo->index);
+        EC_WRITE_U8(rec + 2, sdo->object_code);
+        EC_WRITE_U8(rec + 3, sdo->max_subindex);
+        EC_WRITE_U16(rec + 6, len);
+        rec += EC_SDO_DICT_SDO_SIZE;
+        memcpy(rec, sdo->name, len);
+        rec += len;
+
+        entry_count = 0;
+        list_for_each_entry(entry, &sdo->entries, list) {
+            read_access = 0;
+            write_access = 0;
+            for (i = 0; i < EC_SDO_ENTRY_ACCESS_COUNT; i++) {
+                read_access |= (entry->read_access[i] ? 1 : 0) << i;
+                write_access |= (entry->write_access[i] ? 1 : 0) << i;
+            }
+
+            len = ec_sdo_dict_strlen(entry->description);
+            EC_WRITE_U8(rec, entry->subindex);
+            EC_WRITE_U8(rec + 1, 0x00);
+            EC_WRITE_U16(rec + 2, entry->data_type);
+            EC_WRITE_U16(rec + 4, entry->bit_length);
+            EC_WRITE_U8(rec + 6, read_access);
+            EC_WRITE_U8(rec + 7, write_access);
+            EC_WRITE_U16(rec + 8, len);
+            rec += EC_SDO_DICT_ENTRY_SIZE;
+            memcpy(rec, entry->description, len);
+            rec += len;
+            entry_count++;
+        }
+        EC_WRITE_U16(sdo_rec + 4, entry_count);
+    }
+
+    return length;
+}
+
+/****************************************************************************/
+
+#ifdef EC_SDO_CACHE_FIRMWARE
+
+/** Reads a string from a dictionary image.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_sdo_dict_parse_string(
+        char **str, /**< String to allocate. */
+        const uint8_t *data, /**< Image data. */
+        size_t size, /**< Image size. */
+        size_t *pos, /**< Current position in the image. */
+        size_t len /**< String length. */
+        )
+{
+    if (size - *pos < len) {
+        return -EINVAL;
+    }
+
+    if (len) {
+        if (!(*str = kmalloc(len + 1, GFP_KERNEL))) {
+            return -ENOMEM;
+        }
+        memcpy(*str, data + *pos, len);
+        (*str)[len] = 0;
+        *pos += len;
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Creates a dictionary from a binary image.
+ *
+ * \return Pointer to the new dictionary, or NULL if the image is invalid.
+ */
+static ec_sdo_dict_t *ec_sdo_dict_parse(
+        const uint8_t *data, /**< Image data. */
+        size_t size /**< Image size. */
+        )
+{
+    ec_sdo_dict_t *dict;
+    ec_sdo_t *sdo;
+    ec_sdo_entry_t *entry;
+    unsigned int sdo_count, entry_count, i, j, k;
+    size_t pos = EC_SDO_DICT_HEADER_SIZE, len;
+
+    if (size < EC_SDO_DICT_HEADER_SIZE
+            || EC_READ_U32(data) != EC_SDO_DICT_MAGIC
+            || EC_READ_U16(data + 4) != EC_SDO_DICT_VERSION) {
+        return NULL;
+    }
+
+    if (!(dict = ec_sdo_dict_alloc(EC_READ_U32(data + 8),
+                    EC_READ_U32(data + 12), EC_READ_U32(data + 16)))) {
+        return NULL;
+    }
+
+    sdo_count = EC_READ_U16(data + 6);
+
+    for (i = 0; i < sdo_count; i++) {
+        if (size - pos < EC_SDO_DICT_SDO_SIZE
+                || !(sdo = kmalloc(sizeof(ec_sdo_t), GFP_KERNEL))) {
+            goto out_invalid;
+        }
+
+        ec_sdo_init(sdo, EC_READ_U16(data + pos));
+        list_add_tail(&sdo->list, &dict->sdos);
+        sdo->object_code = EC_READ_U8(data + pos + 2);
+        sdo->max_subindex = EC_READ_U8(data + pos + 3);
+        entry_count = EC_READ_U16(data + pos + 4);
+        len = EC_READ_U16(data + pos + 6);
+        pos += EC_SDO_DICT_SDO_SIZE;
+
+        if (ec_sdo_dict_parse_string(&sdo->name, data, size, &pos, len)) {
+            goto out_invalid;
+        }
+
+        for (j = 0; j < entry_count; j++) {
+            if (size - pos < EC_SDO_DICT_ENTRY_SIZE
+                    || !(entry = kmalloc(sizeof(ec_sdo_entry_t),
+                            GFP_KERNEL))) {
+                goto out_invalid;
+            }
+
+            ec_sdo_entry_init(entry, sdo, EC_READ_U8(data + pos));
+            list_add_tail(&entry->list, &sdo->entries);
+            entry->data_type = EC_READ_U16(data + pos + 2);
+            entry->bit_length = EC_READ_U16(data + pos + 4);
+            for (k = 0; k < EC_SDO_ENTRY_ACCESS_COUNT; k++) {
+                entry->read_access[k] = (EC_READ_U8(data + pos + 6) >> k) & 1;
+                entry->write_access[k] =
+                    (EC_READ_U8(data + pos + 7) >> k) & 1;
+            }
+            len = EC_READ_U16(data + pos + 8);
+            pos += EC_SDO_DICT_ENTRY_SIZE;
+
+            if (ec_sdo_dict_parse_string(&entry->description,
+                        data, size, &pos, len)) {
+                goto out_invalid;
+            }
+        }
+    }
+
+    return dict;
+
+out_invalid:
+    ec_sdo_dict_put(dict);
+    return NULL;
+}
+
+/****************************************************************************/
+
+/** Tries to load a dictionary via the firmware loader.
+ *
+ * \return Pointer to the loaded dictionary, or NULL if none is available.
+ */
+static ec_sdo_dict_t *ec_sdo_cache_load(
+        ec_sdo_cache_t *cache, /**< SDO dictionary cache. */
+        uint32_t vendor_id, /**< Vendor ID. */
+        uint32_t product_code, /**< Product code. */
+        uint32_t revision_number /**< Revision number. */
+        )
+{
+    ec_master_t *master = cache->master;
+    const struct firmware *fw;
+    ec_sdo_dict_t *dict;
+    char name[48];
+
+    snprintf(name, sizeof(name), "ethercat/sdo-%08x-%08x-%08x.bin",
+            vendor_id, product_code, revision_number);
+
+    if (request_firmware_direct(&fw, name, master->class_device)) {
+        return NULL;
+    }
+
+    dict = ec_sdo_dict_parse(fw->data, fw->size);
+    release_firmware(fw);
+
+    if (!dict) {
+        EC_MASTER_WARN(master, "Ignoring %s: Invalid contents.\n", name);
+        return NULL;
+    }
+
+    if (dict->vendor_id != vendor_id || dict->product_code != product_code
+            || dict->revision_number != revision_number) {
+        EC_MASTER_WARN(master, "Ignoring %s: Identity mismatch.\n", name);
+        ec_sdo_dict_put(dict);
+        return NULL;
+    }
+
+    if (ec_sdo_dict_compact(dict)) {
+        EC_MASTER_WARN(master, "Failed to compact SDO dictionary.\n");
+    }
+
+    list_add_tail(&dict->list, &cache->dicts); // cache owns the reference
+    EC_MASTER_DBG(master, 1, "Loaded SDO dictionary from %s.\n", name);
+    return dict;
+}
+
+#endif
+
+/****************************************************************************/
+
+/** SDO dictionary cache constructor.
+ */
+void ec_sdo_cache_init(
+        ec_sdo_cache_t *cache, /**< SDO dictionary cache. */
+        ec_master_t *master /**< Parent master. */
+        )
+{
+    cache->master = master;
+    INIT_LIST_HEAD(&cache->dicts);
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+/****************************************************************************/
+
+/** SDO dictionary cache destructor.
+ *
+ * Dictionaries still used by slaves are freed with their last reference.
+ */
+void ec_sdo_cache_clear(
+        ec_sdo_cache_t *cache /**< SDO dictionary cache. */
+        )
+{
+    ec_sdo_dict_t *dict, *next;
+
+    list_for_each_entry_safe(dict, next, &cache->dicts, list) {
+        list_del_init(&dict->list);
+        ec_sdo_dict_put(dict);
+    }
+}
+
+/****************************************************************************/
+
+/** Looks up the dictionary of a device type.
+ *
+ * If the dictionary is not in memory, it is tried to be loaded via the
+ * firmware loader. The caller has to take its own reference with
+ * ec_sdo_dict_get().
+ *
+ * \return Pointer to the dictionary, or NULL on a cache miss.
+ */
+ec_sdo_dict_t *ec_sdo_cache_find(
+        ec_sdo_cache_t *cache, /**< SDO dictionary cache. */
+        uint32_t vendor_id, /**< Vendor ID. */
+        uint32_t product_code, /**< Product code. */
+        uint32_t revision_number /**< Revision number. */
+        )
+{
+    ec_sdo_dict_t *dict;
+
+    list_for_each_entry(dict, &cache->dicts, list) {
+        if (dict->vendor_id == vendor_id
+                && dict->product_code == product_code
+                && dict->revision_number == revision_number) {
+            cache->hits++;
+            return dict;
+        }
+    }
+
+#ifdef EC_SDO_CACHE_FIRMWARE
+    if ((dict = ec_sdo_cache_load(cache, vendor_id, product_code,
+                    revision_number))) {
+        cache->hits++;
+        return dict;
+    }
+#endif
+
+    cache->misses++;
+    return NULL;
+}
+
+/****************************************************************************/
+
+/** Stores a completely fetched dictionary.
+ *
+ * The dictionary is compacted and the cache takes its own reference. An
+ * existing dictionary for the same device type is replaced; slaves using it
+ * keep their reference.
+ */
+void ec_sdo_cache_store(
+        ec_sdo_cache_t *cache, /**< SDO dictionary cache. */
+        ec_sdo_dict_t *dict /**< SDO dictionary. */
+        )
+{
+    ec_sdo_dict_t *cached, *next;
+
+    if (!list_empty(&dict->list)) {
+        return; // already cached
+    }
+
+    if (ec_sdo_dict_compact(dict)) {
+        EC_MASTER_WARN(cache->master, "Failed to compact SDO dictionary.\n");
+    }
+
+    list_for_each_entry_safe(cached, next, &cache->dicts, list) {
+        if (cached->vendor_id == dict->vendor_id
+                && cached->product_code == dict->product_code
+                && cached->revision_number == dict->revision_number) {
+            list_del_init(&cached->list);
+            ec_sdo_dict_put(cached);
+        }
+    }
+
+    list_add_tail(&ec_sdo_dict_get(dict)->list, &cache->dicts);
+}
+
+/****************************************************************************/
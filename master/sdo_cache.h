@@ -0,0 +1,130 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT SDO dictionary cache.
+ */
+
+/****************************************************************************/
+
+#ifndef __EC_SDO_CACHE_H__
+#define __EC_SDO_CACHE_H__
+
+#include <linux/list.h>
+
+#include "globals.h"
+#include "sdo.h"
+
+/****************************************************************************/
+
+/** Magic number at the beginning of a dictionary image ("ECSD").
+ */
+#define EC_SDO_DICT_MAGIC 0x44534345
+
+/** Version of the dictionary image format.
+ */
+#define EC_SDO_DICT_VERSION 1
+
+/** Size of the dictionary image header in bytes.
+ *
+ * The header consists of the magic number (32 bit), the format version (16
+ * bit), the number of SDOs (16 bit), the vendor ID, the product code and the
+ * revision number (32 bit each).
+ */
+#define EC_SDO_DICT_HEADER_SIZE 20
+
+/** Size of an SDO record in bytes, without the name.
+ *
+ * Each record holds the index (16 bit), the object code and the maximum
+ * subindex (8 bit each), the number of entries and the length of the name
+ * (16 bit each), followed by the name and the entry records.
+ */
+#define EC_SDO_DICT_SDO_SIZE 8
+
+/** Size of an SDO entry record in bytes, without the description.
+ *
+ * Each record holds the subindex (8 bit, followed by a reserved byte), the
+ * data type and the bit length (16 bit each), the read and write access
+ * flags (8 bit each, one bit per state) and the length of the description
+ * (16 bit), followed by the description.
+ */
+#define EC_SDO_DICT_ENTRY_SIZE 10
+
+/****************************************************************************/
+
+/** SDO dictionary.
+ *
+ * A dictionary is shared among all slaves with the same vendor ID, product
+ * code and revision number. It is reference-counted and must not be
+ * modified, once it has been fetched completely.
+ *
+ * Before a dictionary is cached, it is compacted into a single memory block
+ * (the arena) holding the SDOs sorted by index, their entries sorted by
+ * subindex and all names and descriptions, equal strings stored once. The
+ * list heads stay valid for iteration.
+ */
+typedef struct {
+    struct list_head list; /**< List item for the cache. */
+    uint32_t vendor_id; /**< Vendor ID. */
+    uint32_t product_code; /**< Product code. */
+    uint32_t revision_number; /**< Revision number. */
+    struct list_head sdos; /**< List of SDOs. */
+    unsigned int refs; /**< Number of references. */
+    void *arena; /**< Memory block of a compacted dictionary, or NULL. */
+    ec_sdo_t *sdo_array; /**< SDOs sorted by index (in the arena). */
+    unsigned int sdo_count; /**< Number of SDOs in \a sdo_array. */
+} ec_sdo_dict_t;
+
+/****************************************************************************/
+
+/** SDO dictionary cache.
+ *
+ * Dictionaries are looked up by vendor ID, product code and revision number.
+ * Access is serialized by the master semaphore.
+ */
+typedef struct {
+    ec_master_t *master; /**< Parent master. */
+    struct list_head dicts; /**< List of cached dictionaries. */
+    unsigned int hits; /**< Number of cache hits. */
+    unsigned int misses; /**< Number of cache misses. */
+} ec_sdo_cache_t;
+
+/****************************************************************************/
+
+ec_sdo_dict_t *ec_sdo_dict_alloc(uint32_t, uint32_t, uint32_t);
+ec_sdo_dict_t *ec_sdo_dict_get(ec_sdo_dict_t *);
+void ec_sdo_dict_put(ec_sdo_dict_t *);
+int ec_sdo_dict_compact(ec_sdo_dict_t *);
+ec_sdo_t *ec_sdo_dict_find(const ec_sdo_dict_t *, uint16_t);
+size_t ec_sdo_dict_export(const ec_sdo_dict_t *, uint8_t *, size_t);
+
+void ec_sdo_cache_init(ec_sdo_cache_t *, ec_master_t *);
+void ec_sdo_cache_clear(ec_sdo_cache_t *);
+
+ec_sdo_dict_t *ec_sdo_cache_find(ec_sdo_cache_t *, uint32_t, uint32_t,
+        uint32_t);
+void ec_sdo_cache_store(ec_sdo_cache_t *, ec_sdo_dict_t *);
+
+/****************************************************************************/
+
+#endif
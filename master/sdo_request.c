@@ -196,6 +196,15 @@ int ecrt_sdo_request_timeout(ec_sdo_request_t *req, uint32_t timeout)
 
 /****************************************************************************/
 
+int ecrt_sdo_request_complete_access(ec_sdo_request_t *req,
+        int complete_access)
+{
+    req->complete_access = complete_access ? 1 : 0;
+    return 0;
+}
+
+/****************************************************************************/
+
 uint8_t *ecrt_sdo_request_data(const ec_sdo_request_t *req)
 {
     return req->data;
@@ -245,6 +254,7 @@ int ecrt_sdo_request_write(ec_sdo_request_t *req)
 
 EXPORT_SYMBOL(ecrt_sdo_request_index);
 EXPORT_SYMBOL(ecrt_sdo_request_timeout);
+EXPORT_SYMBOL(ecrt_sdo_request_complete_access);
 EXPORT_SYMBOL(ecrt_sdo_request_data);
 EXPORT_SYMBOL(ecrt_sdo_request_data_size);
 EXPORT_SYMBOL(ecrt_sdo_request_state);
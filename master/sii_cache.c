@@ -0,0 +1,351 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT SII image cache.
+ *
+ * Images read during the slave scan are kept in memory, so that a rescan
+ * only has to read the identity words of each slave. Additionally, images
+ * can be provided persistently via the firmware loader, as raw SII dumps
+ * (like the output of 'ethercat sii_read') named
+ * ethercat/sii-<vendor>-<product>-<revision>-<serial>-<alias>.bin
+ * with the numbers in lower-case hexadecimal (8 digits, alias 4 digits).
+ */
+
+/****************************************************************************/
+
+#include <linux/module.h>
+#include <linux/slab.h>
+#include <linux/version.h>
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 14, 0)
+#include <linux/firmware.h>
+#define EC_SII_CACHE_FIRMWARE
+#endif
+
+#include "master.h"
+#include "sii_cache.h"
+
+/****************************************************************************/
+
+/** Number of SII bytes covered by the checksum.
+ */
+#define EC_SII_CHECKSUM_BYTES 14
+
+/****************************************************************************/
+
+/** Calculates the SII checksum.
+ *
+ * CRC-8 with polynomial x^8 + x^2 + x + 1 and initial value 0xff over the
+ * first 7 words.
+ *
+ * \return Checksum.
+ */
+static uint8_t ec_sii_cache_checksum(
+        const uint16_t *words /**< SII contents. */
+        )
+{
+    const uint8_t *data = (const uint8_t *) words;
+    uint8_t crc = 0xff;
+    unsigned int i, j;
+
+    for (i = 0; i < EC_SII_CHECKSUM_BYTES; i++) {
+        crc ^= data[i];
+        for (j = 0; j < 8; j++) {
+            if (crc & 0x80) {
+                crc = (crc << 1) ^ 0x07;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+/****************************************************************************/
+
+/** Validates the size and the checksum of an SII image.
+ *
+ * \retval 0 The image is valid.
+ * \retval -EINVAL Invalid size.
+ * \retval -EBADMSG Checksum mismatch.
+ */
+static int ec_sii_image_check(
+        const uint16_t *words, /**< SII contents. */
+        size_t nwords /**< Number of words. */
+        )
+{
+    if (nwords < EC_FIRST_SII_CATEGORY_OFFSET || nwords > EC_MAX_SII_SIZE) {
+        return -EINVAL;
+    }
+
+    if (ec_sii_cache_checksum(words) != EC_READ_U8(words + 0x0007)) {
+        return -EBADMSG;
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Checks, if an image matches the given identity words.
+ *
+ * \return Non-zero, if the image matches.
+ */
+static int ec_sii_image_matches(
+        const ec_sii_image_t *image, /**< SII image. */
+        const uint16_t *ident /**< Identity words. */
+        )
+{
+    return !memcmp(image->words + EC_SII_IDENT_OFFSET, ident,
+            EC_SII_IDENT_WORDS * 2);
+}
+
+/****************************************************************************/
+
+/** Removes an image from the cache and frees it.
+ */
+static void ec_sii_image_free(
+        ec_sii_image_t *image /**< SII image. */
+        )
+{
+    list_del(&image->list);
+    kfree(image->words);
+    kfree(image);
+}
+
+/****************************************************************************/
+
+/** Adds a copy of an SII image to the cache.
+ *
+ * \return Pointer to the new image, or NULL on error.
+ */
+static ec_sii_image_t *ec_sii_cache_add(
+        ec_sii_cache_t *cache, /**< SII cache. */
+        const uint16_t *words, /**< SII contents. */
+        size_t nwords /**< Number of words. */
+        )
+{
+    ec_sii_image_t *image;
+
+    if (!(image = kmalloc(sizeof(ec_sii_image_t), GFP_KERNEL))) {
+        EC_MASTER_ERR(cache->master, "Failed to allocate SII image.\n");
+        return NULL;
+    }
+
+    if (!(image->words = kmalloc(nwords * 2, GFP_KERNEL))) {
+        EC_MASTER_ERR(cache->master, "Failed to allocate %zu words"
+                " of cached SII data.\n", nwords);
+        kfree(image);
+        return NULL;
+    }
+
+    memcpy(image->words, words, nwords * 2);
+    image->nwords = nwords;
+    list_add_tail(&image->list, &cache->images);
+    return image;
+}
+
+/****************************************************************************/
+
+#ifdef EC_SII_CACHE_FIRMWARE
+
+/** Tries to load an SII image via the firmware loader.
+ *
+ * \return Pointer to the loaded image, or NULL if none is available.
+ */
+static ec_sii_image_t *ec_sii_cache_load(
+        ec_sii_cache_t *cache, /**< SII cache. */
+        const uint16_t *ident /**< Identity words. */
+        )
+{
+    ec_master_t *master = cache->master;
+    const struct firmware *fw;
+    const uint16_t *words;
+    ec_sii_image_t *image = NULL;
+    char name[64];
+    size_t nwords;
+    int ret;
+
+    snprintf(name, sizeof(name),
+            "ethercat/sii-%08x-%08x-%08x-%08x-%04x.bin",
+            EC_READ_U32(ident + 0x0008 - EC_SII_IDENT_OFFSET),
+            EC_READ_U32(ident + 0x000A - EC_SII_IDENT_OFFSET),
+            EC_READ_U32(ident + 0x000C - EC_SII_IDENT_OFFSET),
+            EC_READ_U32(ident + 0x000E - EC_SII_IDENT_OFFSET),
+            EC_READ_U16(ident));
+
+    if (request_firmware_direct(&fw, name, master->class_device)) {
+        return NULL;
+    }
+
+    words = (const uint16_t *) fw->data;
+    nwords = fw->size / 2;
+
+    ret = ec_sii_image_check(words, nwords);
+    if (fw->size % 2 || ret == -EINVAL) {
+        EC_MASTER_WARN(master, "Ignoring %s: Invalid size of %zu bytes.\n",
+                name, fw->size);
+        goto out_release;
+    }
+
+    if (memcmp(words + EC_SII_IDENT_OFFSET, ident, EC_SII_IDENT_WORDS * 2)) {
+        EC_MASTER_WARN(master, "Ignoring %s: Identity mismatch.\n", name);
+        goto out_release;
+    }
+
+    if (ret) {
+        EC_MASTER_WARN(master, "Ignoring %s: Checksum mismatch.\n", name);
+        goto out_release;
+    }
+
+    image = ec_sii_cache_add(cache, words, nwords);
+    if (image) {
+        EC_MASTER_DBG(master, 1, "Loaded SII image from %s.\n", name);
+    }
+
+out_release:
+    release_firmware(fw);
+    return image;
+}
+
+#endif
+
+/****************************************************************************/
+
+/** SII cache constructor.
+ */
+void ec_sii_cache_init(
+        ec_sii_cache_t *cache, /**< SII cache. */
+        ec_master_t *master /**< Parent master. */
+        )
+{
+    cache->master = master;
+    INIT_LIST_HEAD(&cache->images);
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+/****************************************************************************/
+
+/** SII cache destructor.
+ */
+void ec_sii_cache_clear(
+        ec_sii_cache_t *cache /**< SII cache. */
+        )
+{
+    ec_sii_image_t *image, *next;
+
+    list_for_each_entry_safe(image, next, &cache->images, list) {
+        ec_sii_image_free(image);
+    }
+}
+
+/****************************************************************************/
+
+/** Looks up an SII image by the identity words of a slave.
+ *
+ * If the image is not in memory, it is tried to be loaded via the firmware
+ * loader.
+ *
+ * \return Pointer to the image, or NULL on a cache miss.
+ */
+const ec_sii_image_t *ec_sii_cache_find(
+        ec_sii_cache_t *cache, /**< SII cache. */
+        const uint16_t *ident /**< Identity words. */
+        )
+{
+    ec_sii_image_t *image;
+
+    list_for_each_entry(image, &cache->images, list) {
+        if (ec_sii_image_matches(image, ident)) {
+            cache->hits++;
+            return image;
+        }
+    }
+
+#ifdef EC_SII_CACHE_FIRMWARE
+    if ((image = ec_sii_cache_load(cache, ident))) {
+        cache->hits++;
+        return image;
+    }
+#endif
+
+    cache->misses++;
+    return NULL;
+}
+
+/****************************************************************************/
+
+/** Stores a copy of a complete SII image.
+ *
+ * An existing image with the same identity is replaced. Images with an
+ * invalid size or checksum are rejected, because the cache would hand them
+ * out to every slave with the same identity.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_sii_cache_store(
+        ec_sii_cache_t *cache, /**< SII cache. */
+        const uint16_t *words, /**< SII contents. */
+        size_t nwords /**< Number of words. */
+        )
+{
+    int ret;
+
+    if ((ret = ec_sii_image_check(words, nwords))) {
+        EC_MASTER_DBG(cache->master, 1, "Not caching SII image with %zu"
+                " words: %s.\n", nwords,
+                ret == -EINVAL ? "Invalid size" : "Checksum mismatch");
+        return ret;
+    }
+
+    ec_sii_cache_invalidate(cache, words + EC_SII_IDENT_OFFSET);
+
+    if (!ec_sii_cache_add(cache, words, nwords)) {
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Removes the image with the given identity words from the cache.
+ *
+ * This has to be called, when the SII contents of a slave are modified.
+ */
+void ec_sii_cache_invalidate(
+        ec_sii_cache_t *cache, /**< SII cache. */
+        const uint16_t *ident /**< Identity words. */
+        )
+{
+    ec_sii_image_t *image, *next;
+
+    list_for_each_entry_safe(image, next, &cache->images, list) {
+        if (ec_sii_image_matches(image, ident)) {
+            ec_sii_image_free(image);
+        }
+    }
+}
+
+/****************************************************************************/
@@ -0,0 +1,85 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ ****************************************************************************/
+
+/**
+   \file
+   EtherCAT SII image cache.
+*/
+
+/****************************************************************************/
+
+#ifndef __EC_SII_CACHE_H__
+#define __EC_SII_CACHE_H__
+
+#include <linux/list.h>
+
+#include "globals.h"
+
+/****************************************************************************/
+
+/** Word offset of the slave identity in the SII.
+ *
+ * The identity covers the configured station alias (word 0x0004), the
+ * checksum (word 0x0007), vendor ID, product code, revision number and
+ * serial number (words 0x0008 to 0x000F).
+ */
+#define EC_SII_IDENT_OFFSET 0x0004
+
+/** Number of words of the slave identity in the SII.
+ */
+#define EC_SII_IDENT_WORDS 12
+
+/****************************************************************************/
+
+/** Cached SII image.
+ */
+typedef struct {
+    struct list_head list; /**< List item. */
+    uint16_t *words; /**< SII contents. */
+    size_t nwords; /**< Number of words. */
+} ec_sii_image_t;
+
+/****************************************************************************/
+
+/** SII image cache.
+ *
+ * Images are looked up by the identity words of the SII. Access is
+ * serialized by the master semaphore.
+ */
+typedef struct {
+    ec_master_t *master; /**< Parent master. */
+    struct list_head images; /**< List of cached images. */
+    unsigned int hits; /**< Number of cache hits. */
+    unsigned int misses; /**< Number of cache misses. */
+} ec_sii_cache_t;
+
+/****************************************************************************/
+
+void ec_sii_cache_init(ec_sii_cache_t *, ec_master_t *);
+void ec_sii_cache_clear(ec_sii_cache_t *);
+
+const ec_sii_image_t *ec_sii_cache_find(ec_sii_cache_t *, const uint16_t *);
+int ec_sii_cache_store(ec_sii_cache_t *, const uint16_t *, size_t);
+void ec_sii_cache_invalidate(ec_sii_cache_t *, const uint16_t *);
+
+/****************************************************************************/
+
+#endif
@@ -49,6 +49,7 @@ unsigned int ec_slave_get_previous_port(const ec_slave_t *, unsigned int);
 unsigned int ec_slave_get_next_port(const ec_slave_t *, unsigned int);
 uint32_t ec_slave_calc_rtt_sum(const ec_slave_t *);
 ec_slave_t *ec_slave_find_next_dc_slave(ec_slave_t *);
+int ec_slave_state_is_running(ec_slave_state_t);
 
 /****************************************************************************/
 
@@ -78,6 +79,9 @@ void ec_slave_init(
     slave->current_state = EC_SLAVE_STATE_UNKNOWN;
     slave->error_flag = 0;
     slave->force_config = 0;
+    slave->op_deferred = 0;
+    slave->pdo_conf_valid = 0;
+    slave->mbox_status_mapped = 0;
     slave->configured_rx_mailbox_offset = 0x0000;
     slave->configured_rx_mailbox_size = 0x0000;
     slave->configured_tx_mailbox_offset = 0x0000;
@@ -144,7 +148,7 @@ void ec_slave_init(
 
     INIT_LIST_HEAD(&slave->sii.pdos);
 
-    INIT_LIST_HEAD(&slave->sdo_dictionary);
+    slave->sdo_dict = NULL;
 
     slave->sdo_dictionary_fetched = 0;
     slave->jiffies_preop = 0;
@@ -168,8 +172,6 @@ void ec_slave_init(
 
 void ec_slave_clear(ec_slave_t *slave /**< EtherCAT slave */)
 {
-    ec_sdo_t *sdo, *next_sdo;
-    unsigned int i;
     ec_pdo_t *pdo, *next_pdo;
 
     // abort all pending requests
@@ -227,18 +229,15 @@ void ec_slave_clear(ec_slave_t *slave /**< EtherCAT slave */)
         ec_slave_config_detach(slave->config);
     }
 
-    // free all SDOs
-    list_for_each_entry_safe(sdo, next_sdo, &slave->sdo_dictionary, list) {
-        list_del(&sdo->list);
-        ec_sdo_clear(sdo);
-        kfree(sdo);
+    // release the SDO dictionary
+    if (slave->sdo_dict) {
+        ec_sdo_dict_put(slave->sdo_dict);
+        slave->sdo_dict = NULL;
     }
 
     // free all strings
     if (slave->sii.strings) {
-        for (i = 0; i < slave->sii.string_count; i++)
-            kfree(slave->sii.strings[i]);
-        kfree(slave->sii.strings);
+        kfree(slave->sii.strings); // pointers and strings
     }
 
     // free all sync managers
@@ -277,6 +276,21 @@ void ec_slave_clear_sync_managers(ec_slave_t *slave /**< EtherCAT slave. */)
 
 /****************************************************************************/
 
+/** Checks, if a slave state is PREOP, SAFEOP or OP.
+ *
+ * \return Non-zero, if the slave is at least in PREOP.
+ */
+int ec_slave_state_is_running(
+        ec_slave_state_t state /**< Application state. */
+        )
+{
+    state &= EC_SLAVE_STATE_MASK;
+    return state == EC_SLAVE_STATE_PREOP || state == EC_SLAVE_STATE_SAFEOP
+        || state == EC_SLAVE_STATE_OP;
+}
+
+/****************************************************************************/
+
 /**
  * Sets the application state of a slave.
  */
@@ -293,12 +307,60 @@ void ec_slave_set_state(ec_slave_t *slave, /**< EtherCAT slave */
             ec_state_string(new_state, cur_state, 0);
             EC_SLAVE_DBG(slave, 0, "%s -> %s.\n", old_state, cur_state);
         }
+
+        // a slave falling back to INIT or BOOT on its own may have reset
+        // its PDO configuration
+        if (ec_slave_state_is_running(slave->current_state)
+                && !ec_slave_state_is_running(new_state)) {
+            slave->pdo_conf_valid = 0;
+        }
+
         slave->current_state = new_state;
     }
 }
 
 /****************************************************************************/
 
+/** Notifies the slave about an SDO download.
+ *
+ * Writing a PDO mapping or PDO assignment object makes the PDO configuration
+ * known by the master invalid, so that it is written again on the next
+ * configuration.
+ */
+void ec_slave_sdo_download(
+        ec_slave_t *slave, /**< EtherCAT slave */
+        uint16_t index /**< SDO index. */
+        )
+{
+    if ((index >= 0x1600 && index <= 0x1BFF)
+            || (index >= 0x1C10 && index <= 0x1C2F)) {
+        slave->pdo_conf_valid = 0;
+    }
+}
+
+/****************************************************************************/
+
+/** Applies the contents of the DL status register to the port links.
+ */
+void ec_slave_set_dl_status(
+        ec_slave_t *slave, /**< EtherCAT slave */
+        uint16_t dl_status /**< Contents of the DL status register. */
+        )
+{
+    unsigned int i;
+
+    for (i = 0; i < EC_MAX_PORTS; i++) {
+        slave->ports[i].link.link_up =
+            dl_status & (1 << (4 + i)) ? 1 : 0;
+        slave->ports[i].link.loop_closed =
+            dl_status & (1 << (8 + i * 2)) ? 1 : 0;
+        slave->ports[i].link.signal_detected =
+            dl_status & (1 << (9 + i * 2)) ? 1 : 0;
+    }
+}
+
+/****************************************************************************/
+
 /**
  * Request a slave state and resets the error flag.
  */
@@ -315,7 +377,10 @@ void ec_slave_request_state(ec_slave_t *slave, /**< EtherCAT slave */
 
 /**
    Fetches data from a STRING category.
-   \todo range checking
+
+   The string pointers and the strings are stored in a single memory block.
+   Strings exceeding the category are dropped.
+
    \return 0 in case of success, else < 0
 */
 
@@ -325,47 +390,50 @@ int ec_slave_fetch_sii_strings(
         size_t data_size /**< number of bytes */
         )
 {
-    int i, err;
-    size_t size;
+    unsigned int i, count;
+    size_t size, total = 0;
     off_t offset;
+    char *string;
 
-    slave->sii.string_count = data[0];
+    if (!data_size) {
+        return 0;
+    }
 
-    if (slave->sii.string_count) {
-        if (!(slave->sii.strings =
-                    kmalloc(sizeof(char *) * slave->sii.string_count,
-                        GFP_KERNEL))) {
-            EC_SLAVE_ERR(slave, "Failed to allocate string array memory.\n");
-            err = -ENOMEM;
-            goto out_zero;
+    // determine the number of complete strings and their total size
+    offset = 1;
+    for (count = 0; count < data[0]; count++) {
+        if (offset >= data_size || offset + 1 + data[offset] > data_size) {
+            EC_SLAVE_WARN(slave, "String category truncated after"
+                    " %u of %u strings.\n", count, data[0]);
+            break;
         }
+        total += data[offset] + 1;
+        offset += 1 + data[offset];
+    }
 
-        offset = 1;
-        for (i = 0; i < slave->sii.string_count; i++) {
-            size = data[offset];
-            // allocate memory for string structure and data at a single blow
-            if (!(slave->sii.strings[i] =
-                        kmalloc(sizeof(char) * size + 1, GFP_KERNEL))) {
-                EC_SLAVE_ERR(slave, "Failed to allocate string memory.\n");
-                err = -ENOMEM;
-                goto out_free;
-            }
-            memcpy(slave->sii.strings[i], data + offset + 1, size);
-            slave->sii.strings[i][size] = 0x00; // append binary zero
-            offset += 1 + size;
-        }
+    if (!count) {
+        return 0;
     }
 
-    return 0;
+    if (!(slave->sii.strings = kmalloc(sizeof(char *) * count + total,
+                    GFP_KERNEL))) {
+        EC_SLAVE_ERR(slave, "Failed to allocate string memory.\n");
+        return -ENOMEM;
+    }
 
-out_free:
-    for (i--; i >= 0; i--)
-        kfree(slave->sii.strings[i]);
-    kfree(slave->sii.strings);
-    slave->sii.strings = NULL;
-out_zero:
-    slave->sii.string_count = 0;
-    return err;
+    string = (char *) (slave->sii.strings + count);
+    offset = 1;
+    for (i = 0; i < count; i++) {
+        size = data[offset];
+        slave->sii.strings[i] = string;
+        memcpy(string, data + offset + 1, size);
+        string[size] = 0x00; // append binary zero
+        string += size + 1;
+        offset += 1 + size;
+    }
+
+    slave->sii.string_count = count;
+    return 0;
 }
 
 /****************************************************************************/
@@ -625,7 +693,13 @@ void ec_slave_sdo_dict_info(const ec_slave_t *slave, /**< EtherCAT slave */
     ec_sdo_t *sdo;
     ec_sdo_entry_t *entry;
 
-    list_for_each_entry(sdo, &slave->sdo_dictionary, list) {
+    if (!slave->sdo_dict) {
+        *sdo_count = 0;
+        *entry_count = 0;
+        return;
+    }
+
+    list_for_each_entry(sdo, &slave->sdo_dict->sdos, list) {
         sdos++;
         list_for_each_entry(entry, &sdo->entries, list) {
             entries++;
@@ -648,15 +722,11 @@ ec_sdo_t *ec_slave_get_sdo(
         uint16_t index /**< SDO index */
         )
 {
-    ec_sdo_t *sdo;
-
-    list_for_each_entry(sdo, &slave->sdo_dictionary, list) {
-        if (sdo->index != index)
-            continue;
-        return sdo;
+    if (!slave->sdo_dict) {
+        return NULL;
     }
 
-    return NULL;
+    return ec_sdo_dict_find(slave->sdo_dict, index);
 }
 
 /****************************************************************************/
@@ -674,15 +744,11 @@ const ec_sdo_t *ec_slave_get_sdo_const(
         uint16_t index /**< SDO index */
         )
 {
-    const ec_sdo_t *sdo;
-
-    list_for_each_entry(sdo, &slave->sdo_dictionary, list) {
-        if (sdo->index != index)
-            continue;
-        return sdo;
+    if (!slave->sdo_dict) {
+        return NULL;
     }
 
-    return NULL;
+    return ec_sdo_dict_find(slave->sdo_dict, index);
 }
 
 /****************************************************************************/
@@ -698,7 +764,16 @@ const ec_sdo_t *ec_slave_get_sdo_by_pos_const(
 {
     const ec_sdo_t *sdo;
 
-    list_for_each_entry(sdo, &slave->sdo_dictionary, list) {
+    if (!slave->sdo_dict) {
+        return NULL;
+    }
+
+    if (slave->sdo_dict->arena) {
+        return sdo_position < slave->sdo_dict->sdo_count ?
+            &slave->sdo_dict->sdo_array[sdo_position] : NULL;
+    }
+
+    list_for_each_entry(sdo, &slave->sdo_dict->sdos, list) {
         if (sdo_position--)
             continue;
         return sdo;
@@ -720,7 +795,15 @@ uint16_t ec_slave_sdo_count(
     const ec_sdo_t *sdo;
     uint16_t count = 0;
 
-    list_for_each_entry(sdo, &slave->sdo_dictionary, list) {
+    if (!slave->sdo_dict) {
+        return 0;
+    }
+
+    if (slave->sdo_dict->arena) {
+        return slave->sdo_dict->sdo_count;
+    }
+
+    list_for_each_entry(sdo, &slave->sdo_dict->sdos, list) {
         count++;
     }
 
@@ -766,20 +849,24 @@ void ec_slave_find_names_for_pdo(
     ec_pdo_entry_t *pdo_entry;
     const ec_sdo_entry_t *sdo_entry;
 
-    list_for_each_entry(sdo, &slave->sdo_dictionary, list) {
-        if (sdo->index == pdo->index) {
-            ec_pdo_set_name(pdo, sdo->name);
-        } else {
-            list_for_each_entry(pdo_entry, &pdo->entries, list) {
-                if (sdo->index == pdo_entry->index) {
-                    sdo_entry = ec_sdo_get_entry_const(
-                            sdo, pdo_entry->subindex);
-                    if (sdo_entry) {
-                        ec_pdo_entry_set_name(pdo_entry,
-                                sdo_entry->description);
-                    }
-                }
-            }
+    if (!slave->sdo_dict) {
+        return;
+    }
+
+    if ((sdo = ec_sdo_dict_find(slave->sdo_dict, pdo->index))) {
+        ec_pdo_set_name(pdo, sdo->name);
+    }
+
+    list_for_each_entry(pdo_entry, &pdo->entries, list) {
+        if (pdo_entry->index == pdo->index
+                || !(sdo = ec_sdo_dict_find(slave->sdo_dict,
+                        pdo_entry->index))) {
+            continue;
+        }
+
+        sdo_entry = ec_sdo_get_entry_const(sdo, pdo_entry->subindex);
+        if (sdo_entry) {
+            ec_pdo_entry_set_name(pdo_entry, sdo_entry->description);
         }
     }
 }
@@ -37,6 +37,7 @@
 #include "pdo.h"
 #include "sync.h"
 #include "sdo.h"
+#include "sdo_cache.h"
 #include "fsm_slave.h"
 
 /****************************************************************************/
@@ -184,6 +185,13 @@ struct ec_slave
     ec_slave_state_t current_state; /**< Current application state. */
     unsigned int error_flag; /**< Stop processing after an error. */
     unsigned int force_config; /**< Force (re-)configuration. */
+    unsigned int op_deferred; /**< The slave waits in SAFEOP for a grouped
+                                transition to OP. */
+    unsigned int pdo_conf_valid; /**< The PDO assignment and mapping in the
+                                   slave are known to match the last ones
+                                   written by the master. */
+    unsigned int mbox_status_mapped; /**< The SM1 status is mapped into the
+                                       master's mailbox status image. */
     uint16_t configured_rx_mailbox_offset; /**< Configured receive mailbox
                                              offset. */
     uint16_t configured_rx_mailbox_size; /**< Configured receive mailbox size.
@@ -214,7 +222,7 @@ struct ec_slave
     // Slave information interface
     ec_sii_t sii; /**< Extracted SII data. */
 
-    struct list_head sdo_dictionary; /**< SDO dictionary list */
+    ec_sdo_dict_t *sdo_dict; /**< SDO dictionary, or NULL. */
     uint8_t sdo_dictionary_fetched; /**< Dictionary has been fetched. */
     unsigned long jiffies_preop; /**< Time, the slave went to PREOP. */
 
@@ -238,6 +246,8 @@ void ec_slave_clear_sync_managers(ec_slave_t *);
 
 void ec_slave_request_state(ec_slave_t *, ec_slave_state_t);
 void ec_slave_set_state(ec_slave_t *, ec_slave_state_t);
+void ec_slave_sdo_download(ec_slave_t *, uint16_t);
+void ec_slave_set_dl_status(ec_slave_t *, uint16_t);
 
 // SII categories
 int ec_slave_fetch_sii_strings(ec_slave_t *, const uint8_t *, size_t);
@@ -314,15 +314,18 @@ void ec_slave_config_detach(
         )
 {
     if (sc->slave) {
+        ec_fsm_slave_t *fsm = &sc->slave->fsm;
         ec_reg_request_t *reg;
+        unsigned int i;
 
         sc->slave->config = NULL;
 
-        // invalidate processing register request
+        // invalidate processing register requests
         list_for_each_entry(reg, &sc->reg_requests, list) {
-            if (sc->slave->fsm.reg_request == reg) {
-                sc->slave->fsm.reg_request = NULL;
-                break;
+            for (i = 0; i < fsm->reg_count; i++) {
+                if (fsm->reg_requests[i] == reg) {
+                    fsm->reg_requests[i] = NULL;
+                }
             }
         }
 
@@ -1015,6 +1018,63 @@ int ecrt_slave_config_reg_pdo_entry_pos(
 
 /****************************************************************************/
 
+int ecrt_slave_config_reg_pdo(
+        ec_slave_config_t *sc,
+        uint16_t pdo_index,
+        ec_domain_t *domain,
+        unsigned int *size
+        )
+{
+    uint8_t sync_index;
+    const ec_sync_config_t *sync_config;
+    unsigned int bit_offset, bit_length;
+    ec_pdo_t *pdo;
+    ec_pdo_entry_t *entry;
+    int sync_offset;
+
+    EC_CONFIG_DBG(sc, 1, "%s(sc = 0x%p, pdo_index = 0x%04X,"
+            " domain = 0x%p, size = 0x%p)\n",
+            __func__, sc, pdo_index, domain, size);
+
+    for (sync_index = 0; sync_index < EC_MAX_SYNC_MANAGERS; sync_index++) {
+        sync_config = &sc->sync_configs[sync_index];
+        bit_offset = 0;
+
+        list_for_each_entry(pdo, &sync_config->pdos.list, list) {
+            bit_length = 0;
+            list_for_each_entry(entry, &pdo->entries, list) {
+                bit_length += entry->bit_length;
+            }
+
+            if (pdo->index != pdo_index) {
+                bit_offset += bit_length;
+                continue;
+            }
+
+            if (bit_offset % 8) {
+                EC_CONFIG_ERR(sc, "PDO 0x%04X does not byte-align.\n",
+                        pdo_index);
+                return -EFAULT;
+            }
+
+            sync_offset = ec_slave_config_prepare_fmmu(
+                    sc, domain, sync_index, sync_config->dir);
+            if (sync_offset < 0)
+                return sync_offset;
+
+            if (size) {
+                *size = (bit_length + 7) / 8;
+            }
+            return sync_offset + bit_offset / 8;
+        }
+    }
+
+    EC_CONFIG_ERR(sc, "PDO 0x%04X is not assigned.\n", pdo_index);
+    return -ENOENT;
+}
+
+/****************************************************************************/
+
 int ecrt_slave_config_dc(ec_slave_config_t *sc, uint16_t assign_activate,
         uint32_t sync0_cycle_time, int32_t sync0_shift_time,
         uint32_t sync1_cycle_time, int32_t sync1_shift_time)
@@ -1620,6 +1680,7 @@ EXPORT_SYMBOL(ecrt_slave_config_pdo_mapping_clear);
 EXPORT_SYMBOL(ecrt_slave_config_pdos);
 EXPORT_SYMBOL(ecrt_slave_config_reg_pdo_entry);
 EXPORT_SYMBOL(ecrt_slave_config_reg_pdo_entry_pos);
+EXPORT_SYMBOL(ecrt_slave_config_reg_pdo);
 EXPORT_SYMBOL(ecrt_slave_config_dc);
 EXPORT_SYMBOL(ecrt_slave_config_sdo);
 EXPORT_SYMBOL(ecrt_slave_config_sdo8);
@@ -0,0 +1,452 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT warm-start snapshot methods.
+ */
+
+/****************************************************************************/
+
+#include <linux/slab.h>
+#include <linux/version.h>
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(3, 14, 0)
+#include <linux/firmware.h>
+#define EC_SNAPSHOT_FIRMWARE
+#endif
+
+#include "master.h"
+#include "slave.h"
+#include "snapshot.h"
+
+/****************************************************************************/
+
+/** Frees the slave information of a snapshot.
+ */
+static void ec_snapshot_discard(
+        ec_snapshot_t *snapshot /**< Warm-start snapshot. */
+        )
+{
+    if (snapshot->slaves) {
+        kfree(snapshot->slaves);
+        snapshot->slaves = NULL;
+    }
+
+    snapshot->slave_count = 0;
+    snapshot->mismatch = 0;
+}
+
+/****************************************************************************/
+
+/** Parses a snapshot.
+ *
+ * The SII images of the snapshot are stored in the SII cache.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+static int ec_snapshot_parse(
+        ec_snapshot_t *snapshot, /**< Warm-start snapshot. */
+        const uint8_t *data, /**< Snapshot data. */
+        size_t size /**< Size of the snapshot data. */
+        )
+{
+    ec_snapshot_slave_t *s;
+    const uint8_t *rec = data + EC_SNAPSHOT_HEADER_SIZE;
+    const uint8_t *end = data + size;
+    unsigned int count, i, j;
+    size_t nwords;
+
+    if (size < EC_SNAPSHOT_HEADER_SIZE
+            || EC_READ_U32(data) != EC_SNAPSHOT_MAGIC
+            || EC_READ_U16(data + 4) != EC_SNAPSHOT_VERSION) {
+        return -EINVAL;
+    }
+
+    count = EC_READ_U16(data + 6);
+    if (!count) {
+        return -EINVAL;
+    }
+
+    if (!(snapshot->slaves =
+                kmalloc(sizeof(ec_snapshot_slave_t) * count, GFP_KERNEL))) {
+        EC_MASTER_ERR(snapshot->master, "Failed to allocate memory"
+                " for %u snapshot slaves.\n", count);
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (end - rec < EC_SNAPSHOT_SLAVE_SIZE) {
+            goto out_invalid;
+        }
+
+        s = snapshot->slaves + i;
+        s->device_index = EC_READ_U8(rec);
+        s->ring_position = EC_READ_U16(rec + 2);
+        memcpy(s->ident, rec + 4, EC_SII_IDENT_WORDS * 2);
+        s->base_type = EC_READ_U8(rec + 28);
+        s->base_revision = EC_READ_U8(rec + 29);
+        s->base_build = EC_READ_U16(rec + 30);
+        s->base_fmmu_count = EC_READ_U8(rec + 32);
+        s->base_sync_count = EC_READ_U8(rec + 33);
+        s->base_fmmu_bit_operation = EC_READ_U8(rec + 34);
+        s->base_dc_supported = EC_READ_U8(rec + 35);
+        s->base_dc_range = EC_READ_U8(rec + 36);
+        s->has_dc_system_time = EC_READ_U8(rec + 37);
+        s->dl_status = EC_READ_U16(rec + 38);
+        for (j = 0; j < EC_MAX_PORTS; j++) {
+            s->receive_time[j] = EC_READ_U32(rec + 40 + 4 * j);
+        }
+        nwords = EC_READ_U32(rec + 56);
+        rec += EC_SNAPSHOT_SLAVE_SIZE;
+
+        if (s->device_index >= EC_MAX_NUM_DEVICES
+                || nwords > EC_MAX_SII_SIZE || end - rec < nwords * 2) {
+            goto out_invalid;
+        }
+
+#ifdef EC_SII_CACHE
+        if (nwords >= EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS
+                && !memcmp(rec + EC_SII_IDENT_OFFSET * 2, s->ident,
+                    EC_SII_IDENT_WORDS * 2)) {
+            ec_sii_cache_store(&snapshot->master->sii_cache,
+                    (const uint16_t *) rec, nwords);
+        }
+#endif
+
+        rec += nwords * 2;
+    }
+
+    snapshot->slave_count = count;
+    return 0;
+
+out_invalid:
+    kfree(snapshot->slaves);
+    snapshot->slaves = NULL;
+    return -EINVAL;
+}
+
+/****************************************************************************/
+
+#ifdef EC_SNAPSHOT_FIRMWARE
+
+/** Tries to load the snapshot via the firmware loader.
+ */
+static void ec_snapshot_load(
+        ec_snapshot_t *snapshot /**< Warm-start snapshot. */
+        )
+{
+    ec_master_t *master = snapshot->master;
+    const struct firmware *fw;
+    char name[32];
+
+    snprintf(name, sizeof(name), "ethercat/snapshot-%u.bin", master->index);
+
+    if (request_firmware_direct(&fw, name, master->class_device)) {
+        return;
+    }
+
+    if (ec_snapshot_parse(snapshot, fw->data, fw->size)) {
+        EC_MASTER_WARN(master, "Ignoring %s: Invalid contents.\n", name);
+    } else {
+        EC_MASTER_INFO(master, "Loaded snapshot of %u slaves from %s.\n",
+                snapshot->slave_count, name);
+    }
+
+    release_firmware(fw);
+}
+
+#endif
+
+/****************************************************************************/
+
+/** Returns the snapshot information of a slave.
+ *
+ * \return Slave information, or NULL if there is none.
+ */
+static const ec_snapshot_slave_t *ec_snapshot_find(
+        const ec_snapshot_t *snapshot, /**< Warm-start snapshot. */
+        const ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    const ec_snapshot_slave_t *s;
+    unsigned int index = slave - snapshot->master->slaves;
+
+    if (snapshot->mismatch || index >= snapshot->slave_count) {
+        return NULL;
+    }
+
+    s = snapshot->slaves + index;
+    if (s->device_index != slave->device_index
+            || s->ring_position != slave->ring_position) {
+        return NULL;
+    }
+
+    return s;
+}
+
+/****************************************************************************/
+
+/** Snapshot constructor.
+ */
+void ec_snapshot_init(
+        ec_snapshot_t *snapshot, /**< Warm-start snapshot. */
+        ec_master_t *master /**< Parent master. */
+        )
+{
+    snapshot->master = master;
+    snapshot->slaves = NULL;
+    snapshot->slave_count = 0;
+    snapshot->loaded = 0;
+    snapshot->mismatch = 0;
+}
+
+/****************************************************************************/
+
+/** Snapshot destructor.
+ */
+void ec_snapshot_clear(
+        ec_snapshot_t *snapshot /**< Warm-start snapshot. */
+        )
+{
+    ec_snapshot_discard(snapshot);
+}
+
+/****************************************************************************/
+
+/** Prepares a bus scan with the snapshot.
+ *
+ * The snapshot is loaded before the first bus scan. It is discarded, if
+ * the number of slaves per device does not match the bus.
+ */
+void ec_snapshot_start(
+        ec_snapshot_t *snapshot /**< Warm-start snapshot. */
+        )
+{
+    ec_master_t *master = snapshot->master;
+    unsigned int i;
+
+    if (!snapshot->loaded) {
+        snapshot->loaded = 1;
+#ifdef EC_SNAPSHOT_FIRMWARE
+        ec_snapshot_load(snapshot);
+#endif
+    }
+
+    if (!snapshot->slave_count) {
+        return;
+    }
+
+    snapshot->mismatch = 0;
+
+    if (snapshot->slave_count == master->slave_count) {
+        for (i = 0; i < snapshot->slave_count; i++) {
+            if (snapshot->slaves[i].device_index
+                    != master->slaves[i].device_index
+                    || snapshot->slaves[i].ring_position
+                    != master->slaves[i].ring_position) {
+                break;
+            }
+        }
+        if (i == snapshot->slave_count) {
+            return;
+        }
+    }
+
+    EC_MASTER_INFO(master, "Snapshot does not match the bus topology.\n");
+    ec_snapshot_discard(snapshot);
+}
+
+/****************************************************************************/
+
+/** Adopts the DC and data link information of a slave from the snapshot.
+ *
+ * This is only done, if the base information read from the slave matches
+ * the snapshot.
+ *
+ * \return Non-zero, if the information was adopted.
+ */
+int ec_snapshot_adopt(
+        ec_snapshot_t *snapshot, /**< Warm-start snapshot. */
+        ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    const ec_snapshot_slave_t *s;
+    unsigned int i;
+
+    if (!(s = ec_snapshot_find(snapshot, slave))) {
+        return 0;
+    }
+
+    if (s->base_type != slave->base_type
+            || s->base_revision != slave->base_revision
+            || s->base_build != slave->base_build
+            || s->base_fmmu_count != slave->base_fmmu_count
+            || s->base_sync_count != slave->base_sync_count
+            || s->base_fmmu_bit_operation != slave->base_fmmu_bit_operation
+            || s->base_dc_supported != slave->base_dc_supported
+            || s->base_dc_range != slave->base_dc_range) {
+        EC_SLAVE_WARN(slave, "Base information does not match"
+                " the snapshot.\n");
+        snapshot->mismatch = 1;
+        return 0;
+    }
+
+    slave->has_dc_system_time = s->has_dc_system_time;
+    for (i = 0; i < EC_MAX_PORTS; i++) {
+        slave->ports[i].receive_time = s->receive_time[i];
+    }
+    ec_slave_set_dl_status(slave, s->dl_status);
+    return 1;
+}
+
+/****************************************************************************/
+
+/** Verifies the SII identity of a slave against the snapshot.
+ *
+ * The identity covers the alias, vendor ID, product code, revision number
+ * and serial number.
+ */
+void ec_snapshot_verify(
+        ec_snapshot_t *snapshot, /**< Warm-start snapshot. */
+        const ec_slave_t *slave /**< EtherCAT slave. */
+        )
+{
+    const ec_snapshot_slave_t *s;
+
+    if (!(s = ec_snapshot_find(snapshot, slave))) {
+        return;
+    }
+
+    if (slave->sii_nwords < EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS
+            || memcmp(s->ident, slave->sii_words + EC_SII_IDENT_OFFSET,
+                EC_SII_IDENT_WORDS * 2)) {
+        EC_SLAVE_WARN(slave, "Identity does not match the snapshot.\n");
+        snapshot->mismatch = 1;
+    }
+}
+
+/****************************************************************************/
+
+/** Finishes a bus scan with the snapshot.
+ *
+ * The snapshot is only used for one bus scan and is discarded afterwards.
+ *
+ * \return Non-zero, if the bus has to be scanned again without the
+ *         snapshot.
+ */
+int ec_snapshot_finish(
+        ec_snapshot_t *snapshot /**< Warm-start snapshot. */
+        )
+{
+    ec_master_t *master = snapshot->master;
+    int rescan = snapshot->mismatch;
+
+    if (!snapshot->slave_count) {
+        return 0;
+    }
+
+    if (rescan) {
+        EC_MASTER_WARN(master, "Bus does not match the snapshot."
+                " Rescanning.\n");
+    } else {
+        EC_MASTER_INFO(master, "Adopted snapshot of %u slaves.\n",
+                snapshot->slave_count);
+    }
+
+    ec_snapshot_discard(snapshot);
+    return rescan;
+}
+
+/****************************************************************************/
+
+/** Exports a snapshot of the current slaves.
+ *
+ * If \a data is NULL or \a size is too small, only the required size is
+ * determined.
+ *
+ * \return Size of the snapshot in bytes.
+ */
+size_t ec_snapshot_export(
+        ec_master_t *master, /**< EtherCAT master. */
+        uint8_t *data, /**< Target memory, or NULL. */
+        size_t size /**< Size of the target memory. */
+        )
+{
+    const ec_slave_t *slave;
+    size_t length = EC_SNAPSHOT_HEADER_SIZE;
+    uint8_t *rec;
+    uint16_t dl_status;
+    unsigned int i;
+
+    for (slave = master->slaves;
+            slave < master->slaves + master->slave_count; slave++) {
+        length += EC_SNAPSHOT_SLAVE_SIZE + slave->sii_nwords * 2;
+    }
+
+    if (!data || size < length) {
+        return length;
+    }
+
+    EC_WRITE_U32(data, EC_SNAPSHOT_MAGIC);
+    EC_WRITE_U16(data + 4, EC_SNAPSHOT_VERSION);
+    EC_WRITE_U16(data + 6, master->slave_count);
+    rec = data + EC_SNAPSHOT_HEADER_SIZE;
+
+    for (slave = master->slaves;
+            slave < master->slaves + master->slave_count; slave++) {
+        memset(rec, 0, EC_SNAPSHOT_SLAVE_SIZE);
+        EC_WRITE_U8(rec, slave->device_index);
+        EC_WRITE_U16(rec + 2, slave->ring_position);
+        if (slave->sii_nwords >= EC_SII_IDENT_OFFSET + EC_SII_IDENT_WORDS) {
+            memcpy(rec + 4, slave->sii_words + EC_SII_IDENT_OFFSET,
+                    EC_SII_IDENT_WORDS * 2);
+        }
+        EC_WRITE_U8(rec + 28, slave->base_type);
+        EC_WRITE_U8(rec + 29, slave->base_revision);
+        EC_WRITE_U16(rec + 30, slave->base_build);
+        EC_WRITE_U8(rec + 32, slave->base_fmmu_count);
+        EC_WRITE_U8(rec + 33, slave->base_sync_count);
+        EC_WRITE_U8(rec + 34, slave->base_fmmu_bit_operation);
+        EC_WRITE_U8(rec + 35, slave->base_dc_supported);
+        EC_WRITE_U8(rec + 36, slave->base_dc_range);
+        EC_WRITE_U8(rec + 37, slave->has_dc_system_time);
+
+        dl_status = 0;
+        for (i = 0; i < EC_MAX_PORTS; i++) {
+            dl_status |= slave->ports[i].link.link_up << (4 + i);
+            dl_status |= slave->ports[i].link.loop_closed << (8 + i * 2);
+            dl_status |= slave->ports[i].link.signal_detected << (9 + i * 2);
+            EC_WRITE_U32(rec + 40 + 4 * i, slave->ports[i].receive_time);
+        }
+        EC_WRITE_U16(rec + 38, dl_status);
+
+        EC_WRITE_U32(rec + 56, slave->sii_nwords);
+        rec += EC_SNAPSHOT_SLAVE_SIZE;
+        memcpy(rec, slave->sii_words, slave->sii_nwords * 2);
+        rec += slave->sii_nwords * 2;
+    }
+
+    return length;
+}
+
+/****************************************************************************/
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT warm-start snapshot.
+ */
+
+/****************************************************************************/
+
+#ifndef __EC_SNAPSHOT_H__
+#define __EC_SNAPSHOT_H__
+
+#include "globals.h"
+#include "sii_cache.h"
+
+/****************************************************************************/
+
+/** Magic number at the beginning of a snapshot ("ECSN").
+ */
+#define EC_SNAPSHOT_MAGIC 0x4e534345
+
+/** Version of the snapshot format.
+ */
+#define EC_SNAPSHOT_VERSION 1
+
+/** Size of the snapshot header in bytes.
+ *
+ * The header consists of the magic number (32 bit), the format version (16
+ * bit) and the number of slaves (16 bit).
+ */
+#define EC_SNAPSHOT_HEADER_SIZE 8
+
+/** Size of a slave record in bytes, without the SII contents.
+ *
+ * Each record holds the device index (8 bit, followed by a reserved byte),
+ * the ring position (16 bit), the SII identity words (24 bytes), the base
+ * information (10 bytes), the DL status (16 bit), the DC port receive times
+ * (4 x 32 bit) and the number of SII words (32 bit), followed by the SII
+ * contents.
+ */
+#define EC_SNAPSHOT_SLAVE_SIZE 60
+
+/****************************************************************************/
+
+/** Slave information of a warm-start snapshot.
+ */
+typedef struct {
+    uint8_t device_index; /**< Index of the device the slave responds on. */
+    uint16_t ring_position; /**< Ring position on the device. */
+    uint16_t ident[EC_SII_IDENT_WORDS]; /**< SII identity words. */
+    uint8_t base_type; /**< Slave type. */
+    uint8_t base_revision; /**< Revision. */
+    uint16_t base_build; /**< Build number. */
+    uint8_t base_fmmu_count; /**< Number of supported FMMUs. */
+    uint8_t base_sync_count; /**< Number of supported sync managers. */
+    uint8_t base_fmmu_bit_operation; /**< FMMU bit operation is supported. */
+    uint8_t base_dc_supported; /**< Distributed clocks are supported. */
+    uint8_t base_dc_range; /**< DC range. */
+    uint8_t has_dc_system_time; /**< The slave supports the DC system time
+                                  register. */
+    uint16_t dl_status; /**< Contents of the DL status register. */
+    uint32_t receive_time[EC_MAX_PORTS]; /**< DC port receive times. */
+} ec_snapshot_slave_t;
+
+/****************************************************************************/
+
+/** Warm-start snapshot.
+ *
+ * A snapshot of the slaves, their SII contents, the bus topology and the
+ * measured port receive times can be exported to user space and provided
+ * to the next master instance via the firmware loader. On the first bus
+ * scan, the snapshot is adopted for all slaves, that match it. If any slave
+ * does not match, the bus is scanned again without the snapshot. Access is
+ * serialized by the master semaphore.
+ */
+typedef struct {
+    ec_master_t *master; /**< Parent master. */
+    ec_snapshot_slave_t *slaves; /**< Slave information. */
+    unsigned int slave_count; /**< Number of slaves in the snapshot. */
+    unsigned int loaded; /**< Loading the snapshot was tried. */
+    unsigned int mismatch; /**< A slave did not match the snapshot. */
+} ec_snapshot_t;
+
+/****************************************************************************/
+
+void ec_snapshot_init(ec_snapshot_t *, ec_master_t *);
+void ec_snapshot_clear(ec_snapshot_t *);
+
+void ec_snapshot_start(ec_snapshot_t *);
+int ec_snapshot_adopt(ec_snapshot_t *, ec_slave_t *);
+void ec_snapshot_verify(ec_snapshot_t *, const ec_slave_t *);
+int ec_snapshot_finish(ec_snapshot_t *);
+
+size_t ec_snapshot_export(ec_master_t *, uint8_t *, size_t);
+
+/****************************************************************************/
+
+#endif
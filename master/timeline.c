@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT startup timeline methods.
+ */
+
+/****************************************************************************/
+
+#include <linux/vmalloc.h>
+#include <linux/ktime.h>
+
+#include "master.h"
+#include "slave.h"
+#include "timeline.h"
+
+/****************************************************************************/
+
+/** Startup timeline constructor.
+ *
+ * \return Zero on success, otherwise a negative error code.
+ */
+int ec_timeline_init(
+        ec_timeline_t *timeline, /**< Startup timeline. */
+        ec_master_t *master /**< Parent master. */
+        )
+{
+    timeline->master = master;
+    timeline->write_count = 0;
+
+    timeline->events =
+        vmalloc(EC_TIMELINE_SIZE * sizeof(ec_timeline_event_t));
+    if (!timeline->events) {
+        EC_MASTER_ERR(master, "Failed to allocate startup timeline!\n");
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+
+/** Startup timeline destructor.
+ */
+void ec_timeline_clear(
+        ec_timeline_t *timeline /**< Startup timeline. */
+        )
+{
+    if (timeline->events) {
+        vfree(timeline->events);
+        timeline->events = NULL;
+    }
+}
+
+/****************************************************************************/
+
+/** Discard all recorded events.
+ */
+void ec_timeline_reset(
+        ec_timeline_t *timeline /**< Startup timeline. */
+        )
+{
+    timeline->write_count = 0;
+}
+
+/****************************************************************************/
+
+/** Record the transition of a slave state machine into a new state.
+ *
+ * Called by the state machines in the master thread, while the master_sem
+ * is held.
+ */
+void ec_timeline_record(
+        ec_timeline_t *timeline, /**< Startup timeline. */
+        const ec_slave_t *slave, /**< Slave handled by the state machine. */
+        ec_timeline_fsm_t fsm, /**< State machine. */
+        const char *state /**< Name of the entered state. */
+        )
+{
+    ec_timeline_event_t *event;
+
+    event = &timeline->events[timeline->write_count % EC_TIMELINE_SIZE];
+    event->time = ktime_to_ns(ktime_get());
+    event->state = state;
+    event->position = slave->ring_position;
+    event->fsm = fsm;
+    timeline->write_count++;
+}
+
+/****************************************************************************/
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+/** \file
+ * EtherCAT startup timeline.
+ */
+
+/****************************************************************************/
+
+#ifndef __EC_TIMELINE_H__
+#define __EC_TIMELINE_H__
+
+#include "globals.h"
+#include "ioctl.h"
+
+/****************************************************************************/
+
+/** Number of events in the startup timeline.
+ */
+#define EC_TIMELINE_SIZE 4096
+
+/****************************************************************************/
+
+/** Startup timeline event.
+ */
+typedef struct {
+    u64 time; /**< Monotonic time stamp in ns. */
+    const char *state; /**< Name of the entered state. */
+    uint16_t position; /**< Ring position of the slave. */
+    uint8_t fsm; /**< State machine (ec_timeline_fsm_t). */
+} ec_timeline_event_t;
+
+/** EtherCAT startup timeline.
+ *
+ * Keeps the state transitions of the slave scan and slave configuration
+ * state machines in a ring of EC_TIMELINE_SIZE events, so that the time
+ * spent in each phase can be evaluated per slave. The newest events
+ * overwrite the oldest ones.
+ */
+typedef struct {
+    ec_master_t *master; /**< Master owning the timeline. */
+    ec_timeline_event_t *events; /**< Event ring. */
+    uint64_t write_count; /**< Number of events recorded. */
+} ec_timeline_t;
+
+/****************************************************************************/
+
+int ec_timeline_init(ec_timeline_t *, ec_master_t *);
+void ec_timeline_clear(ec_timeline_t *);
+
+void ec_timeline_reset(ec_timeline_t *);
+void ec_timeline_record(ec_timeline_t *, const ec_slave_t *,
+        ec_timeline_fsm_t, const char *);
+
+/****************************************************************************/
+
+#endif
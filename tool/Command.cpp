@@ -144,7 +144,8 @@ Command::Command(const string &name, const string &briefDesc):
     briefDesc(briefDesc),
     verbosity(Normal),
     emergency(false),
-    force(false)
+    force(false),
+    completeAccess(false)
 {
 }
 
@@ -212,6 +213,13 @@ void Command::setForce(bool f)
 
 /****************************************************************************/
 
+void Command::setCompleteAccess(bool c)
+{
+    completeAccess = c;
+};
+
+/****************************************************************************/
+
 void Command::setOutputFile(const string &f)
 {
     outputFile = f;
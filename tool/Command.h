@@ -105,6 +105,9 @@ class Command
         void setForce(bool);
         bool getForce() const;
 
+        void setCompleteAccess(bool);
+        bool getCompleteAccess() const;
+
         void setOutputFile(const string &);
         const string &getOutputFile() const;
 
@@ -150,6 +153,7 @@ class Command
         string dataType;
         bool emergency;
         bool force;
+        bool completeAccess;
         string outputFile;
         string skin;
 
@@ -200,6 +204,13 @@ inline bool Command::getForce() const
 
 /****************************************************************************/
 
+inline bool Command::getCompleteAccess() const
+{
+    return completeAccess;
+}
+
+/****************************************************************************/
+
 inline const string &Command::getOutputFile() const
 {
     return outputFile;
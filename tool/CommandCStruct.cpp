@@ -23,7 +23,9 @@
 
 #include <iostream>
 #include <iomanip>
+#include <vector>
 #include <string.h>
+#include <ctype.h>
 using namespace std;
 
 #include "CommandCStruct.h"
@@ -42,7 +44,8 @@ string CommandCStruct::helpString(const string &binaryBaseName) const
 {
     stringstream str;
 
-    str << binaryBaseName << " " << getName() << " [OPTIONS]" << endl
+    str << binaryBaseName << " " << getName()
+        << " [OPTIONS] [domains]" << endl
         << endl
         << getBriefDescription() << endl
         << endl
@@ -50,10 +53,27 @@ string CommandCStruct::helpString(const string &binaryBaseName) const
         << "ecrt_slave_config_pdos() function of the application" << endl
         << "interface." << endl
         << endl
+        << "If the 'domains' argument is given, a header describing the"
+        << endl
+        << "process data layout of the selected domains is generated"
+        << endl
+        << "instead. This requires an activated master. For each" << endl
+        << "domain, it contains offset and bit position constants for" << endl
+        << "every mapped PDO entry, a packed structure for the process"
+        << endl
+        << "data image, a registration array for" << endl
+        << "ecrt_domain_reg_pdo_entry_list() and a function to check" << endl
+        << "after ecrt_master_activate(), that the actual layout still"
+        << endl
+        << "matches the generated one." << endl
+        << endl
         << "Command-specific options:" << endl
         << "  --alias    -a <alias>" << endl
         << "  --position -p <pos>    Slave selection. See the help of" << endl
         << "                         the 'slaves' command." << endl
+        << "  --domain   -d <index>  Domain selection for 'domains'." << endl
+        << "                         If omitted, all domains are used."
+        << endl
         << endl
         << numericInfo();
 
@@ -67,19 +87,43 @@ void CommandCStruct::execute(const StringVector &args)
     MasterIndexList masterIndices;
     SlaveList slaves;
     SlaveList::const_iterator si;
+    DomainList domains;
+    DomainList::const_iterator di;
+    bool domainLayout = false;
 
-    if (args.size()) {
+    if (args.size() > 1) {
         stringstream err;
-        err << "'" << getName() << "' takes no arguments!";
+        err << "'" << getName() << "' takes at most one argument!";
         throwInvalidUsageException(err);
     }
 
+    if (args.size()) {
+        if (args[0] != "domains") {
+            stringstream err;
+            err << "Invalid argument '" << args[0] << "'!";
+            throwInvalidUsageException(err);
+        }
+        domainLayout = true;
+    }
+
     masterIndices = getMasterIndices();
     MasterIndexList::const_iterator mi;
     for (mi = masterIndices.begin();
             mi != masterIndices.end(); mi++) {
         MasterDevice m(*mi);
         m.open(MasterDevice::Read);
+
+        if (domainLayout) {
+            ec_ioctl_master_t io;
+            m.getMaster(&io);
+            domains = selectedDomains(m, io);
+
+            for (di = domains.begin(); di != domains.end(); di++) {
+                generateDomainCStruct(m, io, *di);
+            }
+            continue;
+        }
+
         slaves = selectedSlaves(m);
 
         for (si = slaves.begin(); si != slaves.end(); si++) {
@@ -199,3 +243,258 @@ void CommandCStruct::generateSlaveCStruct(
 }
 
 /****************************************************************************/
+
+void CommandCStruct::generateDomainCStruct(
+        MasterDevice &m,
+        const ec_ioctl_master_t &master,
+        const ec_ioctl_domain_t &domain
+        )
+{
+    vector<ec_ioctl_config_t> configs;
+    ec_ioctl_domain_fmmu_t fmmu;
+    ec_ioctl_config_pdo_t pdo;
+    ec_ioctl_config_pdo_entry_t entry;
+    DomainEntryList entries;
+    DomainEntryList::const_iterator ei;
+    unsigned int i, j, k, regCount = 0, bytePos = 0;
+    stringstream id, defines, members, regs, offsets, bitPositions;
+
+    for (i = 0; i < master.config_count; i++) {
+        ec_ioctl_config_t config;
+        m.getConfig(&config, i);
+        configs.push_back(config);
+    }
+
+    for (i = 0; i < domain.fmmu_count; i++) {
+        const ec_ioctl_config_t *config = NULL;
+        unsigned int bitOffset;
+
+        m.getFmmu(&fmmu, domain.index, i);
+
+        for (j = 0; j < configs.size(); j++) {
+            if (configs[j].alias == fmmu.slave_config_alias
+                    && configs[j].position == fmmu.slave_config_position) {
+                config = &configs[j];
+                break;
+            }
+        }
+
+        if (!config) {
+            stringstream err;
+            err << "No slave configuration for FMMU " << i
+                << " of domain " << domain.index << "!";
+            throwCommandException(err);
+        }
+
+        bitOffset = (fmmu.logical_address - domain.logical_base_address) * 8;
+
+        for (j = 0; j < config->syncs[fmmu.sync_index].pdo_count; j++) {
+            m.getConfigPdo(&pdo, config->config_index, fmmu.sync_index, j);
+
+            for (k = 0; k < pdo.entry_count; k++) {
+                DomainEntry e;
+
+                m.getConfigPdoEntry(&entry, config->config_index,
+                        fmmu.sync_index, j, k);
+
+                e.config = config;
+                e.index = entry.index;
+                e.subindex = entry.subindex;
+                e.bit_length = entry.bit_length;
+                e.bit_offset = bitOffset;
+                e.dir = fmmu.dir;
+                e.name = (const char *) entry.name;
+                bitOffset += entry.bit_length;
+
+                if (e.index) { // skip gaps
+                    entries.push_back(e);
+                }
+            }
+        }
+    }
+
+    id << "domain" << dec << domain.index;
+
+    for (ei = entries.begin(); ei != entries.end(); ei++) {
+        string macro = id.str() + "_" + entryId(*ei), type;
+        unsigned int byteOffset = ei->bit_offset / 8;
+
+        for (i = 0; i < macro.size(); i++) {
+            macro[i] = toupper(macro[i]);
+        }
+
+        defines << "#define " << macro << " " << dec << byteOffset
+            << " /* 0x" << hex << setfill('0') << setw(4) << ei->index
+            << ":" << setw(2) << (unsigned int) ei->subindex << ", "
+            << dec << (unsigned int) ei->bit_length << " bit, "
+            << (ei->dir == EC_DIR_OUTPUT ? "output" : "input");
+        if (!ei->name.empty()) {
+            defines << ", \"" << ei->name << "\"";
+        }
+        defines << " */" << endl
+            << "#define " << macro << "_BIT " << dec
+            << ei->bit_offset % 8 << endl;
+
+        regs << "    {" << dec << ei->config->alias << ", "
+            << ei->config->position << ", 0x" << hex << setfill('0')
+            << setw(8) << ei->config->vendor_id << ", 0x" << setw(8)
+            << ei->config->product_code << ", 0x" << setw(4) << ei->index
+            << ", 0x" << setw(2) << (unsigned int) ei->subindex << ", &"
+            << id.str() << "_offsets[" << dec << regCount << "], &"
+            << id.str() << "_bit_positions[" << regCount << "]}," << endl;
+        offsets << (regCount ? ", " : "") << macro;
+        bitPositions << (regCount ? ", " : "") << macro << "_BIT";
+        regCount++;
+
+        type = memberType(*ei);
+        if (type.empty() || byteOffset < bytePos) {
+            continue; // covered by a raw byte array
+        }
+
+        if (byteOffset > bytePos) {
+            members << "    uint8_t raw_" << dec << bytePos << "["
+                << byteOffset - bytePos << "];" << endl;
+        }
+
+        members << "    " << type << " " << entryId(*ei);
+        if (type == "uint8_t" && ei->bit_length > 8) {
+            members << "[" << dec << ei->bit_length / 8 << "]";
+        }
+        members << "; /* 0x" << hex << setfill('0') << setw(4) << ei->index
+            << ":" << setw(2) << (unsigned int) ei->subindex << " */"
+            << endl;
+        bytePos = byteOffset + ei->bit_length / 8;
+    }
+
+    if (domain.data_size > bytePos) {
+        members << "    uint8_t raw_" << dec << bytePos << "["
+            << domain.data_size - bytePos << "];" << endl;
+    }
+
+    string upper = id.str();
+    for (i = 0; i < upper.size(); i++) {
+        upper[i] = toupper(upper[i]);
+    }
+
+    cout << "/* Master " << m.getIndex() << ", Domain " << domain.index
+        << endl
+        << " * Logical address 0x" << hex << setfill('0') << setw(8)
+        << domain.logical_base_address << ", " << dec << domain.data_size
+        << " byte, expected working counter "
+        << domain.expected_working_counter << endl
+        << " */" << endl
+        << endl
+        << "#define " << upper << "_SIZE " << domain.data_size << endl
+        << endl
+        << defines.str();
+
+    if (!domain.data_size) {
+        cout << endl;
+        return;
+    }
+
+    cout << endl
+        << "/* Process data image of domain " << domain.index
+        << ". Multi-byte members are" << endl
+        << " * little-endian; use the EC_READ_* and EC_WRITE_* macros on"
+        << endl
+        << " * big-endian hosts. Bit-sized entries are contained in the raw_*"
+        << endl
+        << " * members, use the _BIT constants to access them. */" << endl
+        << "typedef struct __attribute__((packed)) {" << endl
+        << members.str()
+        << "} " << id.str() << "_t;" << endl
+        << endl
+        << "typedef char " << id.str() << "_size_check[sizeof("
+        << id.str() << "_t) == " << upper << "_SIZE ? 1 : -1];" << endl
+        << endl;
+
+    if (!regCount) {
+        return;
+    }
+
+    cout << "static unsigned int " << id.str() << "_offsets["
+        << regCount << "];" << endl
+        << "static unsigned int " << id.str() << "_bit_positions["
+        << regCount << "];" << endl
+        << endl
+        << "static const ec_pdo_entry_reg_t " << id.str() << "_regs[] = {"
+        << endl
+        << regs.str()
+        << "    {}" << endl
+        << "};" << endl
+        << endl
+        << "/* Call after ecrt_domain_reg_pdo_entry_list() with "
+        << id.str() << "_regs" << endl
+        << " * and ecrt_master_activate(). Returns zero, if the actual "
+        << "process data" << endl
+        << " * layout matches the generated one. */" << endl
+        << "static inline int " << id.str()
+        << "_check_layout(const ec_domain_t *domain)" << endl
+        << "{" << endl
+        << "    static const unsigned int offsets[] = {" << endl
+        << "        " << offsets.str() << endl
+        << "    };" << endl
+        << "    static const unsigned int bit_positions[] = {" << endl
+        << "        " << bitPositions.str() << endl
+        << "    };" << endl
+        << "    unsigned int i;" << endl
+        << endl
+        << "    if (ecrt_domain_size(domain) != " << upper << "_SIZE) {"
+        << endl
+        << "        return -1;" << endl
+        << "    }" << endl
+        << endl
+        << "    for (i = 0; i < " << regCount << "; i++) {" << endl
+        << "        if (" << id.str() << "_offsets[i] != offsets[i] ||"
+        << endl
+        << "                " << id.str()
+        << "_bit_positions[i] != bit_positions[i]) {" << endl
+        << "            return -1;" << endl
+        << "        }" << endl
+        << "    }" << endl
+        << endl
+        << "    return 0;" << endl
+        << "}" << endl
+        << endl;
+}
+
+/****************************************************************************/
+
+string CommandCStruct::entryId(const DomainEntry &e)
+{
+    stringstream str;
+
+    str << "slave_" << dec;
+    if (e.config->alias) {
+        str << e.config->alias << "_";
+    }
+    str << e.config->position << "_" << hex << setfill('0')
+        << setw(4) << e.index << "_" << setw(2)
+        << (unsigned int) e.subindex;
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+string CommandCStruct::memberType(const DomainEntry &e)
+{
+    // entries that are not byte-aligned are not mapped to a member
+    if (e.bit_offset % 8 || e.bit_length % 8) {
+        return "";
+    }
+
+    switch (e.bit_length) {
+        case 16:
+            return "uint16_t";
+        case 32:
+            return "uint32_t";
+        case 64:
+            return "uint64_t";
+        default:
+            return "uint8_t";
+    }
+}
+
+/****************************************************************************/
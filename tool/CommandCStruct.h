@@ -37,6 +37,23 @@ class CommandCStruct:
 
     protected:
         void generateSlaveCStruct(MasterDevice &, const ec_ioctl_slave_t &);
+
+        /** PDO entry located in a domain's process data image. */
+        struct DomainEntry {
+            const ec_ioctl_config_t *config; /**< Slave configuration. */
+            uint16_t index; /**< PDO entry index. */
+            uint8_t subindex; /**< PDO entry subindex. */
+            uint8_t bit_length; /**< Size of the entry in bit. */
+            unsigned int bit_offset; /**< Bit offset in the domain. */
+            ec_direction_t dir; /**< Sync manager direction. */
+            string name; /**< PDO entry name. */
+        };
+        typedef list<DomainEntry> DomainEntryList;
+
+        void generateDomainCStruct(MasterDevice &, const ec_ioctl_master_t &,
+                const ec_ioctl_domain_t &);
+        static string entryId(const DomainEntry &);
+        static string memberType(const DomainEntry &);
 };
 
 /****************************************************************************/
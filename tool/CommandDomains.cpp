@@ -67,6 +67,18 @@ string CommandDomains::helpString(const string &binaryBaseName) const
         << endl
         << "The process data are displayed as hexadecimal bytes." << endl
         << endl
+        << "When the working counter of a domain drops, the master" << endl
+        << "checks the AL state, FMMU and sync manager of every" << endl
+        << "participating slave in the background. With --verbose," << endl
+        << "the result of the last check is shown, and slave" << endl
+        << "configurations that did not contribute to the working" << endl
+        << "counter are marked:" << endl
+        << endl
+        << "  Diagnosis 1 at WorkingCounter 2/3: finished" << endl
+        << "  SlaveConfig 0:2, SM3 ( Input), LogAddr 0x00000006, Size 6"
+        << endl
+        << "    Not contributing: AL state PREOP, AL error 0x001B" << endl
+        << endl
         << "Command-specific options:" << endl
         << "  --domain  -d <index>  Positive numerical domain index." << endl
         << "                        If omitted, all domains are" << endl
@@ -162,6 +174,14 @@ void CommandDomains::showDomain(
     if (!domain.data_size || getVerbosity() != Verbose)
         return;
 
+    if (domain.diag_count) {
+        cout << indent << "  Diagnosis " << dec << domain.diag_count
+            << " at WorkingCounter " << domain.diag_working_counter
+            << "/" << domain.expected_working_counter << ": "
+            << (domain.diag_state == EC_WC_DIAG_BUSY ?
+                    "in progress" : "finished") << endl;
+    }
+
     processData = new unsigned char[domain.data_size];
 
     try {
@@ -185,6 +205,11 @@ void CommandDomains::showDomain(
             << setw(8) << fmmu.logical_address
             << ", Size " << dec << fmmu.data_size << endl;
 
+        if (fmmu.diag_flags) {
+            cout << indent << "    Not contributing: "
+                << diagString(fmmu) << endl;
+        }
+
         dataOffset = fmmu.logical_address - domain.logical_base_address;
         if (dataOffset + fmmu.data_size > domain.data_size) {
             stringstream err;
@@ -207,3 +232,38 @@ void CommandDomains::showDomain(
 }
 
 /****************************************************************************/
+
+string CommandDomains::diagString(const ec_ioctl_domain_fmmu_t &fmmu)
+{
+    stringstream str;
+    string sep;
+
+    if (fmmu.diag_flags & EC_WC_DIAG_OFFLINE) {
+        str << sep << "no slave attached";
+        sep = ", ";
+    }
+    if (fmmu.diag_flags & EC_WC_DIAG_NO_RESPONSE) {
+        str << sep << "no response";
+        sep = ", ";
+    }
+    if (fmmu.diag_flags & EC_WC_DIAG_AL_STATE) {
+        str << sep << "AL state " << alStateString(fmmu.diag_al_state);
+        sep = ", ";
+    }
+    if (fmmu.diag_flags & EC_WC_DIAG_AL_ERROR) {
+        str << sep << "AL error 0x" << hex << setfill('0') << setw(4)
+            << fmmu.diag_al_status_code << dec << setfill(' ');
+        sep = ", ";
+    }
+    if (fmmu.diag_flags & EC_WC_DIAG_FMMU) {
+        str << sep << "FMMU disabled or modified";
+        sep = ", ";
+    }
+    if (fmmu.diag_flags & EC_WC_DIAG_SM) {
+        str << sep << "SM disabled";
+    }
+
+    return str.str();
+}
+
+/****************************************************************************/
@@ -38,6 +38,7 @@ class CommandDomains:
     protected:
         void showDomain(MasterDevice &, const ec_ioctl_master_t &,
                 const ec_ioctl_domain_t &, bool);
+        static string diagString(const ec_ioctl_domain_fmmu_t &);
 };
 
 /****************************************************************************/
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 using namespace std;
 
 #include "CommandFoeRead.h"
@@ -71,8 +72,11 @@ void CommandFoeRead::execute(const StringVector &args)
 {
     SlaveList slaves;
     ec_ioctl_slave_t *slave;
-    ec_ioctl_slave_foe_t data;
-    unsigned int i;
+    ec_ioctl_slave_foe_stream_t data;
+    uint8_t chunk[0x4000];
+    ofstream file;
+    ostream *out = &cout;
+    size_t total = 0;
     stringstream err;
 
     if (args.size() != 1) {
@@ -88,28 +92,47 @@ void CommandFoeRead::execute(const StringVector &args)
         throwSingleSlaveRequired(slaves.size());
     }
     slave = &slaves.front();
-    data.slave_position = slave->position;
 
-    /* FIXME: No good idea to have a fixed buffer size.
-     * Read in chunks and fill a buffer instead.
-     */
-    data.offset = 0;
-    data.buffer_size = 0x8800;
-    data.buffer = new uint8_t[data.buffer_size];
+    if (!getOutputFile().empty() && getOutputFile() != "-") {
+        file.open(getOutputFile().c_str(), ios::out | ios::binary);
+        if (file.fail()) {
+            err << "Failed to open '" << getOutputFile() << "'!";
+            throwCommandException(err);
+        }
+        out = &file;
+    }
 
+    memset(&data, 0, sizeof(data));
+    data.slave_position = slave->position;
+    data.write = 0;
     strncpy(data.file_name, args[0].c_str(), sizeof(data.file_name) - 1);
 
+    m.startFoeStream(&data);
+
+    // the data are passed in chunks, while the transfer is running
     try {
-        m.readFoe(&data);
+        do {
+            data.buffer = chunk;
+            data.buffer_size = sizeof(chunk);
+            m.foeStreamData(&data);
+            out->write((const char *) chunk, data.data_size);
+            total += data.data_size;
+        } while (data.data_size);
+
+        m.finishFoeStream(&data);
     } catch (MasterDeviceException &e) {
-        delete [] data.buffer;
+        try {
+            // fetch the result, if the slave aborted the transfer
+            m.finishFoeStream(&data);
+        } catch (MasterDeviceException &) {
+        }
         if (data.result) {
             if (data.result == FOE_OPCODE_ERROR) {
                 err << "FoE read aborted with error code 0x"
                     << setw(8) << setfill('0') << hex << data.error_code
                     << ": " << errorText(data.error_code);
             } else {
-                err << "Failed to write via FoE: "
+                err << "Failed to read via FoE: "
                     << resultText(data.result);
             }
             throwCommandException(err);
@@ -118,13 +141,11 @@ void CommandFoeRead::execute(const StringVector &args)
         }
     }
 
-    // TODO --output-file
-    for (i = 0; i < data.data_size; i++) {
-        uint8_t *w = data.buffer + i;
-        cout << *(uint8_t *) w ;
-    }
+    out->flush();
 
-    delete [] data.buffer;
+    if (getVerbosity() == Verbose) {
+        cerr << "Read " << total << " bytes of FoE data." << endl;
+    }
 }
 
 /****************************************************************************/
@@ -49,7 +49,9 @@ string CommandFoeWrite::helpString(const string &binaryBaseName) const
         << endl
         << getBriefDescription() << endl
         << endl
-        << "This command requires a single slave to be selected." << endl
+        << "If multiple slaves are selected, the file is stored on" << endl
+        << "all of them in parallel. The transfers are processed" << endl
+        << "independently and errors are reported per slave." << endl
         << endl
         << "Arguments:" << endl
         << "  FILENAME can either be a path to a file, or '-'. In" << endl
@@ -76,8 +78,9 @@ string CommandFoeWrite::helpString(const string &binaryBaseName) const
 void CommandFoeWrite::execute(const StringVector &args)
 {
     stringstream err;
-    ec_ioctl_slave_foe_t data;
+    ec_ioctl_slave_foe_stream_t data;
     ifstream file;
+    istream *in;
     SlaveList slaves;
     string storeFileName;
 
@@ -87,7 +90,7 @@ void CommandFoeWrite::execute(const StringVector &args)
     }
 
     if (args[0] == "-") {
-        loadFoeData(&data, cin);
+        in = &cin;
         if (getOutputFile().empty()) {
             err << "Please specify a filename for the slave side"
                 << " with --output-file!";
@@ -101,8 +104,7 @@ void CommandFoeWrite::execute(const StringVector &args)
             err << "Failed to open '" << args[0] << "'!";
             throwCommandException(err);
         }
-        loadFoeData(&data, file);
-        file.close();
+        in = &file;
         if (getOutputFile().empty()) {
             char *cpy = strdup(args[0].c_str()); // basename can modify
                                                  // the string contents
@@ -114,32 +116,36 @@ void CommandFoeWrite::execute(const StringVector &args)
     }
 
     MasterDevice m(getSingleMasterIndex());
-    try {
-        m.open(MasterDevice::ReadWrite);
-    } catch (MasterDeviceException &e) {
-        if (data.buffer_size)
-            delete [] data.buffer;
-        throw e;
-    }
+    m.open(MasterDevice::ReadWrite);
 
     slaves = selectedSlaves(m);
-    if (slaves.size() != 1) {
-        if (data.buffer_size)
-            delete [] data.buffer;
-        throwSingleSlaveRequired(slaves.size());
+    if (slaves.empty()) {
+        err << "The slave selection matches no slaves.";
+        throwInvalidUsageException(err);
     }
-    data.slave_position = slaves.front().position;
 
-    // write data via foe to the slave
-    data.offset = 0;
+    if (slaves.size() > 1) {
+        writeFoeMulti(m, slaves, storeFileName, *in);
+        return;
+    }
+
+    memset(&data, 0, sizeof(data));
+    data.slave_position = slaves.front().position;
+    data.write = 1;
     strncpy(data.file_name, storeFileName.c_str(),
             sizeof(data.file_name) - 1);
 
+    m.startFoeStream(&data);
+
+    // the file is passed in chunks, while the transfer is running
     try {
-        m.writeFoe(&data);
+        writeFoeData(m, &data, *in);
     } catch (MasterDeviceException &e) {
-        if (data.buffer_size)
-            delete [] data.buffer;
+        try {
+            // fetch the result, if the slave aborted the transfer
+            m.finishFoeStream(&data);
+        } catch (MasterDeviceException &) {
+        }
         if (data.result) {
             if (data.result == FOE_OPCODE_ERROR) {
                 err << "FoE write aborted with error code 0x"
@@ -158,21 +164,64 @@ void CommandFoeWrite::execute(const StringVector &args)
     if (getVerbosity() == Verbose) {
         cerr << "FoE writing finished." << endl;
     }
+}
+
+/****************************************************************************/
+
+void CommandFoeWrite::writeFoeData(
+        MasterDevice &m,
+        ec_ioctl_slave_foe_stream_t *data,
+        istream &in
+        )
+{
+    uint8_t chunk[0x4000];
+    size_t size, offset, total = 0;
+
+    do {
+        in.read((char *) chunk, sizeof(chunk));
+        if (in.bad()) {
+            stringstream err;
+            err << "Failed to read FoE data!";
+            throwCommandException(err);
+        }
+        size = in.gcount();
+        total += size;
+
+        offset = 0;
+        do {
+            data->buffer = chunk + offset;
+            data->buffer_size = size - offset;
+            data->last = in.eof();
+            m.foeStreamData(data);
+            offset += data->data_size;
+        } while (offset < size);
+    } while (!in.eof());
 
-    if (data.buffer_size)
-        delete [] data.buffer;
+    if (getVerbosity() == Verbose) {
+        cerr << "Read " << total << " bytes of FoE data." << endl;
+    }
+
+    m.finishFoeStream(data);
 }
 
 /****************************************************************************/
 
-void CommandFoeWrite::loadFoeData(
-        ec_ioctl_slave_foe_t *data,
-        const istream &in
+void CommandFoeWrite::writeFoeMulti(
+        MasterDevice &m,
+        const SlaveList &slaves,
+        const string &storeFileName,
+        istream &in
         )
 {
     stringstream err;
+    ec_ioctl_slave_foe_multi_t data;
+    vector<ec_foe_target_t> targets;
+    SlaveList::const_iterator si;
+    vector<ec_foe_target_t>::const_iterator ti;
+    unsigned int failed = 0;
     ostringstream tmp;
 
+    // the file is loaded once for all slaves
     tmp << in.rdbuf();
     string const &contents = tmp.str();
 
@@ -180,12 +229,54 @@ void CommandFoeWrite::loadFoeData(
         cerr << "Read " << contents.size() << " bytes of FoE data." << endl;
     }
 
-    data->buffer_size = contents.size();
+    for (si = slaves.begin(); si != slaves.end(); si++) {
+        ec_foe_target_t target;
+        memset(&target, 0, sizeof(target));
+        target.slave_position = si->position;
+        targets.push_back(target);
+    }
+
+    memset(&data, 0, sizeof(data));
+    strncpy(data.file_name, storeFileName.c_str(),
+            sizeof(data.file_name) - 1);
+    data.buffer_size = contents.size();
+    data.buffer = (const uint8_t *) contents.data();
+    data.target_count = targets.size();
+    data.targets = &targets.front();
+
+    m.writeFoeMulti(&data);
 
-    if (data->buffer_size) {
-        // allocate buffer and read file into buffer
-        data->buffer = new uint8_t[data->buffer_size];
-        contents.copy((char *) data->buffer, contents.size());
+    for (ti = targets.begin(); ti != targets.end(); ti++) {
+        if (!ti->error) {
+            if (getVerbosity() == Verbose) {
+                cerr << "Slave " << ti->slave_position << ": "
+                    << ti->data_size << " bytes written." << endl;
+            }
+            continue;
+        }
+
+        failed++;
+        cerr << "Slave " << ti->slave_position << ": ";
+        if (ti->result == FOE_OPCODE_ERROR) {
+            cerr << "FoE write aborted with error code 0x"
+                << setw(8) << setfill('0') << hex << ti->error_code
+                << dec << ": " << errorText(ti->error_code);
+        } else if (ti->result) {
+            cerr << "Failed to write via FoE: " << resultText(ti->result);
+        } else {
+            cerr << "Failed to write via FoE: " << strerror(-ti->error);
+        }
+        cerr << " (" << ti->data_size << " bytes written)" << endl;
+    }
+
+    if (failed) {
+        err << "FoE write failed on " << failed << " of "
+            << targets.size() << " slaves.";
+        throwCommandException(err);
+    }
+
+    if (getVerbosity() == Verbose) {
+        cerr << "FoE writing finished." << endl;
     }
 }
 
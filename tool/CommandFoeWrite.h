@@ -36,7 +36,10 @@ class CommandFoeWrite:
         void execute(const StringVector &);
 
     protected:
-        void loadFoeData(ec_ioctl_slave_foe_t *, const istream &);
+        void writeFoeData(MasterDevice &, ec_ioctl_slave_foe_stream_t *,
+                istream &);
+        void writeFoeMulti(MasterDevice &, const SlaveList &, const string &,
+                istream &);
 };
 
 /****************************************************************************/
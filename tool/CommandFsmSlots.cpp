@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+#include <sstream>
+#include <iomanip>
+using namespace std;
+
+#include "CommandFsmSlots.h"
+#include "MasterDevice.h"
+
+/****************************************************************************/
+
+CommandFsmSlots::CommandFsmSlots():
+    Command("fsm_slots",
+            "Set the number of slave FSMs executed in parallel.")
+{
+}
+
+/****************************************************************************/
+
+string CommandFsmSlots::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName() << " <SLOTS>" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "Slave FSMs process the SDO, FoE, SoE, EoE and register" << endl
+        << "requests of the slaves. The master runs at most SLOTS of" << endl
+        << "them in parallel, but never more than the frames of one" << endl
+        << "send interval can carry. The current value is shown by" << endl
+        << "the 'master' command." << endl
+        << endl
+        << "Arguments:" << endl
+        << "  SLOTS is the number of parallel slave FSMs, from 1 to 1024."
+        << endl << endl
+        << numericInfo();
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandFsmSlots::execute(const StringVector &args)
+{
+    MasterIndexList masterIndices;
+    stringstream str;
+    unsigned int slots;
+
+    if (args.size() != 1) {
+        stringstream err;
+        err << "'" << getName() << "' takes exactly one argument!";
+        throwInvalidUsageException(err);
+    }
+
+    str << args[0];
+    str >> resetiosflags(ios::basefield) // guess base from prefix
+        >> slots;
+
+    if (str.fail()) {
+        stringstream err;
+        err << "Invalid number of slots '" << args[0] << "'!";
+        throwInvalidUsageException(err);
+    }
+
+    masterIndices = getMasterIndices();
+    MasterIndexList::const_iterator mi;
+    for (mi = masterIndices.begin();
+            mi != masterIndices.end(); mi++) {
+        MasterDevice m(*mi);
+        m.open(MasterDevice::ReadWrite);
+        m.setFsmSlots(slots);
+    }
+}
+
+/****************************************************************************/
@@ -94,6 +94,8 @@ void CommandMaster::execute(const StringVector &args)
         cout << endl
             << "  Active: " << (data.active ? "yes" : "no") << endl
             << "  Slaves: " << data.slave_count << endl
+            << "  Slave FSM slots: " << data.fsm_slots
+            << " (" << data.ext_ring_size << " datagrams)" << endl
             << "  Ethernet devices:" << endl;
 
         for (dev_idx = EC_DEVICE_MAIN; dev_idx < data.num_devices;
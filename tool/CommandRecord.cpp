@@ -0,0 +1,250 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+using namespace std;
+
+#include "CommandRecord.h"
+#include "MasterDevice.h"
+
+/****************************************************************************/
+
+CommandRecord::CommandRecord():
+    Command("record", "Dump or control the process data flight recorder.")
+{
+}
+
+/****************************************************************************/
+
+string CommandRecord::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName()
+        << " [OPTIONS] [dump|status|freeze|arm]" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "The flight recorder has to be enabled by the application"
+        << endl
+        << "via ecrt_domain_recorder() before activating the master."
+        << endl
+        << endl
+        << "Actions:" << endl
+        << "  dump    Output the recorded cycles in binary form (default)."
+        << endl
+        << "          The recorder has to be frozen." << endl
+        << "  status  Show the recorder state." << endl
+        << "  freeze  Stop recording, as if a trigger fired." << endl
+        << "  arm     Clear the ring and restart recording." << endl
+        << endl
+        << "The dump consists of the recorder header, followed by the"
+        << endl
+        << "valid records from the oldest to the newest. Each record"
+        << endl
+        << "contains a cycle counter, the application time, the working"
+        << endl
+        << "counters and the process data image. Data of multiple"
+        << endl
+        << "domains are concatenated." << endl
+        << endl
+        << "Command-specific options:" << endl
+        << "  --domain -d <index>       Positive numerical domain index."
+        << endl
+        << "                            If omitted, all domains are used."
+        << endl
+        << "  --output-file -o <file>   Write the dump to the given file"
+        << endl
+        << "                            instead of stdout." << endl
+        << endl
+        << numericInfo();
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandRecord::execute(const StringVector &args)
+{
+    MasterIndexList masterIndices;
+    DomainList domains;
+    DomainList::const_iterator di;
+    string action = "dump";
+    ofstream file;
+    ostream *out = &cout;
+
+    if (args.size() > 1) {
+        stringstream err;
+        err << "'" << getName() << "' takes at most one argument!";
+        throwInvalidUsageException(err);
+    }
+
+    if (args.size()) {
+        action = args[0];
+    }
+
+    if (action != "dump" && action != "status" && action != "freeze"
+            && action != "arm") {
+        stringstream err;
+        err << "Invalid action '" << action << "'!";
+        throwInvalidUsageException(err);
+    }
+
+    if (action == "dump" && !getOutputFile().empty()) {
+        file.open(getOutputFile().c_str(), ios::out | ios::binary);
+        if (file.fail()) {
+            stringstream err;
+            err << "Failed to open '" << getOutputFile() << "'!";
+            throwCommandException(err);
+        }
+        out = &file;
+    }
+
+    masterIndices = getMasterIndices();
+    MasterIndexList::const_iterator mi;
+    for (mi = masterIndices.begin();
+            mi != masterIndices.end(); mi++) {
+        ec_ioctl_master_t io;
+        MasterDevice m(*mi);
+        m.open(action == "freeze" || action == "arm" ?
+                MasterDevice::ReadWrite : MasterDevice::Read);
+        m.getMaster(&io);
+
+        domains = selectedDomains(m, io);
+
+        for (di = domains.begin(); di != domains.end(); di++) {
+            if (action == "dump") {
+                dumpRecorder(m, *di, *out);
+            } else if (action == "status") {
+                showRecorder(m, *di);
+            } else if (action == "freeze") {
+                m.freezeRecorder(di->index);
+            } else {
+                m.armRecorder(di->index);
+            }
+        }
+    }
+
+    out->flush();
+}
+
+/****************************************************************************/
+
+void CommandRecord::dumpRecorder(
+        MasterDevice &m,
+        const ec_ioctl_domain_t &domain,
+        ostream &out
+        )
+{
+    ec_ioctl_recorder_read_t data;
+    unsigned char *ring;
+    uint64_t count, first, i;
+
+    m.readRecorder(&data, domain.index, 0, NULL);
+    if (data.header.state == EC_RECORDER_OFF || !data.size) {
+        return;
+    }
+
+    if (data.header.state != EC_RECORDER_FROZEN) {
+        stringstream err;
+        err << "Flight recorder of domain " << domain.index
+            << " is not frozen!";
+        throwCommandException(err);
+    }
+
+    ring = new unsigned char[data.size];
+
+    try {
+        m.readRecorder(&data, domain.index, data.size, ring);
+    } catch (MasterDeviceException &e) {
+        delete [] ring;
+        throw e;
+    }
+
+    count = data.header.write_count;
+    if (count > data.header.depth) {
+        first = count - data.header.depth;
+        count = data.header.depth;
+    } else {
+        first = 0;
+    }
+
+    out.write((const char *) &data.header, sizeof(data.header));
+    for (i = 0; i < count; i++) {
+        uint64_t slot = (first + i) % data.header.depth;
+        out.write((const char *) ring + slot * data.header.record_size,
+                data.header.record_size);
+    }
+
+    delete [] ring;
+}
+
+/****************************************************************************/
+
+void CommandRecord::showRecorder(
+        MasterDevice &m,
+        const ec_ioctl_domain_t &domain
+        )
+{
+    ec_ioctl_recorder_read_t data;
+
+    m.readRecorder(&data, domain.index, 0, NULL);
+
+    cout << "Domain" << dec << domain.index << ": "
+        << stateString(data.header.state);
+
+    if (data.header.state != EC_RECORDER_OFF) {
+        cout << ", " << data.header.write_count << " records written"
+            << ", depth " << data.header.depth
+            << ", " << data.header.record_size << " byte per record";
+        if (data.header.state != EC_RECORDER_ARMED) {
+            cout << ", trigger 0x" << hex << setfill('0') << setw(2)
+                << data.header.trigger << dec
+                << " at record " << data.header.trigger_count;
+        }
+    }
+
+    cout << endl;
+}
+
+/****************************************************************************/
+
+string CommandRecord::stateString(uint32_t state)
+{
+    switch (state) {
+        case EC_RECORDER_OFF:
+            return "off";
+        case EC_RECORDER_ARMED:
+            return "armed";
+        case EC_RECORDER_TRIGGERED:
+            return "triggered";
+        case EC_RECORDER_FROZEN:
+            return "frozen";
+        default:
+            return "???";
+    }
+}
+
+/****************************************************************************/
@@ -21,6 +21,8 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <vector>
 using namespace std;
 
 #include "CommandSdos.h"
@@ -65,12 +67,24 @@ string CommandSdos::helpString(const string &binaryBaseName) const
         << endl
         << "If the --quiet option is given, only the SDOs are output."
         << endl << endl
+        << "With the --output-file option, the dictionary of a single" << endl
+        << "slave is written as a binary image instead. Dictionaries" << endl
+        << "are shared among slaves with the same vendor ID, product" << endl
+        << "code and revision number. An image can be provided to the" << endl
+        << "master via the firmware loader as" << endl
+        << "ethercat/sdo-<VENDOR>-<PRODUCT>-<REVISION>.bin (each as" << endl
+        << "8-digit lower-case hexadecimal number, for example in" << endl
+        << "/lib/firmware), so that the dictionary is not fetched" << endl
+        << "from the slaves again after reloading the master module." << endl
+        << endl
         << "Command-specific options:" << endl
         << "  --alias    -a <alias>" << endl
         << "  --position -p <pos>    Slave selection. See the help of" << endl
         << "                         the 'slaves' command." << endl
         << "  --quiet    -q          Only output SDOs (without the" << endl
         << "                         SDO entries)." << endl
+        << "  --output-file -o <file>  Write the binary dictionary" << endl
+        << "                           image to the given file." << endl
         << endl
         << numericInfo();
 
@@ -92,6 +106,17 @@ void CommandSdos::execute(const StringVector &args)
         throwInvalidUsageException(err);
     }
 
+    if (!getOutputFile().empty()) {
+        MasterDevice m(getSingleMasterIndex());
+        m.open(MasterDevice::Read);
+        slaves = selectedSlaves(m);
+        if (slaves.size() != 1) {
+            throwSingleSlaveRequired(slaves.size());
+        }
+        writeSlaveSdos(m, slaves.front());
+        return;
+    }
+
 	masterIndices = getMasterIndices();
     multiMaster = masterIndices.size() > 1;
     MasterIndexList::const_iterator mi;
@@ -169,3 +194,31 @@ void CommandSdos::listSlaveSdos(
 }
 
 /****************************************************************************/
+
+void CommandSdos::writeSlaveSdos(
+        MasterDevice &m,
+        const ec_ioctl_slave_t &slave
+        )
+{
+    ec_ioctl_slave_sdo_dict_t data;
+    vector<uint8_t> buffer;
+    ofstream file;
+
+    // determine the size first, then fetch the image
+    m.getSdoDictionary(&data, slave.position, NULL, 0);
+    do {
+        buffer.resize(data.length);
+        m.getSdoDictionary(&data, slave.position, &buffer[0], buffer.size());
+    } while (data.length > buffer.size());
+
+    file.open(getOutputFile().c_str(), ios::out | ios::binary);
+    if (file.fail()) {
+        stringstream err;
+        err << "Failed to open '" << getOutputFile() << "'!";
+        throwCommandException(err);
+    }
+
+    file.write((const char *) &buffer[0], data.length);
+}
+
+/****************************************************************************/
@@ -0,0 +1,107 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ ****************************************************************************/
+
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+#include "CommandSnapshot.h"
+#include "MasterDevice.h"
+
+/****************************************************************************/
+
+CommandSnapshot::CommandSnapshot():
+    Command("snapshot", "Output a warm-start snapshot of the bus.")
+{
+}
+
+/****************************************************************************/
+
+string CommandSnapshot::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName() << " [OPTIONS]" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "The binary snapshot contains the slaves, their SII contents," << endl
+        << "the bus topology and the measured DC port receive times." << endl
+        << endl
+        << "If it is provided to the firmware loader as" << endl
+        << "ethercat/snapshot-<MASTER>.bin (for example in" << endl
+        << "/lib/firmware), the master adopts it on the first bus scan" << endl
+        << "after loading the module, instead of reading the SII and" << endl
+        << "the DC information of every slave. Each slave is checked" << endl
+        << "against the snapshot by its base information and its" << endl
+        << "identity (alias, vendor ID, product code, revision and" << endl
+        << "serial number). If any slave does not match, the bus is" << endl
+        << "scanned again without the snapshot." << endl
+        << endl
+        << "Command-specific options:" << endl
+        << "  --output-file -o <file>  Write the snapshot to the given" << endl
+        << "                           file instead of stdout." << endl
+        << endl;
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandSnapshot::execute(const StringVector &args)
+{
+    ec_ioctl_snapshot_t data;
+    vector<uint8_t> buffer;
+    ofstream file;
+    ostream *out = &cout;
+
+    if (args.size()) {
+        stringstream err;
+        err << "'" << getName() << "' takes no arguments!";
+        throwInvalidUsageException(err);
+    }
+
+    MasterDevice m(getSingleMasterIndex());
+    m.open(MasterDevice::Read);
+
+    // determine the size first, then fetch the snapshot
+    m.getSnapshot(&data, NULL, 0);
+    do {
+        buffer.resize(data.length);
+        m.getSnapshot(&data, &buffer[0], buffer.size());
+    } while (data.length > buffer.size());
+
+    if (!getOutputFile().empty()) {
+        file.open(getOutputFile().c_str(), ios::out | ios::binary);
+        if (file.fail()) {
+            stringstream err;
+            err << "Failed to open '" << getOutputFile() << "'!";
+            throwCommandException(err);
+        }
+        out = &file;
+    }
+
+    out->write((const char *) &buffer[0], data.length);
+}
+
+/****************************************************************************/
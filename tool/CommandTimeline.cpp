@@ -0,0 +1,433 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *  vim: expandtab
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <string.h>
+#include <time.h>
+using namespace std;
+
+#include "CommandTimeline.h"
+#include "MasterDevice.h"
+
+/****************************************************************************/
+
+CommandTimeline::CommandTimeline():
+    Command("timeline", "Show the durations of the slave startup phases.")
+{
+}
+
+/****************************************************************************/
+
+string CommandTimeline::helpString(const string &binaryBaseName) const
+{
+    stringstream str;
+
+    str << binaryBaseName << " " << getName()
+        << " [OPTIONS] [show|trace|reset]" << endl
+        << endl
+        << getBriefDescription() << endl
+        << endl
+        << "The master records each state transition of the slave scan"
+        << endl
+        << "and slave configuration state machines in a ring of the"
+        << endl
+        << "latest events. A phase lasts from entering a state until"
+        << endl
+        << "the next transition of the same state machine. Phases, that"
+        << endl
+        << "are still running, are marked with an asterisk." << endl
+        << endl
+        << "Actions:" << endl
+        << "  show   Output the scan and configuration durations per"
+        << endl
+        << "         slave and the accumulated durations per phase,"
+        << endl
+        << "         longest first (default). With --verbose, all"
+        << endl
+        << "         phases of each slave are listed." << endl
+        << "  trace  Output the phases in the Chrome trace event JSON"
+        << endl
+        << "         format, that can be loaded in chrome://tracing or"
+        << endl
+        << "         Perfetto. Each slave is displayed as a thread." << endl
+        << "  reset  Discard the recorded events, for example before a"
+        << endl
+        << "         rescan." << endl
+        << endl
+        << "Command-specific options:" << endl
+        << "  --alias    -a <alias>" << endl
+        << "  --position -p <pos>       Slave selection. See the help of"
+        << endl
+        << "                            the 'slaves' command." << endl
+        << "  --output-file -o <file>   Write the trace to the given file"
+        << endl
+        << "                            instead of stdout." << endl
+        << "  --verbose  -v             List all phases of each slave."
+        << endl
+        << endl
+        << numericInfo();
+
+    return str.str();
+}
+
+/****************************************************************************/
+
+void CommandTimeline::execute(const StringVector &args)
+{
+    MasterIndexList masterIndices;
+    PhaseList phases;
+    string action = "show";
+    ofstream file;
+    ostream *out = &cout;
+
+    if (args.size() > 1) {
+        stringstream err;
+        err << "'" << getName() << "' takes at most one argument!";
+        throwInvalidUsageException(err);
+    }
+
+    if (args.size()) {
+        action = args[0];
+    }
+
+    if (action != "show" && action != "trace" && action != "reset") {
+        stringstream err;
+        err << "Invalid action '" << action << "'!";
+        throwInvalidUsageException(err);
+    }
+
+    if (action == "trace" && !getOutputFile().empty()) {
+        file.open(getOutputFile().c_str(), ios::out);
+        if (file.fail()) {
+            stringstream err;
+            err << "Failed to open '" << getOutputFile() << "'!";
+            throwCommandException(err);
+        }
+        out = &file;
+    }
+
+    masterIndices = getMasterIndices();
+    MasterIndexList::const_iterator mi;
+    for (mi = masterIndices.begin();
+            mi != masterIndices.end(); mi++) {
+        MasterDevice m(*mi);
+        m.open(action == "reset" ?
+                MasterDevice::ReadWrite : MasterDevice::Read);
+
+        if (action == "reset") {
+            m.resetTimeline();
+            continue;
+        }
+
+        readPhases(m, *mi, phases);
+    }
+
+    if (action == "show") {
+        showSlaves(phases);
+        showPhases(phases);
+    } else if (action == "trace") {
+        writeTrace(phases, *out);
+        out->flush();
+    }
+}
+
+/****************************************************************************/
+
+/** Reads the timeline of a master and converts the events to phases.
+ */
+void CommandTimeline::readPhases(
+        MasterDevice &m,
+        unsigned int masterIndex,
+        PhaseList &phases
+        )
+{
+    ec_ioctl_timeline_t data;
+    ec_ioctl_timeline_event_t *events;
+    map<pair<uint16_t, uint8_t>, size_t> open;
+    map<pair<uint16_t, uint8_t>, size_t>::iterator oi;
+    set<uint16_t> positions;
+    SlaveList slaves;
+    SlaveList::const_iterator si;
+    struct timespec ts;
+    uint64_t now;
+    unsigned int i;
+
+    slaves = selectedSlaves(m);
+    for (si = slaves.begin(); si != slaves.end(); si++) {
+        positions.insert(si->position);
+    }
+
+    m.getTimeline(&data, NULL, 0);
+    if (!data.write_count) {
+        return;
+    }
+
+    if (data.write_count > data.size) {
+        cerr << "Master " << masterIndex << ": "
+            << data.write_count - data.size
+            << " oldest events were overwritten." << endl;
+    }
+
+    events = new ec_ioctl_timeline_event_t[data.size];
+
+    try {
+        m.getTimeline(&data, events, data.size);
+    } catch (MasterDeviceException &e) {
+        delete [] events;
+        throw e;
+    }
+
+    // the timeline uses the monotonic clock
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+
+    for (i = 0; i < data.count; i++) {
+        const ec_ioctl_timeline_event_t &ev = events[i];
+        pair<uint16_t, uint8_t> key(ev.slave_position, ev.fsm);
+        string state(ev.state,
+                strnlen(ev.state, EC_TIMELINE_STATE_SIZE));
+
+        if (!positions.count(ev.slave_position)) {
+            continue;
+        }
+
+        // a transition ends the previous phase of the state machine
+        oi = open.find(key);
+        if (oi != open.end()) {
+            Phase &p = phases[oi->second];
+            p.duration = ev.time - p.start;
+            p.running = false;
+            open.erase(oi);
+        }
+
+        if (state == "end" || state == "error") {
+            continue;
+        }
+
+        Phase p;
+        p.master = masterIndex;
+        p.position = ev.slave_position;
+        p.fsm = ev.fsm;
+        p.state = state;
+        p.start = ev.time;
+        p.duration = 0;
+        p.running = true;
+        open[key] = phases.size();
+        phases.push_back(p);
+    }
+
+    delete [] events;
+
+    for (oi = open.begin(); oi != open.end(); oi++) {
+        Phase &p = phases[oi->second];
+        p.duration = now > p.start ? now - p.start : 0;
+    }
+}
+
+/****************************************************************************/
+
+/** Outputs the durations per slave.
+ */
+void CommandTimeline::showSlaves(const PhaseList &phases)
+{
+    typedef pair<unsigned int, uint16_t> SlaveKey;
+    map<SlaveKey, SlaveTimes> slaves;
+    map<SlaveKey, SlaveTimes>::const_iterator si;
+    PhaseList::const_iterator pi;
+
+    for (pi = phases.begin(); pi != phases.end(); pi++) {
+        SlaveKey key(pi->master, pi->position);
+        if (!slaves.count(key)) {
+            SlaveTimes t = {0, 0, NULL};
+            slaves[key] = t;
+        }
+        SlaveTimes &t = slaves[key];
+        if (pi->fsm == EC_TIMELINE_SCAN) {
+            t.scan += pi->duration;
+        } else {
+            t.config += pi->duration;
+        }
+        if (!t.slowest || pi->duration > t.slowest->duration) {
+            t.slowest = &*pi;
+        }
+    }
+
+    cout << "Master  Slave   Scan [ms]  Config [ms]  Slowest phase" << endl;
+
+    for (si = slaves.begin(); si != slaves.end(); si++) {
+        const Phase &s = *si->second.slowest;
+
+        cout << setw(6) << si->first.first << "  "
+            << setw(5) << si->first.second << "  "
+            << setw(10) << msString(si->second.scan) << "  "
+            << setw(11) << msString(si->second.config) << "  "
+            << fsmString(s.fsm) << "/" << s.state
+            << " (" << msString(s.duration) << " ms"
+            << (s.running ? "*" : "") << ")" << endl;
+
+        if (getVerbosity() != Verbose) {
+            continue;
+        }
+
+        for (pi = phases.begin(); pi != phases.end(); pi++) {
+            if (pi->master != si->first.first
+                    || pi->position != si->first.second) {
+                continue;
+            }
+            cout << "                " << setw(10) << msString(pi->duration)
+                << (pi->running ? "* " : "  ") << fsmString(pi->fsm)
+                << "/" << pi->state << endl;
+        }
+    }
+
+    cout << endl;
+}
+
+/****************************************************************************/
+
+/** Outputs the accumulated durations per phase, longest first.
+ */
+void CommandTimeline::showPhases(const PhaseList &phases)
+{
+    map<string, PhaseTimes> times;
+    map<string, PhaseTimes>::const_iterator ti;
+    vector<PhaseTimes> sorted;
+    vector<PhaseTimes>::const_iterator vi;
+    PhaseList::const_iterator pi;
+
+    for (pi = phases.begin(); pi != phases.end(); pi++) {
+        string name = fsmString(pi->fsm) + "/" + pi->state;
+        if (!times.count(name)) {
+            PhaseTimes t;
+            t.name = name;
+            t.count = 0;
+            t.total = 0;
+            t.longest = NULL;
+            times[name] = t;
+        }
+        PhaseTimes &t = times[name];
+        t.count++;
+        t.total += pi->duration;
+        if (!t.longest || pi->duration > t.longest->duration) {
+            t.longest = &*pi;
+        }
+    }
+
+    for (ti = times.begin(); ti != times.end(); ti++) {
+        sorted.push_back(ti->second);
+    }
+    sort(sorted.begin(), sorted.end());
+
+    cout << "Phase                     Count  Total [ms]    Max [ms]"
+        << "  Slowest slave" << endl;
+
+    for (vi = sorted.begin(); vi != sorted.end(); vi++) {
+        cout << left << setw(24) << vi->name << right << "  "
+            << setw(5) << vi->count << "  "
+            << setw(10) << msString(vi->total) << "  "
+            << setw(10) << msString(vi->longest->duration) << "  "
+            << vi->longest->master << "-" << vi->longest->position
+            << endl;
+    }
+}
+
+/****************************************************************************/
+
+/** Outputs the phases in the Chrome trace event format.
+ *
+ * Time stamps are given in microseconds relative to the first phase.
+ */
+void CommandTimeline::writeTrace(const PhaseList &phases, ostream &out)
+{
+    set<pair<unsigned int, uint16_t> > slaves;
+    set<pair<unsigned int, uint16_t> >::const_iterator si;
+    PhaseList::const_iterator pi;
+    uint64_t base = 0;
+    bool first = true;
+
+    for (pi = phases.begin(); pi != phases.end(); pi++) {
+        if (pi == phases.begin() || pi->start < base) {
+            base = pi->start;
+        }
+        slaves.insert(make_pair(pi->master, pi->position));
+    }
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << endl;
+
+    for (si = slaves.begin(); si != slaves.end(); si++) {
+        out << (first ? "" : ",\n")
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": "
+            << si->first << ", \"tid\": " << si->second
+            << ", \"args\": {\"name\": \"Slave " << si->second << "\"}}";
+        first = false;
+    }
+
+    out << fixed << setprecision(3);
+
+    for (pi = phases.begin(); pi != phases.end(); pi++) {
+        out << (first ? "" : ",\n")
+            << "{\"name\": \"" << pi->state << "\", \"cat\": \""
+            << fsmString(pi->fsm) << "\", \"ph\": \"X\", \"ts\": "
+            << (pi->start - base) / 1000.0 << ", \"dur\": "
+            << pi->duration / 1000.0 << ", \"pid\": " << pi->master
+            << ", \"tid\": " << pi->position;
+        if (pi->running) {
+            out << ", \"args\": {\"running\": true}";
+        }
+        out << "}";
+        first = false;
+    }
+
+    out << endl << "]}" << endl;
+}
+
+/****************************************************************************/
+
+string CommandTimeline::fsmString(uint8_t fsm)
+{
+    switch (fsm) {
+        case EC_TIMELINE_SCAN:
+            return "scan";
+        case EC_TIMELINE_CONFIG:
+            return "config";
+        default:
+            return "???";
+    }
+}
+
+/****************************************************************************/
+
+string CommandTimeline::msString(uint64_t ns)
+{
+    stringstream str;
+
+    str << fixed << setprecision(3) << ns / 1000000.0;
+    return str.str();
+}
+
+/****************************************************************************/
@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  This file is part of the IgH EtherCAT Master.
+ *
+ *  The IgH EtherCAT Master is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License version 2, as
+ *  published by the Free Software Foundation.
+ *
+ *  The IgH EtherCAT Master is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ *  Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with the IgH EtherCAT Master; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ ****************************************************************************/
+
+
+#ifndef __COMMANDTIMELINE_H__
+#define __COMMANDTIMELINE_H__
+
+#include "Command.h"
+
+/****************************************************************************/
+
+class CommandTimeline:
+    public Command
+{
+    public:
+        CommandTimeline();
+
+        string helpString(const string &) const;
+        void execute(const StringVector &);
+
+    protected:
+        /** Time spent by a slave state machine in one state. */
+        struct Phase {
+            unsigned int master;
+            uint16_t position;
+            uint8_t fsm;
+            string state;
+            uint64_t start;
+            uint64_t duration;
+            bool running;
+        };
+        typedef vector<Phase> PhaseList;
+
+        /** Accumulated durations of a slave. */
+        struct SlaveTimes {
+            uint64_t scan;
+            uint64_t config;
+            const Phase *slowest;
+        };
+
+        /** Accumulated durations of a phase. */
+        struct PhaseTimes {
+            string name;
+            unsigned int count;
+            uint64_t total;
+            const Phase *longest;
+
+            /** Sorts the longest total duration first. */
+            bool operator<(const PhaseTimes &other) const {
+                return total > other.total;
+            }
+        };
+
+        void readPhases(MasterDevice &, unsigned int, PhaseList &);
+        void showSlaves(const PhaseList &);
+        void showPhases(const PhaseList &);
+        void writeTrace(const PhaseList &, ostream &);
+        static string fsmString(uint8_t);
+        static string msString(uint64_t);
+};
+
+/****************************************************************************/
+
+#endif
@@ -41,6 +41,8 @@ string CommandUpload::helpString(const string &binaryBaseName) const
 
     str << binaryBaseName << " " << getName()
         << " [OPTIONS] <INDEX> <SUBINDEX>" << endl
+        << binaryBaseName << " " << getName()
+        << " [OPTIONS] --complete <INDEX>" << endl
         << endl
         << getBriefDescription() << endl
         << endl
@@ -52,6 +54,10 @@ string CommandUpload::helpString(const string &binaryBaseName) const
         << "information service or the SDO is not in the dictionary," << endl
         << "the --type option is mandatory."  << endl
         << endl
+        << "With --complete, all subindices of the SDO are read at" << endl
+        << "once via CompleteAccess. Subindex 0 is padded to 16 bit." << endl
+        << "The data are output as raw data, unless --type is given." << endl
+        << endl
         << typeInfo()
         << endl
         << "Arguments:" << endl
@@ -65,6 +71,7 @@ string CommandUpload::helpString(const string &binaryBaseName) const
         << "  --position -p <pos>    Slave selection. See the help of" << endl
         << "                         the 'slaves' command." << endl
         << "  --type     -t <type>   SDO entry data type (see above)." << endl
+        << "  --complete -c          Upload the SDO via CompleteAccess." << endl
         << endl
         << numericInfo();
 
@@ -81,7 +88,13 @@ void CommandUpload::execute(const StringVector &args)
     const DataType *dataType = NULL;
     unsigned int uval;
 
-    if (args.size() != 2) {
+    data.complete_access = getCompleteAccess();
+
+    if (data.complete_access && args.size() != 1) {
+        err << "'" << getName() << "' takes one argument"
+            << " with --complete!";
+        throwInvalidUsageException(err);
+    } else if (!data.complete_access && args.size() != 2) {
         err << "'" << getName() << "' takes two arguments!";
         throwInvalidUsageException(err);
     }
@@ -95,15 +108,19 @@ void CommandUpload::execute(const StringVector &args)
         throwInvalidUsageException(err);
     }
 
-    strSubIndex << args[1];
-    strSubIndex
-        >> resetiosflags(ios::basefield) // guess base from prefix
-        >> uval;
-    if (strSubIndex.fail() || uval > 0xff) {
-        err << "Invalid SDO subindex '" << args[1] << "'!";
-        throwInvalidUsageException(err);
+    if (data.complete_access) {
+        data.sdo_entry_subindex = 0;
+    } else {
+        strSubIndex << args[1];
+        strSubIndex
+            >> resetiosflags(ios::basefield) // guess base from prefix
+            >> uval;
+        if (strSubIndex.fail() || uval > 0xff) {
+            err << "Invalid SDO subindex '" << args[1] << "'!";
+            throwInvalidUsageException(err);
+        }
+        data.sdo_entry_subindex = uval;
     }
-    data.sdo_entry_subindex = uval;
 
     MasterDevice m(getSingleMasterIndex());
     m.open(MasterDevice::ReadWrite);
@@ -118,6 +135,8 @@ void CommandUpload::execute(const StringVector &args)
             err << "Invalid data type '" << getDataType() << "'!";
             throwInvalidUsageException(err);
         }
+    } else if (data.complete_access) { // whole object: output raw data
+        dataType = findDataType("raw");
     } else { // no data type specified: fetch from dictionary
         ec_ioctl_slave_sdo_entry_t entry;
 
@@ -66,6 +66,8 @@ std::string FoeCommand::resultText(int result)
             return "FOE_READ_NODATA_ERROR";
         case FOE_MBOX_PROT_ERROR:
             return "FOE_MBOX_PROT_ERROR";
+        case FOE_ABORTED_ERROR:
+            return "FOE_ABORTED_ERROR";
         default:
             return "???";
     }
@@ -267,6 +267,109 @@ void MasterDevice::getData(ec_ioctl_domain_data_t *data,
 
 /****************************************************************************/
 
+void MasterDevice::readRecorder(ec_ioctl_recorder_read_t *data,
+        unsigned int domainIndex, unsigned int size, unsigned char *mem)
+{
+    data->domain_index = domainIndex;
+    data->size = size;
+    data->target = mem;
+
+    if (ioctl(fd, EC_IOCTL_RECORDER_READ, data) < 0) {
+        stringstream err;
+        err << "Failed to read flight recorder: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::freezeRecorder(unsigned int domainIndex)
+{
+    if (ioctl(fd, EC_IOCTL_RECORDER_FREEZE, domainIndex) < 0) {
+        stringstream err;
+        err << "Failed to freeze flight recorder: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::armRecorder(unsigned int domainIndex)
+{
+    if (ioctl(fd, EC_IOCTL_RECORDER_ARM, domainIndex) < 0) {
+        stringstream err;
+        err << "Failed to arm flight recorder: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::getTimeline(ec_ioctl_timeline_t *data,
+        ec_ioctl_timeline_event_t *events, unsigned int count)
+{
+    data->events = events;
+    data->count = count;
+
+    if (ioctl(fd, EC_IOCTL_TIMELINE, data) < 0) {
+        stringstream err;
+        err << "Failed to read startup timeline: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::resetTimeline()
+{
+    if (ioctl(fd, EC_IOCTL_TIMELINE_RESET, 0) < 0) {
+        stringstream err;
+        err << "Failed to reset startup timeline: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::getSnapshot(ec_ioctl_snapshot_t *data, uint8_t *target,
+        uint32_t size)
+{
+    data->data = target;
+    data->size = size;
+
+    if (ioctl(fd, EC_IOCTL_SNAPSHOT, data) < 0) {
+        stringstream err;
+        err << "Failed to get snapshot: ";
+        if (errno == EAGAIN)
+            err << "Bus scan in progress!";
+        else
+            err << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::getSdoDictionary(ec_ioctl_slave_sdo_dict_t *data,
+        uint16_t slave_position, uint8_t *target, uint32_t size)
+{
+    data->slave_position = slave_position;
+    data->data = target;
+    data->size = size;
+
+    if (ioctl(fd, EC_IOCTL_SLAVE_SDO_DICT, data) < 0) {
+        stringstream err;
+        err << "Failed to get SDO dictionary: ";
+        if (errno == ENOENT)
+            err << "No dictionary fetched yet!";
+        else
+            err << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
 void MasterDevice::getSlave(ec_ioctl_slave_t *slave, uint16_t slaveIndex)
 {
     slave->position = slaveIndex;
@@ -478,6 +581,63 @@ void MasterDevice::writeFoe(
 
 /****************************************************************************/
 
+void MasterDevice::startFoeStream(
+        ec_ioctl_slave_foe_stream_t *data
+        )
+{
+    if (ioctl(fd, EC_IOCTL_SLAVE_FOE_STREAM_START, data) < 0) {
+        stringstream err;
+        err << "Failed to start FoE transfer: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::foeStreamData(
+        ec_ioctl_slave_foe_stream_t *data
+        )
+{
+    if (ioctl(fd, EC_IOCTL_SLAVE_FOE_STREAM_DATA, data) < 0) {
+        stringstream err;
+        err << "Failed to transfer FoE data: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+void MasterDevice::finishFoeStream(
+        ec_ioctl_slave_foe_stream_t *data
+        )
+{
+    if (ioctl(fd, EC_IOCTL_SLAVE_FOE_STREAM_FINISH, data) < 0) {
+        stringstream err;
+        err << "Failed to finish FoE transfer: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
+bool MasterDevice::writeFoeMulti(
+        ec_ioctl_slave_foe_multi_t *data
+        )
+{
+    if (ioctl(fd, EC_IOCTL_SLAVE_FOE_WRITE_MULTI, data) < 0) {
+        if (errno == EIO) {
+            return false; // the targets contain the individual errors
+        }
+        stringstream err;
+        err << "Failed to write via FoE: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+
+    return true;
+}
+
+/****************************************************************************/
+
 void MasterDevice::setDebug(unsigned int debugLevel)
 {
     if (ioctl(fd, EC_IOCTL_MASTER_DEBUG, debugLevel) < 0) {
@@ -489,6 +649,17 @@ void MasterDevice::setDebug(unsigned int debugLevel)
 
 /****************************************************************************/
 
+void MasterDevice::setFsmSlots(unsigned int slots)
+{
+    if (ioctl(fd, EC_IOCTL_MASTER_FSM_SLOTS, slots) < 0) {
+        stringstream err;
+        err << "Failed to set slave FSM slots: " << strerror(errno);
+        throw MasterDeviceException(err);
+    }
+}
+
+/****************************************************************************/
+
 void MasterDevice::rescan()
 {
     if (ioctl(fd, EC_IOCTL_MASTER_RESCAN, 0) < 0) {
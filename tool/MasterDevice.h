@@ -134,6 +134,16 @@ class MasterDevice
         void getFmmu(ec_ioctl_domain_fmmu_t *, unsigned int, unsigned int);
         void getData(ec_ioctl_domain_data_t *, unsigned int, unsigned int,
                 unsigned char *);
+        void readRecorder(ec_ioctl_recorder_read_t *, unsigned int,
+                unsigned int, unsigned char *);
+        void freezeRecorder(unsigned int);
+        void armRecorder(unsigned int);
+        void getTimeline(ec_ioctl_timeline_t *, ec_ioctl_timeline_event_t *,
+                unsigned int);
+        void resetTimeline();
+        void getSnapshot(ec_ioctl_snapshot_t *, uint8_t *, uint32_t);
+        void getSdoDictionary(ec_ioctl_slave_sdo_dict_t *, uint16_t,
+                uint8_t *, uint32_t);
         void getSlave(ec_ioctl_slave_t *, uint16_t);
         void getSync(ec_ioctl_slave_sync_t *, uint16_t, uint8_t);
         void getPdo(ec_ioctl_slave_sync_pdo_t *, uint16_t, uint8_t, uint8_t);
@@ -146,12 +156,17 @@ class MasterDevice
         void readReg(ec_ioctl_slave_reg_t *);
         void writeReg(ec_ioctl_slave_reg_t *);
         void setDebug(unsigned int);
+        void setFsmSlots(unsigned int);
         void rescan();
         void sdoDownload(ec_ioctl_slave_sdo_download_t *);
         void sdoUpload(ec_ioctl_slave_sdo_upload_t *);
         void requestState(uint16_t, uint8_t);
         void readFoe(ec_ioctl_slave_foe_t *);
         void writeFoe(ec_ioctl_slave_foe_t *);
+        void startFoeStream(ec_ioctl_slave_foe_stream_t *);
+        void foeStreamData(ec_ioctl_slave_foe_stream_t *);
+        void finishFoeStream(ec_ioctl_slave_foe_stream_t *);
+        bool writeFoeMulti(ec_ioctl_slave_foe_multi_t *);
         void readSoe(ec_ioctl_slave_soe_read_t *);
         void writeSoe(ec_ioctl_slave_soe_write_t *);
 #ifdef EC_EOE
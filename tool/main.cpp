@@ -40,12 +40,14 @@ using namespace std;
 #endif
 #include "CommandFoeRead.h"
 #include "CommandFoeWrite.h"
+#include "CommandFsmSlots.h"
 #include "CommandGraph.h"
 #ifdef EC_EOE
 # include "CommandIp.h"
 #endif
 #include "CommandMaster.h"
 #include "CommandPdos.h"
+#include "CommandRecord.h"
 #include "CommandRegRead.h"
 #include "CommandRegWrite.h"
 #include "CommandRescan.h"
@@ -53,9 +55,11 @@ using namespace std;
 #include "CommandSiiRead.h"
 #include "CommandSiiWrite.h"
 #include "CommandSlaves.h"
+#include "CommandSnapshot.h"
 #include "CommandSoeRead.h"
 #include "CommandSoeWrite.h"
 #include "CommandStates.h"
+#include "CommandTimeline.h"
 #include "CommandUpload.h"
 #include "CommandVersion.h"
 #include "CommandXml.h"
@@ -80,6 +84,7 @@ string dataTypeStr;
 Command::Verbosity verbosity = Command::Normal;
 bool force = false;
 bool emergency = false;
+bool completeAccess = false;
 bool helpRequested = false;
 string outputFile;
 string skin;
@@ -147,6 +152,7 @@ void getOptions(int argc, char **argv)
         {"output-file", required_argument, NULL, 'o'},
         {"skin",        required_argument, NULL, 's'},
         {"emergency",   no_argument,       NULL, 'e'},
+        {"complete",    no_argument,       NULL, 'c'},
         {"force",       no_argument,       NULL, 'f'},
         {"quiet",       no_argument,       NULL, 'q'},
         {"verbose",     no_argument,       NULL, 'v'},
@@ -155,7 +161,7 @@ void getOptions(int argc, char **argv)
     };
 
     do {
-        c = getopt_long(argc, argv, "m:a:p:d:t:o:s:efqvh", longOptions, NULL);
+        c = getopt_long(argc, argv, "m:a:p:d:t:o:s:ecfqvh", longOptions, NULL);
 
         switch (c) {
             case 'm':
@@ -190,6 +196,10 @@ void getOptions(int argc, char **argv)
                 emergency = true;
                 break;
 
+            case 'c':
+                completeAccess = true;
+                break;
+
             case 'f':
                 force = true;
                 break;
@@ -284,12 +294,14 @@ int main(int argc, char **argv)
 #endif
     commandList.push_back(new CommandFoeRead());
     commandList.push_back(new CommandFoeWrite());
+    commandList.push_back(new CommandFsmSlots());
     commandList.push_back(new CommandGraph());
 #ifdef EC_EOE
     commandList.push_back(new CommandIp());
 #endif
     commandList.push_back(new CommandMaster());
     commandList.push_back(new CommandPdos());
+    commandList.push_back(new CommandRecord());
     commandList.push_back(new CommandRegRead());
     commandList.push_back(new CommandRegWrite());
     commandList.push_back(new CommandRescan());
@@ -297,9 +309,11 @@ int main(int argc, char **argv)
     commandList.push_back(new CommandSiiRead());
     commandList.push_back(new CommandSiiWrite());
     commandList.push_back(new CommandSlaves());
+    commandList.push_back(new CommandSnapshot());
     commandList.push_back(new CommandSoeRead());
     commandList.push_back(new CommandSoeWrite());
     commandList.push_back(new CommandStates());
+    commandList.push_back(new CommandTimeline());
     commandList.push_back(new CommandUpload());
     commandList.push_back(new CommandVersion());
     commandList.push_back(new CommandXml());
@@ -322,6 +336,7 @@ int main(int argc, char **argv)
                     cmd->setOutputFile(outputFile);
                     cmd->setSkin(skin);
                     cmd->setEmergency(emergency);
+                    cmd->setCompleteAccess(completeAccess);
                     cmd->setForce(force);
                     cmd->execute(commandArgs);
                 } catch (InvalidUsageException &e) {